@@ -9,6 +9,22 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 01:20  agt     added the input log switches and the ES_Input_t list
+ 10/18/26 00:30  agt     added the ES_TRACER switch and ES_TRACE_RING_SIZE
+ 10/17/26 23:10  agt     added ES_NUM_SHORT_TIMERS
+ 10/17/26 22:30  agt     unused timers are the pool for ES_Timer_Alloc
+ 10/17/26 20:30  agt     added ES_TICKLESS switch
+ 10/17/26 19:40  agt     added ES_NUM_TIMERS
+ 10/17/26 18:45  agt     added ES_MAX_BLOCK_QUEUES, queue sizes now round up
+                         to a power of 2
+ 10/17/26 17:30  agt     added the optional SERV_n_QUEUE_POLICY definitions
+ 10/17/26 15:55  agt     added the optional SERV_n_SUBSCRIBES broadcast masks
+ 10/17/26 15:10  agt     added ES_EVENT_PARAM_BITS
+ 10/17/26 14:20  agt     added ES_MAX_MAILBOXES
+ 10/17/26 13:05  agt     added ES_PROFILER switch and its table sizes
+ 10/17/26 12:10  agt     added ES_QUEUE_TELEMETRY switch
+ 10/17/26 11:02  agt     added the optional SERV_n_BATCH_SIZE definitions
+ 10/17/26 09:40  agt     MAX_NUM_SERVICES can now go up to 64
  12/19/16 20:19  jec     removed EVENT_CHECK_HEADER definition. This goes with
                          the V2.3 move to a single wrapper for event checking
                          headers
@@ -26,8 +42,9 @@
 
 /****************************************************************************/
 // The maximum number of services sets an upper bound on the number of
-// services that the framework will handle. Reasonable values are 8 and 16
-// corresponding to an 8-bit(uint8_t) and 16-bit(uint16_t) Ready variable size
+// services that the framework will handle. Reasonable values are 16, 32 and
+// 64. Up to 32 the Ready bitmap is a single 32 bit word, above that a second
+// word is added, so choose the smallest value that covers NUM_SERVICES
 #define MAX_NUM_SERVICES 16
 
 /****************************************************************************/
@@ -35,6 +52,88 @@
 // a particular application. It will vary in value from 1 to MAX_NUM_SERVICES
 #define NUM_SERVICES 11
 
+/****************************************************************************/
+// The most ISR mailboxes (see ES_Mailbox.h) that can be set up at once. Each
+// interrupt source that posts events needs its own mailbox
+#define ES_MAX_MAILBOXES 4
+
+/****************************************************************************/
+// The most queues that can be set up in a block of memory with ES_InitQueue
+// (deferral queues and the like) at once. The service queues are not counted.
+#define ES_MAX_BLOCK_QUEUES 8
+
+/****************************************************************************/
+// Uncomment this to have the framework record, for each service queue, the
+// high-water mark, the number of posts rejected because the queue was full
+// and the time from post to dispatch. Read the numbers with ES_GetQueueStats
+// or print them with ES_DumpQueueStats. Leave it commented out for a build
+// with no telemetry code or data at all.
+//#define ES_QUEUE_TELEMETRY
+
+/****************************************************************************/
+// Uncomment this to time, with the core timer, every run function call (per
+// service and event type) and every event checker call. Start a dump of the
+// results to the terminal with ES_Profile_StartDump. Leave it commented out
+// for a build with no profiling code or data at all.
+//#define ES_PROFILER
+// event types at or above this number are lumped together in the profile
+#define ES_PROFILE_NUM_EVENT_TYPES 32
+// how many different service/event type pairs the profiler can keep track of
+#define ES_PROFILE_MAX_PAIRS 48
+
+/****************************************************************************/
+// Uncomment this to keep a trace of every post, run function call, timer
+// running out and event checker hit, time stamped with the core timer, in a
+// RAM ring. Press 't' to dump the ring to the terminal, then turn the
+// captured dump into a Chrome trace with HostSim/ES_TraceToChrome.c. Leave it
+// commented out for a build with no tracing code or data at all.
+//#define ES_TRACER
+// the number of records the ring keeps, a power of 2. Each takes 16 bytes
+#define ES_TRACE_RING_SIZE 256
+
+/****************************************************************************/
+// Uncomment ES_INPUT_RECORD to log, from reset, each change of the inputs
+// in ES_Input_t (below), each key and each ADC_MultiRead, with the tick it
+// was read in. Press 'i' to dump the log to the terminal. A host build with
+// ES_INPUT_REPLAY instead plays back the dump in a capture of the terminal,
+// exactly, in virtual time (see ES_InputLog.c). Leave both commented out for
+// a build with no log.
+//#define ES_INPUT_RECORD
+//#define ES_INPUT_REPLAY
+// the size of the log in bytes. A pin change or a key takes 1 to 8
+#define ES_INPUT_LOG_SIZE 4096
+
+/****************************************************************************/
+// Each service may optionally define SERV_n_SUBSCRIBES, the set of event
+// types that it wants to get from ES_PostAll and the ES_PostListxx functions,
+// built from ES_EVENT_BIT(ES_xxx) | ES_EVENT_BIT(ES_yyy)... Broadcast copies
+// of other types are dropped before they reach the service's queue. Services
+// without a definition get every broadcast, and posts made directly to a
+// service are always delivered. Only the first 32 event types can be
+// filtered, broadcasts of higher numbered types reach every service.
+// A service can add to its set at run time with ES_AddSubscriptions.
+
+/****************************************************************************/
+// Each service may optionally define SERV_n_BATCH_SIZE, the number of events
+// that ES_Run will dispatch from that service's queue (including any that it
+// posts to itself along the way) before re-scanning for the highest priority
+// ready service. Services without a definition get 1 event per pass. Timer
+// ticks are processed between batches, so a large budget delays the ticks and
+// higher priority services by up to that many run function calls.
+
+/****************************************************************************/
+// Each service may optionally define SERV_n_QUEUE_POLICY, what its queue does
+// with a post that finds it full or finds the same event (type and param)
+// already waiting: ES_QUEUE_REJECT_NEW (the post fails), ES_QUEUE_DROP_OLDEST
+// (the oldest waiting event is thrown away) and/or ES_QUEUE_COALESCE (the
+// repeat is not added). Services without a definition reject new events.
+// Services that work in steps should take the next step with
+// ES_ContinueService rather than posting to themselves, so the step doesn't
+// use up a queue slot.
+// SERV_n_QUEUE_SIZE is rounded up to a power of 2, so 3 becomes 4 events
+// in the RAM that used to hold 3 events and a header slot, plus a 12 byte
+// ES_RingQueue_t.
+
 /****************************************************************************/
 // These are the definitions for Service 0, the lowest priority service.
 // Every Events and Services application must have a Service 0. Further
@@ -48,6 +147,8 @@
 #define SERV_0_RUN RunRocketLaunchGameFSM
 // How big should this services Queue be?
 #define SERV_0_QUEUE_SIZE 3
+// Which broadcast events does it want? (its test mode adds ES_NEW_KEY)
+#define SERV_0_SUBSCRIBES ES_NO_EVENTS_MASK
 
 /****************************************************************************/
 // The following sections are used to define the parameters for each of the
@@ -64,6 +165,10 @@
 #define SERV_1_RUN RunLEDFSM
 // How big should this services Queue be?
 #define SERV_1_QUEUE_SIZE 3
+// How many events in a row? 8 lets a whole display refresh run as 1 batch
+#define SERV_1_BATCH_SIZE 8
+// Which broadcast events does it want?
+#define SERV_1_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -77,6 +182,8 @@
 #define SERV_2_RUN RunRocketReleaseServo
 // How big should this services Queue be?
 #define SERV_2_QUEUE_SIZE 3
+// Which broadcast events does it want? (its test mode adds ES_NEW_KEY)
+#define SERV_2_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -90,6 +197,8 @@
 #define SERV_3_RUN RunRedButtonFSM
 // How big should this services Queue be?
 #define SERV_3_QUEUE_SIZE 3
+// Which broadcast events does it want?
+#define SERV_3_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -103,6 +212,8 @@
 #define SERV_4_RUN RunRocketHeightServos
 // How big should this services Queue be?
 #define SERV_4_QUEUE_SIZE 3
+// Which broadcast events does it want? (its test mode adds ES_NEW_KEY)
+#define SERV_4_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -116,6 +227,8 @@
 #define SERV_5_RUN RunGreenButtonFSM
 // How big should this services Queue be?
 #define SERV_5_QUEUE_SIZE 3
+// Which broadcast events does it want?
+#define SERV_5_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -129,6 +242,8 @@
 #define SERV_6_RUN RunBlueButtonFSM
 // How big should this services Queue be?
 #define SERV_6_QUEUE_SIZE 3
+// Which broadcast events does it want?
+#define SERV_6_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -142,6 +257,12 @@
 #define SERV_7_RUN RunLEDDisplayService
 // How big should this services Queue be?
 #define SERV_7_QUEUE_SIZE 3
+// How many events in a row? 8 lets a whole display refresh run as 1 batch
+#define SERV_7_BATCH_SIZE 8
+// What about a full queue? Repeats of a waiting message or timeout add nothing
+#define SERV_7_QUEUE_POLICY ES_QUEUE_COALESCE
+// Which broadcast events does it want?
+#define SERV_7_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -155,6 +276,8 @@
 #define SERV_8_RUN RunAudioService
 // How big should this services Queue be?
 #define SERV_8_QUEUE_SIZE 3
+// Which broadcast events does it want? (its test mode adds ES_NEW_KEY)
+#define SERV_8_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -168,6 +291,8 @@
 #define SERV_9_RUN RunTimerServoFSM
 // How big should this services Queue be?
 #define SERV_9_QUEUE_SIZE 3
+// Which broadcast events does it want? (its test mode adds ES_NEW_KEY)
+#define SERV_9_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -181,6 +306,8 @@
 #define SERV_10_RUN RunLimitSwitchFSM
 // How big should this services Queue be?
 #define SERV_10_QUEUE_SIZE 3
+// Which broadcast events does it want?
+#define SERV_10_SUBSCRIBES ES_NO_EVENTS_MASK
 #endif
 
 /****************************************************************************/
@@ -248,6 +375,18 @@
 #define SERV_15_QUEUE_SIZE 3
 #endif
 
+/****************************************************************************/
+// Services 16 through 63 are defined in exactly the same way as those above
+// (SERV_16_HEADER, SERV_16_INIT, SERV_16_RUN, SERV_16_QUEUE_SIZE, ...). Add
+// them here, in numeric sequence, as NUM_SERVICES grows past 16.
+
+/****************************************************************************/
+// The size of EventParam in every event, 16 or 32 bits. With 16, an event is
+// 4 bytes (16 bit type and param) and the queues take the least RAM and time
+// to copy. Choose 32 if some service needs to pass a pointer or other wide
+// value in the param, at the cost of doubling the size of every event.
+#define ES_EVENT_PARAM_BITS 16
+
 /****************************************************************************/
 // Name/define the events of interest
 // Universal events occupy the lowest entries, followed by user-defined events
@@ -261,6 +400,7 @@ typedef enum {
     /* User-defined events start here */
     ES_NEW_KEY, /* signals a new key received from terminal */
     ES_NEW_CHAR, /* signals a new char to enter LED matrix */
+    ES_NEW_COLUMN, /* signals a new pixel column to enter LED matrix */
     ES_KEEP_UPDATING, /* signals LED matrix to keep updating */
     ES_UPDATE_COMPLETE, /* signals LED matrix to finish updating */
     ES_PC_INSERTED, /* signals insertion of a poker chip from sensor */
@@ -282,6 +422,19 @@ typedef enum {
     ES_RESET_GAME_TIMER /*signals TimerServoFSM to stop*/
 } ES_EventType_t;
 
+/****************************************************************************/
+// Name the pins that the event checkers read through ES_Input_Level, for
+// the input log. There can be up to 32
+typedef enum {
+    ES_IN_PC_SENSOR = 0, /* poker chip sensor, PCEventChecker */
+    ES_IN_RED_BUTTON,
+    ES_IN_GREEN_BUTTON,
+    ES_IN_BLUE_BUTTON,
+    ES_IN_IR_LAUNCH, /* IR launch sensor, IRLaunchEventChecker */
+    ES_IN_LIMIT_SWITCH,
+    ES_NUM_INPUTS
+} ES_Input_t;
+
 
 /****************************************************************************/
 // These are the definitions for the Distribution lists. Each definition
@@ -317,10 +470,30 @@ typedef enum {
 // This is the list of event checking functions
 #define EVENT_CHECK_LIST Check4Keystroke, CheckPCDetectionEvents, CheckRedButton, CheckGreenButton, CheckBlueButton, CheckIRLaunchEvents, CheckLimitSwitch
 
+/****************************************************************************/
+// The number of timers, from 16 up to 256
+#define ES_NUM_TIMERS 16
+
+/****************************************************************************/
+// Uncomment this to run the timers without a periodic tick interrupt. The core
+// timer compare is set for the next timer to run out instead, and the tick
+// count is worked out from the core timer count. Leave it commented out for
+// a tick interrupt at the rate passed to ES_Initialize.
+//#define ES_TICKLESS
+
+/****************************************************************************/
+// The number of short (microsecond) timers, see ES_ShortTimer.c. They all
+// share one hardware timer, so more only costs RAM, up to 8
+#define ES_NUM_SHORT_TIMERS 4
+
 /****************************************************************************/
 // These are the definitions for the post functions to be executed when the
 // corresponding timer expires. All 16 must be defined. If you are not using
 // a timer, then you should use TIMER_UNUSED
+// With more than 16 timers, timers 16 to 63 may also be given a
+// TIMERn_RESP_FUNC here. Timers without one can be routed at run time with
+// ES_Timer_SetPostFunc, and are the pool that ES_Timer_Alloc and
+// ES_Timer_AllocCallback hand timers out from
 // Unlike services, any combination of timers may be used and there is no
 // priority in servicing them
 #define TIMER_UNUSED ((pPostFunc)0)
@@ -16,17 +16,16 @@
  Description
    Initializes a queue structure at the beginning of the block of memory
  Notes
-   you should pass it a block that is at least sizeof(ES_Queue_t) larger than
-   the number of entries that you want in the queue. Since the size of an
-   ES_Event (at 4 bytes; 2 enum, 2 param) is greater than the
-   sizeof(ES_Queue_t), you only need to declare an array of ES_Event
-   with 1 more element than you need for the actual queue.
+   the first element of the block is used to find the queue and the
+   capacity is the largest power of 2 that fits in the rest, so declare an
+   array of ES_Event with 1 more element than a power of 2, e.g.
+   ES_Event_t DeferralQueue[8 + 1].
 ****************************************************************************/
 #define ES_InitDeferralQueueWith(a, b) ES_InitQueue(a, b)
 
 /****************************************************************************
  Function
-   ES_DeferEvent  (wrapper for ES_EnQueueLIFO)
+   ES_DeferEvent  (wrapper for ES_EnQueueFIFO)
    this is a straight re-naming to aid readability
  Parameters
    ES_Event * pBlock : pointer to the block of memory in use as the Queue
@@ -34,9 +33,10 @@
  Returns
    bool : true if the add was successful, false if not
  Description
-   if it will fit, adds Event2Add to the Queue
+   if it will fit, adds Event2Add to the end of the Queue, so the deferred
+   events are kept in the order they came in
  ***************************************************************************/
-#define ES_DeferEvent(a, b) ES_EnQueueLIFO(a, b)
+#define ES_DeferEvent(a, b) ES_EnQueueFIFO(a, b)
 
 /****************************************************************************
  Function
@@ -48,11 +48,12 @@
  Returns
      bool true if an event was recalled, false if no event was left in queue
  Description
-     pulls an event off the deferral queue if one is available. It there was
+     pulls all events off the deferral queue if any are available. If there was
      something in the queue, then it posts it LIFO fashion to the queue
      indicated by WhichService
  Notes
-     None.
+     the events come back out in the order that they were deferred, ahead
+     of anything else that was waiting
  Author
      J. Edward Carryer, 11/20/13 16:49
 ****************************************************************************/
@@ -8,6 +8,10 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 15:55 agt      added ES_EventMask_t and the macros to build masks
+ 10/17/26 15:10 agt      EventType is now stored in 16 bits and EventParam is
+                         16 or 32 bits as set by ES_EVENT_PARAM_BITS, making
+                         the normal event 4 bytes instead of 8
  10/19/17 14:22 jec      changed include to ES_Cpnfigre to get definition of
                          ES_EventTyp_t
  08/05/13 15:19 jec      modifications to suit new portable type definitions
@@ -24,10 +28,29 @@
 
 #include "ES_Configure.h"
 
+#if ES_EVENT_PARAM_BITS == 32
+typedef uint32_t ES_EventParam_t;
+#elif ES_EVENT_PARAM_BITS == 16
+typedef uint16_t ES_EventParam_t;
+#else
+#error "ES_EVENT_PARAM_BITS must be 16 or 32"
+#endif
+
+// EventType holds an ES_EventType_t. It is kept in 16 bits rather than in the
+// enum itself, which the compiler makes 32 bits, so that with a 16 bit param
+// the whole event fits in a single word
 typedef struct ES_Event
 {
-  ES_EventType_t EventType;      // what kind of event?
-  uint16_t EventParam;          // parameter value for use w/ this event
+  uint16_t EventType;           // what kind of event?
+  ES_EventParam_t EventParam;   // parameter value for use w/ this event
 }ES_Event_t;
 
+// a set of event types, one bit per type, used for the broadcast
+// subscriptions. Only types below ES_NUM_MASKED_EVENTS have a bit
+typedef uint32_t ES_EventMask_t;
+#define ES_NUM_MASKED_EVENTS 32
+#define ES_EVENT_BIT(EventType) ((ES_EventMask_t)1 << (EventType))
+#define ES_NO_EVENTS_MASK ((ES_EventMask_t)0)
+#define ES_ALL_EVENTS_MASK (~(ES_EventMask_t)0)
+
 #endif /* ES_Events_H */
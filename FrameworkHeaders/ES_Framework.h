@@ -8,6 +8,18 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 07:40 agt      added ES_TakeTimeoutTarget and ES_NO_SERVICE
+ 10/18/26 01:20 agt      include ES_InputLog.h with the other framework headers
+ 10/18/26 00:30 agt      include ES_Tracer.h with the other framework headers
+ 10/17/26 18:45 agt      added ES_PostToServiceLIFOBulk prototype
+ 10/17/26 17:30 agt      added ES_ContinueService prototype
+ 10/17/26 16:40 agt      ES_EndBroadcast delivers the broadcast and reports
+                         whether it succeeded
+ 10/17/26 15:55 agt      added the broadcast subscription prototypes
+ 10/17/26 14:20 agt      include ES_Mailbox.h with the other framework headers
+ 10/17/26 13:05 agt      include ES_Profiler.h with the other framework headers
+ 10/17/26 12:10 agt      added the queue telemetry type and prototypes
+ 10/17/26 11:02 agt      added ES_SetBatchBudget prototype
  11/02/13 17:06 jec      added ES_PostToServiceLIFO prototype
  08/05/13 15:00 jec      added #include for ES_Port.h to get portability stuff
  10/17/06 07:41 jec      started coding
@@ -28,6 +40,10 @@
 #include "ES_PostList.h"
 #include "ES_General.h"
 #include "ES_Timers.h"
+#include "ES_Profiler.h"
+#include "ES_Tracer.h"
+#include "ES_InputLog.h"
+#include "ES_Mailbox.h"
 
 typedef enum
 {
@@ -40,10 +56,38 @@ typedef enum
   FailedOther
 }ES_Return_t;
 
+// queue telemetry for one service, only collected if ES_QUEUE_TELEMETRY is
+// defined in ES_Configure.h. Wait times are in core timer ticks
+typedef struct
+{
+  uint8_t   QueueSize;      // how many events the queue can hold
+  uint8_t   HighWater;      // most events ever waiting at once
+  uint16_t  Overflows;      // posts rejected because the queue was full
+  uint32_t  NumDispatched;  // events passed to the run function
+  uint32_t  MaxWait;        // longest time from post to dispatch
+  uint64_t  TotalWait;      // sum of all post to dispatch times
+}ES_QueueStats_t;
+
+// stands for no service, where a service number is expected
+#define ES_NO_SERVICE 0xFF
+
 ES_Return_t ES_Initialize(TimerRate_t NewRate);
 ES_Return_t ES_Run(void);
 bool ES_PostAll(ES_Event_t ThisEvent);
 bool ES_PostToService(uint8_t WhichService, ES_Event_t ThisEvent);
 bool ES_PostToServiceLIFO(uint8_t WhichService, ES_Event_t TheEvent);
+uint16_t ES_PostToServiceLIFOBulk(uint8_t WhichService,
+    const ES_Event_t *pEvents, uint16_t NumEvents);
+bool ES_ContinueService(uint8_t WhichService, ES_Event_t TheEvent);
+bool ES_SetBatchBudget(uint8_t WhichService, uint8_t NewBudget);
+bool ES_SetSubscriptions(uint8_t WhichService, ES_EventMask_t NewMask);
+bool ES_AddSubscriptions(uint8_t WhichService, ES_EventMask_t MoreEvents);
+void ES_BeginBroadcast(void);
+bool ES_EndBroadcast(bool Deliver);
+bool ES_GetQueueStats(uint8_t WhichService, ES_QueueStats_t *pStats);
+void ES_ResetQueueStats(void);
+void ES_DumpQueueStats(void);
+uint32_t ES_GetSkippedBroadcasts(void);
+uint8_t ES_TakeTimeoutTarget(void);
 
 #endif   // ES_Framework_H
@@ -0,0 +1,55 @@
+/****************************************************************************
+ Module
+     ES_InputLog.h
+ Description
+     header file for the record and replay of the inputs of the Events &
+     Services Framework
+ Notes
+     The event checkers read their pins through ES_Input_Level, keys through
+     ES_Input_IsKeyReady & ES_Input_GetKey, and ADC_MultiRead passes its
+     results through ES_Input_Analog. Without ES_INPUT_RECORD or
+     ES_INPUT_REPLAY in ES_Configure.h these are plain pass-throughs
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 01:20 agt      started coding
+*****************************************************************************/
+#ifndef ES_InputLog_H
+#define ES_InputLog_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+#include "terminal.h"
+
+#if defined(ES_INPUT_RECORD) && defined(ES_INPUT_REPLAY)
+#error "define ES_INPUT_RECORD or ES_INPUT_REPLAY, not both"
+#endif
+
+#if defined(ES_INPUT_RECORD) || defined(ES_INPUT_REPLAY)
+#define ES_INPUT_LOG
+
+/* prototypes for public functions */
+
+void ES_Input_Init(void);
+bool ES_Input_Level(uint8_t WhichInput, bool Level);
+bool ES_Input_IsKeyReady(void);
+uint8_t ES_Input_GetKey(void);
+void ES_Input_Analog(uint32_t *pResults, uint8_t NumResults);
+
+#ifdef ES_INPUT_RECORD
+void ES_Input_StartDump(void);
+void ES_Input_DumpStep(void);
+#else
+bool ES_Input_GetNextTick(uint32_t *pTick);
+bool ES_Input_IsReplayDone(void);
+#endif
+
+#else
+// without the log, the inputs go straight through
+#define ES_Input_Level(WhichInput, Level) (Level)
+#define ES_Input_IsKeyReady() IsNewKeyReady()
+#define ES_Input_GetKey() GetNewKey()
+#define ES_Input_Analog(pResults, NumResults)
+#endif
+
+#endif /* ES_InputLog_H */
@@ -0,0 +1,40 @@
+/****************************************************************************
+ Module
+     ES_Mailbox.h
+ Description
+     header file for the interrupt to framework mailboxes of the Events &
+     Services Framework
+ Notes
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26 14:20 agt      started coding
+*****************************************************************************/
+#ifndef ES_Mailbox_H
+#define ES_Mailbox_H
+
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+// A single producer, single consumer ring of events. One ISR pushes, the
+// framework drains into the target service's queue. Head and Tail run freely
+// and are masked to index the slots, so the size must be a power of 2.
+typedef struct
+{
+  ES_Event_t        *pSlots;      // the event storage
+  uint8_t           Mask;         // number of slots - 1
+  uint8_t           WhichService; // where drained events are posted
+  volatile uint8_t  Head;         // next slot to fill, only the ISR writes it
+  volatile uint8_t  Tail;         // next slot to drain, only ES_Run writes it
+  volatile uint16_t Dropped;      // pushes lost because the mailbox was full
+}ES_Mailbox_t;
+
+/* prototypes for public functions */
+
+bool ES_Mailbox_Init(ES_Mailbox_t *pBox, ES_Event_t *pSlots, uint8_t NumSlots,
+    uint8_t WhichService);
+bool ES_Mailbox_Post(ES_Mailbox_t *pBox, ES_Event_t ThisEvent);
+void ES_Mailbox_DrainAll(void);
+
+#endif /* ES_Mailbox_H */
@@ -9,6 +9,18 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 06:00 agt     added ES_IntsOff & ES_IntsRestore
+ 10/17/26 23:40 agt     REENTRANT is PIC32 only, added _HW_Idle for
+                        the virtual time host port
+ 10/17/26 21:10 agt     added _HW_GetTickCount32 & ES_Timer_GetTime32
+ 10/17/26 20:30 agt     added _HW_ReadCoreCount & _HW_WriteCoreCompare, with a
+                        simulated core timer on a host, for tickless mode
+ 10/17/26 14:20 agt     added ES_LoadAcquire & ES_StoreRelease for the mailboxes.
+                        POST_FROM_INTS is now off, ISRs post through mailboxes
+ 10/17/26 13:05 agt     _HW_GetCoreTicks falls back to clock_gettime on a host
+ 10/17/26 12:10 agt     added _HW_GetCoreTicks for fine grained time stamps
+ 10/17/26 09:12 agt     added ES_CountLeadingZeros to expose the MIPS clz
+                        instruction to the scheduler
  10/26/17 18:39 jec     moves definition of ALL_BITS to here
  10/14/15 21:50 jec     added prototype for ES_Timer_GetTime
  01/18/15 13:24 jec     clean up and adapt to use TI driver lib functions
@@ -22,7 +34,9 @@
 #ifndef ES_PORT_H
 #define ES_PORT_H
 
-// pull in the hardware header files that we need
+// pull in the hardware header files that we need. A host build uses the
+// virtual time port in ES_HostPort.c in place of ES_Port.c, and has a host
+// version of xc.h on its include path for the modules that use the registers
 #include <xc.h>
 
 #include <stdio.h>
@@ -53,7 +67,11 @@
 // reentrant code. In order to post from an ISR, we need for ES_PostToService,
 // ES_EnqueueFIFO, and any service post function that will be called from an
 // ISR to be reentrant.
+#ifdef __XC32
 #define REENTRANT __reentrant
+#else
+#define REENTRANT
+#endif
 
 // these macros provide the wrappers for critical regions, where ints will be off
 // but the state of the interrupt enable prior to entry will be restored.
@@ -66,8 +84,11 @@ extern  uint8_t _INTCON_temp;
 // for the PIC, at this time, we can not post from within interrupts so keep 
 // this definition commented. if you ever get posting from within a int working
 // then uncomment it.
-// For the PIC32, we *can* post from interrupts
-#define POST_FROM_INTS
+// For the PIC32, we *can* post from interrupts, but it means turning all
+// interrupts off around every queue operation. ISRs should now post through
+// an ES_Mailbox instead, which needs no critical region at all. Only define
+// this if some ISR still calls a post function directly.
+//#define POST_FROM_INTS
 
 // in the MIPS architecture, interrupts are not disabled on entry to an ISR
 // the interrupt controller simply prevents interrupts from lower or the
@@ -83,6 +104,65 @@ extern  uint8_t _INTCON_temp;
 #define ExitCritical()
 #endif
 
+// turn interrupts off whether or not POST_FROM_INTS is defined, for the few
+// places that an ISR may reach directly. ES_IntsOff returns the interrupt
+// state for ES_IntsRestore, so unlike EnterCritical these can be nested and
+// used in an ISR. A host build has no interrupts to turn off
+#ifdef __XC32
+#define ES_IntsOff() __builtin_disable_interrupts()
+#define ES_IntsRestore(State) \
+  do { if ((State) & _CP0_STATUS_IE_MASK) { __builtin_enable_interrupts(); } } \
+  while (0)
+#else
+#define ES_IntsOff() (0U)
+#define ES_IntsRestore(State) ((void)(State))
+#endif
+
+// read and publish an index shared between an ISR and the main loop. The
+// acquire/release ordering keeps the data accesses on the correct side of the
+// index access, for the compiler on the PIC32 and for the CPU on a host
+#define ES_LoadAcquire(pIndex) __atomic_load_n((pIndex), __ATOMIC_ACQUIRE)
+#define ES_StoreRelease(pIndex, NewValue) \
+  __atomic_store_n((pIndex), (NewValue), __ATOMIC_RELEASE)
+
+// count the leading zeros in a 32 bit value. On the M4K core XC32 turns
+// __builtin_clz into the single cycle clz instruction, on a host compiler it
+// becomes whatever the host provides. The result for an argument of 0 is
+// undefined, so the caller must test for that first.
+#define ES_CountLeadingZeros(x) ((uint8_t)__builtin_clz((uint32_t)(x)))
+
+// read the free running core timer for fine grained time stamps. It counts
+// at 20MHz (half the 40MHz system clock) and wraps every 214 seconds, so only
+// differences between two readings are meaningful.
+#define ES_CORE_TICKS_PER_US 20
+#ifdef __XC32
+#define _HW_GetCoreTicks() ((uint32_t)_CP0_GET_COUNT())
+#else
+// a host build has no core timer, so scale the monotonic clock to match
+#include <time.h>
+static inline uint32_t _HW_GetCoreTicks(void)
+{
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return (uint32_t)((uint64_t)Now.tv_sec * (ES_CORE_TICKS_PER_US * 1000000UL) +
+         (uint64_t)Now.tv_nsec / (1000 / ES_CORE_TICKS_PER_US));
+}
+#endif
+
+// the core timer count and compare registers as the tickless time base (see
+// ES_Tickless.c) uses them. A host build has a simulated pair instead, which
+// a test moves along by hand so that timer expiry can be checked exactly
+#ifdef __XC32
+#define _HW_ReadCoreCount() ((uint32_t)_CP0_GET_COUNT())
+#define _HW_WriteCoreCompare(NewCompare) _CP0_SET_COMPARE(NewCompare)
+#else
+extern volatile uint32_t ES_SimCoreCount;
+extern volatile uint32_t ES_SimCoreCompare;
+#define _HW_ReadCoreCount() (ES_SimCoreCount)
+#define _HW_WriteCoreCompare(NewCompare) (ES_SimCoreCompare = (NewCompare))
+#endif
+
 /* Rate constants for programming the SysTick Period to generate tick interrupts.
    These assume that we are using the M4K core timer running at 20MHz. Even
    thought the processor clock is 40MHz the core timer increments every other 
@@ -117,10 +197,22 @@ void _HW_PIC32Init(void);
 void _HW_Timer_Init(const TimerRate_t Rate);
 bool _HW_Process_Pending_Ints(void);
 uint16_t _HW_GetTickCount(void);
+uint32_t _HW_GetTickCount32(void);
 void _HW_ConsoleInit(void);
 void _HW_SysTickIntHandler(void);
 
-// and the one Framework function that we define here
+// ES_Run calls _HW_Idle when every queue is empty and no event checker found
+// anything. There is nothing to do on the PIC32, where the tick interrupt
+// keeps time. The host port moves its virtual clock on to the next timer
+// deadline or scripted key here
+#ifdef __XC32
+#define _HW_Idle()
+#else
+void _HW_Idle(void);
+#endif
+
+// and the Framework functions that we define here
 uint16_t ES_Timer_GetTime(void);
+uint32_t ES_Timer_GetTime32(void);
 
 #endif
@@ -0,0 +1,34 @@
+/****************************************************************************
+ Module
+     ES_Profiler.h
+ Description
+     header file for the run function and event checker profiler of the
+     Events & Services Framework
+ Notes
+     everything here is only present when ES_PROFILER is defined in
+     ES_Configure.h
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26 13:05 agt      started coding
+*****************************************************************************/
+#ifndef ES_Profiler_H
+#define ES_Profiler_H
+
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+// the histogram has one bin per power of 2 core ticks, the last bin also
+// counts everything longer
+#define ES_PROFILE_NUM_BINS 16
+
+/* prototypes for public functions */
+
+void ES_Profile_RecordRun(uint8_t WhichService, ES_EventType_t WhichEvent,
+    uint32_t Ticks);
+void ES_Profile_RecordCheck(uint8_t WhichChecker, uint32_t Ticks);
+void ES_Profile_Reset(void);
+void ES_Profile_StartDump(void);
+void ES_Profile_DumpStep(void);
+
+#endif /* ES_Profiler_H */
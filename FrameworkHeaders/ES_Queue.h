@@ -9,6 +9,10 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 18:45 agt      now wraps a ring queue, the policies moved to
+                         ES_RingQueue.h, added ES_GetBlockRing
+ 10/17/26 17:30 agt      added the overflow policies
+ 10/17/26 16:40 agt      added ES_QueueSpace
  08/05/13 15:19 jec      modifications to suit new portable type definitions
  01/15/12 09:36 jec      converted to use new types from ES_Types.h
  10/17/11 07:49 jec      new header to match the rest of the framework
@@ -19,15 +23,22 @@
 
 #include "ES_Types.h"
 #include "ES_Events.h"
+#include "ES_RingQueue.h"
 
 /* prototypes for public functions */
 
 uint8_t ES_InitQueue(ES_Event_t *pBlock, uint8_t BlockSize);
 bool ES_EnQueueFIFO(ES_Event_t *pBlock, ES_Event_t Event2Add);
+ES_EnQueueResult_t ES_EnQueueFIFOWithPolicy(ES_Event_t *pBlock,
+    ES_Event_t Event2Add);
+bool ES_CanEnQueueFIFO(ES_Event_t *pBlock, ES_Event_t Event2Add);
+void ES_SetQueuePolicy(ES_Event_t *pBlock, ES_QueuePolicy_t NewPolicy);
 bool ES_EnQueueLIFO(ES_Event_t *pBlock, ES_Event_t Event2Add);
 uint8_t ES_DeQueue(ES_Event_t *pBlock, ES_Event_t *pReturnEvent);
 //void EF_FlushQueue( unsigned char * pBlock );
 bool ES_IsQueueEmpty(ES_Event_t *pBlock);
+uint8_t ES_QueueSpace(ES_Event_t *pBlock);
+ES_RingQueue_t *ES_GetBlockRing(ES_Event_t *pBlock);
 
 #endif /*ES_Queue_H */
 
@@ -0,0 +1,96 @@
+/****************************************************************************
+ Module
+     ES_RingQueue.h
+ Description
+     header file for the power of 2 ring buffer queues of the Events &
+     Services Framework
+ Notes
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 05:10 agt      added ES_DeQueueBulkLIFO
+ 10/17/26 18:45 agt      started coding
+*****************************************************************************/
+#ifndef ES_RingQueue_H
+#define ES_RingQueue_H
+
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+// what a FIFO post does about a full queue or an event that is already
+// waiting. The policies can be combined, e.g.
+// ES_QUEUE_COALESCE | ES_QUEUE_DROP_OLDEST
+typedef uint8_t ES_QueuePolicy_t;
+#define ES_QUEUE_REJECT_NEW   0x00  // a full queue refuses the new event
+#define ES_QUEUE_DROP_OLDEST  0x01  // a full queue drops its oldest event
+#define ES_QUEUE_COALESCE     0x02  // an event already waiting, with the same
+                                    // type and param, is not added again
+
+// what happened to an event posted with ES_Ring_EnQueueFIFO
+typedef enum
+{
+  ES_ENQUEUE_ADDED,         // it is at the end of the queue
+  ES_ENQUEUE_COALESCED,     // an identical event was already waiting
+  ES_ENQUEUE_DROPPED_OLDEST,// it is at the end, the oldest event was lost
+  ES_ENQUEUE_REJECTED       // the queue was full, it was not added
+}ES_EnQueueResult_t;
+
+// A FIFO of events kept apart from its storage. Head and Tail run freely and
+// are masked to index the storage, so the capacity must be a power of 2, and
+// Head - Tail is always the number of events waiting.
+typedef struct
+{
+  ES_Event_t        *pEvents; // the storage, Mask + 1 events
+  uint16_t          Mask;     // capacity - 1
+  uint16_t          Head;     // count of events put in
+  uint16_t          Tail;     // count of events taken out
+  ES_QueuePolicy_t  Policy;   // what ES_Ring_EnQueueFIFO does when full
+}ES_RingQueue_t;
+
+// the largest capacity that the 16 bit counts can handle
+#define ES_RING_MAX_CAPACITY 32768U
+
+// the smallest power of 2 that holds n events, for sizing ring storage at
+// compile time, e.g. static ES_Event_t Storage[ES_RING_SIZE(5)];
+#define ES_RING_SIZE(n) \
+  ((n) <= 1 ? 1 : (n) <= 2 ? 2 : (n) <= 4 ? 4 : (n) <= 8 ? 8 :           \
+   (n) <= 16 ? 16 : (n) <= 32 ? 32 : (n) <= 64 ? 64 : (n) <= 128 ? 128 : \
+   (n) <= 256 ? 256 : (n) <= 512 ? 512 : (n) <= 1024 ? 1024 : 0)
+
+/* prototypes for public functions */
+
+bool ES_Ring_Init(ES_RingQueue_t *pRing, ES_Event_t *pStorage,
+    uint16_t Capacity);
+void ES_Ring_SetPolicy(ES_RingQueue_t *pRing, ES_QueuePolicy_t NewPolicy);
+ES_EnQueueResult_t ES_Ring_EnQueueFIFO(ES_RingQueue_t *pRing,
+    ES_Event_t Event2Add);
+bool ES_Ring_EnQueueLIFO(ES_RingQueue_t *pRing, ES_Event_t Event2Add);
+uint16_t ES_Ring_DeQueue(ES_RingQueue_t *pRing, ES_Event_t *pReturnEvent);
+bool ES_Ring_CanEnQueueFIFO(ES_RingQueue_t *pRing, ES_Event_t Event2Add);
+uint16_t ES_EnQueueBulk(ES_RingQueue_t *pRing, const ES_Event_t *pEvents,
+    uint16_t NumEvents);
+uint16_t ES_EnQueueBulkLIFO(ES_RingQueue_t *pRing, const ES_Event_t *pEvents,
+    uint16_t NumEvents);
+uint16_t ES_DeQueueBulk(ES_RingQueue_t *pRing, ES_Event_t *pEvents,
+    uint16_t MaxEvents);
+uint16_t ES_DeQueueBulkLIFO(ES_RingQueue_t *pRing, ES_Event_t *pEvents,
+    uint16_t MaxEvents);
+
+// these are called for every dispatch, so they are inline
+static inline uint16_t ES_Ring_Count(const ES_RingQueue_t *pRing)
+{
+  return (uint16_t)(pRing->Head - pRing->Tail);
+}
+
+static inline uint16_t ES_Ring_Space(const ES_RingQueue_t *pRing)
+{
+  return (uint16_t)(pRing->Mask + 1 - ES_Ring_Count(pRing));
+}
+
+static inline bool ES_Ring_IsEmpty(const ES_RingQueue_t *pRing)
+{
+  return pRing->Head == pRing->Tail;
+}
+
+#endif /* ES_RingQueue_H */
@@ -0,0 +1,39 @@
+/****************************************************************************
+ Module
+     ES_ShortTimer.h
+ Description
+     header file for the short (microsecond) timers of the Events & Services
+     Framework
+ Notes
+     ES_NUM_SHORT_TIMERS in ES_Configure.h sets the number of short timers.
+     They all share Timer4/5 of the PIC32
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26 23:10 agt      ported to the PIC32, any number of short timers
+ 10/11/15 10:30 jec      first pass
+*****************************************************************************/
+#ifndef ES_ShortTimer_H
+#define ES_ShortTimer_H
+
+#include "ES_Types.h"
+
+// the two short timers of the original Tiva version
+#define SHORT_TIMER_A 0
+#define SHORT_TIMER_B 1
+
+// a service number for a short timer that is not used
+#define SHORT_TIMER_UNUSED 0xFF
+
+// the longest short timeout, in microseconds. Anything longer should use
+// the ES_Timer functions
+#define ES_SHORT_TIMER_MAX_US 1000000UL
+
+/* prototypes for public functions */
+
+void ES_ShortTimerInit(uint8_t TimeAPrio, uint8_t TimeBPrio);
+bool ES_ShortTimerSetService(uint8_t Which, uint8_t WhichService);
+bool ES_ShortTimerStart(uint8_t Which, uint32_t TimeoutValue);
+void ES_ShortTimerStop(uint8_t Which);
+
+#endif /* ES_ShortTimer_H */
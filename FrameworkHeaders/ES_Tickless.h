@@ -0,0 +1,32 @@
+/****************************************************************************
+ Module
+     ES_Tickless.h
+ Description
+     header file for the tickless time base of the Events & Services
+     Framework
+ Notes
+     only used when ES_TICKLESS is defined in ES_Configure.h
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 07:00 agt      added ES_TICKLESS_MAX_WAIT for the interrupt response
+ 10/17/26 20:30 agt      started coding
+*****************************************************************************/
+#ifndef ES_Tickless_H
+#define ES_Tickless_H
+
+#include "ES_Types.h"
+
+// the longest wait that the compare is set for, well inside the 2^31 core
+// ticks that a signed difference of two counts can cover
+#define ES_TICKLESS_MAX_WAIT 0x40000000UL
+
+/* prototypes for public functions */
+
+void ES_Tickless_Init(uint32_t CoreTicksPerTick);
+void ES_Tickless_Service(void);
+void ES_Tickless_CatchUp(void);
+void ES_Tickless_Reschedule(void);
+uint32_t ES_Tickless_GetTickCount(void);
+
+#endif /* ES_Tickless_H */
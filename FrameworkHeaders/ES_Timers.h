@@ -14,6 +14,16 @@
  History
  When           Who	What/Why
  -------------- ---	--------
+ 10/18/26 07:40 agt  ES_Timer_TimeoutHandled takes the service that handled
+                     the timeout
+ 10/17/26 22:30 agt  added timer handles: ES_Timer_Alloc, ES_Timer_AllocCallback
+                     and ES_Timer_Free
+ 10/17/26 21:45 agt  added ES_Timer_InitPeriodic, ES_Timer_GetOverruns and
+                     ES_Timer_TimeoutHandled
+ 10/17/26 21:10 agt  timer durations are 32 bits, added ES_TIMER_MAX_TIME and
+                     ES_Timer_GetTime32
+ 10/17/26 20:30 agt  added ES_Timer_GetTicksToNext prototype
+ 10/17/26 19:40 agt  added ES_Timer_MultiTick_Resp & ES_Timer_SetPostFunc
  10/13/15 20:48 jec  removed prototype for IsTimerActive, I had removed the code
                      a couple of years ago
  08/13/13 12:03 jec  added prototype for ES_Timer_Tick_Resp as part of
@@ -33,6 +43,7 @@
 
 #include "ES_Port.h"
 #include "ES_Types.h"
+#include "ES_PostList.h"
 
 typedef enum
 {
@@ -42,13 +53,40 @@ typedef enum
   ES_Timer_NOT_ACTIVE = 0
 }ES_TimerReturn_t;
 
+// the longest time that a timer can be set for, in ticks. Expiry times are
+// compared as signed differences, so this is half the range of the 32 bit
+// time base, about 24 days with 1mS ticks
+#define ES_TIMER_MAX_TIME 0x7FFFFFFFUL
+
+// a timer handed out at run time. It is a timer number, so it works with
+// all of the ES_Timer functions that take one
+typedef uint8_t ES_TimerHandle_t;
+#define ES_TIMER_NO_HANDLE 0xFF
+
+// a function that a timer handle calls from the tick response instead of
+// posting an event
+typedef void TimerCallback_t (ES_EventParam_t Param);
+typedef TimerCallback_t (*pTimerCallback);
+
 void ES_Timer_Init(TimerRate_t Rate);
 void ES_Timer_Tick_Resp(void);
-ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint16_t NewTime);
-ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime);
+void ES_Timer_MultiTick_Resp(uint16_t NumTicks);
+ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime);
+ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime);
 ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num);
 ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num);
+ES_TimerReturn_t ES_Timer_InitPeriodic(uint8_t Num, uint32_t Period);
+uint16_t ES_Timer_GetOverruns(uint8_t Num);
+void ES_Timer_TimeoutHandled(uint8_t Num, uint8_t WhichService);
+ES_TimerReturn_t ES_Timer_SetPostFunc(uint8_t Num, pPostFunc PostFunc);
+ES_TimerHandle_t ES_Timer_Alloc(pPostFunc PostFunc, ES_EventType_t EventType,
+    ES_EventParam_t EventParam);
+ES_TimerHandle_t ES_Timer_AllocCallback(pTimerCallback Callback,
+    ES_EventParam_t Param);
+ES_TimerReturn_t ES_Timer_Free(ES_TimerHandle_t Handle);
+bool ES_Timer_GetTicksToNext(uint32_t *pTicks);
 uint16_t ES_Timer_GetTime(void);
+uint32_t ES_Timer_GetTime32(void);
 
 #endif   /* ES_Timers_H */
 /*------------------------------ End of file ------------------------------*/
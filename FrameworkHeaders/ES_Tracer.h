@@ -0,0 +1,134 @@
+/****************************************************************************
+ Module
+     ES_Tracer.h
+ Description
+     header file for the event tracer of the Events & Services Framework
+ Notes
+     The hooks in the framework use the ES_TRACE_xxx macros, which compile to
+     nothing unless ES_TRACER is defined in ES_Configure.h.
+     Every record says what was running when it was made (From):
+       0x00 - 0x3F  the run function of that service
+       0x40 - 0x7F  event checker (From - 0x40) in EVENT_CHECK_LIST
+       0x80 - 0xFD  the response to timer (From - 0x80) running out
+       0xFE         ES_Mailbox_DrainAll, passing on posts made by an ISR
+       0xFF         anything else: the main loop, an init function or an ISR
+                    posting directly
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:00 agt      ES_Trace_Record turns interrupts off itself, as
+                         EnterCritical does nothing without POST_FROM_INTS
+ 10/18/26 00:30 agt      started coding
+*****************************************************************************/
+#ifndef ES_Tracer_H
+#define ES_Tracer_H
+
+#include "ES_Configure.h"
+#include "ES_Types.h"
+#include "ES_Events.h"
+#include "ES_Port.h"
+
+// what a record is about
+typedef enum
+{
+  ES_TRACE_POST = 0,    // Who is the service whose queue got the event
+  ES_TRACE_POST_LIFO,   //   the same, at the front of the queue
+  ES_TRACE_POST_DROP,   //   the same, pushing out the oldest event
+  ES_TRACE_COALESCED,   //   an identical event was already waiting
+  ES_TRACE_REFUSED,     //   the queue was full, the event was lost
+  ES_TRACE_CONTINUE,    //   ES_ContinueService for the service
+  ES_TRACE_RUN_START,   // the run function of service Who was called
+  ES_TRACE_RUN_END,     //   and returned
+  ES_TRACE_TIMEOUT,     // timer Who ran out, with the event it will post
+  ES_TRACE_CHECKER      // event checker Who found an event
+} ES_TraceKind_t;
+
+// what was running when a record was made
+#define ES_TRACE_FROM_CHECKER 0x40
+#define ES_TRACE_FROM_TIMER   0x80
+#define ES_TRACE_FROM_ISR     0xFE
+#define ES_TRACE_FROM_MAIN    0xFF
+
+typedef struct
+{
+  uint32_t  Time;   // core timer count
+  uint32_t  Param;
+  uint16_t  Type;
+  uint8_t   Kind;   // an ES_TraceKind_t
+  uint8_t   Who;
+  uint8_t   From;
+}ES_TraceRecord_t;
+
+#ifdef ES_TRACER
+
+#if (ES_TRACE_RING_SIZE & (ES_TRACE_RING_SIZE - 1)) != 0
+#error "ES_TRACE_RING_SIZE must be a power of 2"
+#endif
+#if ES_NUM_TIMERS > (ES_TRACE_FROM_ISR - ES_TRACE_FROM_TIMER)
+#error "the tracer can't tell that many timers apart"
+#endif
+
+// these are only here so that ES_Trace_Record can be inlined
+extern ES_TraceRecord_t ES_TraceRing[ES_TRACE_RING_SIZE];
+extern uint32_t         ES_TraceCount;
+extern uint8_t          ES_TraceFrom;
+extern bool             ES_TraceIsFrozen;
+
+/****************************************************************************
+ Function
+   ES_Trace_Record
+ Parameters
+   uint8_t : an ES_TraceKind_t
+   uint8_t : the service, timer or checker that the record is about
+   uint16_t, uint32_t : the type and param of the event involved
+ Returns
+   nothing
+ Description
+   time stamps the record and puts it in the ring, over the oldest one
+ Notes
+   interrupts are off while the slot is claimed and filled, whether or not
+   POST_FROM_INTS is defined, so an ISR that traces can't leave a record
+   half written
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static inline void ES_Trace_Record(uint8_t Kind, uint8_t Who, uint16_t Type,
+    uint32_t Param)
+{
+  ES_TraceRecord_t *pRecord;
+  uint32_t         IntState;
+
+  if (ES_TraceIsFrozen)
+  {
+    return;
+  }
+  IntState = ES_IntsOff();
+  pRecord = &ES_TraceRing[ES_TraceCount++ & (ES_TRACE_RING_SIZE - 1)];
+  pRecord->Time   = _HW_GetCoreTicks();
+  pRecord->Param  = Param;
+  pRecord->Type   = Type;
+  pRecord->Kind   = Kind;
+  pRecord->Who    = Who;
+  pRecord->From   = ES_TraceFrom;
+  ES_IntsRestore(IntState);
+}
+
+#define ES_TRACE_EVENT(Kind, Who, ThisEvent) \
+  ES_Trace_Record((Kind), (Who), (ThisEvent).EventType, (ThisEvent).EventParam)
+#define ES_TRACE_MARK(Kind, Who) ES_Trace_Record((Kind), (Who), ES_NO_EVENT, 0)
+#define ES_TRACE_SET_FROM(NewFrom) (ES_TraceFrom = (uint8_t)(NewFrom))
+
+/* prototypes for public functions */
+
+void ES_Trace_Reset(void);
+void ES_Trace_StartDump(void);
+void ES_Trace_DumpStep(void);
+
+#else
+// without the tracer, the hooks compile to nothing
+#define ES_TRACE_EVENT(Kind, Who, ThisEvent)
+#define ES_TRACE_MARK(Kind, Who)
+#define ES_TRACE_SET_FROM(NewFrom)
+#endif /* ES_TRACER */
+
+#endif /* ES_Tracer_H */
@@ -22,17 +22,23 @@ extern "C" {
 #define XMIT_BUFFER_SIZE 1024
     
 // map the generic functions for testing the serial port to actual functions
-// for this platform.
+// for this platform. The host port reads stdin instead of UART1
+#ifdef __XC32
 #define IsNewKeyReady() (U1STAbits.URXDA)
+#define kbhit() (U1STAbits.URXDA)
+#else
+#define IsNewKeyReady() (Terminal_IsRxData())
+#define kbhit() (Terminal_IsRxData())
+#endif
 #define GetNewKey Terminal_ReadByte
 //#define putch Terminal_WriteByte
-#define kbhit() (U1STAbits.URXDA)
     
 void Terminal_HWInit(void);
 uint8_t Terminal_ReadByte(void);
 void Terminal_WriteByte(uint8_t txByte);
 bool Terminal_IsRxData(void);
 void Terminal_MoveBuffer2UART( void );
+uint16_t Terminal_GetXmitSpace( void );
 
 #ifdef __XC16__  // DEPRICATED, USE FOR xc16 of xc32 v1.34 or lower
 int write(int handle, void *buffer, unsigned int len);
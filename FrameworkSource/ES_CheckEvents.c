@@ -8,6 +8,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 00:30 agt     traces checker hits when ES_TRACER is defined
+ 10/17/26 13:05 agt     times each checker call when ES_PROFILER is defined
                 jec     out all user modifications into ES_Configure
  10/16/11 12:32 jec      started coding
 *****************************************************************************/
@@ -16,6 +18,11 @@
 #include "ES_Events.h"
 #include "ES_General.h"
 #include "ES_CheckEvents.h"
+#ifdef ES_PROFILER
+#include "ES_Port.h"
+#include "ES_Profiler.h"
+#endif
+#include "ES_Tracer.h"
 
 // Include the header files for the module(s) with your event checkers.
 // This gets you the prototypes for the event checking functions.
@@ -47,11 +54,25 @@ static CheckFunc *const ES_EventList[] = {
 bool ES_CheckUserEvents(void)
 {
   uint8_t i;
+  bool    FoundEvent;
+#ifdef ES_PROFILER
+  uint32_t ProfileStart;
+#endif
   // loop through the array executing the event checking functions
   for (i = 0; i < ARRAY_SIZE(ES_EventList); i++)
   {
-    if (ES_EventList[i]() == true)
+    ES_TRACE_SET_FROM(ES_TRACE_FROM_CHECKER + i);
+#ifdef ES_PROFILER
+    ProfileStart = _HW_GetCoreTicks();
+#endif
+    FoundEvent = ES_EventList[i]();
+#ifdef ES_PROFILER
+    ES_Profile_RecordCheck(i, _HW_GetCoreTicks() - ProfileStart);
+#endif
+    ES_TRACE_SET_FROM(ES_TRACE_FROM_MAIN);
+    if (FoundEvent == true)
     {
+      ES_TRACE_MARK(ES_TRACE_CHECKER, i);
       break; // found a new event, so process it first
     }
   }
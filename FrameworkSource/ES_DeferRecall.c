@@ -11,7 +11,11 @@
  History
  When           Who     What/Why
  -------------- ---     --------
-
+ 10/18/26 05:10 agt     events are deferred FIFO and recalled newest run first,
+                        so the order they come back in no longer rests on
+                        two LIFOs cancelling, added a test of it
+ 10/17/26 18:45 agt     RecallEvents moves the deferred events in runs with
+                        the bulk ring queue functions
  10/11/14 14:58 jec     converted RecallEvent to RecallEvents to pull all
                         deferred events off the deferral queue
  11/02/13 16:38 jec      Began Coding
@@ -23,10 +27,13 @@
 #include "ES_General.h"
 #include "ES_Events.h"
 #include "ES_DeferRecall.h"
+#include <stddef.h>
 
 /*--------------------------- External Variables --------------------------*/
 
 /*----------------------------- Module Defines ----------------------------*/
+// how many deferred events are moved at a time
+#define RECALL_CHUNK_SIZE 8
 
 /*------------------------------ Module Types -----------------------------*/
 
@@ -49,27 +56,105 @@
      something in the queue, then it posts it LIFO fashion to the queue
      indicated by WhichService
  Notes
-     None.
+     the events come back out in the order that they were deferred, ahead
+     of anything else that was waiting. They are taken RECALL_CHUNK_SIZE at a
+     time from the newest end of the deferral queue and each run is slid in
+     at the front of the service's queue, in order, so each older run goes in
+     ahead of the newer ones. Events that don't fit are lost, the oldest
+     first, as before.
  Author
      J. Edward Carryer, 11/20/13 16:49
 ****************************************************************************/
 bool ES_RecallEvents(uint8_t WhichService, ES_Event_t *pBlock)
 {
-  ES_Event_t  RecalledEvent;
-  bool      WereEventsPulled = false;
-  // recall any events from the queue
+  ES_Event_t      RecalledEvents[RECALL_CHUNK_SIZE];
+  ES_RingQueue_t  *pDeferred;
+  uint16_t        NumRecalled;
+  bool            WereEventsPulled = false;
+
+  pDeferred = ES_GetBlockRing(pBlock);
+  if (pDeferred == NULL)
+  {
+    return false;
+  }
+  // recall any events from the queue, newest run first
   do
   {
-    ES_DeQueue(pBlock, &RecalledEvent);
-    if (RecalledEvent.EventType != ES_NO_EVENT)
+    NumRecalled = ES_DeQueueBulkLIFO(pDeferred, RecalledEvents,
+        ARRAY_SIZE(RecalledEvents));
+    if (NumRecalled != 0)
     {
-      ES_PostToServiceLIFO(WhichService, RecalledEvent);
+      ES_PostToServiceLIFOBulk(WhichService, RecalledEvents, NumRecalled);
       WereEventsPulled = true;
     }
-  } while (RecalledEvent.EventType != ES_NO_EVENT);
+  } while (NumRecalled == ARRAY_SIZE(RecalledEvents));
   return WereEventsPulled;
 }
 
+#ifdef TEST
+// Defers events around a run that already waits in the service's queue and
+// checks that they are recalled in the order that they were deferred, ahead
+// of it, with more than one run of RECALL_CHUNK_SIZE to move.
+// ES_PostToServiceLIFOBulk is stood in for by a ring of the test's own.
+// Build on the host with something like
+//   gcc -DTEST -I FrameworkHeaders FrameworkSource/ES_DeferRecall.c
+//     FrameworkSource/ES_Queue.c FrameworkSource/ES_RingQueue.c dbprintf.o
+
+#include "dbprintf.h"
+
+// more than two runs of RECALL_CHUNK_SIZE
+#define NUM_DEFERRED (2 * RECALL_CHUNK_SIZE + 3)
+// events waiting in the service's queue when they are recalled
+#define NUM_WAITING 3
+
+static ES_Event_t     DeferralQueue[32 + 1];
+static ES_Event_t     ServiceEvents[32];
+static ES_RingQueue_t ServiceRing;
+
+// stands in for the framework, posting to ServiceRing
+uint16_t ES_PostToServiceLIFOBulk(uint8_t WhichService,
+    const ES_Event_t *pEvents, uint16_t NumEvents)
+{
+  return ES_EnQueueBulkLIFO(&ServiceRing, pEvents, NumEvents);
+}
+
+void main(void)
+{
+  ES_Event_t  ThisEvent = { 1, 0 };
+  bool        Passed;
+  uint16_t    i;
+
+  ES_InitDeferralQueueWith(DeferralQueue, ARRAY_SIZE(DeferralQueue));
+  ES_Ring_Init(&ServiceRing, ServiceEvents, ARRAY_SIZE(ServiceEvents));
+  for (i = 0; i < NUM_WAITING; i++)
+  {
+    ThisEvent.EventParam = 100 + i;
+    ES_Ring_EnQueueFIFO(&ServiceRing, ThisEvent);
+  }
+  for (i = 0; i < NUM_DEFERRED; i++)
+  {
+    ThisEvent.EventParam = i;
+    ES_DeferEvent(DeferralQueue, ThisEvent);
+  }
+  Passed = ES_RecallEvents(0, DeferralQueue) &&
+      ES_IsQueueEmpty(DeferralQueue) && !ES_RecallEvents(0, DeferralQueue) &&
+      (ES_Ring_Count(&ServiceRing) == NUM_DEFERRED + NUM_WAITING);
+  for (i = 0; i < NUM_DEFERRED + NUM_WAITING; i++)
+  {
+    ES_Ring_DeQueue(&ServiceRing, &ThisEvent);
+    Passed &= (ThisEvent.EventParam ==
+        ((i < NUM_DEFERRED) ? i : 100 + i - NUM_DEFERRED));
+  }
+  DB_printf("defer and recall order %s\r\n", Passed ? "passed" : "FAILED");
+#ifdef __XC32
+  while (1)
+  {
+    ;
+  }
+#endif
+}
+
+#endif
 /*------------------------------- Footnotes -------------------------------*/
 
 /*------------------------------ End of file ------------------------------*/
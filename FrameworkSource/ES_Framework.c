@@ -8,6 +8,40 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 07:40 agt     ES_Run only lets the timer that posted an ES_TIMEOUT
+                        know that it was handled, added ES_TakeTimeoutTarget
+ 10/18/26 07:20 agt     the telemetry only turns interrupts off when ISRs may
+                        post directly, with ES_IntsOff
+ 10/18/26 07:10 agt     ES_PostAll collects its targets itself, and a post
+                        list collects them with interrupts off when ISRs
+                        may post directly
+ 10/18/26 05:10 agt     ES_PostToServiceLIFOBulk keeps the order of the run
+ 10/18/26 01:20 agt     ES_Initialize starts the input log, ES_Run drives its
+                        dump
+ 10/18/26 00:30 agt     posts, dispatches and continuations are traced when
+                        ES_TRACER is defined, and ES_Run drives the trace dump
+ 10/17/26 23:40 agt     ES_Run calls _HW_Idle when there is nothing to do
+ 10/17/26 21:45 agt     ES_Run tells the timer module as each ES_TIMEOUT is
+                        dispatched, for the periodic timer overrun counts
+ 10/17/26 18:45 agt     the service queues are power of 2 ring queues, added
+                        ES_PostToServiceLIFOBulk for recalling deferred events
+ 10/17/26 17:30 agt     added the per-service queue overflow policies and
+                        ES_ContinueService
+ 10/17/26 16:40 agt     broadcasts are all-or-nothing: every target queue is
+                        checked for room before any of them gets the event
+ 10/17/26 15:55 agt     broadcasts (ES_PostAll and the distribution lists)
+                        skip services that have not subscribed to the event
+ 10/17/26 13:05 agt     ES_Run times each run function call for the profiler
+                        and drives the profile dump when idle
+ 10/17/26 12:10 agt     added optional queue telemetry: high-water marks,
+                        overflow counts and post to dispatch wait times
+ 10/17/26 11:02 agt     ES_Run now dispatches up to a per-service budget of
+                        events from the chosen queue before re-scanning.
+                        Added ES_SetBatchBudget.
+ 10/17/26 09:35 agt     replaced the 16 bit Ready variable with a two level
+                        bitmap searched with count-leading-zeros so that
+                        picking the next service is constant time. Added
+                        entries to expand number of possible services to 64
  08/21/17 13:18 jec     added conditional call to initialize the port lines
                         for the hardware debugging of the framework/apps
  12/19/16 20:18 jec      changed includes to accomodate the change to a fixed
@@ -42,6 +76,9 @@
 #include "EventCheckWrapper.h"
 
 #include "ES_Port.h"          // needed for definition of REENTRANT
+#ifdef ES_QUEUE_TELEMETRY
+#include "dbprintf.h"
+#endif
 
 #include <stdio.h>
 
@@ -67,11 +104,75 @@ typedef struct
 typedef struct
 {
   ES_Event_t *pMem;       // pointer to the memory
-  uint8_t Size;         // how big is it
+  uint16_t Size;        // how big is it, a power of 2
 }ES_QueueDesc_t;
 
+// the batch budget for services that do not define SERV_n_BATCH_SIZE. One
+// event per pass is the classic run-to-completion behavior
+#define ES_DEFAULT_BATCH_SIZE 1
+
+// the services are split into groups of 32, one word of ReadyTable each
+#define SERVICES_PER_GROUP 32
+#define GROUP_SHIFT 5
+#define SERVICE_IN_GROUP_MASK 0x1F
+#define NUM_READY_GROUPS \
+  ((MAX_NUM_SERVICES + SERVICES_PER_GROUP - 1) / SERVICES_PER_GROUP)
+
+#ifdef ES_QUEUE_TELEMETRY
+// the post time of each event waiting in a queue, kept in step with the queue
+typedef struct
+{
+  uint32_t  *pStamps; // one time stamp per queue entry
+  uint8_t   Size;     // how big is it
+  uint8_t   Oldest;   // index of the stamp for the next event to come out
+  uint8_t   NumStamps;
+}StampRing_t;
+
+// only an ISR that posts directly (POST_FROM_INTS) reaches the telemetry
+// from outside the main loop, so only then are interrupts turned off around
+// it. ES_IntsOff nests, as a post from an ISR may already have them off
+#ifdef POST_FROM_INTS
+#define StatsIntsOff() ES_IntsOff()
+#define StatsIntsRestore(State) ES_IntsRestore(State)
+#else
+#define StatsIntsOff() (0U)
+#define StatsIntsRestore(State) ((void)(State))
+#endif
+#endif
+
+#if MAX_NUM_SERVICES > 64
+#error "MAX_NUM_SERVICES can be no larger than 64"
+#endif
+#if NUM_SERVICES > MAX_NUM_SERVICES
+#error "NUM_SERVICES is larger than MAX_NUM_SERVICES"
+#endif
+
 /*---------------------------- Module Functions ---------------------------*/
 //static bool CheckSystemEvents( void );
+static inline void SetReady(uint8_t WhichService);
+static inline void ClearReady(uint8_t WhichService);
+static inline uint8_t GetHighestReady(void);
+static inline bool IsSubscribed(uint8_t WhichService, uint16_t EventType);
+static void AddBroadcastTarget(uint8_t WhichService, ES_Event_t TheEvent);
+static bool DeliverBroadcast(void);
+static bool PostFIFO(uint8_t WhichService, ES_Event_t TheEvent);
+static inline bool IsReady(uint8_t WhichService);
+#ifdef ES_QUEUE_TELEMETRY
+static void RecordPost(uint8_t WhichService, bool AtFront);
+static void RecordOverflow(uint8_t WhichService);
+static void RecordDispatch(uint8_t WhichService);
+static void RecordDrop(uint8_t WhichService);
+#define RecordSkip() (SkippedBroadcasts++)
+#define RecordRefusal() (RefusedBroadcasts++)
+#else
+// without telemetry, the hooks compile to nothing
+#define RecordPost(WhichService, AtFront)
+#define RecordOverflow(WhichService)
+#define RecordDispatch(WhichService)
+#define RecordDrop(WhichService)
+#define RecordSkip()
+#define RecordRefusal()
+#endif
 
 /*---------------------------- Module Variables ---------------------------*/
 /****************************************************************************/
@@ -128,56 +229,344 @@ static ES_ServDesc_t const ServDescList[] =
 #if NUM_SERVICES > 15
   , { SERV_15_INIT, SERV_15_RUN }
 #endif
+#if NUM_SERVICES > 16
+  , { SERV_16_INIT, SERV_16_RUN }
+#endif
+#if NUM_SERVICES > 17
+  , { SERV_17_INIT, SERV_17_RUN }
+#endif
+#if NUM_SERVICES > 18
+  , { SERV_18_INIT, SERV_18_RUN }
+#endif
+#if NUM_SERVICES > 19
+  , { SERV_19_INIT, SERV_19_RUN }
+#endif
+#if NUM_SERVICES > 20
+  , { SERV_20_INIT, SERV_20_RUN }
+#endif
+#if NUM_SERVICES > 21
+  , { SERV_21_INIT, SERV_21_RUN }
+#endif
+#if NUM_SERVICES > 22
+  , { SERV_22_INIT, SERV_22_RUN }
+#endif
+#if NUM_SERVICES > 23
+  , { SERV_23_INIT, SERV_23_RUN }
+#endif
+#if NUM_SERVICES > 24
+  , { SERV_24_INIT, SERV_24_RUN }
+#endif
+#if NUM_SERVICES > 25
+  , { SERV_25_INIT, SERV_25_RUN }
+#endif
+#if NUM_SERVICES > 26
+  , { SERV_26_INIT, SERV_26_RUN }
+#endif
+#if NUM_SERVICES > 27
+  , { SERV_27_INIT, SERV_27_RUN }
+#endif
+#if NUM_SERVICES > 28
+  , { SERV_28_INIT, SERV_28_RUN }
+#endif
+#if NUM_SERVICES > 29
+  , { SERV_29_INIT, SERV_29_RUN }
+#endif
+#if NUM_SERVICES > 30
+  , { SERV_30_INIT, SERV_30_RUN }
+#endif
+#if NUM_SERVICES > 31
+  , { SERV_31_INIT, SERV_31_RUN }
+#endif
+#if NUM_SERVICES > 32
+  , { SERV_32_INIT, SERV_32_RUN }
+#endif
+#if NUM_SERVICES > 33
+  , { SERV_33_INIT, SERV_33_RUN }
+#endif
+#if NUM_SERVICES > 34
+  , { SERV_34_INIT, SERV_34_RUN }
+#endif
+#if NUM_SERVICES > 35
+  , { SERV_35_INIT, SERV_35_RUN }
+#endif
+#if NUM_SERVICES > 36
+  , { SERV_36_INIT, SERV_36_RUN }
+#endif
+#if NUM_SERVICES > 37
+  , { SERV_37_INIT, SERV_37_RUN }
+#endif
+#if NUM_SERVICES > 38
+  , { SERV_38_INIT, SERV_38_RUN }
+#endif
+#if NUM_SERVICES > 39
+  , { SERV_39_INIT, SERV_39_RUN }
+#endif
+#if NUM_SERVICES > 40
+  , { SERV_40_INIT, SERV_40_RUN }
+#endif
+#if NUM_SERVICES > 41
+  , { SERV_41_INIT, SERV_41_RUN }
+#endif
+#if NUM_SERVICES > 42
+  , { SERV_42_INIT, SERV_42_RUN }
+#endif
+#if NUM_SERVICES > 43
+  , { SERV_43_INIT, SERV_43_RUN }
+#endif
+#if NUM_SERVICES > 44
+  , { SERV_44_INIT, SERV_44_RUN }
+#endif
+#if NUM_SERVICES > 45
+  , { SERV_45_INIT, SERV_45_RUN }
+#endif
+#if NUM_SERVICES > 46
+  , { SERV_46_INIT, SERV_46_RUN }
+#endif
+#if NUM_SERVICES > 47
+  , { SERV_47_INIT, SERV_47_RUN }
+#endif
+#if NUM_SERVICES > 48
+  , { SERV_48_INIT, SERV_48_RUN }
+#endif
+#if NUM_SERVICES > 49
+  , { SERV_49_INIT, SERV_49_RUN }
+#endif
+#if NUM_SERVICES > 50
+  , { SERV_50_INIT, SERV_50_RUN }
+#endif
+#if NUM_SERVICES > 51
+  , { SERV_51_INIT, SERV_51_RUN }
+#endif
+#if NUM_SERVICES > 52
+  , { SERV_52_INIT, SERV_52_RUN }
+#endif
+#if NUM_SERVICES > 53
+  , { SERV_53_INIT, SERV_53_RUN }
+#endif
+#if NUM_SERVICES > 54
+  , { SERV_54_INIT, SERV_54_RUN }
+#endif
+#if NUM_SERVICES > 55
+  , { SERV_55_INIT, SERV_55_RUN }
+#endif
+#if NUM_SERVICES > 56
+  , { SERV_56_INIT, SERV_56_RUN }
+#endif
+#if NUM_SERVICES > 57
+  , { SERV_57_INIT, SERV_57_RUN }
+#endif
+#if NUM_SERVICES > 58
+  , { SERV_58_INIT, SERV_58_RUN }
+#endif
+#if NUM_SERVICES > 59
+  , { SERV_59_INIT, SERV_59_RUN }
+#endif
+#if NUM_SERVICES > 60
+  , { SERV_60_INIT, SERV_60_RUN }
+#endif
+#if NUM_SERVICES > 61
+  , { SERV_61_INIT, SERV_61_RUN }
+#endif
+#if NUM_SERVICES > 62
+  , { SERV_62_INIT, SERV_62_RUN }
+#endif
+#if NUM_SERVICES > 63
+  , { SERV_63_INIT, SERV_63_RUN }
+#endif
 };
 
 /****************************************************************************/
 // The queues for the services
 
-static ES_Event_t Queue0[SERV_0_QUEUE_SIZE + 1];
+static ES_Event_t Queue0[ES_RING_SIZE(SERV_0_QUEUE_SIZE)];
 #if NUM_SERVICES > 1
-static ES_Event_t Queue1[SERV_1_QUEUE_SIZE + 1];
+static ES_Event_t Queue1[ES_RING_SIZE(SERV_1_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 2
-static ES_Event_t Queue2[SERV_2_QUEUE_SIZE + 1];
+static ES_Event_t Queue2[ES_RING_SIZE(SERV_2_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 3
-static ES_Event_t Queue3[SERV_3_QUEUE_SIZE + 1];
+static ES_Event_t Queue3[ES_RING_SIZE(SERV_3_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 4
-static ES_Event_t Queue4[SERV_4_QUEUE_SIZE + 1];
+static ES_Event_t Queue4[ES_RING_SIZE(SERV_4_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 5
-static ES_Event_t Queue5[SERV_5_QUEUE_SIZE + 1];
+static ES_Event_t Queue5[ES_RING_SIZE(SERV_5_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 6
-static ES_Event_t Queue6[SERV_6_QUEUE_SIZE + 1];
+static ES_Event_t Queue6[ES_RING_SIZE(SERV_6_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 7
-static ES_Event_t Queue7[SERV_7_QUEUE_SIZE + 1];
+static ES_Event_t Queue7[ES_RING_SIZE(SERV_7_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 8
-static ES_Event_t Queue8[SERV_8_QUEUE_SIZE + 1];
+static ES_Event_t Queue8[ES_RING_SIZE(SERV_8_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 9
-static ES_Event_t Queue9[SERV_9_QUEUE_SIZE + 1];
+static ES_Event_t Queue9[ES_RING_SIZE(SERV_9_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 10
-static ES_Event_t Queue10[SERV_10_QUEUE_SIZE + 1];
+static ES_Event_t Queue10[ES_RING_SIZE(SERV_10_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 11
-static ES_Event_t Queue11[SERV_11_QUEUE_SIZE + 1];
+static ES_Event_t Queue11[ES_RING_SIZE(SERV_11_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 12
-static ES_Event_t Queue12[SERV_12_QUEUE_SIZE + 1];
+static ES_Event_t Queue12[ES_RING_SIZE(SERV_12_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 13
-static ES_Event_t Queue13[SERV_13_QUEUE_SIZE + 1];
+static ES_Event_t Queue13[ES_RING_SIZE(SERV_13_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 14
-static ES_Event_t Queue14[SERV_14_QUEUE_SIZE + 1];
+static ES_Event_t Queue14[ES_RING_SIZE(SERV_14_QUEUE_SIZE)];
 #endif
 #if NUM_SERVICES > 15
-static ES_Event_t Queue15[SERV_15_QUEUE_SIZE + 1];
+static ES_Event_t Queue15[ES_RING_SIZE(SERV_15_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 16
+static ES_Event_t Queue16[ES_RING_SIZE(SERV_16_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 17
+static ES_Event_t Queue17[ES_RING_SIZE(SERV_17_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 18
+static ES_Event_t Queue18[ES_RING_SIZE(SERV_18_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 19
+static ES_Event_t Queue19[ES_RING_SIZE(SERV_19_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 20
+static ES_Event_t Queue20[ES_RING_SIZE(SERV_20_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 21
+static ES_Event_t Queue21[ES_RING_SIZE(SERV_21_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 22
+static ES_Event_t Queue22[ES_RING_SIZE(SERV_22_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 23
+static ES_Event_t Queue23[ES_RING_SIZE(SERV_23_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 24
+static ES_Event_t Queue24[ES_RING_SIZE(SERV_24_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 25
+static ES_Event_t Queue25[ES_RING_SIZE(SERV_25_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 26
+static ES_Event_t Queue26[ES_RING_SIZE(SERV_26_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 27
+static ES_Event_t Queue27[ES_RING_SIZE(SERV_27_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 28
+static ES_Event_t Queue28[ES_RING_SIZE(SERV_28_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 29
+static ES_Event_t Queue29[ES_RING_SIZE(SERV_29_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 30
+static ES_Event_t Queue30[ES_RING_SIZE(SERV_30_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 31
+static ES_Event_t Queue31[ES_RING_SIZE(SERV_31_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 32
+static ES_Event_t Queue32[ES_RING_SIZE(SERV_32_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 33
+static ES_Event_t Queue33[ES_RING_SIZE(SERV_33_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 34
+static ES_Event_t Queue34[ES_RING_SIZE(SERV_34_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 35
+static ES_Event_t Queue35[ES_RING_SIZE(SERV_35_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 36
+static ES_Event_t Queue36[ES_RING_SIZE(SERV_36_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 37
+static ES_Event_t Queue37[ES_RING_SIZE(SERV_37_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 38
+static ES_Event_t Queue38[ES_RING_SIZE(SERV_38_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 39
+static ES_Event_t Queue39[ES_RING_SIZE(SERV_39_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 40
+static ES_Event_t Queue40[ES_RING_SIZE(SERV_40_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 41
+static ES_Event_t Queue41[ES_RING_SIZE(SERV_41_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 42
+static ES_Event_t Queue42[ES_RING_SIZE(SERV_42_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 43
+static ES_Event_t Queue43[ES_RING_SIZE(SERV_43_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 44
+static ES_Event_t Queue44[ES_RING_SIZE(SERV_44_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 45
+static ES_Event_t Queue45[ES_RING_SIZE(SERV_45_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 46
+static ES_Event_t Queue46[ES_RING_SIZE(SERV_46_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 47
+static ES_Event_t Queue47[ES_RING_SIZE(SERV_47_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 48
+static ES_Event_t Queue48[ES_RING_SIZE(SERV_48_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 49
+static ES_Event_t Queue49[ES_RING_SIZE(SERV_49_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 50
+static ES_Event_t Queue50[ES_RING_SIZE(SERV_50_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 51
+static ES_Event_t Queue51[ES_RING_SIZE(SERV_51_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 52
+static ES_Event_t Queue52[ES_RING_SIZE(SERV_52_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 53
+static ES_Event_t Queue53[ES_RING_SIZE(SERV_53_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 54
+static ES_Event_t Queue54[ES_RING_SIZE(SERV_54_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 55
+static ES_Event_t Queue55[ES_RING_SIZE(SERV_55_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 56
+static ES_Event_t Queue56[ES_RING_SIZE(SERV_56_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 57
+static ES_Event_t Queue57[ES_RING_SIZE(SERV_57_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 58
+static ES_Event_t Queue58[ES_RING_SIZE(SERV_58_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 59
+static ES_Event_t Queue59[ES_RING_SIZE(SERV_59_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 60
+static ES_Event_t Queue60[ES_RING_SIZE(SERV_60_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 61
+static ES_Event_t Queue61[ES_RING_SIZE(SERV_61_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 62
+static ES_Event_t Queue62[ES_RING_SIZE(SERV_62_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 63
+static ES_Event_t Queue63[ES_RING_SIZE(SERV_63_QUEUE_SIZE)];
 #endif
 
 /****************************************************************************/
@@ -230,219 +619,2986 @@ static ES_QueueDesc_t const EventQueues[NUM_SERVICES] = {
 #if NUM_SERVICES > 15
   , { Queue15, ARRAY_SIZE(Queue15) }
 #endif
+#if NUM_SERVICES > 16
+  , { Queue16, ARRAY_SIZE(Queue16) }
+#endif
+#if NUM_SERVICES > 17
+  , { Queue17, ARRAY_SIZE(Queue17) }
+#endif
+#if NUM_SERVICES > 18
+  , { Queue18, ARRAY_SIZE(Queue18) }
+#endif
+#if NUM_SERVICES > 19
+  , { Queue19, ARRAY_SIZE(Queue19) }
+#endif
+#if NUM_SERVICES > 20
+  , { Queue20, ARRAY_SIZE(Queue20) }
+#endif
+#if NUM_SERVICES > 21
+  , { Queue21, ARRAY_SIZE(Queue21) }
+#endif
+#if NUM_SERVICES > 22
+  , { Queue22, ARRAY_SIZE(Queue22) }
+#endif
+#if NUM_SERVICES > 23
+  , { Queue23, ARRAY_SIZE(Queue23) }
+#endif
+#if NUM_SERVICES > 24
+  , { Queue24, ARRAY_SIZE(Queue24) }
+#endif
+#if NUM_SERVICES > 25
+  , { Queue25, ARRAY_SIZE(Queue25) }
+#endif
+#if NUM_SERVICES > 26
+  , { Queue26, ARRAY_SIZE(Queue26) }
+#endif
+#if NUM_SERVICES > 27
+  , { Queue27, ARRAY_SIZE(Queue27) }
+#endif
+#if NUM_SERVICES > 28
+  , { Queue28, ARRAY_SIZE(Queue28) }
+#endif
+#if NUM_SERVICES > 29
+  , { Queue29, ARRAY_SIZE(Queue29) }
+#endif
+#if NUM_SERVICES > 30
+  , { Queue30, ARRAY_SIZE(Queue30) }
+#endif
+#if NUM_SERVICES > 31
+  , { Queue31, ARRAY_SIZE(Queue31) }
+#endif
+#if NUM_SERVICES > 32
+  , { Queue32, ARRAY_SIZE(Queue32) }
+#endif
+#if NUM_SERVICES > 33
+  , { Queue33, ARRAY_SIZE(Queue33) }
+#endif
+#if NUM_SERVICES > 34
+  , { Queue34, ARRAY_SIZE(Queue34) }
+#endif
+#if NUM_SERVICES > 35
+  , { Queue35, ARRAY_SIZE(Queue35) }
+#endif
+#if NUM_SERVICES > 36
+  , { Queue36, ARRAY_SIZE(Queue36) }
+#endif
+#if NUM_SERVICES > 37
+  , { Queue37, ARRAY_SIZE(Queue37) }
+#endif
+#if NUM_SERVICES > 38
+  , { Queue38, ARRAY_SIZE(Queue38) }
+#endif
+#if NUM_SERVICES > 39
+  , { Queue39, ARRAY_SIZE(Queue39) }
+#endif
+#if NUM_SERVICES > 40
+  , { Queue40, ARRAY_SIZE(Queue40) }
+#endif
+#if NUM_SERVICES > 41
+  , { Queue41, ARRAY_SIZE(Queue41) }
+#endif
+#if NUM_SERVICES > 42
+  , { Queue42, ARRAY_SIZE(Queue42) }
+#endif
+#if NUM_SERVICES > 43
+  , { Queue43, ARRAY_SIZE(Queue43) }
+#endif
+#if NUM_SERVICES > 44
+  , { Queue44, ARRAY_SIZE(Queue44) }
+#endif
+#if NUM_SERVICES > 45
+  , { Queue45, ARRAY_SIZE(Queue45) }
+#endif
+#if NUM_SERVICES > 46
+  , { Queue46, ARRAY_SIZE(Queue46) }
+#endif
+#if NUM_SERVICES > 47
+  , { Queue47, ARRAY_SIZE(Queue47) }
+#endif
+#if NUM_SERVICES > 48
+  , { Queue48, ARRAY_SIZE(Queue48) }
+#endif
+#if NUM_SERVICES > 49
+  , { Queue49, ARRAY_SIZE(Queue49) }
+#endif
+#if NUM_SERVICES > 50
+  , { Queue50, ARRAY_SIZE(Queue50) }
+#endif
+#if NUM_SERVICES > 51
+  , { Queue51, ARRAY_SIZE(Queue51) }
+#endif
+#if NUM_SERVICES > 52
+  , { Queue52, ARRAY_SIZE(Queue52) }
+#endif
+#if NUM_SERVICES > 53
+  , { Queue53, ARRAY_SIZE(Queue53) }
+#endif
+#if NUM_SERVICES > 54
+  , { Queue54, ARRAY_SIZE(Queue54) }
+#endif
+#if NUM_SERVICES > 55
+  , { Queue55, ARRAY_SIZE(Queue55) }
+#endif
+#if NUM_SERVICES > 56
+  , { Queue56, ARRAY_SIZE(Queue56) }
+#endif
+#if NUM_SERVICES > 57
+  , { Queue57, ARRAY_SIZE(Queue57) }
+#endif
+#if NUM_SERVICES > 58
+  , { Queue58, ARRAY_SIZE(Queue58) }
+#endif
+#if NUM_SERVICES > 59
+  , { Queue59, ARRAY_SIZE(Queue59) }
+#endif
+#if NUM_SERVICES > 60
+  , { Queue60, ARRAY_SIZE(Queue60) }
+#endif
+#if NUM_SERVICES > 61
+  , { Queue61, ARRAY_SIZE(Queue61) }
+#endif
+#if NUM_SERVICES > 62
+  , { Queue62, ARRAY_SIZE(Queue62) }
+#endif
+#if NUM_SERVICES > 63
+  , { Queue63, ARRAY_SIZE(Queue63) }
+#endif
 };
 
-/****************************************************************************/
-// Variable used to keep track of which queues have events in them
-
-uint16_t Ready;
+// the ring queue headers, set up by ES_Initialize to use the memory above
+static ES_RingQueue_t EventRings[NUM_SERVICES];
 
-/*------------------------------ Module Code ------------------------------*/
-/****************************************************************************
- Function
-   ES_Initialize
- Parameters
-   TimerRate_t the rate at which to initialize the framework timer subsystem
- Returns
-   ES_Return_t : FailedPointer if any of the function pointers are NULL
-                 FailedInit if any of the initialization functions failed
- Description
-   Initialize all the services and tests for NULL pointers in the array
- Notes
+/****************************************************************************/
+// The event types that each service takes from broadcasts. Initialized from
+// the optional SERV_n_SUBSCRIBES definitions in ES_Configure.h and adjustable
+// at run time through ES_SetSubscriptions & ES_AddSubscriptions
 
- Author
-   J. Edward Carryer, 10/23/11,
-****************************************************************************/
-ES_Return_t ES_Initialize(TimerRate_t NewRate)
-{
-  uint8_t i;
-  ES_Timer_Init(NewRate);  // start up the timer subsystem
-  // loop through the list testing for NULL pointers and
-  for (i = 0; i < ARRAY_SIZE(ServDescList); i++)
-  {
-    if ((ServDescList[i].InitFunc == (pInitFunc)0) ||
-        (ServDescList[i].RunFunc == (pRunFunc)0))
-    {
-      return FailedPointer; // protect against NULL pointers
-    }
-    // and initializing the event queues (must happen before running inits)
-    ES_InitQueue(EventQueues[i].pMem, EventQueues[i].Size);
-    // executing the init functions
-    if (ServDescList[i].InitFunc(i) != true)
-    {
-      return FailedInit; // this is a failed initialization
-    }
-  }
-#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-  _HW_DebugLines_Init();
+static ES_EventMask_t Subscriptions[NUM_SERVICES] = {
+#ifdef SERV_0_SUBSCRIBES
+  SERV_0_SUBSCRIBES
+#else
+  ES_ALL_EVENTS_MASK
 #endif
-  return Success;
-}
-
-/****************************************************************************
- Function
-   ES_Run
- Parameters
-   None
- Returns
-   ES_Return_t : FailedRun is any of the run functions failed during execution
- Description
-   This is the main framework function. It searches through the services
-   to find one with a non-empty queue and then executes the
-   service to process the event in its queue.
-   while all the queues are empty, it searches for system generated or
-   user generated events or moves bytes from buffer to UART.
- Notes
-   this function only returns in case of an error
- Author
-   J. Edward Carryer, 10/23/11,
-****************************************************************************/
-ES_Return_t ES_Run(void)
-{
-  // make these static to improve speed
-  uint8_t         HighestPrior;
-  static ES_Event_t ThisEvent;
-
-  while (1)  // stay here unless we detect an error condition
-  { // loop through the list executing the run functions for services
-    // with a non-empty queue. Process any pending ints before testing
-    // Ready
-    while ((_HW_Process_Pending_Ints()) && (Ready != 0))
-    {
-      HighestPrior = ES_GetMSBitSet(Ready);
-      if (ES_DeQueue(EventQueues[HighestPrior].pMem, &ThisEvent) == 0)
-      {
-        Ready &= BitNum2ClrMask[HighestPrior]; // mark queue as now empty
-      }
-#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-      _HW_DebugSetLine1();
+#if NUM_SERVICES > 1
+#ifdef SERV_1_SUBSCRIBES
+  , SERV_1_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
 #endif
-      if (ServDescList[HighestPrior].RunFunc(ThisEvent).EventType !=
-          ES_NO_EVENT)
-      {
-        return FailedRun;
-      }
-#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-      _HW_DebugClearLine1();
 #endif
-    }
-
-#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-    _HW_DebugSetLine2();
+#if NUM_SERVICES > 2
+#ifdef SERV_2_SUBSCRIBES
+  , SERV_2_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
 #endif
-    // all the queues are empty, so look for new user detected events
-    if (!ES_CheckUserEvents()) // no new user events
-    {
-      Terminal_MoveBuffer2UART(); // try moving bytes, if available, to UART
-    }
-#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-    _HW_DebugClearLine2();
 #endif
-  }
-}
-
-/****************************************************************************
- Function
-   ES_PostAll
- Parameters
-   ES_Event : The Event to be posted
- Returns
-   boolean : False if any of the post functions failed during execution
- Description
-   posts to all of the services' queues
- Notes
+#if NUM_SERVICES > 3
+#ifdef SERV_3_SUBSCRIBES
+  , SERV_3_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 4
+#ifdef SERV_4_SUBSCRIBES
+  , SERV_4_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 5
+#ifdef SERV_5_SUBSCRIBES
+  , SERV_5_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 6
+#ifdef SERV_6_SUBSCRIBES
+  , SERV_6_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 7
+#ifdef SERV_7_SUBSCRIBES
+  , SERV_7_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 8
+#ifdef SERV_8_SUBSCRIBES
+  , SERV_8_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 9
+#ifdef SERV_9_SUBSCRIBES
+  , SERV_9_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 10
+#ifdef SERV_10_SUBSCRIBES
+  , SERV_10_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 11
+#ifdef SERV_11_SUBSCRIBES
+  , SERV_11_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 12
+#ifdef SERV_12_SUBSCRIBES
+  , SERV_12_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 13
+#ifdef SERV_13_SUBSCRIBES
+  , SERV_13_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 14
+#ifdef SERV_14_SUBSCRIBES
+  , SERV_14_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 15
+#ifdef SERV_15_SUBSCRIBES
+  , SERV_15_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 16
+#ifdef SERV_16_SUBSCRIBES
+  , SERV_16_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 17
+#ifdef SERV_17_SUBSCRIBES
+  , SERV_17_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 18
+#ifdef SERV_18_SUBSCRIBES
+  , SERV_18_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 19
+#ifdef SERV_19_SUBSCRIBES
+  , SERV_19_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 20
+#ifdef SERV_20_SUBSCRIBES
+  , SERV_20_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 21
+#ifdef SERV_21_SUBSCRIBES
+  , SERV_21_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 22
+#ifdef SERV_22_SUBSCRIBES
+  , SERV_22_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 23
+#ifdef SERV_23_SUBSCRIBES
+  , SERV_23_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 24
+#ifdef SERV_24_SUBSCRIBES
+  , SERV_24_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 25
+#ifdef SERV_25_SUBSCRIBES
+  , SERV_25_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 26
+#ifdef SERV_26_SUBSCRIBES
+  , SERV_26_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 27
+#ifdef SERV_27_SUBSCRIBES
+  , SERV_27_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 28
+#ifdef SERV_28_SUBSCRIBES
+  , SERV_28_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 29
+#ifdef SERV_29_SUBSCRIBES
+  , SERV_29_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 30
+#ifdef SERV_30_SUBSCRIBES
+  , SERV_30_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 31
+#ifdef SERV_31_SUBSCRIBES
+  , SERV_31_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 32
+#ifdef SERV_32_SUBSCRIBES
+  , SERV_32_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 33
+#ifdef SERV_33_SUBSCRIBES
+  , SERV_33_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 34
+#ifdef SERV_34_SUBSCRIBES
+  , SERV_34_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 35
+#ifdef SERV_35_SUBSCRIBES
+  , SERV_35_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 36
+#ifdef SERV_36_SUBSCRIBES
+  , SERV_36_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 37
+#ifdef SERV_37_SUBSCRIBES
+  , SERV_37_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 38
+#ifdef SERV_38_SUBSCRIBES
+  , SERV_38_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 39
+#ifdef SERV_39_SUBSCRIBES
+  , SERV_39_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 40
+#ifdef SERV_40_SUBSCRIBES
+  , SERV_40_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 41
+#ifdef SERV_41_SUBSCRIBES
+  , SERV_41_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 42
+#ifdef SERV_42_SUBSCRIBES
+  , SERV_42_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 43
+#ifdef SERV_43_SUBSCRIBES
+  , SERV_43_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 44
+#ifdef SERV_44_SUBSCRIBES
+  , SERV_44_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 45
+#ifdef SERV_45_SUBSCRIBES
+  , SERV_45_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 46
+#ifdef SERV_46_SUBSCRIBES
+  , SERV_46_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 47
+#ifdef SERV_47_SUBSCRIBES
+  , SERV_47_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 48
+#ifdef SERV_48_SUBSCRIBES
+  , SERV_48_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 49
+#ifdef SERV_49_SUBSCRIBES
+  , SERV_49_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 50
+#ifdef SERV_50_SUBSCRIBES
+  , SERV_50_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 51
+#ifdef SERV_51_SUBSCRIBES
+  , SERV_51_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 52
+#ifdef SERV_52_SUBSCRIBES
+  , SERV_52_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 53
+#ifdef SERV_53_SUBSCRIBES
+  , SERV_53_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 54
+#ifdef SERV_54_SUBSCRIBES
+  , SERV_54_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 55
+#ifdef SERV_55_SUBSCRIBES
+  , SERV_55_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 56
+#ifdef SERV_56_SUBSCRIBES
+  , SERV_56_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 57
+#ifdef SERV_57_SUBSCRIBES
+  , SERV_57_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 58
+#ifdef SERV_58_SUBSCRIBES
+  , SERV_58_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 59
+#ifdef SERV_59_SUBSCRIBES
+  , SERV_59_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 60
+#ifdef SERV_60_SUBSCRIBES
+  , SERV_60_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 61
+#ifdef SERV_61_SUBSCRIBES
+  , SERV_61_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 62
+#ifdef SERV_62_SUBSCRIBES
+  , SERV_62_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+#if NUM_SERVICES > 63
+#ifdef SERV_63_SUBSCRIBES
+  , SERV_63_SUBSCRIBES
+#else
+  , ES_ALL_EVENTS_MASK
+#endif
+#endif
+};
+
+// true while a distribution list is being posted, so that ES_PostToService
+// applies the subscriptions and collects the targets instead of posting
+static bool Broadcasting;
+#ifdef POST_FROM_INTS
+// the interrupt state from before the list was posted. ISRs that post
+// directly are held off until the targets are collected, so that their
+// posts are not taken for a part of the broadcast
+static uint32_t BroadcastIntState;
+#endif
+// the service whose queue took the first ES_TIMEOUT since the last call to
+// ES_TakeTimeoutTarget, so that the timers know where their timeouts went
+static uint8_t TimeoutTarget = ES_NO_SERVICE;
+
+// the services that the broadcast under way will go to, one bit per service
+// laid out like ReadyTable, and the event they will get
+static uint32_t BroadcastTargets[NUM_READY_GROUPS];
+static ES_Event_t BroadcastEvent;
+
+/****************************************************************************/
+// The number of events that ES_Run may dispatch from each service's queue
+// before it processes pending interrupts and re-scans the Ready bitmap.
+// Initialized from the optional SERV_n_BATCH_SIZE definitions in
+// ES_Configure.h and adjustable at run time through ES_SetBatchBudget
+
+static uint8_t BatchBudget[NUM_SERVICES] = {
+#ifdef SERV_0_BATCH_SIZE
+  SERV_0_BATCH_SIZE
+#else
+  ES_DEFAULT_BATCH_SIZE
+#endif
+#if NUM_SERVICES > 1
+#ifdef SERV_1_BATCH_SIZE
+  , SERV_1_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 2
+#ifdef SERV_2_BATCH_SIZE
+  , SERV_2_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 3
+#ifdef SERV_3_BATCH_SIZE
+  , SERV_3_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 4
+#ifdef SERV_4_BATCH_SIZE
+  , SERV_4_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 5
+#ifdef SERV_5_BATCH_SIZE
+  , SERV_5_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 6
+#ifdef SERV_6_BATCH_SIZE
+  , SERV_6_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 7
+#ifdef SERV_7_BATCH_SIZE
+  , SERV_7_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 8
+#ifdef SERV_8_BATCH_SIZE
+  , SERV_8_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 9
+#ifdef SERV_9_BATCH_SIZE
+  , SERV_9_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 10
+#ifdef SERV_10_BATCH_SIZE
+  , SERV_10_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 11
+#ifdef SERV_11_BATCH_SIZE
+  , SERV_11_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 12
+#ifdef SERV_12_BATCH_SIZE
+  , SERV_12_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 13
+#ifdef SERV_13_BATCH_SIZE
+  , SERV_13_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 14
+#ifdef SERV_14_BATCH_SIZE
+  , SERV_14_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 15
+#ifdef SERV_15_BATCH_SIZE
+  , SERV_15_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 16
+#ifdef SERV_16_BATCH_SIZE
+  , SERV_16_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 17
+#ifdef SERV_17_BATCH_SIZE
+  , SERV_17_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 18
+#ifdef SERV_18_BATCH_SIZE
+  , SERV_18_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 19
+#ifdef SERV_19_BATCH_SIZE
+  , SERV_19_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 20
+#ifdef SERV_20_BATCH_SIZE
+  , SERV_20_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 21
+#ifdef SERV_21_BATCH_SIZE
+  , SERV_21_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 22
+#ifdef SERV_22_BATCH_SIZE
+  , SERV_22_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 23
+#ifdef SERV_23_BATCH_SIZE
+  , SERV_23_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 24
+#ifdef SERV_24_BATCH_SIZE
+  , SERV_24_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 25
+#ifdef SERV_25_BATCH_SIZE
+  , SERV_25_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 26
+#ifdef SERV_26_BATCH_SIZE
+  , SERV_26_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 27
+#ifdef SERV_27_BATCH_SIZE
+  , SERV_27_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 28
+#ifdef SERV_28_BATCH_SIZE
+  , SERV_28_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 29
+#ifdef SERV_29_BATCH_SIZE
+  , SERV_29_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 30
+#ifdef SERV_30_BATCH_SIZE
+  , SERV_30_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 31
+#ifdef SERV_31_BATCH_SIZE
+  , SERV_31_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 32
+#ifdef SERV_32_BATCH_SIZE
+  , SERV_32_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 33
+#ifdef SERV_33_BATCH_SIZE
+  , SERV_33_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 34
+#ifdef SERV_34_BATCH_SIZE
+  , SERV_34_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 35
+#ifdef SERV_35_BATCH_SIZE
+  , SERV_35_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 36
+#ifdef SERV_36_BATCH_SIZE
+  , SERV_36_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 37
+#ifdef SERV_37_BATCH_SIZE
+  , SERV_37_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 38
+#ifdef SERV_38_BATCH_SIZE
+  , SERV_38_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 39
+#ifdef SERV_39_BATCH_SIZE
+  , SERV_39_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 40
+#ifdef SERV_40_BATCH_SIZE
+  , SERV_40_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 41
+#ifdef SERV_41_BATCH_SIZE
+  , SERV_41_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 42
+#ifdef SERV_42_BATCH_SIZE
+  , SERV_42_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 43
+#ifdef SERV_43_BATCH_SIZE
+  , SERV_43_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 44
+#ifdef SERV_44_BATCH_SIZE
+  , SERV_44_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 45
+#ifdef SERV_45_BATCH_SIZE
+  , SERV_45_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 46
+#ifdef SERV_46_BATCH_SIZE
+  , SERV_46_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 47
+#ifdef SERV_47_BATCH_SIZE
+  , SERV_47_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 48
+#ifdef SERV_48_BATCH_SIZE
+  , SERV_48_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 49
+#ifdef SERV_49_BATCH_SIZE
+  , SERV_49_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 50
+#ifdef SERV_50_BATCH_SIZE
+  , SERV_50_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 51
+#ifdef SERV_51_BATCH_SIZE
+  , SERV_51_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 52
+#ifdef SERV_52_BATCH_SIZE
+  , SERV_52_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 53
+#ifdef SERV_53_BATCH_SIZE
+  , SERV_53_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 54
+#ifdef SERV_54_BATCH_SIZE
+  , SERV_54_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 55
+#ifdef SERV_55_BATCH_SIZE
+  , SERV_55_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 56
+#ifdef SERV_56_BATCH_SIZE
+  , SERV_56_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 57
+#ifdef SERV_57_BATCH_SIZE
+  , SERV_57_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 58
+#ifdef SERV_58_BATCH_SIZE
+  , SERV_58_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 59
+#ifdef SERV_59_BATCH_SIZE
+  , SERV_59_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 60
+#ifdef SERV_60_BATCH_SIZE
+  , SERV_60_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 61
+#ifdef SERV_61_BATCH_SIZE
+  , SERV_61_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 62
+#ifdef SERV_62_BATCH_SIZE
+  , SERV_62_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+#if NUM_SERVICES > 63
+#ifdef SERV_63_BATCH_SIZE
+  , SERV_63_BATCH_SIZE
+#else
+  , ES_DEFAULT_BATCH_SIZE
+#endif
+#endif
+};
+
+/****************************************************************************/
+// What each service's queue does with a FIFO post that finds it full or
+// finds the same event already waiting. Initialized from the optional
+// SERV_n_QUEUE_POLICY definitions in ES_Configure.h
+
+static const ES_QueuePolicy_t QueuePolicies[NUM_SERVICES] = {
+#ifdef SERV_0_QUEUE_POLICY
+  SERV_0_QUEUE_POLICY
+#else
+  ES_QUEUE_REJECT_NEW
+#endif
+#if NUM_SERVICES > 1
+#ifdef SERV_1_QUEUE_POLICY
+  , SERV_1_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 2
+#ifdef SERV_2_QUEUE_POLICY
+  , SERV_2_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 3
+#ifdef SERV_3_QUEUE_POLICY
+  , SERV_3_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 4
+#ifdef SERV_4_QUEUE_POLICY
+  , SERV_4_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 5
+#ifdef SERV_5_QUEUE_POLICY
+  , SERV_5_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 6
+#ifdef SERV_6_QUEUE_POLICY
+  , SERV_6_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 7
+#ifdef SERV_7_QUEUE_POLICY
+  , SERV_7_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 8
+#ifdef SERV_8_QUEUE_POLICY
+  , SERV_8_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 9
+#ifdef SERV_9_QUEUE_POLICY
+  , SERV_9_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 10
+#ifdef SERV_10_QUEUE_POLICY
+  , SERV_10_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 11
+#ifdef SERV_11_QUEUE_POLICY
+  , SERV_11_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 12
+#ifdef SERV_12_QUEUE_POLICY
+  , SERV_12_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 13
+#ifdef SERV_13_QUEUE_POLICY
+  , SERV_13_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 14
+#ifdef SERV_14_QUEUE_POLICY
+  , SERV_14_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 15
+#ifdef SERV_15_QUEUE_POLICY
+  , SERV_15_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 16
+#ifdef SERV_16_QUEUE_POLICY
+  , SERV_16_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 17
+#ifdef SERV_17_QUEUE_POLICY
+  , SERV_17_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 18
+#ifdef SERV_18_QUEUE_POLICY
+  , SERV_18_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 19
+#ifdef SERV_19_QUEUE_POLICY
+  , SERV_19_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 20
+#ifdef SERV_20_QUEUE_POLICY
+  , SERV_20_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 21
+#ifdef SERV_21_QUEUE_POLICY
+  , SERV_21_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 22
+#ifdef SERV_22_QUEUE_POLICY
+  , SERV_22_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 23
+#ifdef SERV_23_QUEUE_POLICY
+  , SERV_23_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 24
+#ifdef SERV_24_QUEUE_POLICY
+  , SERV_24_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 25
+#ifdef SERV_25_QUEUE_POLICY
+  , SERV_25_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 26
+#ifdef SERV_26_QUEUE_POLICY
+  , SERV_26_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 27
+#ifdef SERV_27_QUEUE_POLICY
+  , SERV_27_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 28
+#ifdef SERV_28_QUEUE_POLICY
+  , SERV_28_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 29
+#ifdef SERV_29_QUEUE_POLICY
+  , SERV_29_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 30
+#ifdef SERV_30_QUEUE_POLICY
+  , SERV_30_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 31
+#ifdef SERV_31_QUEUE_POLICY
+  , SERV_31_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 32
+#ifdef SERV_32_QUEUE_POLICY
+  , SERV_32_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 33
+#ifdef SERV_33_QUEUE_POLICY
+  , SERV_33_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 34
+#ifdef SERV_34_QUEUE_POLICY
+  , SERV_34_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 35
+#ifdef SERV_35_QUEUE_POLICY
+  , SERV_35_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 36
+#ifdef SERV_36_QUEUE_POLICY
+  , SERV_36_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 37
+#ifdef SERV_37_QUEUE_POLICY
+  , SERV_37_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 38
+#ifdef SERV_38_QUEUE_POLICY
+  , SERV_38_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 39
+#ifdef SERV_39_QUEUE_POLICY
+  , SERV_39_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 40
+#ifdef SERV_40_QUEUE_POLICY
+  , SERV_40_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 41
+#ifdef SERV_41_QUEUE_POLICY
+  , SERV_41_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 42
+#ifdef SERV_42_QUEUE_POLICY
+  , SERV_42_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 43
+#ifdef SERV_43_QUEUE_POLICY
+  , SERV_43_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 44
+#ifdef SERV_44_QUEUE_POLICY
+  , SERV_44_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 45
+#ifdef SERV_45_QUEUE_POLICY
+  , SERV_45_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 46
+#ifdef SERV_46_QUEUE_POLICY
+  , SERV_46_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 47
+#ifdef SERV_47_QUEUE_POLICY
+  , SERV_47_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 48
+#ifdef SERV_48_QUEUE_POLICY
+  , SERV_48_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 49
+#ifdef SERV_49_QUEUE_POLICY
+  , SERV_49_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 50
+#ifdef SERV_50_QUEUE_POLICY
+  , SERV_50_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 51
+#ifdef SERV_51_QUEUE_POLICY
+  , SERV_51_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 52
+#ifdef SERV_52_QUEUE_POLICY
+  , SERV_52_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 53
+#ifdef SERV_53_QUEUE_POLICY
+  , SERV_53_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 54
+#ifdef SERV_54_QUEUE_POLICY
+  , SERV_54_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 55
+#ifdef SERV_55_QUEUE_POLICY
+  , SERV_55_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 56
+#ifdef SERV_56_QUEUE_POLICY
+  , SERV_56_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 57
+#ifdef SERV_57_QUEUE_POLICY
+  , SERV_57_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 58
+#ifdef SERV_58_QUEUE_POLICY
+  , SERV_58_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 59
+#ifdef SERV_59_QUEUE_POLICY
+  , SERV_59_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 60
+#ifdef SERV_60_QUEUE_POLICY
+  , SERV_60_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 61
+#ifdef SERV_61_QUEUE_POLICY
+  , SERV_61_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 62
+#ifdef SERV_62_QUEUE_POLICY
+  , SERV_62_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+#if NUM_SERVICES > 63
+#ifdef SERV_63_QUEUE_POLICY
+  , SERV_63_QUEUE_POLICY
+#else
+  , ES_QUEUE_REJECT_NEW
+#endif
+#endif
+};
+
+// the pending "continue me" event of each service, ES_NO_EVENT if none. It
+// is dispatched once the service's queue is empty, without using a slot
+static ES_Event_t Continuations[NUM_SERVICES];
+
+#ifdef ES_QUEUE_TELEMETRY
+/****************************************************************************/
+// The post time stamps for each service's queue and the telemetry gathered
+// from them
+
+static uint32_t Stamps0[ES_RING_SIZE(SERV_0_QUEUE_SIZE)];
+#if NUM_SERVICES > 1
+static uint32_t Stamps1[ES_RING_SIZE(SERV_1_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 2
+static uint32_t Stamps2[ES_RING_SIZE(SERV_2_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 3
+static uint32_t Stamps3[ES_RING_SIZE(SERV_3_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 4
+static uint32_t Stamps4[ES_RING_SIZE(SERV_4_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 5
+static uint32_t Stamps5[ES_RING_SIZE(SERV_5_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 6
+static uint32_t Stamps6[ES_RING_SIZE(SERV_6_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 7
+static uint32_t Stamps7[ES_RING_SIZE(SERV_7_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 8
+static uint32_t Stamps8[ES_RING_SIZE(SERV_8_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 9
+static uint32_t Stamps9[ES_RING_SIZE(SERV_9_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 10
+static uint32_t Stamps10[ES_RING_SIZE(SERV_10_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 11
+static uint32_t Stamps11[ES_RING_SIZE(SERV_11_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 12
+static uint32_t Stamps12[ES_RING_SIZE(SERV_12_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 13
+static uint32_t Stamps13[ES_RING_SIZE(SERV_13_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 14
+static uint32_t Stamps14[ES_RING_SIZE(SERV_14_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 15
+static uint32_t Stamps15[ES_RING_SIZE(SERV_15_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 16
+static uint32_t Stamps16[ES_RING_SIZE(SERV_16_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 17
+static uint32_t Stamps17[ES_RING_SIZE(SERV_17_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 18
+static uint32_t Stamps18[ES_RING_SIZE(SERV_18_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 19
+static uint32_t Stamps19[ES_RING_SIZE(SERV_19_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 20
+static uint32_t Stamps20[ES_RING_SIZE(SERV_20_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 21
+static uint32_t Stamps21[ES_RING_SIZE(SERV_21_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 22
+static uint32_t Stamps22[ES_RING_SIZE(SERV_22_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 23
+static uint32_t Stamps23[ES_RING_SIZE(SERV_23_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 24
+static uint32_t Stamps24[ES_RING_SIZE(SERV_24_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 25
+static uint32_t Stamps25[ES_RING_SIZE(SERV_25_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 26
+static uint32_t Stamps26[ES_RING_SIZE(SERV_26_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 27
+static uint32_t Stamps27[ES_RING_SIZE(SERV_27_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 28
+static uint32_t Stamps28[ES_RING_SIZE(SERV_28_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 29
+static uint32_t Stamps29[ES_RING_SIZE(SERV_29_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 30
+static uint32_t Stamps30[ES_RING_SIZE(SERV_30_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 31
+static uint32_t Stamps31[ES_RING_SIZE(SERV_31_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 32
+static uint32_t Stamps32[ES_RING_SIZE(SERV_32_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 33
+static uint32_t Stamps33[ES_RING_SIZE(SERV_33_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 34
+static uint32_t Stamps34[ES_RING_SIZE(SERV_34_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 35
+static uint32_t Stamps35[ES_RING_SIZE(SERV_35_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 36
+static uint32_t Stamps36[ES_RING_SIZE(SERV_36_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 37
+static uint32_t Stamps37[ES_RING_SIZE(SERV_37_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 38
+static uint32_t Stamps38[ES_RING_SIZE(SERV_38_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 39
+static uint32_t Stamps39[ES_RING_SIZE(SERV_39_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 40
+static uint32_t Stamps40[ES_RING_SIZE(SERV_40_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 41
+static uint32_t Stamps41[ES_RING_SIZE(SERV_41_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 42
+static uint32_t Stamps42[ES_RING_SIZE(SERV_42_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 43
+static uint32_t Stamps43[ES_RING_SIZE(SERV_43_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 44
+static uint32_t Stamps44[ES_RING_SIZE(SERV_44_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 45
+static uint32_t Stamps45[ES_RING_SIZE(SERV_45_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 46
+static uint32_t Stamps46[ES_RING_SIZE(SERV_46_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 47
+static uint32_t Stamps47[ES_RING_SIZE(SERV_47_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 48
+static uint32_t Stamps48[ES_RING_SIZE(SERV_48_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 49
+static uint32_t Stamps49[ES_RING_SIZE(SERV_49_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 50
+static uint32_t Stamps50[ES_RING_SIZE(SERV_50_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 51
+static uint32_t Stamps51[ES_RING_SIZE(SERV_51_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 52
+static uint32_t Stamps52[ES_RING_SIZE(SERV_52_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 53
+static uint32_t Stamps53[ES_RING_SIZE(SERV_53_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 54
+static uint32_t Stamps54[ES_RING_SIZE(SERV_54_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 55
+static uint32_t Stamps55[ES_RING_SIZE(SERV_55_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 56
+static uint32_t Stamps56[ES_RING_SIZE(SERV_56_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 57
+static uint32_t Stamps57[ES_RING_SIZE(SERV_57_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 58
+static uint32_t Stamps58[ES_RING_SIZE(SERV_58_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 59
+static uint32_t Stamps59[ES_RING_SIZE(SERV_59_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 60
+static uint32_t Stamps60[ES_RING_SIZE(SERV_60_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 61
+static uint32_t Stamps61[ES_RING_SIZE(SERV_61_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 62
+static uint32_t Stamps62[ES_RING_SIZE(SERV_62_QUEUE_SIZE)];
+#endif
+#if NUM_SERVICES > 63
+static uint32_t Stamps63[ES_RING_SIZE(SERV_63_QUEUE_SIZE)];
+#endif
+
+static StampRing_t StampRings[] = {
+  { Stamps0, ARRAY_SIZE(Stamps0), 0, 0 }
+#if NUM_SERVICES > 1
+  , { Stamps1, ARRAY_SIZE(Stamps1), 0, 0 }
+#endif
+#if NUM_SERVICES > 2
+  , { Stamps2, ARRAY_SIZE(Stamps2), 0, 0 }
+#endif
+#if NUM_SERVICES > 3
+  , { Stamps3, ARRAY_SIZE(Stamps3), 0, 0 }
+#endif
+#if NUM_SERVICES > 4
+  , { Stamps4, ARRAY_SIZE(Stamps4), 0, 0 }
+#endif
+#if NUM_SERVICES > 5
+  , { Stamps5, ARRAY_SIZE(Stamps5), 0, 0 }
+#endif
+#if NUM_SERVICES > 6
+  , { Stamps6, ARRAY_SIZE(Stamps6), 0, 0 }
+#endif
+#if NUM_SERVICES > 7
+  , { Stamps7, ARRAY_SIZE(Stamps7), 0, 0 }
+#endif
+#if NUM_SERVICES > 8
+  , { Stamps8, ARRAY_SIZE(Stamps8), 0, 0 }
+#endif
+#if NUM_SERVICES > 9
+  , { Stamps9, ARRAY_SIZE(Stamps9), 0, 0 }
+#endif
+#if NUM_SERVICES > 10
+  , { Stamps10, ARRAY_SIZE(Stamps10), 0, 0 }
+#endif
+#if NUM_SERVICES > 11
+  , { Stamps11, ARRAY_SIZE(Stamps11), 0, 0 }
+#endif
+#if NUM_SERVICES > 12
+  , { Stamps12, ARRAY_SIZE(Stamps12), 0, 0 }
+#endif
+#if NUM_SERVICES > 13
+  , { Stamps13, ARRAY_SIZE(Stamps13), 0, 0 }
+#endif
+#if NUM_SERVICES > 14
+  , { Stamps14, ARRAY_SIZE(Stamps14), 0, 0 }
+#endif
+#if NUM_SERVICES > 15
+  , { Stamps15, ARRAY_SIZE(Stamps15), 0, 0 }
+#endif
+#if NUM_SERVICES > 16
+  , { Stamps16, ARRAY_SIZE(Stamps16), 0, 0 }
+#endif
+#if NUM_SERVICES > 17
+  , { Stamps17, ARRAY_SIZE(Stamps17), 0, 0 }
+#endif
+#if NUM_SERVICES > 18
+  , { Stamps18, ARRAY_SIZE(Stamps18), 0, 0 }
+#endif
+#if NUM_SERVICES > 19
+  , { Stamps19, ARRAY_SIZE(Stamps19), 0, 0 }
+#endif
+#if NUM_SERVICES > 20
+  , { Stamps20, ARRAY_SIZE(Stamps20), 0, 0 }
+#endif
+#if NUM_SERVICES > 21
+  , { Stamps21, ARRAY_SIZE(Stamps21), 0, 0 }
+#endif
+#if NUM_SERVICES > 22
+  , { Stamps22, ARRAY_SIZE(Stamps22), 0, 0 }
+#endif
+#if NUM_SERVICES > 23
+  , { Stamps23, ARRAY_SIZE(Stamps23), 0, 0 }
+#endif
+#if NUM_SERVICES > 24
+  , { Stamps24, ARRAY_SIZE(Stamps24), 0, 0 }
+#endif
+#if NUM_SERVICES > 25
+  , { Stamps25, ARRAY_SIZE(Stamps25), 0, 0 }
+#endif
+#if NUM_SERVICES > 26
+  , { Stamps26, ARRAY_SIZE(Stamps26), 0, 0 }
+#endif
+#if NUM_SERVICES > 27
+  , { Stamps27, ARRAY_SIZE(Stamps27), 0, 0 }
+#endif
+#if NUM_SERVICES > 28
+  , { Stamps28, ARRAY_SIZE(Stamps28), 0, 0 }
+#endif
+#if NUM_SERVICES > 29
+  , { Stamps29, ARRAY_SIZE(Stamps29), 0, 0 }
+#endif
+#if NUM_SERVICES > 30
+  , { Stamps30, ARRAY_SIZE(Stamps30), 0, 0 }
+#endif
+#if NUM_SERVICES > 31
+  , { Stamps31, ARRAY_SIZE(Stamps31), 0, 0 }
+#endif
+#if NUM_SERVICES > 32
+  , { Stamps32, ARRAY_SIZE(Stamps32), 0, 0 }
+#endif
+#if NUM_SERVICES > 33
+  , { Stamps33, ARRAY_SIZE(Stamps33), 0, 0 }
+#endif
+#if NUM_SERVICES > 34
+  , { Stamps34, ARRAY_SIZE(Stamps34), 0, 0 }
+#endif
+#if NUM_SERVICES > 35
+  , { Stamps35, ARRAY_SIZE(Stamps35), 0, 0 }
+#endif
+#if NUM_SERVICES > 36
+  , { Stamps36, ARRAY_SIZE(Stamps36), 0, 0 }
+#endif
+#if NUM_SERVICES > 37
+  , { Stamps37, ARRAY_SIZE(Stamps37), 0, 0 }
+#endif
+#if NUM_SERVICES > 38
+  , { Stamps38, ARRAY_SIZE(Stamps38), 0, 0 }
+#endif
+#if NUM_SERVICES > 39
+  , { Stamps39, ARRAY_SIZE(Stamps39), 0, 0 }
+#endif
+#if NUM_SERVICES > 40
+  , { Stamps40, ARRAY_SIZE(Stamps40), 0, 0 }
+#endif
+#if NUM_SERVICES > 41
+  , { Stamps41, ARRAY_SIZE(Stamps41), 0, 0 }
+#endif
+#if NUM_SERVICES > 42
+  , { Stamps42, ARRAY_SIZE(Stamps42), 0, 0 }
+#endif
+#if NUM_SERVICES > 43
+  , { Stamps43, ARRAY_SIZE(Stamps43), 0, 0 }
+#endif
+#if NUM_SERVICES > 44
+  , { Stamps44, ARRAY_SIZE(Stamps44), 0, 0 }
+#endif
+#if NUM_SERVICES > 45
+  , { Stamps45, ARRAY_SIZE(Stamps45), 0, 0 }
+#endif
+#if NUM_SERVICES > 46
+  , { Stamps46, ARRAY_SIZE(Stamps46), 0, 0 }
+#endif
+#if NUM_SERVICES > 47
+  , { Stamps47, ARRAY_SIZE(Stamps47), 0, 0 }
+#endif
+#if NUM_SERVICES > 48
+  , { Stamps48, ARRAY_SIZE(Stamps48), 0, 0 }
+#endif
+#if NUM_SERVICES > 49
+  , { Stamps49, ARRAY_SIZE(Stamps49), 0, 0 }
+#endif
+#if NUM_SERVICES > 50
+  , { Stamps50, ARRAY_SIZE(Stamps50), 0, 0 }
+#endif
+#if NUM_SERVICES > 51
+  , { Stamps51, ARRAY_SIZE(Stamps51), 0, 0 }
+#endif
+#if NUM_SERVICES > 52
+  , { Stamps52, ARRAY_SIZE(Stamps52), 0, 0 }
+#endif
+#if NUM_SERVICES > 53
+  , { Stamps53, ARRAY_SIZE(Stamps53), 0, 0 }
+#endif
+#if NUM_SERVICES > 54
+  , { Stamps54, ARRAY_SIZE(Stamps54), 0, 0 }
+#endif
+#if NUM_SERVICES > 55
+  , { Stamps55, ARRAY_SIZE(Stamps55), 0, 0 }
+#endif
+#if NUM_SERVICES > 56
+  , { Stamps56, ARRAY_SIZE(Stamps56), 0, 0 }
+#endif
+#if NUM_SERVICES > 57
+  , { Stamps57, ARRAY_SIZE(Stamps57), 0, 0 }
+#endif
+#if NUM_SERVICES > 58
+  , { Stamps58, ARRAY_SIZE(Stamps58), 0, 0 }
+#endif
+#if NUM_SERVICES > 59
+  , { Stamps59, ARRAY_SIZE(Stamps59), 0, 0 }
+#endif
+#if NUM_SERVICES > 60
+  , { Stamps60, ARRAY_SIZE(Stamps60), 0, 0 }
+#endif
+#if NUM_SERVICES > 61
+  , { Stamps61, ARRAY_SIZE(Stamps61), 0, 0 }
+#endif
+#if NUM_SERVICES > 62
+  , { Stamps62, ARRAY_SIZE(Stamps62), 0, 0 }
+#endif
+#if NUM_SERVICES > 63
+  , { Stamps63, ARRAY_SIZE(Stamps63), 0, 0 }
+#endif
+};
+
+static ES_QueueStats_t QueueStats[NUM_SERVICES];
+// broadcast copies that were not queued because the service didn't subscribe
+static uint32_t SkippedBroadcasts;
+// broadcasts that went to nobody because one of the targets was full
+static uint32_t RefusedBroadcasts;
+#endif
+
+/****************************************************************************/
+// Variables used to keep track of which queues have events in them.
+// This is a two level bitmap: each bit in ReadyTable represents one service
+// and each bit in ReadyGroups shows that the corresponding word of ReadyTable
+// is non-zero. Finding the highest priority ready service takes two
+// count-leading-zeros operations no matter how many services there are.
+
+static uint32_t ReadyGroups;
+static uint32_t ReadyTable[NUM_READY_GROUPS];
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_Initialize
+ Parameters
+   TimerRate_t the rate at which to initialize the framework timer subsystem
+ Returns
+   ES_Return_t : FailedPointer if any of the function pointers are NULL
+                 FailedInit if any of the initialization functions failed
+ Description
+   Initialize all the services and tests for NULL pointers in the array
+ Notes
+
+ Author
+   J. Edward Carryer, 10/23/11,
+****************************************************************************/
+ES_Return_t ES_Initialize(TimerRate_t NewRate)
+{
+  uint8_t i;
+  ES_Timer_Init(NewRate);  // start up the timer subsystem
+#ifdef ES_INPUT_LOG
+  ES_Input_Init();  // before the inits, which read their inputs
+#endif
+  // loop through the list testing for NULL pointers and
+  for (i = 0; i < ARRAY_SIZE(ServDescList); i++)
+  {
+    if ((ServDescList[i].InitFunc == (pInitFunc)0) ||
+        (ServDescList[i].RunFunc == (pRunFunc)0))
+    {
+      return FailedPointer; // protect against NULL pointers
+    }
+    // and initializing the event queues (must happen before running inits)
+    ES_Ring_Init(&EventRings[i], EventQueues[i].pMem, EventQueues[i].Size);
+    ES_Ring_SetPolicy(&EventRings[i], QueuePolicies[i]);
+    // executing the init functions
+    if (ServDescList[i].InitFunc(i) != true)
+    {
+      return FailedInit; // this is a failed initialization
+    }
+  }
+#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
+  _HW_DebugLines_Init();
+#endif
+  return Success;
+}
+
+/****************************************************************************
+ Function
+   ES_Run
+ Parameters
+   None
+ Returns
+   ES_Return_t : FailedRun is any of the run functions failed during execution
+ Description
+   This is the main framework function. It searches through the services
+   to find one with a non-empty queue and then executes the
+   service to process the events in its queue, up to the service's batch
+   budget, before pending interrupts are processed and the search repeats.
+   while all the queues are empty, it searches for system generated or
+   user generated events or moves bytes from buffer to UART.
+ Notes
+   this function only returns in case of an error
+   events posted by a service to itself during a batch are dispatched in
+   the same batch, which is what makes the budget pay off for self-posted
+   continuation events. A service's continuation (see ES_ContinueService)
+   is dispatched after everything in its queue.
+ Author
+   J. Edward Carryer, 10/23/11,
+****************************************************************************/
+ES_Return_t ES_Run(void)
+{
+  // make these static to improve speed
+  uint8_t         HighestPrior;
+  uint8_t         NumDispatched;
+  static ES_Event_t ThisEvent;
+  ES_Event_t      RunResult;
+#ifdef ES_PROFILER
+  uint32_t        ProfileStart;
+#endif
+
+  while (1)  // stay here unless we detect an error condition
+  { // loop through the list executing the run functions for services
+    // with a non-empty queue. Process any pending ints before testing
+    // Ready
+    while ((_HW_Process_Pending_Ints()) && (ReadyGroups != 0))
+    {
+      HighestPrior  = GetHighestReady();
+      NumDispatched = 0;
+      do
+      {
+        if (!ES_Ring_IsEmpty(&EventRings[HighestPrior]))
+        {
+          if ((ES_Ring_DeQueue(&EventRings[HighestPrior], &ThisEvent) == 0) &&
+              (Continuations[HighestPrior].EventType == ES_NO_EVENT))
+          {
+            ClearReady(HighestPrior); // mark queue as now empty
+          }
+          RecordDispatch(HighestPrior);
+        }
+        else  // all that is left is the continuation
+        {
+          ThisEvent = Continuations[HighestPrior];
+          Continuations[HighestPrior].EventType = ES_NO_EVENT;
+          ClearReady(HighestPrior);
+        }
+#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
+        _HW_DebugSetLine1();
+#endif
+        if (ThisEvent.EventType == ES_TIMEOUT)
+        {
+          // a periodic timer may post its next timeout now, if this is the
+          // one it posted
+          ES_Timer_TimeoutHandled((uint8_t)ThisEvent.EventParam, HighestPrior);
+        }
+        ES_TRACE_EVENT(ES_TRACE_RUN_START, HighestPrior, ThisEvent);
+        ES_TRACE_SET_FROM(HighestPrior);
+#ifdef ES_PROFILER
+        ProfileStart = _HW_GetCoreTicks();
+#endif
+        RunResult = ServDescList[HighestPrior].RunFunc(ThisEvent);
+#ifdef ES_PROFILER
+        ES_Profile_RecordRun(HighestPrior, ThisEvent.EventType,
+            _HW_GetCoreTicks() - ProfileStart);
+#endif
+        ES_TRACE_SET_FROM(ES_TRACE_FROM_MAIN);
+        ES_TRACE_EVENT(ES_TRACE_RUN_END, HighestPrior, ThisEvent);
+        if (RunResult.EventType != ES_NO_EVENT)
+        {
+          return FailedRun;
+        }
+#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
+        _HW_DebugClearLine1();
+#endif
+        // keep going on this service until it has nothing left or the budget
+        // is used
+      } while ((++NumDispatched < BatchBudget[HighestPrior]) &&
+               IsReady(HighestPrior));
+    }
+
+#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
+    _HW_DebugSetLine2();
+#endif
+    // all the queues are empty, so look for new user detected events
+    if (!ES_CheckUserEvents()) // no new user events
+    {
+#ifdef ES_PROFILER
+      ES_Profile_DumpStep(); // add to the profile dump if one is under way
+#endif
+#ifdef ES_TRACER
+      ES_Trace_DumpStep(); // and to the trace dump
+#endif
+#ifdef ES_INPUT_RECORD
+      ES_Input_DumpStep(); // and to the input log dump
+#endif
+      Terminal_MoveBuffer2UART(); // try moving bytes, if available, to UART
+      _HW_Idle(); // nothing to do until the next tick or input
+    }
+#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
+    _HW_DebugClearLine2();
+#endif
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_PostAll
+ Parameters
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if the event could not be posted, in which case no
+   service got it
+ Description
+   posts to all of the services' queues
+ Notes
+   services that have not subscribed to this type of event are skipped.
+   Delivery is all-or-nothing: if any subscriber's queue is full, none of
+   them get the event
+ Author
+   J. Edward Carryer, 01/15/12,
+****************************************************************************/
+bool ES_PostAll(ES_Event_t ThisEvent)
+{
+  uint8_t i;
+
+  for (i = 0; i < NUM_READY_GROUPS; i++)
+  {
+    BroadcastTargets[i] = 0;
+  }
+  // every service that wants it is a target
+  for (i = 0; i < ARRAY_SIZE(EventQueues); i++)
+  {
+    AddBroadcastTarget(i, ThisEvent);
+  }
+  return DeliverBroadcast();
+}
+
+/****************************************************************************
+ Function
+   ES_PostToService
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if the post function failed during execution
+ Description
+   posts to one of the services' queues, following its overflow policy
+ Notes
+   used by the timer library to associate a timer with a state machine.
+   Between ES_BeginBroadcast and ES_EndBroadcast, it only notes the service
+   as a target
+ Author
+   J. Edward Carryer, 01/16/12,
+****************************************************************************/
+bool ES_PostToService(uint8_t WhichService, ES_Event_t TheEvent)
+{
+  if (Broadcasting && (WhichService < ARRAY_SIZE(EventQueues)))
+  {
+    AddBroadcastTarget(WhichService, TheEvent);
+    return true;  // a skipped service is not a failure
+  }
+  if (WhichService < ARRAY_SIZE(EventQueues))
+  {
+    return PostFIFO(WhichService, TheEvent);
+  }
+  else
+  {
+    RecordOverflow(WhichService);
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_PostToServiceLIFO
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if the post function failed during execution
+ Description
+   Posts, using LIFO strategy, to one of the services' queues
+ Notes
+   used by the Defer/Recall event capability
+ Author
+   J. Edward Carryer, 11/02/13
+****************************************************************************/
+bool ES_PostToServiceLIFO(uint8_t WhichService, ES_Event_t TheEvent)
+{
+  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
+      (ES_Ring_EnQueueLIFO(&EventRings[WhichService], TheEvent) ==
+        true))
+  {
+    ES_TRACE_EVENT(ES_TRACE_POST_LIFO, WhichService, TheEvent);
+    RecordPost(WhichService, true);
+    SetReady(WhichService); // show queue as non-empty
+    return true;
+  }
+  else
+  {
+    ES_TRACE_EVENT(ES_TRACE_REFUSED, WhichService, TheEvent);
+    RecordOverflow(WhichService);
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_PostToServiceLIFOBulk
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   const ES_Event_t * : The Events to be posted
+   uint16_t : how many there are
+ Returns
+   uint16_t : the number of events posted
+ Description
+   Posts the events to the front of one of the services' queues in order,
+   so the first of them is the next to be dispatched, as calling
+   ES_PostToServiceLIFO for them last to first would. Stops when the queue
+   is full, so only the last of them get in
+ Notes
+   used by ES_RecallEvents to move deferred events in one go. Each event
+   that does not fit counts as an overflow
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint16_t ES_PostToServiceLIFOBulk(uint8_t WhichService,
+    const ES_Event_t *pEvents, uint16_t NumEvents)
+{
+  uint16_t NumPosted = 0;
+  uint16_t i;
+
+  if (WhichService < ARRAY_SIZE(EventQueues))
+  {
+    NumPosted = ES_EnQueueBulkLIFO(&EventRings[WhichService], pEvents,
+        NumEvents);
+    for (i = NumEvents - NumPosted; i < NumEvents; i++)
+    {
+      ES_TRACE_EVENT(ES_TRACE_POST_LIFO, WhichService, pEvents[i]);
+      RecordPost(WhichService, true);
+    }
+    if (NumPosted != 0)
+    {
+      SetReady(WhichService); // show queue as non-empty
+    }
+  }
+  for (i = 0; i < NumEvents - NumPosted; i++)
+  {
+    ES_TRACE_EVENT(ES_TRACE_REFUSED, WhichService, pEvents[i]);
+    RecordOverflow(WhichService);
+  }
+  return NumPosted;
+}
+
+/****************************************************************************
+ Function
+   ES_ContinueService
+ Parameters
+   uint8_t : Which service to continue (index into ServDescList)
+   ES_Event : The Event to be dispatched to it
+ Returns
+   boolean : False if the service does not exist
+ Description
+   asks for TheEvent to be dispatched to the service after the events now
+   in its queue, without using a queue slot. This is the way for a service
+   to take the next step of a multi-step job, instead of posting to itself
+ Notes
+   each service has room for one continuation; a second call before it is
+   dispatched replaces the first. Only call it from the main loop
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_ContinueService(uint8_t WhichService, ES_Event_t TheEvent)
+{
+  if (WhichService < ARRAY_SIZE(Continuations))
+  {
+    ES_TRACE_EVENT(ES_TRACE_CONTINUE, WhichService, TheEvent);
+    Continuations[WhichService] = TheEvent;
+    SetReady(WhichService);
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_SetBatchBudget
+ Parameters
+   uint8_t : Which service to change (index into ServDescList)
+   uint8_t : the new maximum number of events to dispatch in a row
+ Returns
+   boolean : False if the service does not exist or the budget is 0
+ Description
+   changes the number of events that ES_Run will dispatch from this service's
+   queue before it processes pending interrupts and re-scans for the highest
+   priority ready service
+ Notes
+   the starting value comes from SERV_n_BATCH_SIZE in ES_Configure.h
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_SetBatchBudget(uint8_t WhichService, uint8_t NewBudget)
+{
+  if ((WhichService < ARRAY_SIZE(BatchBudget)) && (NewBudget != 0))
+  {
+    BatchBudget[WhichService] = NewBudget;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_SetSubscriptions
+ Parameters
+   uint8_t : Which service to change (index into ServDescList)
+   ES_EventMask_t : the event types it should get from broadcasts
+ Returns
+   boolean : False if the service does not exist
+ Description
+   replaces the service's broadcast subscriptions
+ Notes
+   the starting value comes from SERV_n_SUBSCRIBES in ES_Configure.h
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_SetSubscriptions(uint8_t WhichService, ES_EventMask_t NewMask)
+{
+  if (WhichService < ARRAY_SIZE(Subscriptions))
+  {
+    Subscriptions[WhichService] = NewMask;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_AddSubscriptions
+ Parameters
+   uint8_t : Which service to change (index into ServDescList)
+   ES_EventMask_t : more event types it should get from broadcasts
+ Returns
+   boolean : False if the service does not exist
+ Description
+   adds to the service's broadcast subscriptions, typically from its init
+   function, e.g. ES_AddSubscriptions(MyPriority, ES_EVENT_BIT(ES_NEW_KEY))
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_AddSubscriptions(uint8_t WhichService, ES_EventMask_t MoreEvents)
+{
+  if (WhichService < ARRAY_SIZE(Subscriptions))
+  {
+    Subscriptions[WhichService] |= MoreEvents;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_BeginBroadcast
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   until ES_EndBroadcast, posts through ES_PostToService are treated as
+   broadcasts: services that have not subscribed are dropped and the rest
+   are collected as targets, to be posted by ES_EndBroadcast
+ Notes
+   used by the ES_PostListxx functions, whose lists hold post functions
+   rather than service numbers. Only call it from the main loop. With
+   POST_FROM_INTS, interrupts stay off until ES_EndBroadcast, so that an
+   ISR's post to a service is not collected as a target
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_BeginBroadcast(void)
+{
+  uint8_t i;
+
+#ifdef POST_FROM_INTS
+  BroadcastIntState = ES_IntsOff();
+#endif
+  for (i = 0; i < NUM_READY_GROUPS; i++)
+  {
+    BroadcastTargets[i] = 0;
+  }
+  Broadcasting = true;
+}
+
+/****************************************************************************
+ Function
+   ES_EndBroadcast
+ Parameters
+   bool : true to deliver the broadcast, false to abandon it
+ Returns
+   boolean : true if every target got the event (or there were none), false
+   if it was abandoned or a target's queue was full, in which case no
+   target got it
+ Description
+   posts the event to all of the targets collected since ES_BeginBroadcast
+   and returns ES_PostToService to delivering every post
+ Notes
+   a service listed more than once gets one copy
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_EndBroadcast(bool Deliver)
+{
+  Broadcasting = false;
+#ifdef POST_FROM_INTS
+  ES_IntsRestore(BroadcastIntState);
+#endif
+  if (Deliver)
+  {
+    return DeliverBroadcast();
+  }
+  else
+  {
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_TakeTimeoutTarget
+ Parameters
+   None
+ Returns
+   uint8_t : the service whose queue took the first ES_TIMEOUT posted since
+   the last call, or ES_NO_SERVICE if none was
+ Description
+   reports where an ES_TIMEOUT went and starts looking for the next one
+ Notes
+   the timer module calls this around posting a periodic timer's timeout,
+   so that only that service's dispatch of it counts as handling it. ISRs
+   don't post ES_TIMEOUT, so their posts can't be taken for the timer's
+ Author
+   agt, 10/18/26
+****************************************************************************/
+uint8_t ES_TakeTimeoutTarget(void)
+{
+  uint8_t Target = TimeoutTarget;
+
+  TimeoutTarget = ES_NO_SERVICE;
+  return Target;
+}
 
+#ifdef ES_QUEUE_TELEMETRY
+/****************************************************************************
+ Function
+   ES_GetSkippedBroadcasts
+ Parameters
+   None
+ Returns
+   uint32_t : the number of broadcast copies that were not queued
+ Description
+   each one is a dispatch saved by the subscriptions
+ Notes
+   only present when ES_QUEUE_TELEMETRY is defined
  Author
-   J. Edward Carryer, 01/15/12,
+   agt, 10/17/26
 ****************************************************************************/
-bool ES_PostAll(ES_Event_t ThisEvent)
+uint32_t ES_GetSkippedBroadcasts(void)
+{
+  return SkippedBroadcasts;
+}
+
+/****************************************************************************
+ Function
+   ES_GetQueueStats
+ Parameters
+   uint8_t : Which service's queue to report on
+   ES_QueueStats_t * : where to copy the telemetry
+ Returns
+   boolean : False if the service does not exist
+ Description
+   copies the telemetry gathered for the service's queue since startup or
+   the last call to ES_ResetQueueStats
+ Notes
+   only present when ES_QUEUE_TELEMETRY is defined
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_GetQueueStats(uint8_t WhichService, ES_QueueStats_t *pStats)
+{
+  uint32_t IntState;
+
+  if (WhichService < ARRAY_SIZE(QueueStats))
+  {
+    IntState = StatsIntsOff();
+    *pStats = QueueStats[WhichService];
+    StatsIntsRestore(IntState);
+    pStats->QueueSize = StampRings[WhichService].Size;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_ResetQueueStats
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   clears the telemetry for all of the queues. The high-water marks restart
+   from the number of events waiting right now
+ Notes
+   only present when ES_QUEUE_TELEMETRY is defined
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_ResetQueueStats(void)
+{
+  uint8_t   i;
+  uint32_t  IntState;
+
+  for (i = 0; i < ARRAY_SIZE(QueueStats); i++)
+  {
+    IntState = StatsIntsOff();
+    QueueStats[i].HighWater     = StampRings[i].NumStamps;
+    QueueStats[i].Overflows     = 0;
+    QueueStats[i].NumDispatched = 0;
+    QueueStats[i].MaxWait       = 0;
+    QueueStats[i].TotalWait     = 0;
+    StatsIntsRestore(IntState);
+  }
+  SkippedBroadcasts = 0;
+  RefusedBroadcasts = 0;
+}
+
+/****************************************************************************
+ Function
+   ES_DumpQueueStats
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   prints the telemetry for every queue to the terminal, one line per
+   service, with the wait times converted to microseconds
+ Notes
+   only present when ES_QUEUE_TELEMETRY is defined. The output goes through
+   the terminal buffer, so dump from a run function, not from an ISR
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_DumpQueueStats(void)
+{
+  uint8_t         i;
+  ES_QueueStats_t Stats;
+  uint32_t        MeanWait;
+
+  DB_printf("\r\nQueue telemetry (waits in us)\r\n");
+  for (i = 0; i < ARRAY_SIZE(QueueStats); i++)
+  {
+    ES_GetQueueStats(i, &Stats);
+    MeanWait = 0;
+    if (Stats.NumDispatched != 0)
+    {
+      MeanWait = (uint32_t)(Stats.TotalWait / Stats.NumDispatched);
+    }
+    DB_printf("Svc %d: depth %d/%d, overflows %u, events %u, "
+        "wait mean %u max %u\r\n", i, Stats.HighWater, Stats.QueueSize,
+        Stats.Overflows, Stats.NumDispatched,
+        MeanWait / ES_CORE_TICKS_PER_US, Stats.MaxWait / ES_CORE_TICKS_PER_US);
+  }
+  DB_printf("broadcast copies skipped: %u, broadcasts refused: %u\r\n",
+      SkippedBroadcasts, RefusedBroadcasts);
+}
+#endif
+
+//*********************************
+// private functions
+//*********************************
+/****************************************************************************
+ Function
+   SetReady
+ Parameters
+   uint8_t : Which service has a non-empty queue
+ Returns
+   nothing
+ Description
+   marks the service as ready in both levels of the Ready bitmap
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static inline void SetReady(uint8_t WhichService)
+{
+  ReadyTable[WhichService >> GROUP_SHIFT] |=
+      ((uint32_t)1 << (WhichService & SERVICE_IN_GROUP_MASK));
+  ReadyGroups |= ((uint32_t)1 << (WhichService >> GROUP_SHIFT));
+}
+
+/****************************************************************************
+ Function
+   ClearReady
+ Parameters
+   uint8_t : Which service now has an empty queue
+ Returns
+   nothing
+ Description
+   clears the service's bit in ReadyTable and, if that leaves the group
+   empty, the group's bit in ReadyGroups
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static inline void ClearReady(uint8_t WhichService)
+{
+  uint8_t WhichGroup = WhichService >> GROUP_SHIFT;
+
+  ReadyTable[WhichGroup] &=
+      ~((uint32_t)1 << (WhichService & SERVICE_IN_GROUP_MASK));
+  if (ReadyTable[WhichGroup] == 0)
+  {
+    ReadyGroups &= ~((uint32_t)1 << WhichGroup);
+  }
+}
+
+/****************************************************************************
+ Function
+   GetHighestReady
+ Parameters
+   None
+ Returns
+   uint8_t : the number of the highest priority service with a non-empty queue
+ Description
+   finds the highest numbered group with a ready service, then the highest
+   numbered service in that group
+ Notes
+   ReadyGroups must be non-zero when this is called
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static inline uint8_t GetHighestReady(void)
+{
+#if NUM_READY_GROUPS == 1
+  return ES_GetMSBitSet32(ReadyTable[0]);
+#else
+  uint8_t WhichGroup = ES_GetMSBitSet32(ReadyGroups);
+
+  return (WhichGroup << GROUP_SHIFT) + ES_GetMSBitSet32(ReadyTable[WhichGroup]);
+#endif
+}
+
+/****************************************************************************
+ Function
+   IsSubscribed
+ Parameters
+   uint8_t : Which service (must exist)
+   uint16_t : the type of event being broadcast
+ Returns
+   bool : true if the service wants broadcasts of this type
+ Description
+   tests the service's bit for this event type. Types without a bit are
+   always wanted
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static inline bool IsSubscribed(uint8_t WhichService, uint16_t EventType)
+{
+  return (EventType >= ES_NUM_MASKED_EVENTS) ||
+         ((Subscriptions[WhichService] & ES_EVENT_BIT(EventType)) != 0);
+}
+
+/****************************************************************************
+ Function
+   AddBroadcastTarget
+ Parameters
+   uint8_t : Which service (must exist)
+   ES_Event : The Event being broadcast
+ Returns
+   nothing
+ Description
+   notes the service as a target of the broadcast if it has subscribed to
+   this type of event
+ Notes
+   DeliverBroadcast does the posting, once it knows there is room
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void AddBroadcastTarget(uint8_t WhichService, ES_Event_t TheEvent)
+{
+  if (IsSubscribed(WhichService, TheEvent.EventType))
+  {
+    BroadcastTargets[WhichService >> GROUP_SHIFT] |=
+        ((uint32_t)1 << (WhichService & SERVICE_IN_GROUP_MASK));
+    BroadcastEvent = TheEvent;
+  }
+  else
+  {
+    RecordSkip();
+  }
+}
+
+/****************************************************************************
+ Function
+   DeliverBroadcast
+ Parameters
+   None
+ Returns
+   bool : false if a target's queue was full, in which case nothing was posted
+ Description
+   checks that every queue in BroadcastTargets has room, then posts
+   BroadcastEvent to all of them
+ Notes
+   only ISRs could post between the check and the posts, and they go through
+   the mailboxes, so the room can't be taken away. With POST_FROM_INTS an
+   ISR that posts directly can fill a queue in between, and then that
+   target misses the event while the others get it
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static bool DeliverBroadcast(void)
 {
   uint8_t i;
-  // loop through the list executing the post functions
+
+  // first pass: make sure that nobody will refuse it
   for (i = 0; i < ARRAY_SIZE(EventQueues); i++)
   {
-    if (ES_EnQueueFIFO(EventQueues[i].pMem, ThisEvent) != true)
+    if ((BroadcastTargets[i >> GROUP_SHIFT] &
+        ((uint32_t)1 << (i & SERVICE_IN_GROUP_MASK))) &&
+        !ES_Ring_CanEnQueueFIFO(&EventRings[i], BroadcastEvent))
     {
-      break; // this is a failed post
+      RecordOverflow(i);
+      RecordRefusal();
+      return false;
     }
-    else
+  }
+  // second pass: these can't fail
+  for (i = 0; i < ARRAY_SIZE(EventQueues); i++)
+  {
+    if (BroadcastTargets[i >> GROUP_SHIFT] &
+        ((uint32_t)1 << (i & SERVICE_IN_GROUP_MASK)))
     {
-      Ready |= BitNum2SetMask[i]; // show queue as non-empty
+      PostFIFO(i, BroadcastEvent);
     }
   }
-  if (i == ARRAY_SIZE(EventQueues))    // if no failures
+  return true;
+}
+
+/****************************************************************************
+ Function
+   PostFIFO
+ Parameters
+   uint8_t : Which service (must exist)
+   ES_Event : The Event to be posted
+ Returns
+   bool : false if the queue refused the event
+ Description
+   posts to the end of the service's queue under its overflow policy and
+   keeps the Ready bitmap and the telemetry up to date
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static bool PostFIFO(uint8_t WhichService, ES_Event_t TheEvent)
+{
+  switch (ES_Ring_EnQueueFIFO(&EventRings[WhichService], TheEvent))
   {
-    return true;
+    case ES_ENQUEUE_DROPPED_OLDEST:
+    {
+      ES_TRACE_EVENT(ES_TRACE_POST_DROP, WhichService, TheEvent);
+      RecordDrop(WhichService);
+      RecordPost(WhichService, false);
+      SetReady(WhichService); // show queue as non-empty
+    }
+    break;
+    case ES_ENQUEUE_ADDED:
+    {
+      ES_TRACE_EVENT(ES_TRACE_POST, WhichService, TheEvent);
+      RecordPost(WhichService, false);
+      SetReady(WhichService); // show queue as non-empty
+    }
+    break;
+    case ES_ENQUEUE_COALESCED:
+    { // the identical event that is waiting stands in for it
+      ES_TRACE_EVENT(ES_TRACE_COALESCED, WhichService, TheEvent);
+    }
+    break;
+    default:
+    {
+      ES_TRACE_EVENT(ES_TRACE_REFUSED, WhichService, TheEvent);
+      RecordOverflow(WhichService);
+      return false;
+    }
   }
-  else
+  if ((TheEvent.EventType == ES_TIMEOUT) && (TimeoutTarget == ES_NO_SERVICE))
   {
-    return false;
+    TimeoutTarget = WhichService;
   }
+  return true;
 }
 
 /****************************************************************************
  Function
-   ES_PostToService
+   IsReady
  Parameters
-   uint8_t : Which service to post to (index into ServDescList)
-   ES_Event : The Event to be posted
+   uint8_t : Which service (must exist)
  Returns
-   boolean : False if the post function failed during execution
+   bool : true if the service has events in its queue or a continuation
  Description
-   posts to one of the services' queues
+   tests the service's bit in ReadyTable
  Notes
-   used by the timer library to associate a timer with a state machine
+
  Author
-   J. Edward Carryer, 01/16/12,
+   agt, 10/17/26
 ****************************************************************************/
-bool ES_PostToService(uint8_t WhichService, ES_Event_t TheEvent)
+static inline bool IsReady(uint8_t WhichService)
 {
-  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
-      (ES_EnQueueFIFO(EventQueues[WhichService].pMem, TheEvent) ==
-        true))
+  return (ReadyTable[WhichService >> GROUP_SHIFT] &
+         ((uint32_t)1 << (WhichService & SERVICE_IN_GROUP_MASK))) != 0;
+}
+
+#ifdef ES_QUEUE_TELEMETRY
+/****************************************************************************
+ Function
+   RecordPost
+ Parameters
+   uint8_t : Which service's queue just accepted an event
+   bool : true if the event went in at the front (LIFO)
+ Returns
+   nothing
+ Description
+   time stamps the new entry and updates the queue's high-water mark
+ Notes
+   called from an ISR only with POST_FROM_INTS
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void RecordPost(uint8_t WhichService, bool AtFront)
+{
+  StampRing_t *pRing = &StampRings[WhichService];
+  uint32_t    IntState;
+
+  IntState = StatsIntsOff();
+  if (AtFront)
   {
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
-    return true;
+    pRing->Oldest = (pRing->Oldest == 0) ? pRing->Size - 1 : pRing->Oldest - 1;
+    pRing->pStamps[pRing->Oldest] = _HW_GetCoreTicks();
   }
   else
   {
-    return false;
+    pRing->pStamps[(pRing->Oldest + pRing->NumStamps) % pRing->Size] =
+        _HW_GetCoreTicks();
+  }
+  pRing->NumStamps++;
+  if (pRing->NumStamps > QueueStats[WhichService].HighWater)
+  {
+    QueueStats[WhichService].HighWater = pRing->NumStamps;
   }
+  StatsIntsRestore(IntState);
 }
 
 /****************************************************************************
  Function
-   ES_PostToServiceLIFO
+   RecordOverflow
  Parameters
-   uint8_t : Which service to post to (index into ServDescList)
-   ES_Event : The Event to be posted
+   uint8_t : Which service's queue rejected an event
  Returns
-   boolean : False if the post function failed during execution
+   nothing
  Description
-   Posts, using LIFO strategy, to one of the services' queues
+   counts the rejected post, stopping at the largest count rather than
+   wrapping back to 0
  Notes
-   used by the Defer/Recall event capability
+   also called for posts to services that do not exist, which are ignored
  Author
-   J. Edward Carryer, 11/02/13
+   agt, 10/17/26
 ****************************************************************************/
-bool ES_PostToServiceLIFO(uint8_t WhichService, ES_Event_t TheEvent)
+static void RecordOverflow(uint8_t WhichService)
 {
-  if ((WhichService < ARRAY_SIZE(EventQueues)) &&
-      (ES_EnQueueLIFO(EventQueues[WhichService].pMem, TheEvent) ==
-        true))
+  uint32_t IntState;
+
+  if (WhichService < ARRAY_SIZE(QueueStats))
   {
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
-    return true;
+    IntState = StatsIntsOff();
+    if (QueueStats[WhichService].Overflows != UINT16_MAX)
+    {
+      QueueStats[WhichService].Overflows++;
+    }
+    StatsIntsRestore(IntState);
   }
-  else
+}
+
+/****************************************************************************
+ Function
+   RecordDispatch
+ Parameters
+   uint8_t : Which service's queue just gave up its oldest event
+ Returns
+   nothing
+ Description
+   retires the time stamp of the dequeued event and accumulates its wait
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void RecordDispatch(uint8_t WhichService)
+{
+  StampRing_t     *pRing  = &StampRings[WhichService];
+  ES_QueueStats_t *pStats = &QueueStats[WhichService];
+  uint32_t        Wait;
+  uint32_t        IntState;
+
+  IntState = StatsIntsOff();
+  Wait = _HW_GetCoreTicks() - pRing->pStamps[pRing->Oldest];
+  if (++pRing->Oldest >= pRing->Size)
   {
-    return false;
+    pRing->Oldest = 0;
+  }
+  pRing->NumStamps--;
+  StatsIntsRestore(IntState);
+
+  pStats->NumDispatched++;
+  pStats->TotalWait += Wait;
+  if (Wait > pStats->MaxWait)
+  {
+    pStats->MaxWait = Wait;
   }
 }
 
-//*********************************
-// private functions
-//*********************************
+/****************************************************************************
+ Function
+   RecordDrop
+ Parameters
+   uint8_t : Which service's queue just threw away its oldest event
+ Returns
+   nothing
+ Description
+   retires the time stamp of the lost event and counts it as an overflow
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void RecordDrop(uint8_t WhichService)
+{
+  StampRing_t *pRing = &StampRings[WhichService];
+  uint32_t    IntState;
+
+  IntState = StatsIntsOff();
+  if (++pRing->Oldest >= pRing->Size)
+  {
+    pRing->Oldest = 0;
+  }
+  pRing->NumStamps--;
+  StatsIntsRestore(IntState);
+  RecordOverflow(WhichService);
+}
+#endif
+
 #if 0
 /****************************************************************************
  Function
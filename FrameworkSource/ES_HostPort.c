@@ -0,0 +1,615 @@
+/****************************************************************************
+ Module
+   ES_HostPort.c
+
+ Revision
+   1.0.1
+
+ Description
+   A Linux host port of the hardware specific functions of the framework,
+   with a virtual clock, so that the services can be run on a PC faster
+   than real time.
+ Notes
+   A host build compiles this file in place of ES_Port.c and terminal.c.
+   The project modules that touch the PIC32 registers build against the
+   register model in HostSim (xc.h and PIC32Sim.c).
+
+   Time is counted in virtual ticks of the length passed to ES_Initialize.
+   The tick count only moves in _HW_Idle, which ES_Run calls when every
+   queue is empty and no event checker found anything, so run functions take
+   no simulated time. From there it jumps straight to the next timer
+   deadline, or to the time of the next scripted key if that is sooner.
+
+   Terminal output goes to stdout. Where the input comes from depends on
+   stdin:
+   - a terminal: keys are taken as they are typed and the virtual clock is
+     held to the wall clock, so the game can be played by hand
+   - a file or a pipe: a script, run as fast as possible. Each line is a
+     delay in milliseconds, then the keys that are typed once it has gone
+     by, e.g. "1500 p". Keys are given one to each pass of the event
+     checkers. A '#' starts a comment. The run ends when the delay on the
+     last line has gone by, with a report of the simulated seconds per wall
+     second
+   For example, with the keyboard test events of RocketLaunchGameFSM
+   (TESTGAME) and a script of the moves of a whole game:
+     gcc -DTESTGAME -I FrameworkHeaders -I ProjectHeaders -I HostSim
+         FrameworkSource/ES_HostPort.c HostSim/PIC32Sim.c (the other
+         framework and project files, less ES_Port.c, terminal.c,
+         ES_Tickless.c and ES_ShortTimer.c) -o game
+     ./game < FullGame.txt
+   Built with ES_INPUT_REPLAY, stdin is instead a capture of the terminal
+   of a session recorded with ES_INPUT_RECORD, holding a dump of the input
+   log. The clock then moves on to the next logged input rather than the
+   next scripted key, and the run ends at the end of the log.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:20 agt     flushes stdout only when something has been printed
+ 10/18/26 02:10 agt     takes the interrupts of the ISRs attached to the model
+ 10/18/26 01:20 agt     replays a dump of the input log in place of a script
+ 10/17/26 23:55 agt     builds against the HostSim register model
+ 10/17/26 23:40 agt     started coding
+ ***************************************************************************/
+#ifdef __XC32
+#error "ES_HostPort.c is the host port, build ES_Port.c for the PIC32"
+#endif
+
+#include <stdint.h>         // for exact size data types
+#include <stdbool.h>        // for the bool data type
+#include <stdio.h>
+#include <stdio_ext.h>      // for __fpending
+#include <stdlib.h>         // for exit
+#include <time.h>           // for the wall clock
+#include <unistd.h>         // for isatty & read
+#include <termios.h>        // to take keys as they are typed
+#include <sys/select.h>     // to wait for a key with a time limit
+
+#include "ES_Configure.h"
+#include "ES_Port.h"        // the header file for this module
+#include "ES_Types.h"       // framework type definitions
+#include "ES_Timers.h"      // framework timer prototypes
+#include "ES_Mailbox.h"     // to drain the ISR mailboxes
+#include "ES_InputLog.h"    // to follow a replay of the inputs
+
+#include "terminal.h"       // terminal prototypes
+#include "PIC32Sim.h"       // to take the interrupts of the register model
+
+#ifdef ES_TICKLESS
+#error "the host port keeps its own virtual time, build it without ES_TICKLESS"
+#endif
+
+/****************************************************************************
+ * Module Level defines
+ ***************************************************************************/
+// the longest script line that is read
+#define SCRIPT_LINE_LEN 256
+// the most ticks passed to the timers in one call
+#define MAX_TICKS_PER_RESP UINT16_MAX
+
+/*---------------------------- Module Functions ---------------------------*/
+static void     ReadScriptLine(void);
+static void     EndRun(void);
+static uint64_t GetWallNanoSecs(void);
+static uint32_t GetWallTicks(void);
+static void     RestoreTerminal(void);
+
+/*---------------------------- Module Variables ---------------------------*/
+// virtual ticks since _HW_Timer_Init
+static uint32_t SysTickCounter;
+// ticks that the clock has moved on that the timers have not seen yet
+static uint32_t PendingTicks;
+// the length of a tick in core timer counts, one of the TimerRate_t values
+static TimerRate_t tickPeriod = ES_Timer_RATE_1mS;
+// the wall clock at _HW_Timer_Init
+static uint64_t WallStart;
+
+// true when stdin is a terminal rather than a script
+static bool IsInteractive;
+static struct termios SavedTermios;
+
+// a key from the terminal that has been looked at but not read
+static bool     HaveRxByte;
+static uint8_t  RxByte;
+
+// the script line being typed: the keys left and when they are due
+static char     ScriptKeys[SCRIPT_LINE_LEN];
+static char     *pNextKey = ScriptKeys;
+static uint32_t KeysDueTick;
+// true once the last line of the script has been read
+static bool     ScriptDone;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+    _HW_PIC32Init
+ Parameters
+    none
+ Returns
+     None.
+ Description
+    the host version of the basic hardware init, which only has the terminal
+    to set up
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+void _HW_PIC32Init(void)
+{
+  Terminal_HWInit();
+}
+
+/****************************************************************************
+ Function
+     _HW_Timer_Init
+ Parameters
+     TimerRate_t Rate set to one of the TMR_RATE_XX enum values to set the
+     Tick rate
+ Returns
+     None.
+ Description
+     starts the virtual clock at tick 0 and notes the wall clock, for the
+     report at the end of a run
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+void _HW_Timer_Init(const TimerRate_t Rate)
+{
+  if (Rate > 0)
+  {
+    tickPeriod = Rate;
+  }
+  SysTickCounter  = 0;
+  PendingTicks    = 0;
+  WallStart       = GetWallNanoSecs();
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTickCount()
+ Parameters
+    none
+ Returns
+    uint16_t   count of number of virtual ticks that have occurred.
+ Description
+    the low 16 bits of _HW_GetTickCount32
+ Notes
+
+ Author
+    agt, 10/17/26
+****************************************************************************/
+uint16_t _HW_GetTickCount(void)
+{
+  return (uint16_t)_HW_GetTickCount32();
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTickCount32()
+ Parameters
+    none
+ Returns
+    uint32_t   count of number of virtual ticks that have occurred.
+ Description
+    the virtual clock, for ES_Timer_GetTime32
+ Notes
+
+ Author
+    agt, 10/17/26
+****************************************************************************/
+uint32_t _HW_GetTickCount32(void)
+{
+  return SysTickCounter;
+}
+
+/****************************************************************************
+ Function
+     _HW_Process_Pending_Ints
+ Parameters
+     none
+ Returns
+     always true.
+ Description
+     calls the ISRs attached to the register model whose interrupts are
+     pending, moves events from the ISR mailboxes to the service queues and
+     passes the ticks that _HW_Idle moved the clock on by to the timers
+ Notes
+     returns true for the loop test in ES_Run, as the PIC32 version does
+ Author
+     agt, 10/17/26
+****************************************************************************/
+bool _HW_Process_Pending_Ints(void)
+{
+  PIC32Sim_TakeInterrupts();
+  ES_Mailbox_DrainAll();
+
+  while (PendingTicks > 0)
+  {
+    uint16_t Ticks = (PendingTicks > MAX_TICKS_PER_RESP) ?
+        MAX_TICKS_PER_RESP : (uint16_t)PendingTicks;
+
+    PendingTicks -= Ticks;
+    ES_Timer_MultiTick_Resp(Ticks);
+  }
+  return true;
+}
+
+/****************************************************************************
+ Function
+     _HW_Idle
+ Parameters
+     none
+ Returns
+     none.
+ Description
+     moves the virtual clock on to the next timer deadline or scripted key,
+     whichever comes first. In a terminal session it waits for that time on
+     the wall clock, or for a key. In a replay of the inputs the logged
+     inputs take the place of the keys
+ Notes
+     called by ES_Run when there is nothing to do. A script run ends here
+     once the last line is due and all of its keys have been read, a replay
+     once the clock reaches the end of the log
+ Author
+     agt, 10/17/26
+****************************************************************************/
+void _HW_Idle(void)
+{
+  uint32_t  TicksToTimer;
+  uint32_t  Target;
+  bool      TimerActive;
+
+  if (__fpending(stdout) != 0)
+  {
+    fflush(stdout); // what the services printed shows before the wait
+  }
+  if ((PendingTicks != 0) || HaveRxByte)
+  {
+    return; // ES_Run has work to do first
+  }
+  TimerActive = ES_Timer_GetTicksToNext(&TicksToTimer);
+  if (TimerActive && (TicksToTimer == 0))
+  {
+    TicksToTimer = 1;
+  }
+
+  if (IsInteractive)
+  {
+    struct timeval  Wait;
+    fd_set          Keys;
+    uint32_t        WallTicks = GetWallTicks();
+
+    // wait for the next timer to be due on the wall clock, or for a key
+    if (TimerActive && ((int32_t)(SysTickCounter + TicksToTimer - WallTicks)
+        > 0))
+    {
+      uint64_t WaitUS = (uint64_t)(SysTickCounter + TicksToTimer - WallTicks) *
+          tickPeriod / ES_CORE_TICKS_PER_US;
+      Wait.tv_sec   = WaitUS / 1000000;
+      Wait.tv_usec  = WaitUS % 1000000;
+      FD_ZERO(&Keys);
+      FD_SET(STDIN_FILENO, &Keys);
+      select(STDIN_FILENO + 1, &Keys, NULL, NULL, &Wait);
+    }
+    else if (!TimerActive)
+    {
+      FD_ZERO(&Keys);
+      FD_SET(STDIN_FILENO, &Keys);
+      select(STDIN_FILENO + 1, &Keys, NULL, NULL, NULL);
+    }
+    // the clock catches up with the wall clock, but never past the timer,
+    // so that each timeout is seen in the tick that it was due
+    Target = GetWallTicks();
+    if (TimerActive && ((int32_t)(Target - (SysTickCounter + TicksToTimer))
+        > 0))
+    {
+      Target = SysTickCounter + TicksToTimer;
+    }
+  }
+  else
+  {
+#ifdef ES_INPUT_REPLAY
+    uint32_t InputTick;
+
+    if (!ES_Input_GetNextTick(&InputTick))
+    {
+      EndRun();
+    }
+    Target = InputTick;
+    if (TimerActive && ((int32_t)(SysTickCounter + TicksToTimer - InputTick)
+        < 0))
+    {
+      Target = SysTickCounter + TicksToTimer;
+    }
+#else
+    if (*pNextKey == '\0')
+    {
+      ReadScriptLine();
+    }
+    if (ScriptDone && (*pNextKey == '\0') &&
+        ((int32_t)(SysTickCounter - KeysDueTick) >= 0))
+    {
+      EndRun();
+    }
+    // on to the next timer, or the keys if they come first. Keys that are
+    // due already but have not been read don't hold the clock up
+    Target = TimerActive ? (SysTickCounter + TicksToTimer) : KeysDueTick;
+    if (((int32_t)(KeysDueTick - SysTickCounter) > 0) &&
+        ((int32_t)(KeysDueTick - Target) < 0))
+    {
+      Target = KeysDueTick;
+    }
+#endif
+  }
+
+  if ((int32_t)(Target - SysTickCounter) > 0)
+  {
+    PendingTicks    = Target - SysTickCounter;
+    SysTickCounter  = Target;
+  }
+}
+
+/****************************************************************************
+ Function
+     _HW_ConsoleInit
+ Parameters
+     none
+ Returns
+     none.
+ Description
+     sets up the terminal for console I/O
+ Notes
+
+ Author
+     agt, 10/17/26
+ ****************************************************************************/
+void _HW_ConsoleInit(void)
+{
+  Terminal_HWInit();
+}
+
+/****************************************************************************
+ Function
+     Terminal_HWInit
+ Parameters
+     none
+ Returns
+     none.
+ Description
+     works out whether stdin is a terminal or a script. A terminal is put in
+     a mode where keys are passed on as they are typed, without an echo
+ Notes
+     the terminal mode is put back when the program exits
+ Author
+     agt, 10/17/26
+ ****************************************************************************/
+void Terminal_HWInit(void)
+{
+  static bool IsInitialized = false;
+  struct termios NewTermios;
+
+  if (IsInitialized)
+  {
+    return;
+  }
+  IsInitialized = true;
+  IsInteractive = isatty(STDIN_FILENO);
+  if (IsInteractive && (tcgetattr(STDIN_FILENO, &SavedTermios) == 0))
+  {
+    NewTermios          = SavedTermios;
+    NewTermios.c_lflag &= ~(ICANON | ECHO);
+    NewTermios.c_cc[VMIN]   = 1;
+    NewTermios.c_cc[VTIME]  = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &NewTermios);
+    atexit(RestoreTerminal);
+  }
+}
+
+/****************************************************************************
+ Function
+     Terminal_IsRxData
+ Parameters
+     none
+ Returns
+     bool : true if a key is ready
+ Description
+     a key is ready once it has been typed, or, in a script, once the virtual
+     clock has reached the time of its line
+ Notes
+
+ Author
+     agt, 10/17/26
+ ****************************************************************************/
+bool Terminal_IsRxData(void)
+{
+  if (IsInteractive)
+  {
+    if (!HaveRxByte)
+    {
+      struct timeval  NoWait = { 0, 0 };
+      fd_set          Keys;
+
+      FD_ZERO(&Keys);
+      FD_SET(STDIN_FILENO, &Keys);
+      if ((select(STDIN_FILENO + 1, &Keys, NULL, NULL, &NoWait) > 0) &&
+          (read(STDIN_FILENO, &RxByte, 1) == 1))
+      {
+        HaveRxByte = true;
+      }
+    }
+    return HaveRxByte;
+  }
+  if (*pNextKey == '\0')
+  {
+    ReadScriptLine();
+  }
+  return (*pNextKey != '\0') &&
+         ((int32_t)(SysTickCounter - KeysDueTick) >= 0);
+}
+
+/****************************************************************************
+ Function
+     Terminal_ReadByte
+ Parameters
+     none
+ Returns
+     uint8_t : the next key
+ Description
+     returns the next key, waiting for it as the UART version does
+ Notes
+
+ Author
+     agt, 10/17/26
+ ****************************************************************************/
+uint8_t Terminal_ReadByte(void)
+{
+  while (!Terminal_IsRxData())
+  {
+    _HW_Idle();
+    _HW_Process_Pending_Ints();
+  }
+  if (IsInteractive)
+  {
+    HaveRxByte = false;
+    return RxByte;
+  }
+  return (uint8_t)*pNextKey++;
+}
+
+/****************************************************************************
+ Function
+     Terminal_WriteByte
+ Parameters
+     uint8_t : the byte to write
+ Returns
+     none.
+ Description
+     writes the byte to stdout
+ Notes
+
+ Author
+     agt, 10/17/26
+ ****************************************************************************/
+void Terminal_WriteByte(uint8_t txByte)
+{
+  putchar(txByte);
+}
+
+/****************************************************************************
+ Function
+     Terminal_MoveBuffer2UART
+ Parameters
+     none
+ Returns
+     none.
+ Description
+     stdout does its own buffering, so there is nothing to move
+ Notes
+
+ Author
+     agt, 10/17/26
+ ****************************************************************************/
+void Terminal_MoveBuffer2UART(void)
+{
+}
+
+/****************************************************************************
+ Function
+     Terminal_GetXmitSpace
+ Parameters
+     none
+ Returns
+     uint16_t : the space in the transmit buffer
+ Description
+     stdout never fills, so this is always the size of the UART version's
+     buffer
+ Notes
+
+ Author
+     agt, 10/17/26
+ ****************************************************************************/
+uint16_t Terminal_GetXmitSpace(void)
+{
+  return XMIT_BUFFER_SIZE;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+// reads script lines until one with keys to type, or the end of the script,
+// adding up the delays on the way
+static void ReadScriptLine(void)
+{
+  char      Line[SCRIPT_LINE_LEN];
+  char      *pChar;
+  char      *pKey;
+  uint32_t  DelayMS;
+
+  while (!ScriptDone)
+  {
+    if (fgets(Line, sizeof(Line), stdin) == NULL)
+    {
+      ScriptDone = true;
+      break;
+    }
+    DelayMS = (uint32_t)strtoul(Line, &pChar, 10);
+    KeysDueTick += (uint32_t)((uint64_t)DelayMS * 1000 * ES_CORE_TICKS_PER_US /
+        tickPeriod);
+    // the rest of the line, up to a comment, are the keys
+    pKey = ScriptKeys;
+    for ( ; (*pChar != '\0') && (*pChar != '#'); pChar++)
+    {
+      if ((*pChar != ' ') && (*pChar != '\t') && (*pChar != '\r') &&
+          (*pChar != '\n'))
+      {
+        *pKey++ = *pChar;
+      }
+    }
+    *pKey     = '\0';
+    pNextKey  = ScriptKeys;
+    if (ScriptKeys[0] != '\0')
+    {
+      break;
+    }
+  }
+}
+
+// prints how fast the run went and stops the program
+static void EndRun(void)
+{
+  double SimSecs  = (double)SysTickCounter * tickPeriod /
+      (ES_CORE_TICKS_PER_US * 1000000.0);
+  double WallSecs = (GetWallNanoSecs() - WallStart) / 1e9;
+
+  printf("\r\nES host: %.3f simulated seconds in %.4f wall seconds, "
+      "%.0f simulated seconds per wall second\r\n", SimSecs, WallSecs,
+      (WallSecs > 0) ? SimSecs / WallSecs : 0.0);
+  exit(0);
+}
+
+// the monotonic wall clock
+static uint64_t GetWallNanoSecs(void)
+{
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return (uint64_t)Now.tv_sec * 1000000000ULL + (uint64_t)Now.tv_nsec;
+}
+
+// whole ticks of wall time since _HW_Timer_Init
+static uint32_t GetWallTicks(void)
+{
+  return (uint32_t)((GetWallNanoSecs() - WallStart) * ES_CORE_TICKS_PER_US /
+         1000 / tickPeriod);
+}
+
+// puts the terminal back the way that it was found
+static void RestoreTerminal(void)
+{
+  tcsetattr(STDIN_FILENO, TCSANOW, &SavedTermios);
+}
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
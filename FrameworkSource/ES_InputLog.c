@@ -0,0 +1,621 @@
+/****************************************************************************
+ Module
+     ES_InputLog.c
+ Description
+     Records everything that the game reads from the outside world (the
+     levels of the pins read by the event checkers, the keys and the ADC
+     results) from reset, and plays a recording back in a host build, so
+     that a session on the real hardware can be run again, bit for bit, as
+     fast as the host can go.
+ Notes
+     With ES_INPUT_RECORD, each input is logged when it is read with a value
+     different from the last one logged, along with the framework tick
+     (ES_Timer_GetTime32) that it was read in. Keys and ADC results are
+     logged every time. The log is a byte stream in RAM:
+       0b000nnnnn       input n was read low
+       0b001nnnnn       input n was read high
+       0b010xxxxx k     key k
+       0b011nnnnn ...   n ADC results, 2 bytes each, low byte first
+       0b100nnnnn       the tick moves on by n (1 to 31), or for n = 0 by
+                        the number in the bytes that follow, 7 bits a byte,
+                        low bits first, the top bit set in all but the last
+       0b101xxxxx       the end of the log
+     When it is full the log is ended, so a recording always replays up to
+     where it stops. 'i' dumps the log to the terminal, a line at a time
+     from ES_Run's idle loop, and ends it. Recording is cheap enough to
+     leave in: a pin read that has not changed costs a compare.
+
+     With ES_INPUT_REPLAY (host builds only) ES_Input_Init reads a terminal
+     capture holding a dump from stdin. Each read of an input returns the
+     value that was recorded for it, and each logged value is handed out in
+     the tick and in the order that it was read in on the hardware. As the
+     services are run in the same order from the same inputs, they read in
+     the same ticks and in the same order, which is what makes the replay
+     exact. ES_HostPort.c moves the clock on to the next logged tick and
+     ends the run at the end of the log. make -C HostSim replay-check records
+     a scripted session and checks that its replay dumps the same trace.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:30 agt      notes point to the replay check
+ 10/18/26 01:20 agt      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_InputLog.h"
+
+#ifdef ES_INPUT_LOG
+
+#include "ES_Timers.h"
+#include "terminal.h"
+#include "dbprintf.h"
+#ifdef ES_INPUT_REPLAY
+#ifdef __XC32
+#error "ES_INPUT_REPLAY is for host builds, the PIC32 can only record"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+/*----------------------------- Module Defines ----------------------------*/
+// the kind of a record is in the top 3 bits of its first byte
+#define KIND_MASK   0xE0
+#define ARG_MASK    0x1F
+#define REC_LOW     0x00
+#define REC_HIGH    0x20
+#define REC_KEY     0x40
+#define REC_ANALOG  0x60
+#define REC_DELAY   0x80
+#define REC_END     0xA0
+
+// bits of a long delay in each byte, and the flag for more to come
+#define DELAY_BITS  7
+#define DELAY_MORE  0x80
+
+// the longest delay takes 6 bytes. An end record needs room for one
+// delay and itself
+#define MAX_DELAY_LEN 6
+#define END_ROOM (MAX_DELAY_LEN + 1)
+
+// bytes of the log per line of the dump
+#define DUMP_BYTES_PER_LINE 32
+// don't start a line of the dump unless the terminal buffer has this much room
+#define DUMP_LINE_ROOM 160
+
+/*---------------------------- Module Functions ---------------------------*/
+static void SetKnownLevel(uint32_t Bit, bool Level);
+#ifdef ES_INPUT_RECORD
+static bool StartRecord(uint8_t NumBytes);
+static void AddDelay(void);
+static void EndLog(void);
+#else
+static void LoadReplay(void);
+static bool IsNextDue(uint8_t Kind);
+static void SkipDelays(void);
+static uint32_t ReadDelay(void);
+#endif
+
+/*---------------------------- Module Variables ---------------------------*/
+static uint8_t  Log[ES_INPUT_LOG_SIZE];
+static uint32_t LogLen;
+
+// the last level logged for each input, and which inputs have one
+static uint32_t KnownLevels;
+static uint32_t KnownInputs;
+
+#ifdef ES_INPUT_RECORD
+// the tick of the last record, and has the end record been written
+static uint32_t LogTick;
+static bool     IsEnded;
+
+// the next byte of the log to print, while a dump is under way
+static uint32_t DumpNext;
+static bool     DumpHeader;
+static bool     Dumping;
+#else
+// the next record to hand out and the tick it is due in
+static uint32_t ReplayPos;
+static uint32_t NextTick;
+// the tick of the end record
+static uint32_t EndTick;
+// ADC reads that did not match the log
+static uint32_t Mismatches;
+#endif
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_Input_Init
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   starts a new recording, or loads the recording to be played back
+ Notes
+   called from ES_Initialize before the service inits, which read the
+   starting levels of their inputs. A replay reads the capture from stdin,
+   and stops the program if there is no dump in it
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void ES_Input_Init(void)
+{
+  KnownLevels = 0;
+  KnownInputs = 0;
+  LogLen      = 0;
+#ifdef ES_INPUT_RECORD
+  LogTick     = ES_Timer_GetTime32();
+  IsEnded     = false;
+#else
+  LoadReplay();
+#endif
+}
+
+/****************************************************************************
+ Function
+   ES_Input_Level
+ Parameters
+   uint8_t : the input, one of the ES_Input_t values in ES_Configure.h
+   bool : the level just read from its pin
+ Returns
+   bool : the level to use
+ Description
+   logs the level if it has changed, or, in a replay, gives the level that
+   was read at this point on the hardware
+ Notes
+   an input that is not in the log keeps the level of its pin
+ Author
+   agt, 10/18/26
+****************************************************************************/
+bool ES_Input_Level(uint8_t WhichInput, bool Level)
+{
+  uint32_t Bit = (uint32_t)1 << WhichInput;
+
+#ifdef ES_INPUT_RECORD
+  if ((((KnownInputs & Bit) == 0) || (((KnownLevels & Bit) != 0) != Level)) &&
+      StartRecord(1))
+  {
+    Log[LogLen++] = (Level ? REC_HIGH : REC_LOW) | WhichInput;
+    SetKnownLevel(Bit, Level);
+  }
+  return Level;
+#else
+  if ((IsNextDue(REC_LOW) || IsNextDue(REC_HIGH)) &&
+      ((Log[ReplayPos] & ARG_MASK) == WhichInput))
+  {
+    SetKnownLevel(Bit, (Log[ReplayPos++] & KIND_MASK) == REC_HIGH);
+    SkipDelays();
+  }
+  return (KnownInputs & Bit) ? ((KnownLevels & Bit) != 0) : Level;
+#endif
+}
+
+/****************************************************************************
+ Function
+   ES_Input_IsKeyReady
+ Parameters
+   None
+ Returns
+   bool : true if there is a key to read
+ Description
+   IsNewKeyReady, or in a replay, is a key due now
+ Notes
+
+ Author
+   agt, 10/18/26
+****************************************************************************/
+bool ES_Input_IsKeyReady(void)
+{
+#ifdef ES_INPUT_RECORD
+  return IsNewKeyReady();
+#else
+  return IsNextDue(REC_KEY);
+#endif
+}
+
+/****************************************************************************
+ Function
+   ES_Input_GetKey
+ Parameters
+   None
+ Returns
+   uint8_t : the key
+ Description
+   GetNewKey, logging the key, or in a replay, the key that is due now
+ Notes
+   only call it once ES_Input_IsKeyReady has returned true
+ Author
+   agt, 10/18/26
+****************************************************************************/
+uint8_t ES_Input_GetKey(void)
+{
+  uint8_t Key;
+
+#ifdef ES_INPUT_RECORD
+  Key = GetNewKey();
+  if (StartRecord(2))
+  {
+    Log[LogLen++] = REC_KEY;
+    Log[LogLen++] = Key;
+  }
+#else
+  Key = 0;
+  if (IsNextDue(REC_KEY))
+  {
+    Key = Log[ReplayPos + 1];
+    ReplayPos += 2;
+    SkipDelays();
+  }
+#endif
+  return Key;
+}
+
+/****************************************************************************
+ Function
+   ES_Input_Analog
+ Parameters
+   uint32_t * : the results of an ADC_MultiRead
+   uint8_t : how many there are
+ Returns
+   nothing
+ Description
+   logs the results, or in a replay, replaces them with the ones that were
+   read at this point on the hardware
+ Notes
+   a replay that finds no matching results in the log leaves these alone
+   and counts a mismatch
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void ES_Input_Analog(uint32_t *pResults, uint8_t NumResults)
+{
+  uint8_t i;
+
+  if (NumResults > ARG_MASK)
+  {
+    NumResults = ARG_MASK;
+  }
+#ifdef ES_INPUT_RECORD
+  if (StartRecord(1 + 2 * NumResults))
+  {
+    Log[LogLen++] = REC_ANALOG | NumResults;
+    for (i = 0; i < NumResults; i++)
+    {
+      Log[LogLen++] = (uint8_t)pResults[i];
+      Log[LogLen++] = (uint8_t)(pResults[i] >> 8);
+    }
+  }
+#else
+  if (IsNextDue(REC_ANALOG) && ((Log[ReplayPos] & ARG_MASK) == NumResults))
+  {
+    ReplayPos++;
+    for (i = 0; i < NumResults; i++)
+    {
+      pResults[i] = Log[ReplayPos] | ((uint32_t)Log[ReplayPos + 1] << 8);
+      ReplayPos += 2;
+    }
+    SkipDelays();
+  }
+  else
+  {
+    Mismatches++;
+  }
+#endif
+}
+
+#ifdef ES_INPUT_RECORD
+/****************************************************************************
+ Function
+   ES_Input_StartDump
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   ends the log and starts printing it to the terminal. The printing itself
+   happens in ES_Input_DumpStep
+ Notes
+   nothing more is recorded after this, so each dump is of the same log
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void ES_Input_StartDump(void)
+{
+  if (!IsEnded)
+  {
+    EndLog();
+  }
+  DumpNext    = 0;
+  DumpHeader  = true;
+  Dumping     = true;
+}
+
+/****************************************************************************
+ Function
+   ES_Input_DumpStep
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   prints the next lines of a dump started with ES_Input_StartDump, as long
+   as the terminal buffer has room for them
+ Notes
+   called from the idle part of ES_Run. The log is printed in lines of
+   "I " and up to 32 bytes in hex, between a line "Inputs: <n> bytes" and
+   a line "Inputs end"
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void ES_Input_DumpStep(void)
+{
+  static const char HexDigits[] = "0123456789abcdef";
+  char    Line[2 * DUMP_BYTES_PER_LINE + 1];
+  uint8_t i;
+
+  while (Dumping && (Terminal_GetXmitSpace() >= DUMP_LINE_ROOM))
+  {
+    if (DumpHeader)
+    {
+      DB_printf("\r\nInputs: %u bytes\r\n", LogLen);
+      DumpHeader = false;
+    }
+    else if (DumpNext < LogLen)
+    {
+      for (i = 0; (i < DUMP_BYTES_PER_LINE) && (DumpNext < LogLen); i++)
+      {
+        Line[2 * i]     = HexDigits[Log[DumpNext] >> 4];
+        Line[2 * i + 1] = HexDigits[Log[DumpNext] & 0x0F];
+        DumpNext++;
+      }
+      Line[2 * i] = '\0';
+      DB_printf("I %s\r\n", Line);
+    }
+    else
+    {
+      DB_printf("Inputs end\r\n");
+      Dumping = false;
+    }
+  }
+}
+#else
+/****************************************************************************
+ Function
+   ES_Input_GetNextTick
+ Parameters
+   uint32_t * : where to put the tick
+ Returns
+   bool : false once the replay is over
+ Description
+   gives the tick that the next logged input is due in, so that the host
+   port can move the clock straight on to it
+ Notes
+   if the next input is overdue, the replay has gone off the log, and the
+   tick given is the end of the log
+ Author
+   agt, 10/18/26
+****************************************************************************/
+bool ES_Input_GetNextTick(uint32_t *pTick)
+{
+  if (ES_Input_IsReplayDone())
+  {
+    return false;
+  }
+  *pTick = ((int32_t)(NextTick - ES_Timer_GetTime32()) > 0) ? NextTick :
+      EndTick;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_Input_IsReplayDone
+ Parameters
+   None
+ Returns
+   bool : true once the clock has reached the end of the log
+ Description
+   at the end, reports to stderr if any logged input was not handed out as
+   it was read on the hardware
+ Notes
+   call it when nothing is left to do in the current tick
+ Author
+   agt, 10/18/26
+****************************************************************************/
+bool ES_Input_IsReplayDone(void)
+{
+  static bool IsReported = false;
+
+  if ((int32_t)(ES_Timer_GetTime32() - EndTick) < 0)
+  {
+    return false;
+  }
+  if (!IsReported)
+  {
+    IsReported = true;
+    if (((Log[ReplayPos] & KIND_MASK) != REC_END) || (Mismatches != 0))
+    {
+      fprintf(stderr, "input replay: left the log at byte %u of %u, "
+          "%u ADC reads not in the log\n", ReplayPos, LogLen, Mismatches);
+    }
+  }
+  return true;
+}
+#endif
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+// notes the last level seen on an input
+static void SetKnownLevel(uint32_t Bit, bool Level)
+{
+  KnownInputs |= Bit;
+  if (Level)
+  {
+    KnownLevels |= Bit;
+  }
+  else
+  {
+    KnownLevels &= ~Bit;
+  }
+}
+
+#ifdef ES_INPUT_RECORD
+// notes the time and makes sure that there is room for a record of this
+// length, ending the log if there is not
+static bool StartRecord(uint8_t NumBytes)
+{
+  if (IsEnded)
+  {
+    return false;
+  }
+  if (LogLen + MAX_DELAY_LEN + NumBytes + END_ROOM > sizeof(Log))
+  {
+    EndLog();
+    return false;
+  }
+  AddDelay();
+  return true;
+}
+
+// logs the ticks since the last record
+static void AddDelay(void)
+{
+  uint32_t Now    = ES_Timer_GetTime32();
+  uint32_t Delay  = Now - LogTick;
+
+  if (Delay == 0)
+  {
+    return;
+  }
+  LogTick = Now;
+  if (Delay <= ARG_MASK)
+  {
+    Log[LogLen++] = REC_DELAY | (uint8_t)Delay;
+    return;
+  }
+  Log[LogLen++] = REC_DELAY;
+  while (Delay >= DELAY_MORE)
+  {
+    Log[LogLen++] = (uint8_t)(Delay & (DELAY_MORE - 1)) | DELAY_MORE;
+    Delay >>= DELAY_BITS;
+  }
+  Log[LogLen++] = (uint8_t)Delay;
+}
+
+// ends the log at the current tick
+static void EndLog(void)
+{
+  AddDelay();
+  Log[LogLen++] = REC_END;
+  IsEnded = true;
+}
+#else
+// reads the last dump of the inputs in the capture on stdin into the log
+// and finds the tick that it ends in
+static void LoadReplay(void)
+{
+  char      Line[256];
+  char      *pHex;
+  unsigned  Byte;
+  unsigned  DumpLen = 0;
+  int       NumChars;
+  bool      InDump  = false;
+  bool      IsEnd   = false;
+
+  if (isatty(STDIN_FILENO))
+  {
+    fprintf(stderr, "input replay: give the capture with the dump on stdin\n");
+    exit(1);
+  }
+  while (!IsEnd && (fgets(Line, sizeof(Line), stdin) != NULL))
+  {
+    if ((pHex = strstr(Line, "Inputs: ")) != NULL)
+    {
+      // a dump that was cut off is replaced by the next one
+      InDump  = (sscanf(pHex, "Inputs: %u bytes", &DumpLen) == 1);
+      LogLen  = 0;
+    }
+    else if (InDump && (strstr(Line, "Inputs end") != NULL))
+    {
+      IsEnd = true;
+    }
+    else if (InDump && (strncmp(Line, "I ", 2) == 0))
+    {
+      pHex = Line + 2;
+      while ((LogLen < sizeof(Log)) &&
+             (sscanf(pHex, "%2x%n", &Byte, &NumChars) == 1))
+      {
+        Log[LogLen++] = (uint8_t)Byte;
+        pHex += NumChars;
+      }
+    }
+  }
+  if (!IsEnd || (LogLen != DumpLen) || (LogLen == 0) ||
+      (Log[LogLen - 1] != REC_END))
+  {
+    fprintf(stderr, "input replay: no complete dump of the inputs found\n");
+    exit(1);
+  }
+  // find the end tick, then start from the top
+  ReplayPos = 0;
+  NextTick  = 0;
+  while (ReplayPos < LogLen)
+  {
+    SkipDelays();
+    if ((Log[ReplayPos] & KIND_MASK) == REC_END)
+    {
+      break;
+    }
+    ReplayPos += ((Log[ReplayPos] & KIND_MASK) == REC_KEY) ? 2 :
+        ((Log[ReplayPos] & KIND_MASK) == REC_ANALOG) ?
+        1 + 2 * (Log[ReplayPos] & ARG_MASK) : 1;
+  }
+  EndTick     = NextTick;
+  ReplayPos   = 0;
+  NextTick    = 0;
+  Mismatches  = 0;
+  SkipDelays();
+}
+
+// is the next record of this kind, and due now
+static bool IsNextDue(uint8_t Kind)
+{
+  return ((Log[ReplayPos] & KIND_MASK) == Kind) &&
+         ((int32_t)(ES_Timer_GetTime32() - NextTick) >= 0);
+}
+
+// moves the replay past any delays, adding them to the tick
+static void SkipDelays(void)
+{
+  while ((Log[ReplayPos] & KIND_MASK) == REC_DELAY)
+  {
+    NextTick += ReadDelay();
+  }
+}
+
+// reads the delay at ReplayPos and moves past it
+static uint32_t ReadDelay(void)
+{
+  uint32_t  Delay;
+  uint8_t   Shift = 0;
+
+  Delay = Log[ReplayPos++] & ARG_MASK;
+  if (Delay != 0)
+  {
+    return Delay;
+  }
+  do
+  {
+    Delay |= (uint32_t)(Log[ReplayPos] & (DELAY_MORE - 1)) << Shift;
+    Shift += DELAY_BITS;
+  } while (Log[ReplayPos++] & DELAY_MORE);
+  return Delay;
+}
+#endif
+
+#endif /* ES_INPUT_LOG */
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
@@ -18,6 +18,10 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 06:50 agt      a 64 service mismatch fails the TEST harness
+ 10/17/26 09:20 agt      ES_GetMSBitSet now uses count-leading-zeros instead of
+                         walking the nybbles. The nybble table is kept as the
+                         reference for the test harness benchmark.
  10/20/13 17:03 jec      converted Byte2MSBitNum array to a Nybble sized array
                          (15 entries) and made function GetMSBitSet() to figure
                          out the MSB set. This was done to facilitate moving to
@@ -33,6 +37,7 @@
 #include "ES_Types.h"
 #include "ES_General.h"
 #include "ES_Timers.h"
+#include "ES_LookupTables.h"
 #include "bitdefs.h"
 
 /*----------------------------- Module Defines ----------------------------*/
@@ -77,6 +82,30 @@ uint8_t const Nybble2MSBitNum[15] = {
 
 /*------------------------------ Module Code ------------------------------*/
 uint8_t ES_GetMSBitSet(uint16_t Val2Check)
+{
+  uint8_t ReturnVal = 128; // this is the error return value
+
+  // clz is undefined for 0, so only use it when there is a bit to find
+  if (Val2Check != 0)
+  {
+    ReturnVal = ES_GetMSBitSet32(Val2Check);
+  }
+  return ReturnVal;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+#ifdef TEST
+#include <stdio.h>
+
+#define NUM_BENCH_PASSES 16
+
+/*
+  This is the original nybble-at-a-time search, kept here as the reference
+  that the count-leading-zeros version is checked and timed against.
+*/
+static uint8_t NybbleGetMSBitSet(uint16_t Val2Check)
 {
   int8_t  LoopCntr;
   uint8_t Nybble2Test;
@@ -101,28 +130,122 @@ uint8_t ES_GetMSBitSet(uint16_t Val2Check)
   return ReturnVal;
 }
 
-/***************************************************************************
- private functions
- ***************************************************************************/
-#ifdef TEST
-#include <stdio.h>
+// the nybble search extended to 64 services: scan 4 16-bit words from the top
+static uint8_t NybbleGetHighest64(const uint16_t *pWords)
+{
+  int8_t WhichWord;
+  for (WhichWord = 3; WhichWord >= 0; WhichWord--)
+  {
+    if (pWords[WhichWord] != 0)
+    {
+      return NybbleGetMSBitSet(pWords[WhichWord]) + (WhichWord * 16);
+    }
+  }
+  return 128;
+}
+
+// the two level clz search for 64 services, as used by ES_Run
+static uint8_t ClzGetHighest64(uint32_t Groups, const uint32_t *pTable)
+{
+  uint8_t WhichGroup = ES_GetMSBitSet32(Groups);
+  return (WhichGroup << 5) + ES_GetMSBitSet32(pTable[WhichGroup]);
+}
 
 void main(void)
 {
-  uint16_t  Counter = 0;
-  uint8_t   MSBit;
+  uint16_t          Counter;
+  uint8_t           Pass;
+  uint8_t           WhichBit;
+  uint32_t          StartTime;
+  uint32_t          NybbleTime;
+  uint32_t          ClzTime;
+  uint16_t          Words[4];
+  uint32_t          Table[2];
+  uint32_t          Groups;
+  volatile uint8_t  Sink; // keep the optimizer from dropping the calls
+  bool              Passed = true;
 
   puts( "Testing the MSB Look-up function\n\r");
   puts( __TIME__ " " __DATE__);
   puts( "\n\r");
-  MSBit = ES_GetMSBitSet(Counter);
-    printf("the MSB set in %u is bit %d\n\r", Counter, MSBit);
 
+  // check the clz version against the nybble table for every 16 bit value
   for (Counter = 1; Counter != 0; Counter++)
   {
-    MSBit = ES_GetMSBitSet(Counter);
-    printf("the MSB set in %u is bit %d\n\r", Counter, MSBit);
+    if (ES_GetMSBitSet(Counter) != NybbleGetMSBitSet(Counter))
+    {
+      printf("mismatch at %u\n\r", Counter);
+      Passed = false;
+    }
+  }
+  if (ES_GetMSBitSet(0) != 128)
+  {
+    puts("mismatch at 0\n\r");
+    Passed = false;
+  }
+  printf("16 bit check %s\n\r", Passed ? "passed" : "FAILED");
+
+  // time both versions over every 16 bit Ready pattern
+  StartTime = _CP0_GET_COUNT();
+  for (Pass = 0; Pass < NUM_BENCH_PASSES; Pass++)
+  {
+    for (Counter = 1; Counter != 0; Counter++)
+    {
+      Sink = NybbleGetMSBitSet(Counter);
+    }
+  }
+  NybbleTime = _CP0_GET_COUNT() - StartTime;
+
+  StartTime = _CP0_GET_COUNT();
+  for (Pass = 0; Pass < NUM_BENCH_PASSES; Pass++)
+  {
+    for (Counter = 1; Counter != 0; Counter++)
+    {
+      Sink = ES_GetMSBitSet(Counter);
+    }
+  }
+  ClzTime = _CP0_GET_COUNT() - StartTime;
+  printf("16 services: nybble %u, clz %u core timer ticks per 1000 lookups\n\r",
+      (unsigned int)(NybbleTime / (NUM_BENCH_PASSES * 65535UL / 1000)),
+      (unsigned int)(ClzTime / (NUM_BENCH_PASSES * 65535UL / 1000)));
+
+  // 64 services, with only a single service ready. This is the worst case
+  // for the nybble search since it has to walk down to the bit
+  NybbleTime  = 0;
+  ClzTime     = 0;
+  for (WhichBit = 0; WhichBit < 64; WhichBit++)
+  {
+    Words[0] = Words[1] = Words[2] = Words[3] = 0;
+    Words[WhichBit >> 4] = (uint16_t)(1U << (WhichBit & 0x0F));
+    Table[0] = Table[1] = 0;
+    Table[WhichBit >> 5] = (uint32_t)1 << (WhichBit & 0x1F);
+    Groups = (uint32_t)1 << (WhichBit >> 5);
+
+    if ((NybbleGetHighest64(Words) != WhichBit) ||
+        (ClzGetHighest64(Groups, Table) != WhichBit))
+    {
+      printf("64 service mismatch at %u\n\r", WhichBit);
+      Passed = false;
+    }
+
+    StartTime = _CP0_GET_COUNT();
+    for (Counter = 0; Counter < 1000; Counter++)
+    {
+      Sink = NybbleGetHighest64(Words);
+    }
+    NybbleTime += _CP0_GET_COUNT() - StartTime;
+
+    StartTime = _CP0_GET_COUNT();
+    for (Counter = 0; Counter < 1000; Counter++)
+    {
+      Sink = ClzGetHighest64(Groups, Table);
+    }
+    ClzTime += _CP0_GET_COUNT() - StartTime;
   }
+  printf("64 services: nybble %u, clz %u core timer ticks per 1000 lookups\n\r",
+      (unsigned int)(NybbleTime / 64), (unsigned int)(ClzTime / 64));
+  printf("lookup checks %s\n\r", Passed ? "passed" : "FAILED");
+  (void)Sink;
 }
 
 #endif
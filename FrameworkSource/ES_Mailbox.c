@@ -0,0 +1,322 @@
+//#define TEST
+/****************************************************************************
+ Module
+     ES_Mailbox.c
+ Description
+     Lock-free mailboxes that let interrupt responses post events without
+     touching the service queues, and so without disabling interrupts.
+ Notes
+     Each mailbox has exactly one producer (an ISR) and one consumer
+     (_HW_Process_Pending_Ints, by way of ES_Mailbox_DrainAll). The producer
+     only writes Head and the consumer only writes Tail. Each side fills or
+     empties a slot before publishing its index with a release store and reads
+     the other side's index with an acquire load, which is all the ordering
+     that a single core needs, and is also enough for a multi-core host test.
+     The mailboxes must be set up with ES_Mailbox_Init (from a service init
+     function) before the ISR that feeds them is enabled.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 00:30 agt      posts passed on from the ISRs are traced as such
+ 10/17/26 14:20 agt      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Mailbox.h"
+#include "ES_Port.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// largest mailbox that the 8 bit free running indices can handle
+#define MAX_MAILBOX_SLOTS 128
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+// the mailboxes that ES_Mailbox_DrainAll empties, in order of registration
+static ES_Mailbox_t *MailboxList[ES_MAX_MAILBOXES];
+static uint8_t      NumMailboxes;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_Mailbox_Init
+ Parameters
+   ES_Mailbox_t * : the mailbox to set up
+   ES_Event_t * : the storage for its events
+   uint8_t : number of entries in that storage, a power of 2 up to 128
+   uint8_t : the service that should receive the events
+ Returns
+   bool : false if the size is not a power of 2 or ES_MAX_MAILBOXES
+          mailboxes are already in use
+ Description
+   empties the mailbox and adds it to the list drained by the framework
+ Notes
+   call this before enabling the interrupt that posts to the mailbox
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_Mailbox_Init(ES_Mailbox_t *pBox, ES_Event_t *pSlots, uint8_t NumSlots,
+    uint8_t WhichService)
+{
+  if ((NumSlots == 0) || (NumSlots > MAX_MAILBOX_SLOTS) ||
+      ((NumSlots & (NumSlots - 1)) != 0) ||
+      (NumMailboxes == ARRAY_SIZE(MailboxList)))
+  {
+    return false;
+  }
+  pBox->pSlots        = pSlots;
+  pBox->Mask          = NumSlots - 1;
+  pBox->WhichService  = WhichService;
+  pBox->Head          = 0;
+  pBox->Tail          = 0;
+  pBox->Dropped       = 0;
+  MailboxList[NumMailboxes++] = pBox;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_Mailbox_Post
+ Parameters
+   ES_Mailbox_t * : the mailbox to post to
+   ES_Event_t : the event to post
+ Returns
+   bool : false if the mailbox was full and the event was dropped
+ Description
+   adds the event to the mailbox. The framework moves it to the service's
+   queue the next time that it processes pending interrupts
+ Notes
+   meant to be called only from the one ISR that owns the mailbox. It does
+   not disable interrupts
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_Mailbox_Post(ES_Mailbox_t *pBox, ES_Event_t ThisEvent)
+{
+  uint8_t Head = pBox->Head;  // only we change Head, no need to synchronize
+
+  if ((uint8_t)(Head - ES_LoadAcquire(&pBox->Tail)) > pBox->Mask)
+  {
+    pBox->Dropped++;
+    return false;
+  }
+  pBox->pSlots[Head & pBox->Mask] = ThisEvent;
+  // publish the slot only after the event is in it
+  ES_StoreRelease(&pBox->Head, (uint8_t)(Head + 1));
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_Mailbox_DrainAll
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   moves the events waiting in every mailbox to their services' queues
+ Notes
+   called from _HW_Process_Pending_Ints. If a service's queue is full, the
+   rest of its mailbox is left for the next pass rather than lost
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Mailbox_DrainAll(void)
+{
+  uint8_t       i;
+  ES_Mailbox_t  *pBox;
+  uint8_t       Head;
+  uint8_t       Tail;
+
+  ES_TRACE_SET_FROM(ES_TRACE_FROM_ISR);
+  for (i = 0; i < NumMailboxes; i++)
+  {
+    pBox  = MailboxList[i];
+    Tail  = pBox->Tail;   // only we change Tail
+    Head  = ES_LoadAcquire(&pBox->Head);
+    while (Tail != Head)
+    {
+      if (ES_PostToService(pBox->WhichService,
+          pBox->pSlots[Tail & pBox->Mask]) != true)
+      {
+        break;  // no room in the queue, try again next time
+      }
+      Tail++;
+      // hand the slot back to the ISR only after we are done with it
+      ES_StoreRelease(&pBox->Tail, Tail);
+    }
+  }
+  ES_TRACE_SET_FROM(ES_TRACE_FROM_MAIN);
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+#ifdef TEST
+/* Host stress test. An "ISR" thread pushes a numbered stream of events as
+   fast as it can while the main thread drains, then the same stream is sent
+   through an ES_Queue guarded by a lock, standing in for the interrupt
+   disable that POST_FROM_INTS puts around every queue operation. For each
+   path it reports the longest time that the producer spent in a post and the
+   longest time that it was locked out (the interrupt-disable window).
+   When the buffer is full the producer yields rather than spin, so the test
+   also runs on a single core host.
+   Build on the host with the stand-in xc.h and pthreads, compiling
+   ES_Queue.c without TEST so that only this main is included, e.g.
+     gcc -c -I<stub> -IFrameworkHeaders FrameworkSource/ES_Queue.c
+     gcc -DTEST -O2 -I<stub> -IFrameworkHeaders -IProjectHeaders
+       FrameworkSource/ES_Mailbox.c ES_Queue.o -lpthread
+*/
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "ES_Queue.h"
+
+#define NUM_TEST_EVENTS 200000UL
+
+static ES_Mailbox_t       TestBox;
+static ES_Event_t         TestSlots[8];
+static ES_Event_t         TestQueue[8 + 1];
+static pthread_mutex_t    QueueLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t           NextExpected;
+static uint32_t           NumOutOfOrder;
+static uint32_t           RefuseCount;
+static uint32_t           MaxPost;
+static uint32_t           MaxWindow;
+
+// stands in for the framework: checks the sequence and, every so often,
+// refuses the event the way a full queue would
+bool ES_PostToService(uint8_t WhichService, ES_Event_t ThisEvent)
+{
+  if ((++RefuseCount % 97) == 0)
+  {
+    return false;
+  }
+  if (ThisEvent.EventParam != (uint16_t)NextExpected)
+  {
+    NumOutOfOrder++;
+  }
+  NextExpected++;
+  return true;
+}
+
+static void *MailboxProducer(void *pUnused)
+{
+  uint32_t    i;
+  uint32_t    Start, Took;
+  ES_Event_t  ThisEvent = { ES_SHORT_TIMEOUT, 0 };
+
+  for (i = 0; i < NUM_TEST_EVENTS; i++)
+  {
+    ThisEvent.EventParam = (uint16_t)i;
+    do
+    {
+      Start = _HW_GetCoreTicks();
+      bool Posted = ES_Mailbox_Post(&TestBox, ThisEvent);
+      Took = _HW_GetCoreTicks() - Start;
+      if (Took > MaxPost)
+      {
+        MaxPost = Took;
+      }
+      if (Posted)
+      {
+        break;
+      }
+      sched_yield();
+    } while (1);
+  }
+  return pUnused;
+}
+
+static void *QueueProducer(void *pUnused)
+{
+  uint32_t    i;
+  uint32_t    Start, Took;
+  bool        Posted;
+  ES_Event_t  ThisEvent = { ES_SHORT_TIMEOUT, 0 };
+
+  for (i = 0; i < NUM_TEST_EVENTS; i++)
+  {
+    ThisEvent.EventParam = (uint16_t)i;
+    do
+    {
+      Start = _HW_GetCoreTicks();
+      pthread_mutex_lock(&QueueLock);
+      Posted = ES_EnQueueFIFO(TestQueue, ThisEvent);
+      pthread_mutex_unlock(&QueueLock);
+      Took = _HW_GetCoreTicks() - Start;
+      if (Took > MaxPost)
+      {
+        MaxPost = Took;
+      }
+      if (!Posted)
+      {
+        sched_yield();
+      }
+    } while (!Posted);
+  }
+  return pUnused;
+}
+
+int main(void)
+{
+  pthread_t   Producer;
+  ES_Event_t  ThisEvent;
+  uint32_t    Start, Took;
+  uint8_t     NumLeft;
+
+  // lock-free mailbox
+  ES_Mailbox_Init(&TestBox, TestSlots, ARRAY_SIZE(TestSlots), 0);
+  pthread_create(&Producer, NULL, MailboxProducer, NULL);
+  while (NextExpected < NUM_TEST_EVENTS)
+  {
+    ES_Mailbox_DrainAll();
+    sched_yield();
+  }
+  pthread_join(Producer, NULL);
+  printf("mailbox: %lu events, %u out of order, %u pushes found it full, "
+      "max post %u ticks, max window 0 ticks\n", NUM_TEST_EVENTS,
+      NumOutOfOrder, TestBox.Dropped, MaxPost);
+
+  // queue behind a lock
+  MaxPost       = 0;
+  NextExpected  = 0;
+  NumOutOfOrder = 0;
+  ES_InitQueue(TestQueue, ARRAY_SIZE(TestQueue));
+  pthread_create(&Producer, NULL, QueueProducer, NULL);
+  while (NextExpected < NUM_TEST_EVENTS)
+  {
+    Start = _HW_GetCoreTicks();
+    pthread_mutex_lock(&QueueLock);
+    NumLeft = ES_DeQueue(TestQueue, &ThisEvent);
+    pthread_mutex_unlock(&QueueLock);
+    Took = _HW_GetCoreTicks() - Start;
+    if (Took > MaxWindow)
+    {
+      MaxWindow = Took;
+    }
+    if (ThisEvent.EventType == ES_SHORT_TIMEOUT)
+    {
+      if (ThisEvent.EventParam != (uint16_t)NextExpected)
+      {
+        NumOutOfOrder++;
+      }
+      NextExpected++;
+    }
+    else
+    {
+      sched_yield();  // empty, let the producer run
+    }
+    NumLeft++; // keep the compiler quiet
+  }
+  pthread_join(Producer, NULL);
+  printf("locked queue: %lu events, %u out of order, "
+      "max post %u ticks, max window %u ticks\n", NUM_TEST_EVENTS,
+      NumOutOfOrder, MaxPost, MaxWindow);
+  printf("(ticks are 50ns, matching the 20MHz core timer)\n");
+  return 0;
+}
+#endif
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
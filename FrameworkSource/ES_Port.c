@@ -13,6 +13,15 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 07:00 agt     the tickless interrupt moves the compare on, so that
+                        the core timer interrupt flag can be cleared
+ 10/17/26 21:10 agt     SysTickCounter is 32 bits, added _HW_GetTickCount32
+ 10/17/26 20:30 agt     with ES_TICKLESS the core timer compare is set for the
+                        next timer to run out instead of every tick
+ 10/17/26 19:40 agt     missed ticks are passed to the timers in one call
+ 10/17/26 14:20 agt     _HW_Process_Pending_Ints drains the ISR mailboxes. The
+                        tick ISR disables interrupts itself now that
+                        EnterCritical is empty without POST_FROM_INTS
  08/06/21 15:43 jec     no changes just a test of using GIT from within MPLABX
  08/06/21 13:04 jec     cleaned things up in preparation for the 2021 AY
  10/05/20 18:52 ram     started work on port to PIC32MX170F256B
@@ -70,12 +79,16 @@
 #include <stdint.h>         // for exact size data types
 #include <stdbool.h>        // for the bool data type
 
+#include "ES_Configure.h"   // for ES_TICKLESS
 #include "ES_Port.h"        // the header file for this module
 #include "ES_Types.h"       // framework type definitions
 #include "ES_Timers.h"      // framework timer prototypes
+#include "ES_Mailbox.h"     // to drain the ISR mailboxes
+#include "ES_Tickless.h"    // tickless time base
 
 #include "terminal.h"       // terminal prototypes for init function
 
+#ifndef ES_TICKLESS
 // TickCount is used to track the number of timer ints that have occurred
 // since the last check. It should really never be more than 1, but just to
 // be sure, we increment it in the interrupt response rather than simply
@@ -86,9 +99,10 @@
 static volatile uint8_t TickCount;
 
 // Global tick count to monitor number of SysTick Interrupts
-// make uint16_t to maintain backwards compatibility and not overly burden
-// 8 and 16 bit processors
-static volatile uint16_t SysTickCounter = 0;
+// 32 bits, so that it takes 49 days at 1mS ticks to wrap. _HW_GetTickCount
+// still returns the low 16 bits for backwards compatibility
+static volatile uint32_t SysTickCounter = 0;
+#endif
 
 // Rate value that needs to be continually added to the compare register to 
 // ensure the interrupts occur periodically
@@ -155,11 +169,16 @@ void _HW_Timer_Init(const TimerRate_t Rate)
     // copy over rate value to module var
     tickPeriod = Rate;
         
+#ifdef ES_TICKLESS
+    // the compare is set for the first timer to run out, not the next tick
+    ES_Tickless_Init(Rate);
+#else
     // get the current sys clock time
     uint32_t currTime = _CP0_GET_COUNT();
     // add the rate to i1t         
     // place value into compare register
     _CP0_SET_COMPARE(currTime + Rate);
+#endif
     // Use multivector
     INTCONbits.MVEC = 1;
     // Set Core Timer CT interrupt priority to 3
@@ -197,9 +216,21 @@ void _HW_Timer_Init(const TimerRate_t Rate)
      As currently (4/21/19) implemented this does not actually post events
      but simply increments a counter to indicate that the interrupt has occurred.
      the framework response is handled below in _HW_Process_Pending_Ints
+     With ES_TICKLESS the interrupt only comes when a timer is due, and all it
+     does is end a wait, as _HW_Process_Pending_Ints reads the core count.
+     The core timer keeps its interrupt request up until the compare is
+     written, so the compare is moved out of the way first.
+     ES_Tickless_Service sets it for the next deadline
  Author
     R. Merchant, 10/05/20  18:57
 ****************************************************************************/
+#ifdef ES_TICKLESS
+void __ISR(_CORE_TIMER_VECTOR, IPL3AUTO ) _HW_SysTickIntHandler(void)
+{
+  _HW_WriteCoreCompare(_HW_ReadCoreCount() + ES_TICKLESS_MAX_WAIT);
+  IFS0CLR = _IFS0_CTIF_MASK;
+}
+#else
 void __ISR(_CORE_TIMER_VECTOR, IPL3AUTO ) _HW_SysTickIntHandler(void)
 {
   static uint32_t deltaTime; // static for speed
@@ -214,7 +245,9 @@ void __ISR(_CORE_TIMER_VECTOR, IPL3AUTO ) _HW_SysTickIntHandler(void)
   // of the compare register. If that happened, we could end up programming the 
   // compare for a time that had already passed, resulting in a loss of 
   // tick interrupts until the CoreTimer rolled around.
-  EnterCritical();
+  // This has to happen whether or not POST_FROM_INTS is defined, so we
+  // don't use EnterCritical/ExitCritical here
+  __builtin_disable_interrupts();
   // get the time difference since the interrupt
   deltaTime = _CP0_GET_COUNT() - _CP0_GET_COMPARE();
   
@@ -253,7 +286,7 @@ void __ISR(_CORE_TIMER_VECTOR, IPL3AUTO ) _HW_SysTickIntHandler(void)
     _CP0_SET_COMPARE(_CP0_GET_COMPARE() + 
       (intsThatShouldHaveHappened * tickPeriod));
   }// end if (deltaTime < tickPeriod - 12)
-  ExitCritical();
+  __builtin_enable_interrupts();
   // and keep our tick counters going
   TickCount += intsThatShouldHaveHappened;
   SysTickCounter += intsThatShouldHaveHappened;
@@ -263,6 +296,7 @@ void __ISR(_CORE_TIMER_VECTOR, IPL3AUTO ) _HW_SysTickIntHandler(void)
   LATBbits.LATB15 = ~LATBbits.LATB15;
 #endif
 }
+#endif /* ES_TICKLESS */
 
 /****************************************************************************
  Function
@@ -281,7 +315,30 @@ void __ISR(_CORE_TIMER_VECTOR, IPL3AUTO ) _HW_SysTickIntHandler(void)
 ****************************************************************************/
 uint16_t _HW_GetTickCount(void)
 {
+  return (uint16_t)_HW_GetTickCount32();
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTickCount32()
+ Parameters
+    none
+ Returns
+    uint32_t   count of number of system ticks that have occurred.
+ Description
+    the full 32 bit tick count, for ES_Timer_GetTime32
+ Notes
+    a 32 bit read is a single load on the PIC32, so the ISR can't split it
+ Author
+    agt, 10/17/26
+****************************************************************************/
+uint32_t _HW_GetTickCount32(void)
+{
+#ifdef ES_TICKLESS
+  return ES_Tickless_GetTickCount();
+#else
   return SysTickCounter;
+#endif
 }
 
 /****************************************************************************
@@ -302,19 +359,38 @@ uint16_t _HW_GetTickCount(void)
      run function is called and even when there are no queues with events.
      This routine could be expanded to process any other interrupt sources
      that you would like to use to post events to the framework services.
+     Events that ISRs left in their mailboxes are moved to the service
+     queues here.
+     With ES_TICKLESS the timers are brought up to date here once the core
+     count reaches the next deadline.
  Author
      J. Edward Carryer, 08/13/13 13:27
 ****************************************************************************/
 bool _HW_Process_Pending_Ints(void)
 {
+#ifndef ES_TICKLESS
+  uint8_t PendingTicks;
+#endif
+
+  ES_Mailbox_DrainAll();
+
+#ifdef ES_TICKLESS
+  ES_Tickless_Service();
+#else
   // in the case where there was a long delay in getting to this function,
   // multiple interrupts may have occurred (TickCount > 1), so process them all
-  while (TickCount > 0)
+  // in one pass
+  if (TickCount > 0)
   {
+    // mask the tick int while taking the count, so no tick can be lost
+    IEC0CLR       = _IEC0_CTIE_MASK;
+    PendingTicks  = TickCount;
+    TickCount     = 0;
+    IEC0SET       = _IEC0_CTIE_MASK;
     /* call the framework tick response to actually run the timers */
-    ES_Timer_Tick_Resp();
-    TickCount--;
+    ES_Timer_MultiTick_Resp(PendingTicks);
   }
+#endif
   return true;  // always return true to allow loop test in ES_Run to proceed
 }
 
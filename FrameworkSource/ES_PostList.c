@@ -9,6 +9,9 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 16:40 agt     list posts are all-or-nothing
+ 10/17/26 15:55 agt     lists are posted as broadcasts, so services that have
+                        not subscribed to the event are skipped
  10/26/17 18:20 jec     moved prototype of PostToList into the conditional to
                         eliminate warning when not using distribution lists
  08/05/13 15:04 jec      added #includes for ES_Port & ES_Types and converted
@@ -23,6 +26,7 @@
 #include "../FrameworkHeaders/ES_Configure.h"
 #include "../FrameworkHeaders/ES_General.h"
 #include "../FrameworkHeaders/ES_PostList.h"
+#include "../FrameworkHeaders/ES_Framework.h"
 #include "../FrameworkHeaders/ES_ServiceHeaders.h"
 
 /*---------------------------- Module Functions ---------------------------*/
@@ -164,17 +168,22 @@ bool ES_PostList07(ES_Event_t NewEvent)
    EF_Event NewEvent : the new event to be passed to each of the state machine
    posting functions in the list
  Returns
-   bool: true if all the post functions succeeded, false if any failed
+   bool: true if all the post functions succeeded, false if any failed, in
+   which case none of the state machines got the event
  Description
    Posts NewEvent to all of the state machines listed in the list
  Notes
-
+   the posts are made as a broadcast, so state machines that have not
+   subscribed to this type of event don't get it. The post functions only
+   collect the targets; ES_EndBroadcast posts to them once it knows that
+   all of them have room
  Author
    J. Edward Carryer, 10/24/11, 07:52
 ****************************************************************************/
 static bool PostToList(PostFunc_t *const *List, uint8_t ListSize, ES_Event_t NewEvent)
 {
   uint8_t i;
+  ES_BeginBroadcast();
   // loop through the list executing the post functions
   for (i = 0; i < ListSize; i++)
   {
@@ -183,14 +192,8 @@ static bool PostToList(PostFunc_t *const *List, uint8_t ListSize, ES_Event_t New
       break; // this is a failed post
     }
   }
-  if (i != ListSize)   // if no failures, i = ListSize
-  {
-    return false;
-  }
-  else
-  {
-    return true;
-  }
+  // if no failures, i = ListSize
+  return ES_EndBroadcast(i == ListSize);
 }
 
 #endif /* NUM_DIST_LISTS > 0*/
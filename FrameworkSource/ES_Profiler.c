@@ -0,0 +1,318 @@
+/****************************************************************************
+ Module
+     ES_Profiler.c
+ Description
+     Accumulates the time taken by each run function, split by the type of
+     event it was handed, and by each event checker in EVENT_CHECK_LIST.
+     For each one it keeps the min, max and mean time in core timer ticks
+     (2 instruction cycles each) and a log2 histogram.
+ Notes
+     ES_Run and ES_CheckUserEvents do the timing and call the Record
+     functions. The dump is written a line at a time from ES_Run's idle loop,
+     whenever the terminal buffer has room, so it never overruns the buffer
+     and never holds up the tick processing.
+     When ES_PROFILER is not defined this module compiles to nothing.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26 13:05 agt      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+
+#ifdef ES_PROFILER
+
+#include "ES_Profiler.h"
+#include "ES_General.h"
+#include "ES_LookupTables.h"
+#include "ES_CheckEvents.h"
+#include "EventCheckWrapper.h"
+#include "terminal.h"
+#include "dbprintf.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+typedef struct
+{
+  uint8_t   Who;    // service number for run cells, checker number otherwise
+  uint8_t   What;   // event type, run cells only
+  uint32_t  Count;
+  uint32_t  Min;
+  uint32_t  Max;
+  uint64_t  Total;
+  uint16_t  Histogram[ES_PROFILE_NUM_BINS];
+}ProfileCell_t;
+
+// let the compiler count the entries in EVENT_CHECK_LIST for us
+#define NUM_CHECKERS \
+  (sizeof((CheckFunc *[]){ EVENT_CHECK_LIST }) / sizeof(CheckFunc *))
+
+// turn the list of checkers into a string for the dump
+#define LIST_TO_STRING(...) #__VA_ARGS__
+#define EXPAND_TO_STRING(...) LIST_TO_STRING(__VA_ARGS__)
+
+// don't start a line of the dump unless the terminal buffer has this much room
+#define DUMP_LINE_ROOM 160
+
+// the lines of the dump before the cells
+#define NUM_HEADER_LINES 2
+
+/*---------------------------- Module Functions ---------------------------*/
+static void AddSample(ProfileCell_t *pCell, uint32_t Ticks);
+static void PrintCell(char Kind, ProfileCell_t *pCell);
+
+/*---------------------------- Module Variables ---------------------------*/
+// run cells are handed out in the order that the pairs are first seen.
+// RunCellIndex holds the cell number + 1 for each pair, 0 for none yet
+static ProfileCell_t  RunCells[ES_PROFILE_MAX_PAIRS];
+static uint8_t        NumRunCells;
+static uint8_t        RunCellIndex[NUM_SERVICES][ES_PROFILE_NUM_EVENT_TYPES];
+// calls not recorded because all of the run cells were in use
+static uint32_t       MissedRuns;
+
+static ProfileCell_t  CheckCells[NUM_CHECKERS];
+
+// which line of the dump is next, and are we dumping at all
+static uint8_t        DumpLine;
+static bool           Dumping;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_Profile_RecordRun
+ Parameters
+   uint8_t : the service whose run function was called
+   ES_EventType_t : the type of the event it was handed
+   uint32_t : how long the call took in core timer ticks
+ Returns
+   nothing
+ Description
+   adds the call to the cell for this service/event type pair, claiming a
+   new cell the first time the pair is seen
+ Notes
+   called from ES_Run
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Profile_RecordRun(uint8_t WhichService, ES_EventType_t WhichEvent,
+    uint32_t Ticks)
+{
+  uint8_t EventIndex;
+  uint8_t *pIndex;
+
+  EventIndex = (WhichEvent < ES_PROFILE_NUM_EVENT_TYPES) ?
+      (uint8_t)WhichEvent : ES_PROFILE_NUM_EVENT_TYPES - 1;
+  pIndex = &RunCellIndex[WhichService][EventIndex];
+  if (*pIndex == 0)   // first time for this pair
+  {
+    if (NumRunCells == ARRAY_SIZE(RunCells))
+    {
+      MissedRuns++;
+      return;
+    }
+    RunCells[NumRunCells].Who   = WhichService;
+    RunCells[NumRunCells].What  = EventIndex;
+    *pIndex = ++NumRunCells;
+  }
+  AddSample(&RunCells[*pIndex - 1], Ticks);
+}
+
+/****************************************************************************
+ Function
+   ES_Profile_RecordCheck
+ Parameters
+   uint8_t : the index of the checker in EVENT_CHECK_LIST
+   uint32_t : how long the call took in core timer ticks
+ Returns
+   nothing
+ Description
+   adds the call to the checker's cell
+ Notes
+   called from ES_CheckUserEvents
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Profile_RecordCheck(uint8_t WhichChecker, uint32_t Ticks)
+{
+  if (WhichChecker < ARRAY_SIZE(CheckCells))
+  {
+    AddSample(&CheckCells[WhichChecker], Ticks);
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_Profile_Reset
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   throws away everything recorded so far
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Profile_Reset(void)
+{
+  uint8_t i, j;
+
+  for (i = 0; i < NUM_SERVICES; i++)
+  {
+    for (j = 0; j < ES_PROFILE_NUM_EVENT_TYPES; j++)
+    {
+      RunCellIndex[i][j] = 0;
+    }
+  }
+  NumRunCells = 0;
+  MissedRuns  = 0;
+  for (i = 0; i < ARRAY_SIZE(CheckCells); i++)
+  {
+    CheckCells[i].Count = 0;
+    for (j = 0; j < ES_PROFILE_NUM_BINS; j++)
+    {
+      CheckCells[i].Histogram[j] = 0;
+    }
+  }
+  for (i = 0; i < ARRAY_SIZE(RunCells); i++)
+  {
+    RunCells[i].Count = 0;
+    for (j = 0; j < ES_PROFILE_NUM_BINS; j++)
+    {
+      RunCells[i].Histogram[j] = 0;
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_Profile_StartDump
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   starts printing the profile to the terminal. The printing itself happens
+   in ES_Profile_DumpStep
+ Notes
+   the cells keep accumulating while the dump is in progress
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Profile_StartDump(void)
+{
+  DumpLine  = 0;
+  Dumping   = true;
+}
+
+/****************************************************************************
+ Function
+   ES_Profile_DumpStep
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   prints the next lines of a dump started with ES_Profile_StartDump, as
+   long as the terminal buffer has room for them
+ Notes
+   called from the idle part of ES_Run. Run cells are printed as
+   S<service> E<event type>, checker cells as C<index in EVENT_CHECK_LIST>.
+   Times are in core timer ticks, histogram bin n counts the calls that took
+   from 2^n up to 2^(n+1) ticks
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Profile_DumpStep(void)
+{
+  while (Dumping && (Terminal_GetXmitSpace() >= DUMP_LINE_ROOM))
+  {
+    if (DumpLine == 0)
+    {
+      DB_printf("\r\nProfile in core ticks (%d per us), %d pairs, %u missed\r\n",
+          ES_CORE_TICKS_PER_US, NumRunCells, MissedRuns);
+    }
+    else if (DumpLine == 1)
+    {
+      DB_printf("Checkers: %s\r\n", EXPAND_TO_STRING(EVENT_CHECK_LIST));
+    }
+    else if (DumpLine < NUM_HEADER_LINES + NumRunCells)
+    {
+      PrintCell('S', &RunCells[DumpLine - NUM_HEADER_LINES]);
+    }
+    else if (DumpLine <
+        NUM_HEADER_LINES + NumRunCells + ARRAY_SIZE(CheckCells))
+    {
+      PrintCell('C', &CheckCells[DumpLine - NUM_HEADER_LINES - NumRunCells]);
+    }
+    else
+    {
+      Dumping = false;
+    }
+    DumpLine++;
+  }
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+// folds one timing into a cell
+static void AddSample(ProfileCell_t *pCell, uint32_t Ticks)
+{
+  uint8_t Bin;
+
+  if ((pCell->Count == 0) || (Ticks < pCell->Min))
+  {
+    pCell->Min = Ticks;
+  }
+  if ((pCell->Count == 0) || (Ticks > pCell->Max))
+  {
+    pCell->Max = Ticks;
+  }
+  if (pCell->Count == 0)
+  {
+    pCell->Total = 0;
+  }
+  pCell->Count++;
+  pCell->Total += Ticks;
+
+  Bin = (Ticks == 0) ? 0 : ES_GetMSBitSet32(Ticks);
+  if (Bin >= ES_PROFILE_NUM_BINS)
+  {
+    Bin = ES_PROFILE_NUM_BINS - 1;
+  }
+  if (pCell->Histogram[Bin] != UINT16_MAX)
+  {
+    pCell->Histogram[Bin]++;
+  }
+}
+
+// prints one line of the dump, skipping cells that never saw a call
+static void PrintCell(char Kind, ProfileCell_t *pCell)
+{
+  uint8_t i;
+
+  if (pCell->Count == 0)
+  {
+    return;
+  }
+  if (Kind == 'S')
+  {
+    DB_printf("S%d E%d:", pCell->Who, pCell->What);
+  }
+  else
+  {
+    DB_printf("C%d:", (int)(pCell - CheckCells));
+  }
+  DB_printf(" n %u min %u mean %u max %u |", pCell->Count, pCell->Min,
+      (uint32_t)(pCell->Total / pCell->Count), pCell->Max);
+  for (i = 0; i < ES_PROFILE_NUM_BINS; i++)
+  {
+    DB_printf(" %u", pCell->Histogram[i]);
+  }
+  DB_printf("\r\n");
+}
+
+#endif /* ES_PROFILER */
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
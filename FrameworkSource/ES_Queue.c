@@ -5,35 +5,43 @@
  Description
      Implements a FIFO circular buffer of EF_Event in a block of memory
  Notes
-
+     The queues are ES_RingQueue_t rings (see ES_RingQueue.c) whose events
+     are kept in the block. The ring headers come from a pool of
+     ES_MAX_BLOCK_QUEUES, and the first element of the block holds the
+     number of the one in use, so the functions here only look that up and
+     pass the call on.
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 07:30 agt      the broadcast benchmark reports the fastest and the
+                         median of repeated runs
+ 10/18/26 05:10 agt      a block too small for any events no longer uses up
+                         a ring, added its test
+ 10/17/26 18:45 agt      rewritten as a wrapper for the power of 2 ring
+                         queues, capacities round down to a power of 2
+ 10/17/26 17:30 agt      added the overflow policies, kept in the spare byte
+                         of the queue header, and their tests
+ 10/17/26 16:40 agt      added ES_QueueSpace for all-or-nothing broadcasts, and
+                         a broadcast benchmark to the test
+ 10/17/26 15:10 agt      updated the notes and test for the 4 byte event, added
+                         a RAM report and copy benchmark to the test
  01/15/12 09:34 jec      converted to use the new C99 types from types.h
  08/09/11 18:16 jec      started coding
 *****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
 #include "../FrameworkHeaders/ES_Configure.h"
 #include "../FrameworkHeaders/ES_Queue.h"
-#include "../FrameworkHeaders/ES_Port.h" /* get the macros for EnterCritical and ExitCritical */
+#include <stddef.h>
 
 /*----------------------------- Module Defines ----------------------------*/
-// QueueSize is max number of entries in the queue
-// CurrentIndex is the 'read-from' index,
-// actually CurrentIndex + sizeof(EF_Queue_t)
-// entries are made to CurrentIndex + NumEntries + sizeof(ES_Queue_t)
-typedef struct
-{
-  uint8_t QueueSize;
-  uint8_t CurrentIndex;
-  uint8_t NumEntries;
-}ES_Queue_t;
-
-typedef ES_Queue_t *pQueue_t;
+// the largest capacity a block can have, with a uint8_t BlockSize
+#define MAX_BLOCK_CAPACITY 128
 
 /*---------------------------- Module Functions ---------------------------*/
 
 /*---------------------------- Module Variables ---------------------------*/
+static ES_RingQueue_t BlockRings[ES_MAX_BLOCK_QUEUES];
+static uint8_t        NumBlockRings;
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -43,28 +51,102 @@ typedef ES_Queue_t *pQueue_t;
    EF_Event * pBlock : pointer to the block of memory to use for the Queue
    unsigned char BlockSize: size of the block pointed to by pBlock
  Returns
-   max number of entries in the created queue
+   max number of entries in the created queue, 0 if there was no ring left
+   in the pool or the block has no room for an event
  Description
-   Initializes a queue structure at the beginning of the block of memory
+   Initializes a queue in the block of memory
  Notes
-   you should pass it a block that is at least sizeof(ES_Queue_t) larger than
-   the number of entries that you want in the queue. Since the size of an
-   ES_Event (at 4 bytes; 2 enum, 2 param) is greater than the
-   sizeof(ES_Queue_t), you only need to declare an array of ES_Event
-   with 1 more element than you need for the actual queue.
+   the first element of the block is used to find the queue, the rest hold
+   its events. The capacity is the largest power of 2 that fits in the rest,
+   so declare an array of ES_Event with 1 more element than a power of 2,
+   e.g. ES_Event_t Queue[8 + 1].
+   Initializing the same block again empties it without using up another
+   ring. New queues reject posts when full, see ES_SetQueuePolicy
  Author
    J. Edward Carryer, 08/09/11, 18:40
 ****************************************************************************/
 uint8_t ES_InitQueue(ES_Event_t *pBlock, uint8_t BlockSize)
 {
-  pQueue_t pThisQueue;
-  // initialize the Queue by setting up initial values for elements
-  pThisQueue = (pQueue_t)pBlock;
-  // use all but the structure overhead as the Queue
-  pThisQueue->QueueSize     = BlockSize - 1;
-  pThisQueue->CurrentIndex  = 0;
-  pThisQueue->NumEntries    = 0;
-  return pThisQueue->QueueSize;
+  uint8_t Capacity;
+  uint8_t WhichRing;
+
+  if (BlockSize < 2)
+  {
+    // no room for any events, so do not use up a ring on it
+    if (BlockSize == 1)
+    {
+      pBlock[0].EventType = ES_MAX_BLOCK_QUEUES; // marks it as having no ring
+    }
+    return 0;
+  }
+  WhichRing = (uint8_t)pBlock[0].EventType;
+  if ((WhichRing >= NumBlockRings) ||
+      (BlockRings[WhichRing].pEvents != &pBlock[1]))
+  {
+    if (NumBlockRings >= ES_MAX_BLOCK_QUEUES)
+    {
+      pBlock[0].EventType = ES_MAX_BLOCK_QUEUES; // marks it as having no ring
+      return 0;
+    }
+    WhichRing = NumBlockRings++;
+    pBlock[0].EventType = WhichRing;
+  }
+  // use all but the first element, rounded down to a power of 2
+  for (Capacity = MAX_BLOCK_CAPACITY; Capacity > BlockSize - 1; Capacity >>= 1)
+  {}
+  ES_Ring_Init(&BlockRings[WhichRing], &pBlock[1], Capacity);
+  return Capacity;
+}
+
+/****************************************************************************
+ Function
+   ES_GetBlockRing
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   ES_RingQueue_t * : the ring that keeps its events in the block, NULL if
+   ES_InitQueue could not give it one
+ Description
+   lets the bulk ring functions be used on a queue set up with ES_InitQueue
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+ES_RingQueue_t *ES_GetBlockRing(ES_Event_t *pBlock)
+{
+  if (pBlock[0].EventType >= NumBlockRings)
+  {
+    return NULL;
+  }
+  return &BlockRings[pBlock[0].EventType];
+}
+
+/****************************************************************************
+ Function
+   ES_SetQueuePolicy
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_QueuePolicy_t NewPolicy : what FIFO posts should do when the queue is
+     full or already holds the same event
+ Returns
+   nothing
+ Description
+   sets the overflow policy used by ES_EnQueueFIFO and
+   ES_EnQueueFIFOWithPolicy
+ Notes
+   LIFO posts always reject when the queue is full
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_SetQueuePolicy(ES_Event_t *pBlock, ES_QueuePolicy_t NewPolicy)
+{
+  ES_RingQueue_t *pRing = ES_GetBlockRing(pBlock);
+
+  if (pRing != NULL)
+  {
+    ES_Ring_SetPolicy(pRing, NewPolicy);
+  }
 }
 
 /****************************************************************************
@@ -74,34 +156,68 @@ uint8_t ES_InitQueue(ES_Event_t *pBlock, uint8_t BlockSize)
    ES_Event * pBlock : pointer to the block of memory in use as the Queue
    ES_Event Event2Add : event to be added to the Queue
  Returns
-   bool : true if the add was successful, false if not
+   bool : true if the add was successful (or the queue's policy made it
+   unnecessary), false if not
  Description
    if it will fit, adds Event2Add to the Queue
  Notes
-
+   see ES_EnQueueFIFOWithPolicy
   Author
    J. Edward Carryer, 08/09/11, 18:59
 ****************************************************************************/
 bool ES_EnQueueFIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
 {
-  pQueue_t pThisQueue;
-  pThisQueue = (pQueue_t)pBlock;
-  // index will go from 0 to QueueSize-1 so use '<' to test if there is space
-  if (pThisQueue->NumEntries < pThisQueue->QueueSize) // save the new event, use % to create circular buffer in block
-  {   
-    EnterCritical();  // save interrupt state, turn ints off
-// 1+ to step past the Queue struct at the beginning of the block
-	pBlock[1 + ((pThisQueue->CurrentIndex + pThisQueue->NumEntries)
-          % pThisQueue->QueueSize)] = Event2Add;
-    pThisQueue->NumEntries++; // inc number of entries
-    ExitCritical();    // restore saved interrupt state
-
-    return true;
-  }
-  else
+  return ES_EnQueueFIFOWithPolicy(pBlock, Event2Add) != ES_ENQUEUE_REJECTED;
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueFIFOWithPolicy
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event to be added to the Queue
+ Returns
+   ES_EnQueueResult_t : what became of Event2Add
+ Description
+   adds Event2Add to the end of the Queue, applying the queue's policy,
+   see ES_Ring_EnQueueFIFO
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+ES_EnQueueResult_t ES_EnQueueFIFOWithPolicy(ES_Event_t *pBlock,
+    ES_Event_t Event2Add)
+{
+  ES_RingQueue_t *pRing = ES_GetBlockRing(pBlock);
+
+  if (pRing == NULL)
   {
-    return false;
+    return ES_ENQUEUE_REJECTED;
   }
+  return ES_Ring_EnQueueFIFO(pRing, Event2Add);
+}
+
+/****************************************************************************
+ Function
+   ES_CanEnQueueFIFO
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event Event2Add : event that might be added to the Queue
+ Returns
+   bool : true if a FIFO post of Event2Add would succeed right now
+ Description
+   checks for room, or for a policy that would take the event anyway
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_CanEnQueueFIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
+{
+  ES_RingQueue_t *pRing = ES_GetBlockRing(pBlock);
+
+  return (pRing != NULL) && ES_Ring_CanEnQueueFIFO(pRing, Event2Add);
 }
 
 /****************************************************************************
@@ -123,35 +239,9 @@ bool ES_EnQueueFIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
 ****************************************************************************/
 bool ES_EnQueueLIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
 {
-  pQueue_t pThisQueue;
-  pThisQueue = (pQueue_t)pBlock;
-  // index will go from 0 to QueueSize-1 so use '<' to test if there is space
-  if (pThisQueue->NumEntries < pThisQueue->QueueSize)
-  {
-#ifdef POST_FROM_INTS
-    EnterCritical();  // save interrupt state, turn ints off
-#endif
-    // OK, there is space note that the queue now has 1 more entry
-    pThisQueue->NumEntries++;
-    // Check to see if we need to wrap around as we back up index
-    if (pThisQueue->CurrentIndex == 0)
-    {
-      pThisQueue->CurrentIndex = pThisQueue->QueueSize - 1;
-    }
-    else
-    {
-      pThisQueue->CurrentIndex--;
-    }
-    pBlock[1 + pThisQueue->CurrentIndex] = Event2Add;
-#ifdef POST_FROM_INTS
-    ExitCritical();    // restore saved interrupt state
-#endif
-    return true;
-  }
-  else    // in case no room on the queue
-  {
-    return false;
-  }
+  ES_RingQueue_t *pRing = ES_GetBlockRing(pBlock);
+
+  return (pRing != NULL) && ES_Ring_EnQueueLIFO(pRing, Event2Add);
 }
 
 /****************************************************************************
@@ -172,37 +262,15 @@ bool ES_EnQueueLIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
 ****************************************************************************/
 uint8_t ES_DeQueue(ES_Event_t *pBlock, ES_Event_t *pReturnEvent)
 {
-  pQueue_t  pThisQueue;
-  uint8_t   NumLeft;
+  ES_RingQueue_t *pRing = ES_GetBlockRing(pBlock);
 
-  pThisQueue = (pQueue_t)pBlock;
-  if (pThisQueue->NumEntries > 0)
+  if (pRing == NULL)
   {
-#ifdef POST_FROM_INTS
-    EnterCritical();  // save interrupt state, turn ints off
-#endif
-    *pReturnEvent = pBlock[1 + pThisQueue->CurrentIndex];
-    // inc the index
-    pThisQueue->CurrentIndex++;
-    // this way we only do the modulo operation when we really need to
-    if (pThisQueue->CurrentIndex >= pThisQueue->QueueSize)
-    {
-      pThisQueue->CurrentIndex = (uint8_t)(pThisQueue->CurrentIndex % pThisQueue->QueueSize);
-    }
-    //dec number of elements since we took 1 out
-    NumLeft = --pThisQueue->NumEntries;
-#ifdef POST_FROM_INTS
-    ExitCritical();    // restore saved interrupt state
-#endif
-
-  }
-  else     // no items left in the queue
-  {
-    (*pReturnEvent).EventType   = ES_NO_EVENT;
-    (*pReturnEvent).EventParam  = 0;
-    NumLeft                     = 0;
+    pReturnEvent->EventType   = ES_NO_EVENT;
+    pReturnEvent->EventParam  = 0;
+    return 0;
   }
-  return NumLeft;
+  return (uint8_t)ES_Ring_DeQueue(pRing, pReturnEvent);
 }
 
 /****************************************************************************
@@ -221,54 +289,81 @@ uint8_t ES_DeQueue(ES_Event_t *pBlock, ES_Event_t *pReturnEvent)
 ****************************************************************************/
 bool ES_IsQueueEmpty(ES_Event_t *pBlock)
 {
-  pQueue_t pThisQueue;
+  ES_RingQueue_t *pRing = ES_GetBlockRing(pBlock);
 
-  pThisQueue = (pQueue_t)pBlock;
-  return pThisQueue->NumEntries == 0;
+  return (pRing == NULL) || ES_Ring_IsEmpty(pRing);
 }
 
-#if 0
 /****************************************************************************
  Function
-   QueueFlushQueue
+   ES_QueueSpace
  Parameters
-   unsigned char * pBlock : pointer to the block of memory in use as the Queue
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
  Returns
-   nothing
+   uint8_t : the number of events that could be added right now
  Description
-   flushes the Queue by reinitializing the indecies
+   see above
  Notes
-
+   ignores the queue's policy, see ES_CanEnQueueFIFO
  Author
-   J. Edward Carryer, 08/12/06, 19:24
+   agt, 10/17/26
 ****************************************************************************/
-void QueueFlushQueue(uint8_t *pBlock)
+uint8_t ES_QueueSpace(ES_Event_t *pBlock)
 {
-  pQueue_t pThisQueue;
-  // doing this with a Queue structure is not strictly necessary
-  // but makes it clearer what is going on.
-  pThisQueue                = (pQueue_t)pBlock;
-  pThisQueue->CurrentIndex  = 0;
-  pThisQueue->NumEntries    = 0;
-  return;
+  ES_RingQueue_t *pRing = ES_GetBlockRing(pBlock);
+
+  return (pRing == NULL) ? 0 : (uint8_t)ES_Ring_Space(pRing);
 }
 
-#endif
-/***************************************************************************
- private functions
- ***************************************************************************/
 #ifdef TEST
 
 #include <stdio.h>
 #include "ES_General.h"
+#include "dbprintf.h"
+
+// the number of events pushed through a queue by the copy benchmark
+#define NUM_COPY_EVENTS 100000UL
+
+// RAM taken by the queue of service n, including its ring header
+#define QUEUE_RAM(n) (ES_RING_SIZE(SERV_##n##_QUEUE_SIZE) * sizeof(ES_Event_t) \
+    + sizeof(ES_RingQueue_t))
 
-static ES_Event   TestQueue[3 + 1];
+// the number of broadcasts made at each subscriber count
+#define NUM_BROADCASTS 20000UL
+// the timed runs of each broadcast benchmark, after one to warm up
+#define NUM_BENCH_RUNS 31
+#define MAX_SUBSCRIBERS 16
+// a reference to a shared broadcast slot, as it would sit in a queue
+#define SLOT_REF_EVENT 0xFFFF
+
+// a shared broadcast slot: one copy of the event, freed by the last reader
+typedef struct
+{
+  ES_Event_t  Event;
+  uint8_t     RefCount;
+}BroadcastSlot_t;
+
+static ES_Event_t TestQueue[4 + 1];
+static ES_Event_t TinyQueue[1];
+static ES_Event_t SubscriberEvents[MAX_SUBSCRIBERS][4];
+static ES_RingQueue_t SubscriberRings[MAX_SUBSCRIBERS];
+static BroadcastSlot_t Slot;
 volatile uint8_t  NumLeft; // for debugging visibility
 
+static void ReportRAM(void);
+static void TestTinyBlock(void);
+static void TestPolicies(void);
+static void BenchmarkCopies(void);
+static void BenchmarkBroadcasts(uint8_t NumSubscribers);
+static uint32_t TimeCopyBroadcasts(uint8_t NumSubscribers);
+static uint32_t TimeSlotBroadcasts(uint8_t NumSubscribers);
+static void InitSubscriberRings(uint8_t NumSubscribers);
+static void SortTicks(uint32_t *pTicks, uint8_t NumTicks);
+
 void main(void)
 {
-  ES_Event  MyEvent;
-  bool      bReturn;
+  ES_Event_t  MyEvent;
+  bool        bReturn;
 
   ES_InitQueue(TestQueue, ARRAY_SIZE(TestQueue));
   MyEvent.EventType   = 0;
@@ -300,16 +395,21 @@ void main(void)
   bReturn             = ES_EnQueueFIFO(TestQueue, MyEvent);
   bReturn             += 1; // keep that sily optimizer away
 
+  MyEvent.EventType   = 12;
+  MyEvent.EventParam  = 13;
+  bReturn             = ES_EnQueueFIFO(TestQueue, MyEvent);
+  bReturn             += 1; // keep that sily optimizer away
+
   // queue is now full so this one should fail
   MyEvent.EventType   = 6;
   MyEvent.EventParam  = 7;
   bReturn             = ES_EnQueueFIFO(TestQueue, MyEvent);
   bReturn             += 1; // keep that sily optimizer away
 
-  // at this point, the events in the queue should be 0,2,4
-  // so pull off the 0, leaving 2 entries
+  // at this point, the events in the queue should be 0,2,4,12
+  // so pull off the 0, leaving 3 entries
   NumLeft = ES_DeQueue(TestQueue, &MyEvent);
-  if (NumLeft != 2)
+  if (NumLeft != 3)
   {
     bReturn = 0;
   }
@@ -319,15 +419,308 @@ void main(void)
   bReturn             = ES_EnQueueLIFO(TestQueue, MyEvent);
   bReturn             += 1; // keep that sily optimizer away
 
-  // at this point, the events in the queue should be 8,2,4
-  // so pull off the 8, leaving 2 entries
+  // at this point, the events in the queue should be 8,2,4,12
+  // so pull off the 8, leaving 3 entries
   NumLeft = ES_DeQueue(TestQueue, &MyEvent);
   NumLeft += 3; //to keep the compiler from optimizing away the last save
 
+  ReportRAM();
+  TestTinyBlock();
+  TestPolicies();
+  BenchmarkCopies();
+  BenchmarkBroadcasts(4);
+  BenchmarkBroadcasts(11);
+  BenchmarkBroadcasts(16);
+
+#ifdef __XC32
   while (1)
   {
     ;
   }
+#endif
+}
+
+// prints the size of an event and the RAM taken by the service queues in
+// the current ES_Configure.h
+static void ReportRAM(void)
+{
+  uint32_t QueueRAM = QUEUE_RAM(0);
+#if NUM_SERVICES > 1
+  QueueRAM += QUEUE_RAM(1);
+#endif
+#if NUM_SERVICES > 2
+  QueueRAM += QUEUE_RAM(2);
+#endif
+#if NUM_SERVICES > 3
+  QueueRAM += QUEUE_RAM(3);
+#endif
+#if NUM_SERVICES > 4
+  QueueRAM += QUEUE_RAM(4);
+#endif
+#if NUM_SERVICES > 5
+  QueueRAM += QUEUE_RAM(5);
+#endif
+#if NUM_SERVICES > 6
+  QueueRAM += QUEUE_RAM(6);
+#endif
+#if NUM_SERVICES > 7
+  QueueRAM += QUEUE_RAM(7);
+#endif
+#if NUM_SERVICES > 8
+  QueueRAM += QUEUE_RAM(8);
+#endif
+#if NUM_SERVICES > 9
+  QueueRAM += QUEUE_RAM(9);
+#endif
+#if NUM_SERVICES > 10
+  QueueRAM += QUEUE_RAM(10);
+#endif
+#if NUM_SERVICES > 11
+  QueueRAM += QUEUE_RAM(11);
+#endif
+#if NUM_SERVICES > 12
+  QueueRAM += QUEUE_RAM(12);
+#endif
+#if NUM_SERVICES > 13
+  QueueRAM += QUEUE_RAM(13);
+#endif
+#if NUM_SERVICES > 14
+  QueueRAM += QUEUE_RAM(14);
+#endif
+#if NUM_SERVICES > 15
+  QueueRAM += QUEUE_RAM(15);
+#endif
+
+  DB_printf("ES_Event_t is %d bytes with a %d bit param\r\n",
+      (int)sizeof(ES_Event_t), ES_EVENT_PARAM_BITS);
+  DB_printf("the %d service queues take %d bytes\r\n", NUM_SERVICES,
+      QueueRAM);
+}
+
+// a block with room for no events gets no ring and takes no posts
+static void TestTinyBlock(void)
+{
+  ES_Event_t  MyEvent = { 1, 0 };
+  uint8_t     RingsUsed = NumBlockRings;
+  bool        Passed;
+
+  Passed = (ES_InitQueue(TinyQueue, ARRAY_SIZE(TinyQueue)) == 0) &&
+      (ES_InitQueue(TinyQueue, 0) == 0) && (NumBlockRings == RingsUsed) &&
+      !ES_EnQueueFIFO(TinyQueue, MyEvent) && ES_IsQueueEmpty(TinyQueue);
+  DB_printf("block too small for a queue %s\r\n",
+      Passed ? "passed" : "FAILED");
+}
+
+// fills TestQueue under each overflow policy and checks what comes out
+static void TestPolicies(void)
+{
+  ES_Event_t  MyEvent = { 1, 0 };
+  bool        Passed  = true;
+
+  // reject new: the 5th event is refused and the first 4 come out
+  ES_InitQueue(TestQueue, ARRAY_SIZE(TestQueue));
+  for (MyEvent.EventParam = 0; MyEvent.EventParam < 4; MyEvent.EventParam++)
+  {
+    ES_EnQueueFIFO(TestQueue, MyEvent);
+  }
+  Passed &= (ES_EnQueueFIFOWithPolicy(TestQueue, MyEvent) ==
+      ES_ENQUEUE_REJECTED);
+  Passed &= !ES_CanEnQueueFIFO(TestQueue, MyEvent);
+  ES_DeQueue(TestQueue, &MyEvent);
+  Passed &= (MyEvent.EventParam == 0);
+
+  // drop oldest: the 5th event pushes out the 1st, leaving 1,2,3,4
+  ES_InitQueue(TestQueue, ARRAY_SIZE(TestQueue));
+  ES_SetQueuePolicy(TestQueue, ES_QUEUE_DROP_OLDEST);
+  for (MyEvent.EventParam = 0; MyEvent.EventParam < 4; MyEvent.EventParam++)
+  {
+    ES_EnQueueFIFO(TestQueue, MyEvent);
+  }
+  Passed &= ES_CanEnQueueFIFO(TestQueue, MyEvent);
+  Passed &= (ES_EnQueueFIFOWithPolicy(TestQueue, MyEvent) ==
+      ES_ENQUEUE_DROPPED_OLDEST);
+  NumLeft = ES_DeQueue(TestQueue, &MyEvent);
+  Passed &= (MyEvent.EventParam == 1) && (NumLeft == 3);
+  ES_DeQueue(TestQueue, &MyEvent);
+  ES_DeQueue(TestQueue, &MyEvent);
+  ES_DeQueue(TestQueue, &MyEvent);
+  Passed &= (MyEvent.EventParam == 4);
+
+  // coalesce: a repeat of a waiting event is not added, a new param is
+  ES_InitQueue(TestQueue, ARRAY_SIZE(TestQueue));
+  ES_SetQueuePolicy(TestQueue, ES_QUEUE_COALESCE);
+  MyEvent.EventParam = 7;
+  Passed &= (ES_EnQueueFIFOWithPolicy(TestQueue, MyEvent) == ES_ENQUEUE_ADDED);
+  Passed &= (ES_EnQueueFIFOWithPolicy(TestQueue, MyEvent) ==
+      ES_ENQUEUE_COALESCED);
+  MyEvent.EventParam = 8;
+  Passed &= (ES_EnQueueFIFOWithPolicy(TestQueue, MyEvent) == ES_ENQUEUE_ADDED);
+  Passed &= (ES_QueueSpace(TestQueue) == 2);
+
+  DB_printf("overflow policies %s\r\n", Passed ? "passed" : "FAILED");
+}
+
+// times events going through a FIFO queue, one copy in and one copy out
+static void BenchmarkCopies(void)
+{
+  ES_Event_t  MyEvent = { 1, 0 };
+  uint32_t    i;
+  uint32_t    Start, Elapsed;
+
+  ES_InitQueue(TestQueue, ARRAY_SIZE(TestQueue));
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_COPY_EVENTS; i++)
+  {
+    MyEvent.EventParam = (ES_EventParam_t)i;
+    ES_EnQueueFIFO(TestQueue, MyEvent);
+    NumLeft = ES_DeQueue(TestQueue, &MyEvent);
+  }
+  Elapsed = _HW_GetCoreTicks() - Start;
+  DB_printf("%d events through a queue in %d core ticks, %d events/ms\r\n",
+      NUM_COPY_EVENTS, Elapsed,
+      (uint32_t)((uint64_t)NUM_COPY_EVENTS * 1000 * ES_CORE_TICKS_PER_US /
+      Elapsed));
+}
+
+// times a broadcast to NumSubscribers rings and back out again two ways:
+// the way ES_PostAll does it, checking every queue for room and then copying
+// the event in, and with a shared refcounted slot holding the event and the
+// queues holding references to it. A single run is short enough for an
+// interrupt (or on a host, the OS) to double it, so each way is run once to
+// warm up and then NUM_BENCH_RUNS times, taking turns, and the fastest and
+// the median runs are reported
+static void BenchmarkBroadcasts(uint8_t NumSubscribers)
+{
+  uint32_t  CopyTicks[NUM_BENCH_RUNS];
+  uint32_t  SlotTicks[NUM_BENCH_RUNS];
+  uint8_t   Run;
+
+  TimeCopyBroadcasts(NumSubscribers);
+  TimeSlotBroadcasts(NumSubscribers);
+  for (Run = 0; Run < NUM_BENCH_RUNS; Run++)
+  {
+    CopyTicks[Run] = TimeCopyBroadcasts(NumSubscribers);
+    SlotTicks[Run] = TimeSlotBroadcasts(NumSubscribers);
+  }
+  SortTicks(CopyTicks, NUM_BENCH_RUNS);
+  SortTicks(SlotTicks, NUM_BENCH_RUNS);
+
+  DB_printf("%d subscribers, %d broadcasts, ticks min/median of %d runs: "
+      "copies %d bytes %d/%d, shared slot %d bytes %d/%d\r\n",
+      NumSubscribers, NUM_BROADCASTS, NUM_BENCH_RUNS,
+      NumSubscribers * (int)sizeof(ES_Event_t), CopyTicks[0],
+      CopyTicks[NUM_BENCH_RUNS / 2],
+      NumSubscribers * (int)sizeof(ES_Event_t) + (int)sizeof(BroadcastSlot_t),
+      SlotTicks[0], SlotTicks[NUM_BENCH_RUNS / 2]);
+}
+
+// one run of broadcasts copied into each subscriber's ring, in core ticks
+static uint32_t TimeCopyBroadcasts(uint8_t NumSubscribers)
+{
+  ES_Event_t  MyEvent = { 1, 0 };
+  ES_Event_t  Received;
+  uint32_t    i;
+  uint8_t     j;
+  uint32_t    Start;
+
+  InitSubscriberRings(NumSubscribers);
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_BROADCASTS; i++)
+  {
+    MyEvent.EventParam = (ES_EventParam_t)i;
+    for (j = 0; j < NumSubscribers; j++)
+    {
+      if (ES_Ring_Space(&SubscriberRings[j]) == 0)
+      {
+        break;
+      }
+    }
+    if (j == NumSubscribers)
+    {
+      for (j = 0; j < NumSubscribers; j++)
+      {
+        ES_Ring_EnQueueFIFO(&SubscriberRings[j], MyEvent);
+      }
+    }
+    for (j = 0; j < NumSubscribers; j++)
+    {
+      NumLeft = ES_Ring_DeQueue(&SubscriberRings[j], &Received);
+    }
+  }
+  return _HW_GetCoreTicks() - Start;
+}
+
+// one run of broadcasts through the shared slot, in core ticks
+static uint32_t TimeSlotBroadcasts(uint8_t NumSubscribers)
+{
+  ES_Event_t  MyEvent = { 1, 0 };
+  ES_Event_t  Received;
+  uint32_t    i;
+  uint8_t     j;
+  uint32_t    Start;
+
+  InitSubscriberRings(NumSubscribers);
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_BROADCASTS; i++)
+  {
+    ES_Event_t Ref = { SLOT_REF_EVENT, 0 };
+
+    MyEvent.EventParam = (ES_EventParam_t)i;
+    for (j = 0; j < NumSubscribers; j++)
+    {
+      if (ES_Ring_Space(&SubscriberRings[j]) == 0)
+      {
+        break;
+      }
+    }
+    if ((j == NumSubscribers) && (Slot.RefCount == 0))
+    {
+      Slot.Event    = MyEvent;
+      Slot.RefCount = NumSubscribers;
+      for (j = 0; j < NumSubscribers; j++)
+      {
+        ES_Ring_EnQueueFIFO(&SubscriberRings[j], Ref);
+      }
+    }
+    for (j = 0; j < NumSubscribers; j++)
+    {
+      NumLeft = ES_Ring_DeQueue(&SubscriberRings[j], &Received);
+      if (Received.EventType == SLOT_REF_EVENT)
+      {
+        Received = Slot.Event;
+        Slot.RefCount--;
+      }
+    }
+  }
+  return _HW_GetCoreTicks() - Start;
+}
+
+static void InitSubscriberRings(uint8_t NumSubscribers)
+{
+  uint8_t j;
+
+  for (j = 0; j < NumSubscribers; j++)
+  {
+    ES_Ring_Init(&SubscriberRings[j], SubscriberEvents[j],
+        ARRAY_SIZE(SubscriberEvents[j]));
+  }
+}
+
+// insertion sort, smallest first, for the few benchmark runs
+static void SortTicks(uint32_t *pTicks, uint8_t NumTicks)
+{
+  uint8_t   i, j;
+  uint32_t  Ticks;
+
+  for (i = 1; i < NumTicks; i++)
+  {
+    Ticks = pTicks[i];
+    for (j = i; (j > 0) && (pTicks[j - 1] > Ticks); j--)
+    {
+      pTicks[j] = pTicks[j - 1];
+    }
+    pTicks[j] = Ticks;
+  }
 }
 
 #endif
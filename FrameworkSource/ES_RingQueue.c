@@ -0,0 +1,600 @@
+//#define TEST
+/****************************************************************************
+ Module
+     ES_RingQueue.c
+ Description
+     Implements a FIFO of ES_Event_t in a power of 2 ring buffer, with its
+     bookkeeping kept in an ES_RingQueue_t apart from the events
+ Notes
+     Head and Tail are 16 bit counts that run freely and wrap, so indexing is
+     a mask and the number of events waiting is always Head - Tail, with no
+     compare-and-reset on either side. The bulk functions move runs of events
+     with at most two block copies, one up to the end of the storage and one
+     from its start.
+     Posts only come from the main loop (interrupts use the mailboxes), so
+     the critical regions are empty unless POST_FROM_INTS is defined.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 05:10 agt      bulk LIFO posts keep the order of the run, added
+                         ES_DeQueueBulkLIFO
+ 10/17/26 18:45 agt      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "../FrameworkHeaders/ES_Configure.h"
+#include "../FrameworkHeaders/ES_RingQueue.h"
+#include "../FrameworkHeaders/ES_Port.h" /* get the macros for EnterCritical and ExitCritical */
+#include <string.h>
+
+/*----------------------------- Module Defines ----------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+static bool IsWaiting(ES_RingQueue_t *pRing, ES_Event_t ThisEvent);
+
+/*---------------------------- Module Variables ---------------------------*/
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_Ring_Init
+ Parameters
+   ES_RingQueue_t * pRing : the queue to set up
+   ES_Event_t * pStorage : where its events are kept
+   uint16_t Capacity : number of events in pStorage, a power of 2 up to
+     ES_RING_MAX_CAPACITY
+ Returns
+   bool : false if the capacity is not a power of 2 or is too big
+ Description
+   empties the queue and gives it the reject-new overflow policy
+ Notes
+   size the storage with ES_RING_SIZE to round a count up to a power of 2
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_Ring_Init(ES_RingQueue_t *pRing, ES_Event_t *pStorage,
+    uint16_t Capacity)
+{
+  if ((Capacity == 0) || (Capacity > ES_RING_MAX_CAPACITY) ||
+      ((Capacity & (Capacity - 1)) != 0))
+  {
+    return false;
+  }
+  pRing->pEvents  = pStorage;
+  pRing->Mask     = Capacity - 1;
+  pRing->Head     = 0;
+  pRing->Tail     = 0;
+  pRing->Policy   = ES_QUEUE_REJECT_NEW;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_Ring_SetPolicy
+ Parameters
+   ES_RingQueue_t * pRing : the queue to change
+   ES_QueuePolicy_t NewPolicy : what FIFO posts should do when the queue is
+     full or already holds the same event
+ Returns
+   nothing
+ Description
+   sets the overflow policy used by ES_Ring_EnQueueFIFO
+ Notes
+   LIFO and bulk posts always reject when the queue is full
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Ring_SetPolicy(ES_RingQueue_t *pRing, ES_QueuePolicy_t NewPolicy)
+{
+  pRing->Policy = NewPolicy;
+}
+
+/****************************************************************************
+ Function
+   ES_Ring_EnQueueFIFO
+ Parameters
+   ES_RingQueue_t * pRing : the queue to add to
+   ES_Event_t Event2Add : event to be added to the end of the queue
+ Returns
+   ES_EnQueueResult_t : what became of Event2Add
+ Description
+   adds Event2Add to the end of the queue, applying the queue's policy:
+   with ES_QUEUE_COALESCE it is not added if an event with the same type and
+   param is already waiting, with ES_QUEUE_DROP_OLDEST a full queue makes
+   room by throwing away its oldest event, otherwise a full queue rejects it
+ Notes
+   coalescing looks through every waiting event, which is cheap for the
+   short queues used here
+ Author
+   agt, 10/17/26
+****************************************************************************/
+ES_EnQueueResult_t ES_Ring_EnQueueFIFO(ES_RingQueue_t *pRing,
+    ES_Event_t Event2Add)
+{
+  ES_EnQueueResult_t Result = ES_ENQUEUE_ADDED;
+
+  if ((pRing->Policy & ES_QUEUE_COALESCE) && IsWaiting(pRing, Event2Add))
+  {
+    return ES_ENQUEUE_COALESCED;
+  }
+  EnterCritical();  // save interrupt state, turn ints off
+  if (ES_Ring_Count(pRing) > pRing->Mask)
+  {
+    if (!(pRing->Policy & ES_QUEUE_DROP_OLDEST))
+    {
+      ExitCritical();
+      return ES_ENQUEUE_REJECTED;
+    }
+    pRing->Tail++;  // step past the oldest event to make room
+    Result = ES_ENQUEUE_DROPPED_OLDEST;
+  }
+  pRing->pEvents[pRing->Head & pRing->Mask] = Event2Add;
+  pRing->Head++;
+  ExitCritical();    // restore saved interrupt state
+  return Result;
+}
+
+/****************************************************************************
+ Function
+   ES_Ring_EnQueueLIFO
+ Parameters
+   ES_RingQueue_t * pRing : the queue to add to
+   ES_Event_t Event2Add : event to be added at the front of the queue
+ Returns
+   bool : true if the add was successful, false if not
+ Description
+   if it will fit, adds Event2Add at the extraction point, making it the
+   next event to be removed by a DeQueue operation
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_Ring_EnQueueLIFO(ES_RingQueue_t *pRing, ES_Event_t Event2Add)
+{
+  if (ES_Ring_Count(pRing) > pRing->Mask)
+  {
+    return false;
+  }
+  EnterCritical();
+  pRing->Tail--;
+  pRing->pEvents[pRing->Tail & pRing->Mask] = Event2Add;
+  ExitCritical();
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_Ring_DeQueue
+ Parameters
+   ES_RingQueue_t * pRing : the queue to take from
+   ES_Event_t * pReturnEvent : used to return the event pulled from the queue
+ Returns
+   uint16_t : the number of events remaining in the queue
+ Description
+   pulls the oldest event from the queue, or ES_NO_EVENT if it was empty,
+   and copies it to *pReturnEvent
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint16_t ES_Ring_DeQueue(ES_RingQueue_t *pRing, ES_Event_t *pReturnEvent)
+{
+  uint16_t NumLeft;
+
+  if (ES_Ring_IsEmpty(pRing))
+  {
+    pReturnEvent->EventType   = ES_NO_EVENT;
+    pReturnEvent->EventParam  = 0;
+    return 0;
+  }
+  EnterCritical();
+  *pReturnEvent = pRing->pEvents[pRing->Tail & pRing->Mask];
+  pRing->Tail++;
+  NumLeft = ES_Ring_Count(pRing);
+  ExitCritical();
+  return NumLeft;
+}
+
+/****************************************************************************
+ Function
+   ES_Ring_CanEnQueueFIFO
+ Parameters
+   ES_RingQueue_t * pRing : the queue that might be added to
+   ES_Event_t Event2Add : event that might be added
+ Returns
+   bool : true if ES_Ring_EnQueueFIFO of Event2Add would succeed right now
+ Description
+   checks for room, or for a policy that would take the event anyway
+ Notes
+   lets a broadcast check all of its target queues before posting to any
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool ES_Ring_CanEnQueueFIFO(ES_RingQueue_t *pRing, ES_Event_t Event2Add)
+{
+  return (ES_Ring_Count(pRing) <= pRing->Mask) ||
+         (pRing->Policy & ES_QUEUE_DROP_OLDEST) ||
+         ((pRing->Policy & ES_QUEUE_COALESCE) && IsWaiting(pRing, Event2Add));
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueBulk
+ Parameters
+   ES_RingQueue_t * pRing : the queue to add to
+   const ES_Event_t * pEvents : the events to add, oldest first
+   uint16_t NumEvents : how many there are
+ Returns
+   uint16_t : the number of events added
+ Description
+   adds as many of the events as will fit to the end of the queue, in order
+ Notes
+   the queue's policy is not applied
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint16_t ES_EnQueueBulk(ES_RingQueue_t *pRing, const ES_Event_t *pEvents,
+    uint16_t NumEvents)
+{
+  uint16_t Start;
+  uint16_t ToEnd;
+
+  if (NumEvents > ES_Ring_Space(pRing))
+  {
+    NumEvents = ES_Ring_Space(pRing);
+  }
+  EnterCritical();
+  Start = pRing->Head & pRing->Mask;
+  ToEnd = pRing->Mask + 1 - Start;  // room before the storage wraps
+  if (NumEvents <= ToEnd)
+  {
+    memcpy(&pRing->pEvents[Start], pEvents, NumEvents * sizeof(ES_Event_t));
+  }
+  else
+  {
+    memcpy(&pRing->pEvents[Start], pEvents, ToEnd * sizeof(ES_Event_t));
+    memcpy(&pRing->pEvents[0], &pEvents[ToEnd],
+        (NumEvents - ToEnd) * sizeof(ES_Event_t));
+  }
+  pRing->Head += NumEvents;
+  ExitCritical();
+  return NumEvents;
+}
+
+/****************************************************************************
+ Function
+   ES_EnQueueBulkLIFO
+ Parameters
+   ES_RingQueue_t * pRing : the queue to add to
+   const ES_Event_t * pEvents : the events to add, oldest first
+   uint16_t NumEvents : how many there are
+ Returns
+   uint16_t : the number of events added
+ Description
+   puts the events at the front of the queue in order, so pEvents[0] is the
+   next to come out and the rest follow it, ahead of the events that were
+   waiting. If the queue fills, the last events of the run are the ones
+   added
+ Notes
+   the run is pushed to the front last event first, as calling
+   ES_Ring_EnQueueLIFO for pEvents[NumEvents - 1] down to pEvents[0] would.
+   Used by ES_RecallEvents to slide a run of deferred events in ahead of
+   the ones that are waiting
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint16_t ES_EnQueueBulkLIFO(ES_RingQueue_t *pRing, const ES_Event_t *pEvents,
+    uint16_t NumEvents)
+{
+  uint16_t NumAdded;
+  uint16_t i;
+
+  NumAdded = NumEvents;
+  if (NumAdded > ES_Ring_Space(pRing))
+  {
+    NumAdded = ES_Ring_Space(pRing);
+  }
+  EnterCritical();
+  for (i = NumEvents; i > NumEvents - NumAdded; i--)
+  {
+    pRing->Tail--;
+    pRing->pEvents[pRing->Tail & pRing->Mask] = pEvents[i - 1];
+  }
+  ExitCritical();
+  return NumAdded;
+}
+
+/****************************************************************************
+ Function
+   ES_DeQueueBulk
+ Parameters
+   ES_RingQueue_t * pRing : the queue to take from
+   ES_Event_t * pEvents : where to copy the events, oldest first
+   uint16_t MaxEvents : the most that pEvents can hold
+ Returns
+   uint16_t : the number of events taken
+ Description
+   takes up to MaxEvents events from the front of the queue
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint16_t ES_DeQueueBulk(ES_RingQueue_t *pRing, ES_Event_t *pEvents,
+    uint16_t MaxEvents)
+{
+  uint16_t NumEvents;
+  uint16_t Start;
+  uint16_t ToEnd;
+
+  EnterCritical();
+  NumEvents = ES_Ring_Count(pRing);
+  if (NumEvents > MaxEvents)
+  {
+    NumEvents = MaxEvents;
+  }
+  Start = pRing->Tail & pRing->Mask;
+  ToEnd = pRing->Mask + 1 - Start;  // events before the storage wraps
+  if (NumEvents <= ToEnd)
+  {
+    memcpy(pEvents, &pRing->pEvents[Start], NumEvents * sizeof(ES_Event_t));
+  }
+  else
+  {
+    memcpy(pEvents, &pRing->pEvents[Start], ToEnd * sizeof(ES_Event_t));
+    memcpy(&pEvents[ToEnd], &pRing->pEvents[0],
+        (NumEvents - ToEnd) * sizeof(ES_Event_t));
+  }
+  pRing->Tail += NumEvents;
+  ExitCritical();
+  return NumEvents;
+}
+
+/****************************************************************************
+ Function
+   ES_DeQueueBulkLIFO
+ Parameters
+   ES_RingQueue_t * pRing : the queue to take from
+   ES_Event_t * pEvents : where to copy the events, oldest first
+   uint16_t MaxEvents : the most that pEvents can hold
+ Returns
+   uint16_t : the number of events taken
+ Description
+   takes up to MaxEvents of the newest events from the end of the queue,
+   leaving the older ones waiting
+ Notes
+   lets ES_RecallEvents move the newest run of deferred events first, so
+   that each older run can go in front of it
+ Author
+   agt, 10/18/26
+****************************************************************************/
+uint16_t ES_DeQueueBulkLIFO(ES_RingQueue_t *pRing, ES_Event_t *pEvents,
+    uint16_t MaxEvents)
+{
+  uint16_t NumEvents;
+  uint16_t Start;
+  uint16_t ToEnd;
+
+  EnterCritical();
+  NumEvents = ES_Ring_Count(pRing);
+  if (NumEvents > MaxEvents)
+  {
+    NumEvents = MaxEvents;
+  }
+  pRing->Head -= NumEvents;
+  Start = pRing->Head & pRing->Mask;
+  ToEnd = pRing->Mask + 1 - Start;  // events before the storage wraps
+  if (NumEvents <= ToEnd)
+  {
+    memcpy(pEvents, &pRing->pEvents[Start], NumEvents * sizeof(ES_Event_t));
+  }
+  else
+  {
+    memcpy(pEvents, &pRing->pEvents[Start], ToEnd * sizeof(ES_Event_t));
+    memcpy(&pEvents[ToEnd], &pRing->pEvents[0],
+        (NumEvents - ToEnd) * sizeof(ES_Event_t));
+  }
+  ExitCritical();
+  return NumEvents;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+/****************************************************************************
+ Function
+   IsWaiting
+ Parameters
+   ES_RingQueue_t * pRing : the queue to search
+   ES_Event_t ThisEvent : the event to look for
+ Returns
+   bool : true if an event with the same type and param is in the queue
+ Description
+   walks the waiting events from oldest to newest
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static bool IsWaiting(ES_RingQueue_t *pRing, ES_Event_t ThisEvent)
+{
+  uint16_t i;
+
+  for (i = pRing->Tail; i != pRing->Head; i++)
+  {
+    if ((pRing->pEvents[i & pRing->Mask].EventType == ThisEvent.EventType) &&
+        (pRing->pEvents[i & pRing->Mask].EventParam == ThisEvent.EventParam))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef TEST
+// Checks the ring operations, including runs that wrap around the end of the
+// storage, then times single and bulk moves. On the host the times are core
+// timer ticks scaled from the clock; on the PIC32 they are real core ticks,
+// 2 system clocks each.
+// Build on the host with something like
+//   gcc -DTEST -I FrameworkHeaders FrameworkSource/ES_RingQueue.c dbprintf.c
+
+#include <stdio.h>
+#include "ES_General.h"
+#include "dbprintf.h"
+
+// the number of events pushed through a queue by each benchmark
+#define NUM_BENCH_EVENTS 80000UL
+// events per bulk call
+#define BULK_SIZE 8
+
+static ES_Event_t     Storage[16];
+static ES_RingQueue_t TestRing;
+
+static bool TestRingOps(void);
+static void Benchmark(void);
+
+void main(void)
+{
+  DB_printf("ring queue operations %s\r\n",
+      TestRingOps() ? "passed" : "FAILED");
+  Benchmark();
+#ifdef __XC32
+  while (1)
+  {
+    ;
+  }
+#endif
+}
+
+static bool TestRingOps(void)
+{
+  ES_Event_t  In[12];
+  ES_Event_t  Out[12];
+  ES_Event_t  OneEvent;
+  bool        Passed = true;
+  uint16_t    i;
+
+  for (i = 0; i < ARRAY_SIZE(In); i++)
+  {
+    In[i].EventType   = 1;
+    In[i].EventParam  = (ES_EventParam_t)i;
+  }
+  Passed &= !ES_Ring_Init(&TestRing, Storage, 12);  // not a power of 2
+  Passed &= ES_Ring_Init(&TestRing, Storage, ARRAY_SIZE(Storage));
+
+  // move the indices near the end of the storage so the next runs wrap
+  Passed &= (ES_EnQueueBulk(&TestRing, In, 10) == 10);
+  Passed &= (ES_DeQueueBulk(&TestRing, Out, 10) == 10);
+  Passed &= (Out[9].EventParam == 9);
+
+  // 12 in, wrapping, then only 4 more fit
+  Passed &= (ES_EnQueueBulk(&TestRing, In, 12) == 12);
+  Passed &= (ES_EnQueueBulk(&TestRing, In, 12) == 4);
+  Passed &= (ES_Ring_Count(&TestRing) == 16);
+  Passed &= (ES_Ring_EnQueueFIFO(&TestRing, In[0]) == ES_ENQUEUE_REJECTED);
+  Passed &= (ES_DeQueueBulk(&TestRing, Out, 12) == 12);
+  for (i = 0; i < 12; i++)
+  {
+    Passed &= (Out[i].EventParam == i);
+  }
+  Passed &= (ES_Ring_DeQueue(&TestRing, &OneEvent) == 3);
+  Passed &= (OneEvent.EventParam == 0);
+
+  // LIFO: a run of 3 pushed to the front comes out in order, ahead of 1,2,3
+  Passed &= (ES_EnQueueBulkLIFO(&TestRing, &In[4], 3) == 3);
+  for (i = 0; i < 3; i++)
+  {
+    ES_Ring_DeQueue(&TestRing, &OneEvent);
+    Passed &= (OneEvent.EventParam == 4 + i);
+  }
+  ES_Ring_DeQueue(&TestRing, &OneEvent);
+  Passed &= (OneEvent.EventParam == 1);
+  // and the newest 2 taken from the end, in order, leave the 3
+  ES_EnQueueBulk(&TestRing, &In[7], 2);
+  Passed &= (ES_DeQueueBulkLIFO(&TestRing, Out, 12) == 4);
+  Passed &= (Out[0].EventParam == 2) && (Out[3].EventParam == 8);
+  ES_Ring_EnQueueFIFO(&TestRing, In[3]);
+  ES_EnQueueBulk(&TestRing, &In[7], 2);
+  Passed &= (ES_DeQueueBulkLIFO(&TestRing, Out, 2) == 2);
+  Passed &= (Out[0].EventParam == 7) && (Out[1].EventParam == 8);
+  // a run too big for the room left puts in its last events
+  ES_EnQueueBulk(&TestRing, In, 12);
+  ES_EnQueueBulk(&TestRing, In, 2);
+  Passed &= (ES_EnQueueBulkLIFO(&TestRing, &In[4], 3) == 1);
+  ES_Ring_DeQueue(&TestRing, &OneEvent);
+  Passed &= (OneEvent.EventParam == 6);
+  ES_DeQueueBulk(&TestRing, Out, 12);
+  Passed &= (Out[0].EventParam == 3) && (Out[1].EventParam == 0);
+  Passed &= ES_Ring_EnQueueLIFO(&TestRing, In[9]);
+  ES_Ring_DeQueue(&TestRing, &OneEvent);
+  Passed &= (OneEvent.EventParam == 9);
+
+  // the 16 bit counts keep working as they wrap past 65535
+  TestRing.Head = TestRing.Tail = 0xFFFE;
+  Passed &= (ES_EnQueueBulk(&TestRing, In, 5) == 5);
+  Passed &= (ES_Ring_Count(&TestRing) == 5);
+  Passed &= (ES_DeQueueBulk(&TestRing, Out, 12) == 5);
+  Passed &= (Out[4].EventParam == 4) && ES_Ring_IsEmpty(&TestRing);
+  ES_Ring_DeQueue(&TestRing, &OneEvent);
+  Passed &= (OneEvent.EventType == ES_NO_EVENT);
+
+  // policies
+  ES_Ring_SetPolicy(&TestRing, ES_QUEUE_COALESCE);
+  Passed &= (ES_Ring_EnQueueFIFO(&TestRing, In[2]) == ES_ENQUEUE_ADDED);
+  Passed &= (ES_Ring_EnQueueFIFO(&TestRing, In[2]) == ES_ENQUEUE_COALESCED);
+  ES_Ring_SetPolicy(&TestRing, ES_QUEUE_DROP_OLDEST);
+  ES_EnQueueBulk(&TestRing, In, 15);
+  Passed &= (ES_Ring_EnQueueFIFO(&TestRing, In[11]) ==
+      ES_ENQUEUE_DROPPED_OLDEST);
+  ES_Ring_DeQueue(&TestRing, &OneEvent);
+  Passed &= (OneEvent.EventParam == 0);
+  return Passed;
+}
+
+static void Benchmark(void)
+{
+  ES_Event_t  Batch[BULK_SIZE];
+  ES_Event_t  OneEvent = { 1, 0 };
+  uint32_t    i;
+  uint16_t    j;
+  uint32_t    Start, SingleTicks, BulkTicks;
+
+  ES_Ring_Init(&TestRing, Storage, ARRAY_SIZE(Storage));
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_BENCH_EVENTS; i += BULK_SIZE)
+  {
+    for (j = 0; j < BULK_SIZE; j++)
+    {
+      OneEvent.EventParam = (ES_EventParam_t)j;
+      ES_Ring_EnQueueFIFO(&TestRing, OneEvent);
+    }
+    for (j = 0; j < BULK_SIZE; j++)
+    {
+      ES_Ring_DeQueue(&TestRing, &OneEvent);
+    }
+  }
+  SingleTicks = _HW_GetCoreTicks() - Start;
+
+  for (j = 0; j < BULK_SIZE; j++)
+  {
+    Batch[j] = OneEvent;
+  }
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_BENCH_EVENTS; i += BULK_SIZE)
+  {
+    ES_EnQueueBulk(&TestRing, Batch, BULK_SIZE);
+    ES_DeQueueBulk(&TestRing, Batch, BULK_SIZE);
+  }
+  BulkTicks = _HW_GetCoreTicks() - Start;
+
+  DB_printf("%d events in and out one at a time: %d core ticks\r\n",
+      NUM_BENCH_EVENTS, SingleTicks);
+  DB_printf("%d events in and out %d at a time: %d core ticks\r\n",
+      NUM_BENCH_EVENTS, BULK_SIZE, BulkTicks);
+}
+
+#endif
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
@@ -1,187 +1,491 @@
-//#define DEBUG
+//#define TEST
 /****************************************************************************
  Module
    ES_ShortTimer.c
 
  Revision
-   1.0.1
+   2.0.0
 
  Description
    This is a library to provide for the creation of short time-outs
    (shorter than the resolution of the ES_Timer library).
 
  Notes
-   This module uses the Tiva Peripheral Driver Library functions and
-   the ability that it provides to 'hook' a function into an interrupt
-   response routine without modifying the vector table directly.
-   Uses timers A & B on 16/32 bit Timer Module 5
+   Uses Timer4 & Timer5 of the PIC32 as one 32 bit timer, counting the 20MHz
+   peripheral clock, for a resolution of 1/20 uS. The short timers share it:
+   the period is set for the next short timer to run out, and the interrupt
+   response posts its ES_SHORT_TIMEOUT and sets the period for the one after.
+   Deadlines are kept in counts from the start of the current period, which
+   is where the count restarts on each period match.
+   Timeouts go through an ISR mailbox (see ES_Mailbox.c) for each service
+   that has short timers, so the interrupt never touches the service queues.
+   ES_ShortTimerStart and ES_ShortTimerStop only mask the Timer5 interrupt.
+   In a host build the registers are a model that the test drives.
 
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 23:10 agt     ported from the Tiva to Timer4/5 of the PIC32, with
+                        ES_NUM_SHORT_TIMERS timers sharing the one hardware
+                        timer and posting through ISR mailboxes
  10/11/15 10:30 jec     first pass
  10/11/15 18:10 jec     converted to post events to the framework
 
 ****************************************************************************/
-// the common headers for I/O, C99 types
-#include <stdio.h>
+// the common headers for C99 types
 #include <stdint.h>
 #include <stdbool.h>
-#include "BITDEFS.H"
-
-// the headers to access the GPIO subsystem
-#include "inc/hw_memmap.h"
-#include "inc/hw_types.h"
-#include "inc/hw_gpio.h"
-#include "inc/hw_sysctl.h"
-#include "inc/hw_timer.h"
-#include "inc/hw_ints.h"
-
-// the headers to access the TivaWare Library
-#include "driverlib/sysctl.h"
-#include "driverlib/pin_map.h"
-#include "driverlib/gpio.h"
-#include "driverlib/timer.h"
-#include "driverlib/interrupt.h"
 
 // the header to get the timing functions
 #include "ES_ShortTimer.h"
 
 // the framework headers
-#include "ES_Framework.h"
 #include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Mailbox.h"
+#include "ES_RingQueue.h"
 
-// module level functions
+#if ES_NUM_SHORT_TIMERS > 8
+#error "ES_NUM_SHORT_TIMERS can be no larger than 8"
+#endif
+
+// the peripheral clock is 20MHz and the prescaler is 1:1
+#define COUNTS_PER_US 20
+
+// timeouts shorter than the time it takes to set the timer up are posted
+// at once, as the Tiva version did
+#define MIN_TIMEOUT_US 10
+
+// the least time between now and a period match that is set up. A period
+// already passed would not match until the count wrapped
+#define MIN_LEAD_COUNTS (2 * COUNTS_PER_US)
 
-// define for the timer pre-scaler. this sets the resolution of the
-// timing functions
-// the current values are based on a 40mHz clock rate to give 1uS resolution
-#define PRE_1uS 40
+// each service's mailbox holds two timeouts for every short timer
+#define MAILBOX_SLOTS ES_RING_SIZE(2 * ES_NUM_SHORT_TIMERS)
 
-void ShortTimerAHandler(void);
-void ShortTimerBHandler(void);
+#ifdef __XC32
+#include <xc.h>
+#include <sys/attribs.h>
+
+#define READ_COUNT()        (TMR4)
+#define WRITE_COUNT(x)      (TMR4 = (x))
+#define READ_PERIOD()       (PR4)
+#define WRITE_PERIOD(x)     (PR4 = (x))
+#define TIMER_IS_ON()       (T4CONbits.ON)
+#define TIMER_ON()          (T4CONSET = _T4CON_ON_MASK)
+#define TIMER_OFF()         (T4CONCLR = _T4CON_ON_MASK)
+#define MASK_INT()          (IEC0CLR = _IEC0_T5IE_MASK)
+#define UNMASK_INT()        (IEC0SET = _IEC0_T5IE_MASK)
+#define INT_IS_PENDING()    (IFS0bits.T5IF)
+#define CLEAR_INT()         (IFS0CLR = _IFS0_T5IF_MASK)
+#else
+#include <sys/attribs.h>
+
+// the parts of Timer4/5 that this module uses
+static struct
+{
+  uint32_t  TMR4;
+  uint32_t  PR4;
+  bool      ON;
+  bool      T5IE;
+  bool      T5IF;
+}SimRegs;
+
+#define READ_COUNT()        (SimRegs.TMR4)
+#define WRITE_COUNT(x)      (SimRegs.TMR4 = (x))
+#define READ_PERIOD()       (SimRegs.PR4)
+#define WRITE_PERIOD(x)     (SimRegs.PR4 = (x))
+#define TIMER_IS_ON()       (SimRegs.ON)
+#define TIMER_ON()          (SimRegs.ON = true)
+#define TIMER_OFF()         (SimRegs.ON = false)
+#define MASK_INT()          (SimRegs.T5IE = false)
+#define UNMASK_INT()        (SimRegs.T5IE = true)
+#define INT_IS_PENDING()    (SimRegs.T5IF)
+#define CLEAR_INT()         (SimRegs.T5IF = false)
+#endif
+
+// module level functions
+static void HandleMatch(void);
+static void SetNextPeriod(void);
+static void PostTimeout(uint8_t Which);
 
 // module level variables
 
-static uint8_t  Timer_A_Priority  = SHORT_TIMER_UNUSED;
-static uint8_t  Timer_B_Priority  = SHORT_TIMER_UNUSED;
+// a mailbox for each service that has short timers
+static ES_Mailbox_t Mailboxes[ES_NUM_SHORT_TIMERS];
+static ES_Event_t   MailboxSlots[ES_NUM_SHORT_TIMERS][MAILBOX_SLOTS];
+static uint8_t      NumMailboxes;
+
+// the mailbox of each short timer, plus 1, 0 for a timer with no service
+static uint8_t      TimerMailbox[ES_NUM_SHORT_TIMERS];
+
+// when each running short timer runs out, in counts from the start of the
+// current period
+static uint32_t     Deadline[ES_NUM_SHORT_TIMERS];
+
+// a bit for each running short timer
+static volatile uint8_t Running;
 
 //******************************
 // ES_ShortTimerInit()
 // Initialize the timer subsystem and log the services to which the timeout
-// messages will be posted
+// messages will be posted for short timers A & B. Other short timers are
+// given services with ES_ShortTimerSetService
 //******************************
 void ES_ShortTimerInit(uint8_t TimeAPrio, uint8_t TimeBPrio)
 {
-#ifdef DEBUG
-// set up I/O lines for debugging
-  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
-  GPIOPinTypeGPIOOutput(GPIO_PORTB_BASE, GPIO_PIN_0 | GPIO_PIN_1);
-// start with the lines low
-  GPIOPinWrite(GPIO_PORTB_BASE, GPIO_PIN_0 | GPIO_PIN_1, BIT0LO & BIT1LO);
+#ifdef __XC32
+  // Timer4 & 5 as one 32 bit timer on the peripheral clock, prescale 1:1
+  T4CON = 0;
+  T5CON = 0;
+  T4CONbits.T32 = 1;
+  // the 32 bit timer interrupts through Timer5
+  IPC5bits.T5IP = 4;
 #endif
-
-// enable the clock to the timer module
-  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER5);
-// configure as 2 16 bit timers
-  TimerConfigure(TIMER5_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_ONE_SHOT |
-      TIMER_CFG_B_ONE_SHOT);
-// set prescale to get 1uS resolution
-  TimerPrescaleSet(TIMER5_BASE, TIMER_BOTH, PRE_1uS);
-// log the service to which the timeout will be posted
-  Timer_A_Priority  = TimeAPrio;
-  Timer_B_Priority  = TimeBPrio;
+  TIMER_OFF();
+  WRITE_COUNT(0);
+  Running = 0;
+  CLEAR_INT();
+  UNMASK_INT();
+  ES_ShortTimerSetService(SHORT_TIMER_A, TimeAPrio);
+  ES_ShortTimerSetService(SHORT_TIMER_B, TimeBPrio);
 }
 
-void ES_ShortTimerStart(uint32_t Which, uint16_t TimeoutValue)
+//******************************
+// ES_ShortTimerSetService()
+// log the service to which the timeouts of a short timer will be posted.
+// Returns false if the timer does not exist or no mailbox was left for the
+// service
+//******************************
+bool ES_ShortTimerSetService(uint8_t Which, uint8_t WhichService)
 {
-  if ((Which != TIMER_A) && (Which != TIMER_B))
+  uint8_t i;
+
+  if (Which >= ES_NUM_SHORT_TIMERS)
   {
-    return;
+    return false;
+  }
+  ES_ShortTimerStop(Which);
+  TimerMailbox[Which] = 0;
+  if (WhichService == SHORT_TIMER_UNUSED)
+  {
+    return true;
   }
-  // for very short delays. just immediatly post. There is 10us of overhead
-  if (TimeoutValue < 11)
+  // short timers for the same service share its mailbox
+  for (i = 0; i < NumMailboxes; i++)
   {
-    if (Which == TIMER_A)
+    if (Mailboxes[i].WhichService == WhichService)
     {
-      ShortTimerAHandler();
+      TimerMailbox[Which] = i + 1;
+      return true;
     }
-    else
+  }
+  if ((NumMailboxes == ES_NUM_SHORT_TIMERS) ||
+      !ES_Mailbox_Init(&Mailboxes[NumMailboxes], MailboxSlots[NumMailboxes],
+      MAILBOX_SLOTS, WhichService))
+  {
+    return false;
+  }
+  TimerMailbox[Which] = ++NumMailboxes;
+  return true;
+}
+
+//******************************
+// ES_ShortTimerStart()
+// (re)starts a short timer to post an ES_SHORT_TIMEOUT, with the timer
+// number as the param, in TimeoutValue microseconds. Returns false if the
+// timer does not exist, has no service or the time is too long
+//******************************
+bool ES_ShortTimerStart(uint8_t Which, uint32_t TimeoutValue)
+{
+  uint32_t  Counts;
+  ES_Event_t ThisEvent;
+
+  if ((Which >= ES_NUM_SHORT_TIMERS) || (TimerMailbox[Which] == 0) ||
+      (TimeoutValue > ES_SHORT_TIMER_MAX_US))
+  {
+    return false;
+  }
+  // for very short delays, just post now
+  if (TimeoutValue < MIN_TIMEOUT_US)
+  {
+    ES_ShortTimerStop(Which);
+    ThisEvent.EventType   = ES_SHORT_TIMEOUT;
+    ThisEvent.EventParam  = Which;
+    return ES_PostToService(Mailboxes[TimerMailbox[Which] - 1].WhichService,
+               ThisEvent);
+  }
+  Counts = TimeoutValue * COUNTS_PER_US;
+
+  MASK_INT();
+  // a match while we had the interrupt masked must be dealt with first, as
+  // it has already restarted the count
+  if (INT_IS_PENDING())
+  {
+    CLEAR_INT();
+    HandleMatch();
+  }
+  if (!TIMER_IS_ON())
+  {
+    WRITE_COUNT(0);
+    Deadline[Which] = Counts;
+    Running         = 1 << Which;
+    WRITE_PERIOD(Counts - 1);
+    TIMER_ON();
+  }
+  else
+  {
+    Deadline[Which] = READ_COUNT() + Counts;
+    Running        |= 1 << Which;
+    // only move the match if this one is sooner
+    if (Deadline[Which] - 1 < READ_PERIOD())
     {
-      ShortTimerBHandler();
+      SetNextPeriod();
     }
   }
-  TimerLoadSet(TIMER5_BASE, Which, TimeoutValue);
+  UNMASK_INT();
+  return true;
+}
 
-  if (Which == TIMER_A) // local enable
+//******************************
+// ES_ShortTimerStop()
+// stops a short timer. A timeout that it has already posted is still
+// delivered
+//******************************
+void ES_ShortTimerStop(uint8_t Which)
+{
+  if (Which >= ES_NUM_SHORT_TIMERS)
   {
-    TimerIntEnable(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
-    // NVIC Enable
-    IntEnable(INT_TIMER5A_TM4C123);
+    return;
   }
-  else
+  MASK_INT();
+  Running &= ~(1 << Which);
+  // the period is left alone, a match with nothing due just sets the next
+  if (Running == 0)
   {
-    // local enable
-    TimerIntEnable(TIMER5_BASE, TIMER_TIMB_TIMEOUT);
-    // NVIC Enable
-    IntEnable(INT_TIMER5B_TM4C123);
+    TIMER_OFF();
+    CLEAR_INT();
   }
+  UNMASK_INT();
+}
 
-  TimerEnable(TIMER5_BASE, Which);
+//******************************
+// ShortTimerISR()
+// the Timer5 interrupt response, for the period match of the 32 bit timer
+//******************************
+void __ISR(_TIMER_5_VECTOR, IPL4AUTO) ShortTimerISR(void)
+{
+  CLEAR_INT();
+  HandleMatch();
+}
 
-#ifdef DEBUG
-// raise I/O line to show we started
-  if (Which == TIMER_A)
+//******************************
+// HandleMatch()
+// posts the timeouts of the short timers due by the end of the period that
+// just ended, moves the others' deadlines into the new period and sets it
+// up. Called from the ISR, or with the interrupt masked
+//******************************
+static void HandleMatch(void)
+{
+  uint32_t  Elapsed = READ_PERIOD() + 1;  // the count restarted after PR4
+  uint8_t   Which;
+
+  for (Which = 0; Which < ES_NUM_SHORT_TIMERS; Which++)
+  {
+    if (Running & (1 << Which))
+    {
+      if (Deadline[Which] <= Elapsed)
+      {
+        Running &= ~(1 << Which);
+        PostTimeout(Which);
+      }
+      else
+      {
+        Deadline[Which] -= Elapsed;
+      }
+    }
+  }
+  if (Running == 0)
   {
-    GPIOPinWrite(GPIO_PORTB_BASE, BIT0HI, BIT0HI);
+    TIMER_OFF();
+    WRITE_COUNT(0);
   }
   else
   {
-    GPIOPinWrite(GPIO_PORTB_BASE, BIT1HI, BIT1HI);
+    SetNextPeriod();
   }
-#endif
-  return;
 }
 
-void ShortTimerAHandler(void)
+//******************************
+// SetNextPeriod()
+// sets the period match for the running short timer that is due first, but
+// never so close to the count that the match could be missed. Called from
+// the ISR, or with the interrupt masked
+//******************************
+static void SetNextPeriod(void)
 {
-  ES_Event_t ThisEvent;
+  uint32_t  Soonest = UINT32_MAX;
+  uint32_t  Earliest;
+  uint8_t   Which;
 
-// start by clearing the source of the interrupt
-  TimerIntClear(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
-#ifdef DEBUG
-// lower I/O line to show we arrived
-  GPIOPinWrite(GPIO_PORTB_BASE, BIT0HI, BIT0LO);
-#endif
-
-// post the timeout for this timer
-  ThisEvent.EventType   = ES_SHORT_TIMEOUT;
-  ThisEvent.EventParam  = TIMER_A;
-// protect against timer that was not correctly initialized
-  if (Timer_A_Priority != SHORT_TIMER_UNUSED)
+  for (Which = 0; Which < ES_NUM_SHORT_TIMERS; Which++)
+  {
+    if ((Running & (1 << Which)) && (Deadline[Which] < Soonest))
+    {
+      Soonest = Deadline[Which];
+    }
+  }
+  Earliest = READ_COUNT() + MIN_LEAD_COUNTS;
+  if (Soonest < Earliest)
   {
-    ES_PostToService(Timer_A_Priority, ThisEvent);
+    Soonest = Earliest; // late, it will be posted at this match
   }
+  WRITE_PERIOD(Soonest - 1);
 }
 
-void ShortTimerBHandler(void)
+//******************************
+// PostTimeout()
+// puts the ES_SHORT_TIMEOUT of a short timer in its service's mailbox
+//******************************
+static void PostTimeout(uint8_t Which)
 {
   ES_Event_t ThisEvent;
 
-// start by clearing the source of the interrupt
-  TimerIntClear(TIMER5_BASE, TIMER_TIMB_TIMEOUT);
-#ifdef DEBUG
-// lower I/O line to show we arrived
-  GPIOPinWrite(GPIO_PORTB_BASE, BIT1HI, BIT1LO);
-#endif
-
-// post the timeout for this timer
   ThisEvent.EventType   = ES_SHORT_TIMEOUT;
-  ThisEvent.EventParam  = TIMER_B;
-// protect against timer that was not correctly initialized
-  if (Timer_B_Priority != SHORT_TIMER_UNUSED)
+  ThisEvent.EventParam  = Which;
+  ES_Mailbox_Post(&Mailboxes[TimerMailbox[Which] - 1], ThisEvent);
+}
+
+#ifdef TEST
+// Host test of the register model. It moves the count along the way Timer4/5
+// does, sets the flag on each period match and calls the ISR when the
+// interrupt is unmasked, and checks the period registers and the timeouts
+// that come out of the mailboxes. Build it with the mailboxes, e.g.
+//   gcc -DTEST -I<stand-in xc.h> -IFrameworkHeaders -IProjectHeaders
+//     FrameworkSource/ES_ShortTimer.c FrameworkSource/ES_Mailbox.c dbprintf.c
+
+#include "dbprintf.h"
+
+#define SERVICE_1 3
+#define SERVICE_2 5
+
+static ES_Event_t Posted[16];
+static uint8_t    PostedTo[16];
+static uint32_t   PostedAt[16];
+static uint8_t    NumPosted;
+static uint32_t   SimTime;  // counts since the test started
+
+// stands in for the framework, logging what the mailboxes deliver
+bool ES_PostToService(uint8_t WhichService, ES_Event_t ThisEvent)
+{
+  if (NumPosted < ARRAY_SIZE(Posted))
   {
-    ES_PostToService(Timer_B_Priority, ThisEvent);
+    PostedTo[NumPosted]   = WhichService;
+    PostedAt[NumPosted]   = SimTime;
+    Posted[NumPosted++]   = ThisEvent;
+  }
+  return true;
+}
+
+// runs the timer for a number of counts, draining the mailboxes after each
+// count the way ES_Run would between dispatches
+static void RunCounts(uint32_t NumCounts)
+{
+  while (NumCounts-- > 0)
+  {
+    SimTime++;
+    if (SimRegs.ON)
+    {
+      if (SimRegs.TMR4 == SimRegs.PR4)
+      {
+        SimRegs.TMR4 = 0;
+        SimRegs.T5IF = true;
+      }
+      else
+      {
+        SimRegs.TMR4++;
+      }
+    }
+    if (SimRegs.T5IF && SimRegs.T5IE)
+    {
+      ShortTimerISR();
+    }
+    ES_Mailbox_DrainAll();
   }
 }
 
+static bool CheckPost(uint8_t Num, uint8_t Service, uint8_t Which,
+    uint32_t DueAt)
+{
+  return (NumPosted > Num) && (PostedTo[Num] == Service) &&
+         (Posted[Num].EventType == ES_SHORT_TIMEOUT) &&
+         (Posted[Num].EventParam == Which) && (PostedAt[Num] == DueAt);
+}
+
+void main(void)
+{
+  bool Passed = true;
+
+  ES_ShortTimerInit(SERVICE_1, SERVICE_2);
+  Passed &= ES_ShortTimerSetService(2, SERVICE_1);
+  Passed &= ES_ShortTimerSetService(3, SERVICE_2);
+  Passed &= !ES_ShortTimerStart(4, 100);    // no such timer
+  Passed &= !ES_ShortTimerStart(0, ES_SHORT_TIMER_MAX_US + 1);
+  Passed &= (NumMailboxes == 2);            // one for each service
+
+  // one timer: 100uS is 2000 counts, so the period register is 1999
+  ES_ShortTimerStart(0, 100);
+  Passed &= SimRegs.ON && (SimRegs.PR4 == 1999) && (SimRegs.TMR4 == 0);
+  // 500 counts in, a 30uS timer is sooner, so the period comes in to 1099
+  RunCounts(500);
+  ES_ShortTimerStart(1, 30);
+  Passed &= (SimRegs.PR4 == 1099);
+  // a 200uS timer is later, so it leaves the period alone
+  ES_ShortTimerStart(2, 200);
+  Passed &= (SimRegs.PR4 == 1099);
+  RunCounts(600);
+  // timer 1 came out at the match, and timer 0 is 900 counts into the
+  // new period
+  Passed &= CheckPost(0, SERVICE_2, 1, 1100);
+  Passed &= (SimRegs.PR4 == 899);
+  RunCounts(900);
+  Passed &= CheckPost(1, SERVICE_1, 0, 2000);
+  RunCounts(2500);
+  Passed &= CheckPost(2, SERVICE_1, 2, 4500);
+  // with nothing running, the timer stops
+  Passed &= !SimRegs.ON && (NumPosted == 3);
+
+  // all four at once, in reverse order, one stopped
+  SimTime = 0;
+  NumPosted = 0;
+  ES_ShortTimerStart(0, 40);
+  ES_ShortTimerStart(1, 30);
+  ES_ShortTimerStart(2, 20);
+  ES_ShortTimerStart(3, 10);
+  ES_ShortTimerStop(1);
+  RunCounts(1000);
+  Passed &= CheckPost(0, SERVICE_2, 3, 200) && CheckPost(1, SERVICE_1, 2, 400)
+      && CheckPost(2, SERVICE_1, 0, 800) && (NumPosted == 3);
+
+  // a match that comes while the interrupt is masked is dealt with before a
+  // start uses the count
+  SimTime = 0;
+  NumPosted = 0;
+  ES_ShortTimerStart(0, 50);
+  MASK_INT();
+  RunCounts(1010);  // the match was at 1000, and the count started again
+  Passed &= (NumPosted == 0) && SimRegs.T5IF;
+  ES_ShortTimerStart(1, 50);
+  Passed &= (SimRegs.PR4 == 999) && !SimRegs.T5IF;
+  RunCounts(1000);
+  Passed &= CheckPost(0, SERVICE_1, 0, 1011) && CheckPost(1, SERVICE_2, 1, 2010);
+
+  // a very short time is posted at once
+  SimTime = 0;
+  NumPosted = 0;
+  ES_ShortTimerStart(3, 5);
+  Passed &= CheckPost(0, SERVICE_2, 3, 0) && !SimRegs.ON;
+
+  DB_printf("short timers %s\r\n", Passed ? "passed" : "FAILED");
+}
+#endif
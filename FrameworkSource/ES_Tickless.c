@@ -0,0 +1,329 @@
+//#define TEST
+/****************************************************************************
+ Module
+     ES_Tickless.c
+ Description
+     A time base for the framework timers that has no periodic tick
+     interrupt. The core timer compare is set for the next timer to run out
+     and the tick count is worked out from the core timer count.
+ Notes
+     Only used when ES_TICKLESS is defined in ES_Configure.h.
+     Ticks still have the length set by ES_Initialize and timers still count
+     whole ticks, measured from the start of the tick that they were started
+     in, so they run out when they would have with the tick interrupt.
+     ES_Run polls ES_Tickless_Service through _HW_Process_Pending_Ints, so
+     the count is checked against the deadline even if the compare was set
+     for a time that had already gone by. The interrupt only has to happen
+     when a deadline is reached, not every tick.
+     The core timer is reached through _HW_ReadCoreCount and
+     _HW_WriteCoreCompare, which are a simulated pair in a host build.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 07:50 agt      the test stands in for ES_TakeTimeoutTarget too
+ 10/18/26 07:00 agt      the compare is written on every reschedule, as the
+                         interrupt moves it. The test has a build target
+ 10/18/26 05:50 agt      the test fails on a wrong or missed timeout
+ 10/17/26 20:30 agt      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "../FrameworkHeaders/ES_Configure.h"
+#include "../FrameworkHeaders/ES_Tickless.h"
+#include "../FrameworkHeaders/ES_Timers.h"
+#include "../FrameworkHeaders/ES_Port.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+static uint32_t CoreTicksPerTick;
+// the core count at the start of the current tick
+static uint32_t TickStart;
+// whole ticks from ES_Tickless_Init to TickStart
+static uint32_t TickCount;
+// the core count that the next timer runs out at
+static uint32_t Deadline;
+
+#ifndef __XC32
+// the simulated core timer of a host build
+volatile uint32_t ES_SimCoreCount;
+volatile uint32_t ES_SimCoreCompare;
+#endif
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_Tickless_Init
+ Parameters
+   uint32_t CoreTicksPerTick : length of a tick in core timer counts, one of
+     the TimerRate_t values
+ Returns
+   nothing
+ Description
+   starts the first tick now and sets the compare for the next deadline
+ Notes
+   called by _HW_Timer_Init in place of setting up the periodic compare
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Tickless_Init(uint32_t NewCoreTicksPerTick)
+{
+  CoreTicksPerTick  = NewCoreTicksPerTick;
+  TickStart         = _HW_ReadCoreCount();
+  TickCount         = 0;
+  Deadline          = TickStart;
+  ES_Tickless_Reschedule();
+}
+
+/****************************************************************************
+ Function
+   ES_Tickless_Service
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   once the core count reaches the deadline, moves the timers up to the
+   current tick, which posts their timeouts, and sets the next deadline
+ Notes
+   called from _HW_Process_Pending_Ints, so before every dispatch. Between
+   deadlines it costs a read of the core count and a compare
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Tickless_Service(void)
+{
+  if ((int32_t)(_HW_ReadCoreCount() - Deadline) >= 0)
+  {
+    ES_Tickless_CatchUp();
+    ES_Tickless_Reschedule();
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_Tickless_CatchUp
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   passes the whole ticks that have gone by since the last call to the
+   timers, in one call to ES_Timer_MultiTick_Resp
+ Notes
+   the timer module calls this before it uses its time base, so a timer
+   started between deadlines counts from the current tick
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Tickless_CatchUp(void)
+{
+  uint32_t Elapsed;
+
+  Elapsed = (_HW_ReadCoreCount() - TickStart) / CoreTicksPerTick;
+  if (Elapsed != 0)
+  {
+    // account for the ticks first, in case a post starts a timer
+    TickStart += Elapsed * CoreTicksPerTick;
+    TickCount += Elapsed;
+    while (Elapsed > UINT16_MAX)
+    {
+      ES_Timer_MultiTick_Resp(UINT16_MAX);
+      Elapsed -= UINT16_MAX;
+    }
+    ES_Timer_MultiTick_Resp((uint16_t)Elapsed);
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_Tickless_Reschedule
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   sets the compare for the start of the tick that the next timer runs out
+   in, or as far off as it can go if no timer is active
+ Notes
+   the timer module calls this after starting a timer. The compare is
+   written even when the deadline has not moved, as the interrupt response
+   moves it out of the way to clear the interrupt
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void ES_Tickless_Reschedule(void)
+{
+  uint32_t TicksToNext;
+  uint32_t MaxTicks = ES_TICKLESS_MAX_WAIT / CoreTicksPerTick;
+
+  if (!ES_Timer_GetTicksToNext(&TicksToNext) || (TicksToNext > MaxTicks))
+  {
+    TicksToNext = MaxTicks;
+  }
+  Deadline = TickStart + TicksToNext * CoreTicksPerTick;
+  _HW_WriteCoreCompare(Deadline);
+}
+
+/****************************************************************************
+ Function
+   ES_Tickless_GetTickCount
+ Parameters
+   none
+ Returns
+   uint32_t : whole ticks since ES_Tickless_Init
+ Description
+   works the tick count out from the core timer count
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint32_t ES_Tickless_GetTickCount(void)
+{
+  return TickCount + (_HW_ReadCoreCount() - TickStart) / CoreTicksPerTick;
+}
+
+#ifdef TEST
+// Runs the timers on the simulated core timer and checks that every timeout
+// is posted in the tick that it is due, across a wrap of the core count, and
+// that none is missed. The timers are one-shots that the post function
+// starts again each time, so a missed timeout leaves its timer stopped.
+// The simulated main loop moves the count along by a varying amount (the
+// time taken by run functions) between calls to ES_Tickless_Service. Each
+// time the count passes the compare it responds as _HW_SysTickIntHandler
+// does, moving the compare out of the way, and a timeout that is posted
+// without such an interrupt ahead of it also counts as wrong, as a target
+// waiting in _HW_Idle would not have woken for it. Returns 1 if any timeout
+// was wrong.
+// Host only, as it drives ES_SimCoreCount. make -C HostSim tickless-check
+// builds it with the timer module and runs it.
+
+#include <stdio.h>
+#include "ES_General.h"
+#include "../FrameworkHeaders/ES_Framework.h"
+
+#ifndef ES_TICKLESS
+#error "build the tickless test with ES_TICKLESS defined"
+#endif
+#ifdef __XC32
+#error "the tickless test runs on a host"
+#endif
+
+// 1ms ticks
+#define PER_TICK ES_Timer_RATE_1mS
+#define NUM_SIM_TICKS 20000UL
+// the timers and the ticks that each one is started for
+#define NUM_TEST_TIMERS 4
+static const uint16_t Periods[NUM_TEST_TIMERS] = { 1, 7, 250, 1000 };
+
+static uint32_t DueTick[NUM_TEST_TIMERS];
+static uint32_t NumTimeouts;
+static uint32_t NumWrong;
+// the count passed the compare since the last ES_Tickless_Service
+static bool     Woken;
+
+static bool CheckTimeout(ES_Event_t ThisEvent);
+
+// the parts of the PIC32 port that the timer module calls
+void _HW_Timer_Init(const TimerRate_t Rate)
+{
+  ES_Tickless_Init(Rate);
+}
+
+uint16_t _HW_GetTickCount(void)
+{
+  return (uint16_t)ES_Tickless_GetTickCount();
+}
+
+uint32_t _HW_GetTickCount32(void)
+{
+  return ES_Tickless_GetTickCount();
+}
+
+// and the part of the framework: no periodic timers run here
+uint8_t ES_TakeTimeoutTarget(void)
+{
+  return ES_NO_SERVICE;
+}
+
+int main(void)
+{
+  uint32_t  Interrupts = 0;
+  uint32_t  Seed = 12345;
+  uint32_t  Step, Before;
+  uint8_t   i;
+
+  ES_SimCoreCount = 0xFFFFFFFFUL - 5000UL * PER_TICK; // wraps after 5000 ticks
+  ES_Timer_Init(PER_TICK);
+  for (i = 0; i < NUM_TEST_TIMERS; i++)
+  {
+    ES_Timer_SetPostFunc(i, CheckTimeout);
+  }
+  // only the 1 tick timer runs for the first 100 ticks, then all of them
+  ES_Timer_InitTimer(0, Periods[0]);
+  DueTick[0] = ES_Tickless_GetTickCount() + Periods[0];
+
+  while (ES_Tickless_GetTickCount() < NUM_SIM_TICKS)
+  {
+    if (ES_Tickless_GetTickCount() == 100)
+    {
+      ES_Timer_StopTimer(0);
+      for (i = 1; i < NUM_TEST_TIMERS; i++)
+      {
+        ES_Timer_InitTimer(i, Periods[i]);
+        DueTick[i] = ES_Tickless_GetTickCount() + Periods[i];
+      }
+    }
+    // a run function takes somewhere from 0 to 0.3 ticks
+    Seed    = Seed * 1103515245UL + 12345UL;
+    Step    = (Seed >> 8) % (PER_TICK * 3 / 10);
+    Before  = ES_SimCoreCount;
+    ES_SimCoreCount += Step;
+    if ((ES_SimCoreCompare - Before - 1) < Step)
+    {
+      // the count passed the compare, respond as _HW_SysTickIntHandler does
+      Interrupts++;
+      Woken = true;
+      ES_SimCoreCompare = ES_SimCoreCount + ES_TICKLESS_MAX_WAIT;
+    }
+    ES_Tickless_Service();
+    Woken = false;
+  }
+
+  // the timers still running should all be due after the end
+  for (i = 1; i < NUM_TEST_TIMERS; i++)
+  {
+    if (DueTick[i] <= ES_Tickless_GetTickCount())
+    {
+      NumWrong++; // its last timeout never came
+    }
+  }
+
+  printf("tickless: %u timeouts, %u in the wrong tick, missed or not woken "
+      "for, %u interrupts in %lu ticks\r\n", (unsigned)NumTimeouts,
+      (unsigned)NumWrong, (unsigned)Interrupts, NUM_SIM_TICKS);
+  printf("tickless timers %s\r\n", (NumWrong == 0) ? "passed" : "FAILED");
+  return (NumWrong == 0) ? 0 : 1;
+}
+
+// checks that the timeout came in the tick that it was due and starts the
+// one-shot timer again
+static bool CheckTimeout(ES_Event_t ThisEvent)
+{
+  uint8_t Num = (uint8_t)ThisEvent.EventParam;
+
+  NumTimeouts++;
+  if ((ES_Tickless_GetTickCount() != DueTick[Num]) || !Woken)
+  {
+    NumWrong++;
+  }
+  ES_Timer_InitTimer(Num, Periods[Num]);
+  DueTick[Num] = ES_Tickless_GetTickCount() + Periods[Num];
+  return true;
+}
+
+#endif
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
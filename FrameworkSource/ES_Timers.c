@@ -1,18 +1,44 @@
+//#define TEST
 /****************************************************************************
  Module
      ES_Timers.c
 
  Description
-     This is a module implementing  8 16 bit timers all using the RTI
-     timebase
+     This is a module implementing ES_NUM_TIMERS 32 bit timers all using the
+     RTI timebase
 
  Notes
      Everything is done in terms of RTI Ticks, which can change from
      application to application.
+     The active timers are kept in a binary min-heap keyed on the tick that
+     they run out on, so a tick only has to look at the top of the heap,
+     and starting or stopping a timer is O(log n).
+     A periodic timer is put back in the heap one period after the tick it
+     was due on, not the tick its timeout was handled on, so it keeps its
+     phase however late the service is.
+     A timer handle is just a timer number. Timers with no post function in
+     ES_Configure.h form the pool that ES_Timer_Alloc hands out from, and
+     the numbered timer functions work on handles too.
 
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 19:40 agt      replaced the scan of all active timers on each tick
+                         with a min-heap on expiry time. ES_NUM_TIMERS sets
+                         the number of timers. Added ES_Timer_MultiTick_Resp
+                         and ES_Timer_SetPostFunc
+ 10/17/26 20:30 agt      added ES_Timer_GetTicksToNext and the tickless mode
+                         hooks
+ 10/17/26 21:10 agt      timer durations are 32 bits, up to ES_TIMER_MAX_TIME.
+                         Added ES_Timer_GetTime32
+ 10/17/26 21:45 agt      added periodic timers, which reload in the tick
+                         response, and their overrun counts
+ 10/17/26 22:30 agt      added timer handles given out at run time, with their
+                         own event or a callback
+ 10/18/26 00:30 agt      timers running out are traced when ES_TRACER is
+                         defined
+ 10/18/26 07:40 agt      a periodic timer's timeout only counts as handled
+                         when the service that its queue went to gets it
  10/27/14 14:02 jec      moved ticking of 'time' to ES_Port to allow it to tick
                          even while blocking. required change to ES_GetTime too
  10/20/13 10:48 jec      moved definition of BITS_PER_BYTE to ES_General.h
@@ -50,48 +76,107 @@
 #include "../FrameworkHeaders/ES_LookupTables.h"
 #include "../FrameworkHeaders/ES_Timers.h"
 #include "../FrameworkHeaders/ES_Port.h"
+#include "../FrameworkHeaders/ES_Tickless.h"
+#include <stddef.h>
+
+#ifdef TEST
+// the benchmark needs up to 256 timers
+#undef ES_NUM_TIMERS
+#define ES_NUM_TIMERS 256
+#endif
 /*--------------------------- External Variables --------------------------*/
 
 /*----------------------------- Module Defines ----------------------------*/
+// TMR_HeapPos value for a timer that is not counting
+#define NOT_ACTIVE 0xFFFF
 
-/*------------------------------ Module Types -----------------------------*/
+// the timers that ES_Timer_Alloc can hand out, all but 255, which is
+// ES_TIMER_NO_HANDLE
+#if ES_NUM_TIMERS > 255
+#define NUM_HANDLES 255
+#else
+#define NUM_HANDLES ES_NUM_TIMERS
+#endif
 
-/*
-   the size of Tflag sets the number of timers, uint8 = 8, uint16 = 16 ...)
-   to add more timers, you will need to change the data type and modify
-   the initialization of TMR_TimerArray and TMR_MaskArray
-*/
+#if ES_NUM_TIMERS > 256
+#error "ES_NUM_TIMERS can be no larger than 256"
+#endif
+#if ES_NUM_TIMERS < 16
+#error "ES_NUM_TIMERS must be at least 16"
+#endif
 
-typedef uint16_t Tflag_t;
+#ifdef ES_TICKLESS
+// bring TMR_Now up to date before using it, and move the compare for the
+// next deadline after changing the heap
+#define CatchUp() ES_Tickless_CatchUp()
+#define Reschedule() ES_Tickless_Reschedule()
+#else
+// with a tick interrupt, TMR_Now is kept up to date by the tick response
+#define CatchUp()
+#define Reschedule()
+#endif
 
-typedef uint16_t Timer_t; // sets size of timers to 16 bits
+/*------------------------------ Module Types -----------------------------*/
 
 /*---------------------------- Module Functions ---------------------------*/
+static inline bool ExpiresBefore(uint8_t TimerA, uint8_t TimerB);
+static void HeapInsert(uint8_t Num);
+static void HeapRemove(uint8_t Num);
+static void SiftUp(uint16_t Pos);
+static void SiftDown(uint16_t Pos);
+static void Reload(uint8_t Num);
+static void AddOverruns(uint8_t Num, uint32_t NumMissed);
+static bool Expire(uint8_t Num);
+static inline bool HasTarget(uint8_t Num);
+static ES_TimerHandle_t FindFreeTimer(void);
 
 /*---------------------------- Module Variables ---------------------------*/
-static Timer_t TMR_TimerArray[sizeof(Tflag_t) * BITS_PER_BYTE] =
-{
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0,
-  0x0
-};
+// the tick count that the expiry times are measured against. It only moves
+// forward in ES_Timer_Tick_Resp and ES_Timer_MultiTick_Resp
+static uint32_t TMR_Now;
+
+// the tick on which each active timer runs out
+static uint32_t TMR_Expiry[ES_NUM_TIMERS];
+
+// the ticks that each inactive timer has left to count. Set by SetTimer,
+// saved by StopTimer and cleared when the timer runs out
+static uint32_t TMR_Remaining[ES_NUM_TIMERS];
+
+// the period of each periodic timer, 0 for a one shot timer
+static uint32_t TMR_Period[ES_NUM_TIMERS];
+
+// expiries of each periodic timer that its service did not get, because the
+// last timeout had not been handled yet or the tick response was too late
+static uint16_t TMR_Overruns[ES_NUM_TIMERS];
 
-static Tflag_t TMR_ActiveFlags;
+// true while a periodic timer's last timeout is waiting to be handled
+static bool     TMR_Pending[ES_NUM_TIMERS];
 
-static pPostFunc const Timer2PostFunc[sizeof(Tflag_t) * BITS_PER_BYTE] =
+// the service whose queue took a periodic timer's pending timeout, or
+// ES_NO_SERVICE if it went somewhere else, e.g. to a post function that
+// is not a service queue
+static uint8_t  TMR_Owner[ES_NUM_TIMERS];
+
+// the event that each timer posts. ES_NO_EVENT, as they start out, stands
+// for ES_TIMEOUT with the timer number as the param, so the numbered timers
+// need no setting up
+static uint16_t         TMR_EventType[ES_NUM_TIMERS];
+static ES_EventParam_t  TMR_EventParam[ES_NUM_TIMERS];
+
+// the function a timer handle calls in place of posting, or NULL
+static pTimerCallback   TMR_Callback[ES_NUM_TIMERS];
+
+// the active timers as a binary min-heap on expiry time, so the next one to
+// run out is always TMR_Heap[0]
+static uint8_t  TMR_Heap[ES_NUM_TIMERS];
+static uint16_t TMR_HeapSize;
+
+// where each timer is in TMR_Heap, NOT_ACTIVE if it isn't there
+static uint16_t TMR_HeapPos[ES_NUM_TIMERS];
+
+// the post function of each timer, from the TIMERn_RESP_FUNC definitions or
+// ES_Timer_SetPostFunc
+static pPostFunc Timer2PostFunc[ES_NUM_TIMERS] =
 {
   TIMER0_RESP_FUNC,
   TIMER1_RESP_FUNC,
@@ -109,6 +194,342 @@ static pPostFunc const Timer2PostFunc[sizeof(Tflag_t) * BITS_PER_BYTE] =
   TIMER13_RESP_FUNC,
   TIMER14_RESP_FUNC,
   TIMER15_RESP_FUNC
+#if ES_NUM_TIMERS > 16
+#ifdef TIMER16_RESP_FUNC
+  , TIMER16_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 17
+#ifdef TIMER17_RESP_FUNC
+  , TIMER17_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 18
+#ifdef TIMER18_RESP_FUNC
+  , TIMER18_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 19
+#ifdef TIMER19_RESP_FUNC
+  , TIMER19_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 20
+#ifdef TIMER20_RESP_FUNC
+  , TIMER20_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 21
+#ifdef TIMER21_RESP_FUNC
+  , TIMER21_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 22
+#ifdef TIMER22_RESP_FUNC
+  , TIMER22_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 23
+#ifdef TIMER23_RESP_FUNC
+  , TIMER23_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 24
+#ifdef TIMER24_RESP_FUNC
+  , TIMER24_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 25
+#ifdef TIMER25_RESP_FUNC
+  , TIMER25_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 26
+#ifdef TIMER26_RESP_FUNC
+  , TIMER26_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 27
+#ifdef TIMER27_RESP_FUNC
+  , TIMER27_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 28
+#ifdef TIMER28_RESP_FUNC
+  , TIMER28_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 29
+#ifdef TIMER29_RESP_FUNC
+  , TIMER29_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 30
+#ifdef TIMER30_RESP_FUNC
+  , TIMER30_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 31
+#ifdef TIMER31_RESP_FUNC
+  , TIMER31_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 32
+#ifdef TIMER32_RESP_FUNC
+  , TIMER32_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 33
+#ifdef TIMER33_RESP_FUNC
+  , TIMER33_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 34
+#ifdef TIMER34_RESP_FUNC
+  , TIMER34_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 35
+#ifdef TIMER35_RESP_FUNC
+  , TIMER35_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 36
+#ifdef TIMER36_RESP_FUNC
+  , TIMER36_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 37
+#ifdef TIMER37_RESP_FUNC
+  , TIMER37_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 38
+#ifdef TIMER38_RESP_FUNC
+  , TIMER38_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 39
+#ifdef TIMER39_RESP_FUNC
+  , TIMER39_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 40
+#ifdef TIMER40_RESP_FUNC
+  , TIMER40_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 41
+#ifdef TIMER41_RESP_FUNC
+  , TIMER41_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 42
+#ifdef TIMER42_RESP_FUNC
+  , TIMER42_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 43
+#ifdef TIMER43_RESP_FUNC
+  , TIMER43_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 44
+#ifdef TIMER44_RESP_FUNC
+  , TIMER44_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 45
+#ifdef TIMER45_RESP_FUNC
+  , TIMER45_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 46
+#ifdef TIMER46_RESP_FUNC
+  , TIMER46_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 47
+#ifdef TIMER47_RESP_FUNC
+  , TIMER47_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 48
+#ifdef TIMER48_RESP_FUNC
+  , TIMER48_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 49
+#ifdef TIMER49_RESP_FUNC
+  , TIMER49_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 50
+#ifdef TIMER50_RESP_FUNC
+  , TIMER50_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 51
+#ifdef TIMER51_RESP_FUNC
+  , TIMER51_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 52
+#ifdef TIMER52_RESP_FUNC
+  , TIMER52_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 53
+#ifdef TIMER53_RESP_FUNC
+  , TIMER53_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 54
+#ifdef TIMER54_RESP_FUNC
+  , TIMER54_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 55
+#ifdef TIMER55_RESP_FUNC
+  , TIMER55_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 56
+#ifdef TIMER56_RESP_FUNC
+  , TIMER56_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 57
+#ifdef TIMER57_RESP_FUNC
+  , TIMER57_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 58
+#ifdef TIMER58_RESP_FUNC
+  , TIMER58_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 59
+#ifdef TIMER59_RESP_FUNC
+  , TIMER59_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 60
+#ifdef TIMER60_RESP_FUNC
+  , TIMER60_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 61
+#ifdef TIMER61_RESP_FUNC
+  , TIMER61_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 62
+#ifdef TIMER62_RESP_FUNC
+  , TIMER62_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
+#if ES_NUM_TIMERS > 63
+#ifdef TIMER63_RESP_FUNC
+  , TIMER63_RESP_FUNC
+#else
+  , TIMER_UNUSED
+#endif
+#endif
 };
 
 /*------------------------------ Module Code ------------------------------*/
@@ -130,6 +551,15 @@ static pPostFunc const Timer2PostFunc[sizeof(Tflag_t) * BITS_PER_BYTE] =
 ****************************************************************************/
 void ES_Timer_Init(TimerRate_t Rate)
 {
+  uint16_t i;
+
+  for (i = 0; i < ES_NUM_TIMERS; i++)
+  {
+    TMR_HeapPos[i]  = NOT_ACTIVE;
+    TMR_Period[i]   = 0;
+    TMR_Pending[i]  = false;
+  }
+  TMR_HeapSize = 0;
   // call the hardware init routine
   _HW_Timer_Init(Rate);
 }
@@ -139,28 +569,41 @@ void ES_Timer_Init(TimerRate_t Rate)
      ES_Timer_SetTimer
  Parameters
      unsigned char Num, the number of the timer to set.
-     unsigned int NewTime, the new time to set on that timer
+     uint32_t NewTime, the new time to set on that timer, from 1 to
+       ES_TIMER_MAX_TIME
  Returns
      ES_Timer_ERR if requested timer does not exist or has no service
      ES_Timer_OK  otherwise
  Description
      sets the time for a timer, but does not make it active.
  Notes
-     None.
+     a timer that is already counting starts counting NewTime from now
  Author
      J. Edward Carryer, 02/24/97 17:11
 ****************************************************************************/
-ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime)
+ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime)
 {
   /* tried to set a timer that doesn't exist */
-  if ((Num >= ARRAY_SIZE(TMR_TimerArray)) ||
+  if ((Num >= ARRAY_SIZE(Timer2PostFunc)) ||
       /* tried to set a timer without a service */
-      (Timer2PostFunc[Num] == TIMER_UNUSED) ||
-      (NewTime == 0))   /* no time being set */
+      !HasTarget(Num) ||
+      (NewTime == 0) ||  /* no time being set */
+      (NewTime > ES_TIMER_MAX_TIME))
   {
     return ES_Timer_ERR;
   }
-  TMR_TimerArray[Num] = NewTime;
+  if (TMR_HeapPos[Num] != NOT_ACTIVE)
+  {
+    CatchUp();
+    HeapRemove(Num);
+    TMR_Expiry[Num] = TMR_Now + NewTime;
+    HeapInsert(Num);
+    Reschedule();
+  }
+  else
+  {
+    TMR_Remaining[Num] = NewTime;
+  }
   return ES_Timer_OK;
 }
 
@@ -172,23 +615,30 @@ ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime)
  Returns
      ES_Timer_ERR for error ES_Timer_OK for success
  Description
-     simply sets the active flag in TMR_ActiveFlags to (re)start a
-     stopped timer.
+     (re)starts a stopped timer with the time that it had left, or the time
+     from ES_Timer_SetTimer
  Notes
-     None.
+     starting a timer that is already counting changes nothing
  Author
      J. Edward Carryer, 02/24/97 14:45
 ****************************************************************************/
 ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
 {
-  /* tried to set a timer that doesn't exist */
-  if ((Num >= ARRAY_SIZE(TMR_TimerArray)) ||
-      /* tried to set a timer with no time on it */
-      (TMR_TimerArray[Num] == 0))
+  if (Num >= ARRAY_SIZE(Timer2PostFunc))
   {
-    return ES_Timer_ERR;
+    return ES_Timer_ERR;    /* tried to start a timer that doesn't exist */
+  }
+  if (TMR_HeapPos[Num] == NOT_ACTIVE)
+  {
+    if (TMR_Remaining[Num] == 0)
+    {
+      return ES_Timer_ERR;  /* tried to start a timer with no time on it */
+    }
+    CatchUp();
+    TMR_Expiry[Num] = TMR_Now + TMR_Remaining[Num];
+    HeapInsert(Num);
+    Reschedule();
   }
-  TMR_ActiveFlags |= BitNum2SetMask[Num];  /* set timer as active */
   return ES_Timer_OK;
 }
 
@@ -200,8 +650,9 @@ ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
  Returns
      ES_Timer_ERR for error (timer doesn't exist) ES_Timer_OK for success.
  Description
-     simply clears the bit in TMR_ActiveFlags associated with this
-     timer. This will cause it to stop counting.
+     takes the timer out of the heap of active timers, keeping the time
+     that it had left for ES_Timer_StartTimer. This will cause it to stop
+     counting.
  Notes
      None.
  Author
@@ -209,11 +660,16 @@ ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
 ****************************************************************************/
 ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num)
 {
-  if (Num >= ARRAY_SIZE(TMR_TimerArray))
+  if (Num >= ARRAY_SIZE(Timer2PostFunc))
   {
     return ES_Timer_ERR;    /* tried to set a timer that doesn't exist */
   }
-  TMR_ActiveFlags &= BitNum2ClrMask[Num];  /* set timer as inactive */
+  if (TMR_HeapPos[Num] != NOT_ACTIVE)
+  {
+    CatchUp();
+    TMR_Remaining[Num] = TMR_Expiry[Num] - TMR_Now;
+    HeapRemove(Num);
+  }
   return ES_Timer_OK;
 }
 
@@ -222,7 +678,8 @@ ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num)
      ES_Timer_InitTimer
  Parameters
      unsigned char Num, the number of the timer to start
-     unsigned int NewTime, the number of ticks to be counted
+     uint32_t NewTime, the number of ticks to be counted, from 1 to
+       ES_TIMER_MAX_TIME
  Returns
      ES_Timer_ERR if the requested timer does not exist, ES_Timer_OK otherwise.
  Description
@@ -233,22 +690,281 @@ ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num)
  Author
      J. Edward Carryer, 02/24/97 14:51
 ****************************************************************************/
-ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint16_t NewTime)
+ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime)
 {
   /* tried to set a timer that doesn't exist */
-  if ((Num >= ARRAY_SIZE(TMR_TimerArray)) ||
+  if ((Num >= ARRAY_SIZE(Timer2PostFunc)) ||
       /* tried to set a timer without a service */
-      (Timer2PostFunc[Num] == TIMER_UNUSED) ||
+      !HasTarget(Num) ||
       /* tried to set a timer without putting any time on it */
-      (NewTime == 0))
+      (NewTime == 0) ||
+      /* or more than the time base can count to */
+      (NewTime > ES_TIMER_MAX_TIME))
+  {
+    return ES_Timer_ERR;
+  }
+  CatchUp();
+  if (TMR_HeapPos[Num] != NOT_ACTIVE)
+  {
+    HeapRemove(Num);
+  }
+  TMR_Period[Num] = 0;  // a one shot timer
+  TMR_Expiry[Num] = TMR_Now + NewTime;
+  HeapInsert(Num);
+  Reschedule();
+  return ES_Timer_OK;
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_InitPeriodic
+ Parameters
+     unsigned char Num, the number of the timer to start
+     uint32_t Period, the number of ticks between timeouts, from 1 to
+       ES_TIMER_MAX_TIME
+ Returns
+     ES_Timer_ERR if the requested timer does not exist, ES_Timer_OK otherwise.
+ Description
+     starts the timer counting, posting an ES_TIMEOUT every Period ticks
+     until it is stopped, with no need for the service to restart it
+ Notes
+     The timeouts stay in step with the first one however late they are
+     handled. While a timeout is waiting to be handled the timer does not
+     post another one, it counts an overrun instead, see
+     ES_Timer_GetOverruns. ES_Timer_InitTimer makes it a one shot timer
+     again, ES_Timer_StopTimer & ES_Timer_StartTimer pause it.
+ Author
+     agt, 10/17/26
+****************************************************************************/
+ES_TimerReturn_t ES_Timer_InitPeriodic(uint8_t Num, uint32_t Period)
+{
+  if (ES_Timer_InitTimer(Num, Period) != ES_Timer_OK)
+  {
+    return ES_Timer_ERR;
+  }
+  TMR_Period[Num]   = Period;
+  TMR_Overruns[Num] = 0;
+  TMR_Pending[Num]  = false;
+  return ES_Timer_OK;
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_GetOverruns
+ Parameters
+     unsigned char Num, the number of a periodic timer
+ Returns
+     uint16_t : the timeouts that the service missed since the last call
+ Description
+     reads and clears the overrun count of a periodic timer. A timeout is
+     missed when it comes while the last one is still waiting to be
+     handled, when the tick response fell more than a period behind, or
+     when the post failed
+ Notes
+     the count stops at 65535
+ Author
+     agt, 10/17/26
+****************************************************************************/
+uint16_t ES_Timer_GetOverruns(uint8_t Num)
+{
+  uint16_t Overruns;
+
+  if (Num >= ARRAY_SIZE(Timer2PostFunc))
+  {
+    return 0;
+  }
+  Overruns          = TMR_Overruns[Num];
+  TMR_Overruns[Num] = 0;
+  return Overruns;
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_TimeoutHandled
+ Parameters
+     unsigned char Num, the number of the timer from an ES_TIMEOUT event
+     uint8_t WhichService, the service that the event is dispatched to
+ Returns
+     None.
+ Description
+     lets a periodic timer post its next timeout, if the event is the one
+     that it posted
+ Notes
+     called by ES_Run as it dispatches each ES_TIMEOUT event. An ES_TIMEOUT
+     that a service or a timer handle posts with the number of a periodic
+     timer is not taken for that timer's timeout unless it goes to the same
+     service as the timer's timeouts do
+ Author
+     agt, 10/17/26
+****************************************************************************/
+void ES_Timer_TimeoutHandled(uint8_t Num, uint8_t WhichService)
+{
+  if ((Num < ARRAY_SIZE(Timer2PostFunc)) && TMR_Pending[Num] &&
+      ((TMR_Owner[Num] == WhichService) || (TMR_Owner[Num] == ES_NO_SERVICE)))
+  {
+    TMR_Pending[Num] = false;
+  }
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_SetPostFunc
+ Parameters
+     unsigned char Num, the number of the timer
+     pPostFunc PostFunc, where its timeout events should go, or
+       TIMER_UNUSED
+ Returns
+     ES_Timer_ERR if the requested timer does not exist, ES_Timer_OK otherwise.
+ Description
+     routes a timer's timeout events to a service at run time. Timers
+     above 63 can only be routed this way
+ Notes
+     a timer that is counting keeps counting
+ Author
+     agt, 10/17/26
+****************************************************************************/
+ES_TimerReturn_t ES_Timer_SetPostFunc(uint8_t Num, pPostFunc PostFunc)
+{
+  if (Num >= ARRAY_SIZE(Timer2PostFunc))
+  {
+    return ES_Timer_ERR;
+  }
+  Timer2PostFunc[Num] = PostFunc;
+  return ES_Timer_OK;
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_Alloc
+ Parameters
+     pPostFunc PostFunc, where the timer's events should go
+     ES_EventType_t EventType, the type of event to post when it runs out
+     ES_EventParam_t EventParam, the param to post with it
+ Returns
+     ES_TimerHandle_t : the timer, or ES_TIMER_NO_HANDLE if none are free
+ Description
+     hands out a timer that has no post function in ES_Configure.h, set up
+     to post the given event. Start it with ES_Timer_InitTimer or
+     ES_Timer_InitPeriodic like any other timer
+ Notes
+     only a handle posting ES_TIMEOUT with its own number as the param has
+     its periodic timeouts matched up with their dispatch, see
+     ES_Timer_InitPeriodic. Any other periodic handle posts every time
+ Author
+     agt, 10/17/26
+****************************************************************************/
+ES_TimerHandle_t ES_Timer_Alloc(pPostFunc PostFunc, ES_EventType_t EventType,
+    ES_EventParam_t EventParam)
+{
+  ES_TimerHandle_t Handle;
+
+  if ((PostFunc == TIMER_UNUSED) || (EventType == ES_NO_EVENT))
+  {
+    return ES_TIMER_NO_HANDLE;
+  }
+  Handle = FindFreeTimer();
+  if (Handle != ES_TIMER_NO_HANDLE)
+  {
+    Timer2PostFunc[Handle]  = PostFunc;
+    TMR_EventType[Handle]   = EventType;
+    TMR_EventParam[Handle]  = EventParam;
+  }
+  return Handle;
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_AllocCallback
+ Parameters
+     pTimerCallback Callback, the function to call when the timer runs out
+     ES_EventParam_t Param, passed to the callback
+ Returns
+     ES_TimerHandle_t : the timer, or ES_TIMER_NO_HANDLE if none are free
+ Description
+     hands out a timer that calls a function instead of posting an event
+ Notes
+     the callback runs from the tick response, in _HW_Process_Pending_Ints,
+     so it should be as short as an event checker. It may post events and
+     start or stop timers, itself included
+ Author
+     agt, 10/17/26
+****************************************************************************/
+ES_TimerHandle_t ES_Timer_AllocCallback(pTimerCallback Callback,
+    ES_EventParam_t Param)
+{
+  ES_TimerHandle_t Handle;
+
+  if (Callback == NULL)
+  {
+    return ES_TIMER_NO_HANDLE;
+  }
+  Handle = FindFreeTimer();
+  if (Handle != ES_TIMER_NO_HANDLE)
+  {
+    TMR_Callback[Handle]    = Callback;
+    TMR_EventParam[Handle]  = Param;
+  }
+  return Handle;
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_Free
+ Parameters
+     ES_TimerHandle_t Handle, a timer from ES_Timer_Alloc or
+       ES_Timer_AllocCallback
+ Returns
+     ES_Timer_ERR if the handle is not a timer, ES_Timer_OK otherwise.
+ Description
+     stops the timer and puts it back in the pool
+ Notes
+     a timeout that it has already posted is still delivered
+ Author
+     agt, 10/17/26
+****************************************************************************/
+ES_TimerReturn_t ES_Timer_Free(ES_TimerHandle_t Handle)
+{
+  if (Handle >= ARRAY_SIZE(Timer2PostFunc))
   {
     return ES_Timer_ERR;
   }
-  TMR_TimerArray[Num] = NewTime;
-  TMR_ActiveFlags     |= BitNum2SetMask[Num]; /* set timer as active */
+  ES_Timer_StopTimer(Handle);
+  Timer2PostFunc[Handle]  = TIMER_UNUSED;
+  TMR_Callback[Handle]    = NULL;
+  TMR_EventType[Handle]   = ES_NO_EVENT;
+  TMR_Period[Handle]      = 0;
+  TMR_Pending[Handle]     = false;
   return ES_Timer_OK;
 }
 
+/****************************************************************************
+ Function
+     ES_Timer_GetTicksToNext
+ Parameters
+     uint32_t * pTicks, used to return the number of ticks until the next
+       active timer runs out, 0 if one is already due
+ Returns
+     bool : false if no timer is active
+ Description
+     looks at the timer on top of the heap
+ Notes
+     used by the tickless time base to set the core timer compare
+ Author
+     agt, 10/17/26
+****************************************************************************/
+bool ES_Timer_GetTicksToNext(uint32_t *pTicks)
+{
+  int32_t TicksLeft;
+
+  if (TMR_HeapSize == 0)
+  {
+    return false;
+  }
+  TicksLeft = (int32_t)(TMR_Expiry[TMR_Heap[0]] - TMR_Now);
+  *pTicks   = (TicksLeft > 0) ? (uint32_t)TicksLeft : 0;
+  return true;
+}
+
 /****************************************************************************
  Function
      ES_Timer_GetTime
@@ -270,6 +986,26 @@ uint16_t ES_Timer_GetTime(void)
   return _HW_GetTickCount();
 }
 
+/****************************************************************************
+ Function
+     ES_Timer_GetTime32
+ Parameters
+     None.
+ Returns
+     the current tick count, all 32 bits of it
+ Description
+     the same as ES_Timer_GetTime, for times longer than 65535 ticks
+ Notes
+     it wraps after 49 days with 1mS ticks. Take the difference of two times
+     as a uint32_t and it is right across the wrap
+ Author
+     agt, 10/17/26
+****************************************************************************/
+uint32_t ES_Timer_GetTime32(void)
+{
+  return _HW_GetTickCount32();
+}
+
 /****************************************************************************
  Function
      ES_Timer_Tick_Resp
@@ -278,47 +1014,863 @@ uint16_t ES_Timer_GetTime(void)
  Returns
      None.
  Description
-     This is the new Tick response routine to support the timer module.
-     It will increment time, to maintain the functionality of the
-     GetTime() timer and it will check through the active timers,
-     decrementing each active timers count, if the count goes to 0, it
-     will post an event to the corresponding SM and clear the active flag to
-     prevent further counting.
+     This is the Tick response routine to support the timer module.
+     It processes a single tick, see ES_Timer_MultiTick_Resp
  Notes
-     Called from _Timer_Int_Resp in ES_Port.c.
+     Called from _HW_Process_Pending_Ints in ES_Port.c.
  Author
      J. Edward Carryer, 02/24/97 15:06
 ****************************************************************************/
 void ES_Timer_Tick_Resp(void)
 {
-  static Tflag_t  NeedsProcessing;
-  static uint8_t  NextTimer2Process;
-  static ES_Event_t NewEvent;
+  ES_Timer_MultiTick_Resp(1);
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_MultiTick_Resp
+ Parameters
+     uint16_t NumTicks, the number of ticks that have gone by
+ Returns
+     None.
+ Description
+     moves the timer time base forward by NumTicks and, for every active
+     timer that has run out, posts an ES_TIMEOUT event to the corresponding
+     service and makes the timer inactive.
+ Notes
+     Called from _HW_Process_Pending_Ints in ES_Port.c.
+     Only the earliest expiry is looked at, so a tick with nothing running
+     out costs the same however many timers are active. Timers that run out
+     in the same pass post in the order they ran out, the highest numbered
+     first if they ran out on the same tick, as they did with the old scan.
+     A periodic timer goes back in the heap before its post, and posts once
+     however many periods it is behind
+ Author
+     agt, 10/17/26
+****************************************************************************/
+void ES_Timer_MultiTick_Resp(uint16_t NumTicks)
+{
+  uint8_t NextTimer2Process;
 
-  if (TMR_ActiveFlags != 0) /* if !=0 , then at least 1 timer is active */
+  TMR_Now += NumTicks;
+  while ((TMR_HeapSize != 0) &&
+         ((int32_t)(TMR_Expiry[TMR_Heap[0]] - TMR_Now) <= 0))
   {
-    // start by getting a list of all the active timers
-    NeedsProcessing = TMR_ActiveFlags;
-    do
+    NextTimer2Process = TMR_Heap[0];
+    /* stop counting before the post, so that the service can restart it */
+    HeapRemove(NextTimer2Process);
+    if (TMR_Period[NextTimer2Process] == 0)
+    {
+      TMR_Remaining[NextTimer2Process] = 0;
+      /* post the timeout event to the right Service */
+      Expire(NextTimer2Process);
+    }
+    else
     {
-      // find the MSB that is set
-      NextTimer2Process = ES_GetMSBitSet(NeedsProcessing);
-      /* decrement that timer, check if timed out */
-      if (--TMR_TimerArray[NextTimer2Process] == 0)
+      Reload(NextTimer2Process);
+      if (TMR_Pending[NextTimer2Process])
       {
-        NewEvent.EventType  = ES_TIMEOUT;
-        NewEvent.EventParam = NextTimer2Process;
-        /* post the timeout event to the right Service */
-        Timer2PostFunc[NextTimer2Process](NewEvent);
-        /* and stop counting */
-        TMR_ActiveFlags &= BitNum2ClrMask[NextTimer2Process];
+        AddOverruns(NextTimer2Process, 1);
       }
-      // mark off the active timer that we just processed
-      NeedsProcessing &= BitNum2ClrMask[NextTimer2Process];
-    } while (NeedsProcessing != 0);
+      else
+      {
+        // pending before the post, in case the timeout is handled at once.
+        // Only a plain ES_TIMEOUT is matched up with its dispatch, in the
+        // service whose queue takes it
+        TMR_Pending[NextTimer2Process] =
+            (TMR_EventType[NextTimer2Process] == ES_NO_EVENT) &&
+            (TMR_Callback[NextTimer2Process] == NULL);
+        TMR_Owner[NextTimer2Process] = ES_NO_SERVICE;
+        ES_TakeTimeoutTarget(); // forget any earlier ES_TIMEOUT
+        if (!Expire(NextTimer2Process))
+        {
+          TMR_Pending[NextTimer2Process] = false;
+          AddOverruns(NextTimer2Process, 1);
+        }
+        else if (TMR_Pending[NextTimer2Process])
+        {
+          TMR_Owner[NextTimer2Process] = ES_TakeTimeoutTarget();
+        }
+      }
+    }
+  }
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+/****************************************************************************
+ Function
+     ExpiresBefore
+ Parameters
+     uint8_t TimerA, uint8_t TimerB : two active timers
+ Returns
+     bool : true if TimerA should come out of the heap before TimerB
+ Description
+     compares expiry times, allowing for TMR_Now wrapping around, and breaks
+     ties in favor of the higher numbered timer
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static inline bool ExpiresBefore(uint8_t TimerA, uint8_t TimerB)
+{
+  int32_t Difference = (int32_t)(TMR_Expiry[TimerA] - TMR_Expiry[TimerB]);
+
+  return (Difference < 0) || ((Difference == 0) && (TimerA > TimerB));
+}
+
+/****************************************************************************
+ Function
+     HeapInsert
+ Parameters
+     uint8_t Num : an inactive timer, with its TMR_Expiry set
+ Returns
+     None.
+ Description
+     adds the timer to the heap of active timers
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static void HeapInsert(uint8_t Num)
+{
+  TMR_Heap[TMR_HeapSize]  = Num;
+  TMR_HeapPos[Num]        = TMR_HeapSize;
+  SiftUp(TMR_HeapSize++);
+}
+
+/****************************************************************************
+ Function
+     HeapRemove
+ Parameters
+     uint8_t Num : an active timer
+ Returns
+     None.
+ Description
+     takes the timer out of the heap of active timers, filling its place
+     with the last timer in the heap
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static void HeapRemove(uint8_t Num)
+{
+  uint16_t  Pos = TMR_HeapPos[Num];
+  uint8_t   Last;
+
+  TMR_HeapPos[Num] = NOT_ACTIVE;
+  Last = TMR_Heap[--TMR_HeapSize];
+  if (Last != Num)
+  {
+    TMR_Heap[Pos]     = Last;
+    TMR_HeapPos[Last] = Pos;
+    // the replacement may belong above or below this spot
+    if ((Pos > 0) && ExpiresBefore(Last, TMR_Heap[(Pos - 1) / 2]))
+    {
+      SiftUp(Pos);
+    }
+    else
+    {
+      SiftDown(Pos);
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+     SiftUp
+ Parameters
+     uint16_t Pos : a place in the heap
+ Returns
+     None.
+ Description
+     moves the timer at Pos up past any parents that expire after it
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static void SiftUp(uint16_t Pos)
+{
+  uint8_t   Num = TMR_Heap[Pos];
+  uint16_t  Parent;
+
+  while (Pos > 0)
+  {
+    Parent = (Pos - 1) / 2;
+    if (!ExpiresBefore(Num, TMR_Heap[Parent]))
+    {
+      break;
+    }
+    TMR_Heap[Pos]                 = TMR_Heap[Parent];
+    TMR_HeapPos[TMR_Heap[Pos]]    = Pos;
+    Pos                           = Parent;
+  }
+  TMR_Heap[Pos]     = Num;
+  TMR_HeapPos[Num]  = Pos;
+}
+
+/****************************************************************************
+ Function
+     SiftDown
+ Parameters
+     uint16_t Pos : a place in the heap
+ Returns
+     None.
+ Description
+     moves the timer at Pos down past any children that expire before it
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static void SiftDown(uint16_t Pos)
+{
+  uint8_t   Num = TMR_Heap[Pos];
+  uint16_t  Child;
+
+  while ((Child = 2 * Pos + 1) < TMR_HeapSize)
+  {
+    // pick the child that expires first
+    if ((Child + 1 < TMR_HeapSize) &&
+        ExpiresBefore(TMR_Heap[Child + 1], TMR_Heap[Child]))
+    {
+      Child++;
+    }
+    if (!ExpiresBefore(TMR_Heap[Child], Num))
+    {
+      break;
+    }
+    TMR_Heap[Pos]               = TMR_Heap[Child];
+    TMR_HeapPos[TMR_Heap[Pos]]  = Pos;
+    Pos                         = Child;
+  }
+  TMR_Heap[Pos]     = Num;
+  TMR_HeapPos[Num]  = Pos;
+}
+
+/****************************************************************************
+ Function
+     Reload
+ Parameters
+     uint8_t Num : a periodic timer that has just been taken out of the heap
+ Returns
+     None.
+ Description
+     puts the timer back in the heap for the first of its expiry times that
+     is still to come, counting the ones that were skipped as overruns
+ Notes
+     the divide is only needed when the tick response is a period late
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static void Reload(uint8_t Num)
+{
+  uint32_t Late = TMR_Now - TMR_Expiry[Num];
+  uint32_t NumMissed = 0;
+
+  if (Late >= TMR_Period[Num])
+  {
+    NumMissed = Late / TMR_Period[Num];
+    AddOverruns(Num, NumMissed);
+  }
+  TMR_Expiry[Num] += (NumMissed + 1) * TMR_Period[Num];
+  HeapInsert(Num);
+}
+
+/****************************************************************************
+ Function
+     AddOverruns
+ Parameters
+     uint8_t Num : a periodic timer
+     uint32_t NumMissed : timeouts that its service did not get
+ Returns
+     None.
+ Description
+     adds to the overrun count, stopping at 65535
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static void AddOverruns(uint8_t Num, uint32_t NumMissed)
+{
+  uint32_t Total = TMR_Overruns[Num] + NumMissed;
+
+  TMR_Overruns[Num] = (Total > UINT16_MAX) ? UINT16_MAX : (uint16_t)Total;
+}
+
+/****************************************************************************
+ Function
+     Expire
+ Parameters
+     uint8_t Num : a timer that has run out
+ Returns
+     bool : false if the post failed
+ Description
+     calls the timer's callback, or posts its event to its service
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static bool Expire(uint8_t Num)
+{
+  static ES_Event_t NewEvent;
+  bool              ReturnVal;
+
+  if (TMR_Callback[Num] != NULL)
+  {
+    NewEvent.EventType  = ES_NO_EVENT;
+    NewEvent.EventParam = TMR_EventParam[Num];
+  }
+  else if (TMR_EventType[Num] == ES_NO_EVENT)
+  {
+    NewEvent.EventType  = ES_TIMEOUT;
+    NewEvent.EventParam = Num;
+  }
+  else
+  {
+    NewEvent.EventType  = TMR_EventType[Num];
+    NewEvent.EventParam = TMR_EventParam[Num];
+  }
+  ES_TRACE_EVENT(ES_TRACE_TIMEOUT, Num, NewEvent);
+  ES_TRACE_SET_FROM(ES_TRACE_FROM_TIMER + Num);
+  if (TMR_Callback[Num] != NULL)
+  {
+    TMR_Callback[Num](NewEvent.EventParam);
+    ReturnVal = true;
+  }
+  else
+  {
+    ReturnVal = Timer2PostFunc[Num](NewEvent);
+  }
+  ES_TRACE_SET_FROM(ES_TRACE_FROM_MAIN);
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+     HasTarget
+ Parameters
+     uint8_t Num : a timer
+ Returns
+     bool : true if the timer has a service or a callback to tell
+ Description
+     a timer without one is free for ES_Timer_Alloc and can't be started
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static inline bool HasTarget(uint8_t Num)
+{
+  return (Timer2PostFunc[Num] != TIMER_UNUSED) || (TMR_Callback[Num] != NULL);
+}
+
+/****************************************************************************
+ Function
+     FindFreeTimer
+ Parameters
+     None.
+ Returns
+     ES_TimerHandle_t : a timer with no service or callback, or
+       ES_TIMER_NO_HANDLE
+ Description
+     searches from the top down, leaving the low numbers for ES_Configure.h
+ Notes
+
+ Author
+     agt, 10/17/26
+****************************************************************************/
+static ES_TimerHandle_t FindFreeTimer(void)
+{
+  uint16_t Num;
+
+  for (Num = NUM_HANDLES; Num-- > 0;)
+  {
+    if (!HasTarget(Num))
+    {
+      return (ES_TimerHandle_t)Num;
+    }
   }
+  return ES_TIMER_NO_HANDLE;
 }
 
+#ifdef TEST
+// Checks the timer behavior that services rely on, runs a week of 1mS ticks
+// with timers longer than 16 bits across a wrap of the time base, checks
+// the drift of a periodic timer against one restarted by its service and
+// the timer handles, then times
+// the tick
+// response with 8, 16, 64 and 256 active timers, against the scan of every
+// active timer that the heap replaced. Timers are re-armed as they run out,
+// with periods spread from 100 to about 400 ticks. Times are core ticks per
+// tick on the PIC32, and scaled from the clock on a host.
+// On the PIC32, build it with the project so the TIMERn_RESP_FUNC services
+// exist. ES_Timer_Init calls _HW_Timer_Init, so the tick is running.
+
+#include <stdio.h>
+#include "dbprintf.h"
+
+#define NUM_BENCH_TICKS 20000UL
+// how many ticks are missed at once in the catch-up benchmark
+#define NUM_MISSED 10
+// the period of timer n in the benchmarks
+#define BENCH_PERIOD(n) (100 + ((n) * 37) % 300)
+// a week of 1mS ticks
+#define WEEK_TICKS (7UL * 24 * 60 * 60 * 1000)
+// the week test timers run for a second, an hour and a day
+#define NUM_LONG_TIMERS 3
+static const uint32_t LongPeriods[NUM_LONG_TIMERS] =
+{ 1000UL, 3600000UL, 86400000UL };
+
+static uint8_t  TimeoutLog[8];
+static uint8_t  NumTimeouts;
+static uint16_t ScanCounts[ES_NUM_TIMERS];
+static bool     ScanActive[ES_NUM_TIMERS];
+// the periodic test runs 10000 periods of 200 ticks
+#define NUM_PERIODS 10000UL
+#define TEST_PERIOD 200
+static uint32_t PeriodicCount;
+static ES_Event_t LastEvent;
+static uint16_t CallbackCount;
+static ES_EventParam_t CallbackParam;
+static uint32_t RestartedCount;
+static uint32_t LongDue[NUM_LONG_TIMERS];
+static uint32_t LongCounts[NUM_LONG_TIMERS];
+static bool     LongOnTime;
+#ifndef __XC32
+// on the host the timers are tested without the framework, so the test's
+// post functions stand in for the service queues and set which service took
+// each ES_TIMEOUT
+static uint8_t  TestTarget = ES_NO_SERVICE;
+#endif
+
+static bool LogTimeout(ES_Event_t ThisEvent);
+static bool RearmTimeout(ES_Event_t ThisEvent);
+static bool CheckLongTimeout(ES_Event_t ThisEvent);
+static bool TestTimers(void);
+static bool TestWeek(void);
+static bool CountPeriodic(ES_Event_t ThisEvent);
+static bool RestartTimeout(ES_Event_t ThisEvent);
+static bool TestPeriodic(void);
+#ifndef __XC32
+static bool PostToService3(ES_Event_t ThisEvent);
+static bool TestOwner(void);
+#endif
+static bool LogEvent(ES_Event_t ThisEvent);
+static void CountCallback(ES_EventParam_t Param);
+static bool TestHandles(void);
+static void ScanTick(uint16_t NumTimers);
+static void Benchmark(uint16_t NumTimers);
+
+void main(void)
+{
+  ES_Timer_Init(ES_Timer_RATE_1mS);
+  DB_printf("timer behavior %s\r\n", TestTimers() ? "passed" : "FAILED");
+  DB_printf("a week of ticks %s\r\n", TestWeek() ? "passed" : "FAILED");
+  DB_printf("periodic timers %s\r\n", TestPeriodic() ? "passed" : "FAILED");
+  DB_printf("timer handles %s\r\n", TestHandles() ? "passed" : "FAILED");
+#ifndef __XC32
+  DB_printf("timeout owners %s\r\n", TestOwner() ? "passed" : "FAILED");
+#endif
+  Benchmark(8);
+  Benchmark(16);
+  Benchmark(64);
+  Benchmark(256);
+#ifdef __XC32
+  while (1)
+  {
+    ;
+  }
+#endif
+}
+
+static bool LogTimeout(ES_Event_t ThisEvent)
+{
+  if (NumTimeouts < ARRAY_SIZE(TimeoutLog))
+  {
+    TimeoutLog[NumTimeouts++] = (uint8_t)ThisEvent.EventParam;
+  }
+  return true;
+}
+
+static bool RearmTimeout(ES_Event_t ThisEvent)
+{
+  ES_Timer_InitTimer((uint8_t)ThisEvent.EventParam,
+      BENCH_PERIOD(ThisEvent.EventParam));
+  return true;
+}
+
+static bool TestTimers(void)
+{
+  bool      Passed = true;
+  uint16_t  i;
+
+  for (i = 0; i < 4; i++)
+  {
+    ES_Timer_SetPostFunc(i, LogTimeout);
+  }
+  ES_Timer_SetPostFunc(4, TIMER_UNUSED);
+  Passed &= (ES_Timer_InitTimer(4, 10) == ES_Timer_ERR);
+  Passed &= (ES_Timer_InitTimer(0, 0) == ES_Timer_ERR);
+
+  // run out in time order, ties go highest number first
+  TMR_Now = 0xFFFFFFF0; // and across the wrap of the time base
+  ES_Timer_InitTimer(0, 5);
+  ES_Timer_InitTimer(1, 3);
+  ES_Timer_InitTimer(2, 5);
+  ES_Timer_InitTimer(3, 40);
+  ES_Timer_Tick_Resp();
+  ES_Timer_Tick_Resp();
+  Passed &= (NumTimeouts == 0);
+  ES_Timer_MultiTick_Resp(30);
+  Passed &= (NumTimeouts == 3) && (TimeoutLog[0] == 1) &&
+      (TimeoutLog[1] == 2) && (TimeoutLog[2] == 0);
+  // a run out timer can't be started again without a new time
+  Passed &= (ES_Timer_StartTimer(1) == ES_Timer_ERR);
+
+  // timer 3 has 8 ticks left: stop it, wait, and it resumes with 8
+  ES_Timer_StopTimer(3);
+  ES_Timer_MultiTick_Resp(100);
+  Passed &= (NumTimeouts == 3);
+  ES_Timer_StartTimer(3);
+  ES_Timer_MultiTick_Resp(7);
+  Passed &= (NumTimeouts == 3);
+  ES_Timer_Tick_Resp();
+  Passed &= (NumTimeouts == 4) && (TimeoutLog[3] == 3);
+
+  // SetTimer only loads a stopped timer, and restarts a running one
+  ES_Timer_SetTimer(0, 2);
+  ES_Timer_MultiTick_Resp(5);
+  Passed &= (NumTimeouts == 4);
+  ES_Timer_StartTimer(0);
+  ES_Timer_InitTimer(1, 100);
+  ES_Timer_SetTimer(1, 1);
+  ES_Timer_Tick_Resp();
+  Passed &= (NumTimeouts == 5) && (TimeoutLog[4] == 1);
+  ES_Timer_Tick_Resp();
+  Passed &= (NumTimeouts == 6) && (TimeoutLog[5] == 0);
+  Passed &= (TMR_HeapSize == 0);
+  return Passed;
+}
+
+// checks that a week test timer ran out on the tick it was due, and starts
+// it again
+static bool CheckLongTimeout(ES_Event_t ThisEvent)
+{
+  uint8_t Num = (uint8_t)ThisEvent.EventParam;
+
+  LongOnTime &= (TMR_Now == LongDue[Num]);
+  LongCounts[Num]++;
+  ES_Timer_InitTimer(Num, LongPeriods[Num]);
+  LongDue[Num] = TMR_Now + LongPeriods[Num];
+  return true;
+}
+
+// Runs a week of ticks, wrapping the time base half way through. The ticks
+// are passed on in bunches of up to 50, as they are when the tick response
+// falls behind, but never past the next expiry, so every timeout can be
+// checked against the tick it was due on
+static bool TestWeek(void)
+{
+  bool      Passed = true;
+  uint32_t  Ticks = 0;
+  uint32_t  Seed = 12345;
+  uint32_t  Step, TicksToNext;
+  uint8_t   i;
+
+  ES_Timer_Init(ES_Timer_RATE_1mS);
+  Passed &= (ES_Timer_InitTimer(0, ES_TIMER_MAX_TIME + 1) == ES_Timer_ERR);
+  TMR_Now     = (uint32_t)(0 - WEEK_TICKS / 2);
+  LongOnTime  = true;
+  for (i = 0; i < NUM_LONG_TIMERS; i++)
+  {
+    ES_Timer_SetPostFunc(i, CheckLongTimeout);
+    ES_Timer_InitTimer(i, LongPeriods[i]);
+    LongDue[i]    = TMR_Now + LongPeriods[i];
+    LongCounts[i] = 0;
+  }
+  while (Ticks < WEEK_TICKS)
+  {
+    Seed = Seed * 1103515245UL + 12345UL;
+    Step = 1 + (Seed >> 16) % 50;
+    if (ES_Timer_GetTicksToNext(&TicksToNext) && (TicksToNext < Step))
+    {
+      Step = TicksToNext;
+    }
+    ES_Timer_MultiTick_Resp((uint16_t)Step);
+    Ticks += Step;
+  }
+  Passed &= LongOnTime;
+  for (i = 0; i < NUM_LONG_TIMERS; i++)
+  {
+    Passed &= (LongCounts[i] == WEEK_TICKS / LongPeriods[i]);
+    ES_Timer_StopTimer(i);
+  }
+  return Passed;
+}
+
+// counts the timeouts of the periodic timer, and hands them straight back
+// the way ES_Run does
+static bool CountPeriodic(ES_Event_t ThisEvent)
+{
+  PeriodicCount++;
+  ES_Timer_TimeoutHandled((uint8_t)ThisEvent.EventParam, 0);
+  return true;
+}
+
+// restarts the timer when the timeout is handled, as the services used to
+static bool RestartTimeout(ES_Event_t ThisEvent)
+{
+  RestartedCount++;
+  ES_Timer_InitTimer((uint8_t)ThisEvent.EventParam, TEST_PERIOD);
+  return true;
+}
+
+// Runs a periodic timer and a timer restarted on each timeout side by side
+// for 10000 periods, with the ticks passed on in bunches of 1 to 20 as they
+// are when the tick response is late. The periodic timer must end exactly
+// 10000 periods on; the other one falls behind by the lateness of every
+// timeout. Then checks the overrun counts.
+static bool TestPeriodic(void)
+{
+  bool      Passed = true;
+  uint32_t  Ticks = 0;
+  uint32_t  Seed = 12345;
+  uint32_t  Step, TicksToNext;
+
+  ES_Timer_Init(ES_Timer_RATE_1mS);
+  ES_Timer_SetPostFunc(0, CountPeriodic);
+  ES_Timer_SetPostFunc(1, RestartTimeout);
+  ES_Timer_InitPeriodic(0, TEST_PERIOD);
+  ES_Timer_InitTimer(1, TEST_PERIOD);
+  PeriodicCount   = 0;
+  RestartedCount  = 0;
+  while (Ticks < NUM_PERIODS * TEST_PERIOD)
+  {
+    Seed = Seed * 1103515245UL + 12345UL;
+    Step = 1 + (Seed >> 16) % 20;
+    if (Step > NUM_PERIODS * TEST_PERIOD - Ticks)
+    {
+      Step = NUM_PERIODS * TEST_PERIOD - Ticks;
+    }
+    ES_Timer_MultiTick_Resp((uint16_t)Step);
+    Ticks += Step;
+  }
+  // the periodic timer is due again in exactly one period
+  ES_Timer_StopTimer(1);
+  Passed &= ES_Timer_GetTicksToNext(&TicksToNext) &&
+      (TicksToNext == TEST_PERIOD);
+  Passed &= (PeriodicCount == NUM_PERIODS);
+  Passed &= (ES_Timer_GetOverruns(0) == 0);
+  DB_printf("%d periods: periodic timer drift %d ticks, restarted timer %d "
+      "timeouts, drift %d ticks\r\n", NUM_PERIODS,
+      TEST_PERIOD - TicksToNext, RestartedCount,
+      NUM_PERIODS * TEST_PERIOD - RestartedCount * TEST_PERIOD -
+      (TEST_PERIOD - TMR_Remaining[1]));
+
+  // a service that doesn't handle its timeouts gets one, and an overrun for
+  // each that came after it
+  ES_Timer_SetPostFunc(0, LogTimeout);
+  NumTimeouts = 0;
+  ES_Timer_InitPeriodic(0, 10);
+  ES_Timer_MultiTick_Resp(50);
+  Passed &= (NumTimeouts == 1) && (ES_Timer_GetOverruns(0) == 4);
+  Passed &= (ES_Timer_GetOverruns(0) == 0);
+  ES_Timer_TimeoutHandled(0, 0);
+  ES_Timer_MultiTick_Resp(10);
+  Passed &= (NumTimeouts == 2) && (ES_Timer_GetOverruns(0) == 0);
+  ES_Timer_StopTimer(0);
+  return Passed;
+}
+
+#ifndef __XC32
+uint8_t ES_TakeTimeoutTarget(void)
+{
+  uint8_t Target = TestTarget;
+
+  TestTarget = ES_NO_SERVICE;
+  return Target;
+}
+
+// logs the timeout as taken by the queue of service 3
+static bool PostToService3(ES_Event_t ThisEvent)
+{
+  if (TestTarget == ES_NO_SERVICE)
+  {
+    TestTarget = 3;
+  }
+  return LogTimeout(ThisEvent);
+}
+
+// A periodic timer's timeout goes to service 3. An ES_TIMEOUT with the same
+// number dispatched to service 5 must not count as handled, so the timer
+// still holds back its next timeouts; the real one dispatched to service 3
+// lets them through again
+static bool TestOwner(void)
+{
+  bool Passed = true;
+
+  ES_Timer_Init(ES_Timer_RATE_1mS);
+  ES_Timer_SetPostFunc(0, PostToService3);
+  NumTimeouts = 0;
+  ES_Timer_InitPeriodic(0, 10);
+  ES_Timer_MultiTick_Resp(10);
+  Passed &= (NumTimeouts == 1);
+  ES_Timer_TimeoutHandled(0, 5);
+  ES_Timer_MultiTick_Resp(10);
+  Passed &= (NumTimeouts == 1) && (ES_Timer_GetOverruns(0) == 1);
+  ES_Timer_TimeoutHandled(0, 3);
+  ES_Timer_MultiTick_Resp(10);
+  Passed &= (NumTimeouts == 2) && (ES_Timer_GetOverruns(0) == 0);
+  ES_Timer_StopTimer(0);
+  return Passed;
+}
+#endif
+
+static bool LogEvent(ES_Event_t ThisEvent)
+{
+  LastEvent = ThisEvent;
+  return true;
+}
+
+static void CountCallback(ES_EventParam_t Param)
+{
+  CallbackCount++;
+  CallbackParam = Param;
+}
+
+// Hands out a handle that posts its own event and one with a callback, runs
+// them, then hands out every free timer and gives them all back
+static bool TestHandles(void)
+{
+  bool              Passed = true;
+  ES_TimerHandle_t  EventHandle, CallbackHandle, Handle;
+  ES_TimerHandle_t  Taken[ES_NUM_TIMERS];
+  uint16_t          NumTaken = 0;
+  uint16_t          i;
+
+  ES_Timer_Init(ES_Timer_RATE_1mS);
+  Passed &= (ES_Timer_Alloc(TIMER_UNUSED, ES_NEW_KEY, 0) ==
+      ES_TIMER_NO_HANDLE);
+  Passed &= (ES_Timer_AllocCallback(NULL, 0) == ES_TIMER_NO_HANDLE);
+
+  // handed out from the top, never 255
+  EventHandle     = ES_Timer_Alloc(LogEvent, ES_NEW_KEY, 'k');
+  CallbackHandle  = ES_Timer_AllocCallback(CountCallback, 77);
+  Passed &= (EventHandle == 254) && (CallbackHandle == 253);
+
+  LastEvent.EventType = ES_NO_EVENT;
+  CallbackCount       = 0;
+  ES_Timer_InitTimer(EventHandle, 5);
+  ES_Timer_InitPeriodic(CallbackHandle, 3);
+  ES_Timer_MultiTick_Resp(4);
+  Passed &= (LastEvent.EventType == ES_NO_EVENT) && (CallbackCount == 1);
+  ES_Timer_MultiTick_Resp(2);
+  Passed &= (LastEvent.EventType == ES_NEW_KEY) &&
+      (LastEvent.EventParam == 'k');
+  Passed &= (CallbackCount == 2) && (CallbackParam == 77);
+  Passed &= (ES_Timer_GetOverruns(CallbackHandle) == 0);
+
+  // a freed handle stops, can't be started and is handed out again
+  ES_Timer_Free(CallbackHandle);
+  ES_Timer_MultiTick_Resp(10);
+  Passed &= (CallbackCount == 2);
+  Passed &= (ES_Timer_InitTimer(CallbackHandle, 5) == ES_Timer_ERR);
+  Passed &= (ES_Timer_AllocCallback(CountCallback, 0) == CallbackHandle);
+  ES_Timer_Free(CallbackHandle);
+  ES_Timer_Free(EventHandle);
+
+  // every free timer can be handed out once, and only once
+  while ((Handle = ES_Timer_Alloc(LogEvent, ES_NEW_KEY, 0)) !=
+      ES_TIMER_NO_HANDLE)
+  {
+    for (i = 0; i < NumTaken; i++)
+    {
+      Passed &= (Taken[i] != Handle);
+    }
+    Taken[NumTaken++] = Handle;
+    Passed &= (NumTaken < ES_NUM_TIMERS);
+  }
+  // the timers with services in ES_Configure.h are not in the pool
+  Passed &= (NumTaken > 200) && (NumTaken < 255);
+  for (i = 0; i < NumTaken; i++)
+  {
+    ES_Timer_Free(Taken[i]);
+  }
+  return Passed;
+}
+
+// one tick the way ES_Timer_Tick_Resp used to do it, decrementing every
+// active timer
+static void ScanTick(uint16_t NumTimers)
+{
+  uint16_t i;
+
+  for (i = 0; i < NumTimers; i++)
+  {
+    if (ScanActive[i] && (--ScanCounts[i] == 0))
+    {
+      ScanCounts[i] = BENCH_PERIOD(i);  // stands in for the post & re-arm
+    }
+  }
+}
+
+static void Benchmark(uint16_t NumTimers)
+{
+  uint32_t  Start, HeapTicks, ScanTicks, CatchUpTicks;
+  uint32_t  i;
+  uint16_t  j;
+
+  ES_Timer_Init(ES_Timer_RATE_1mS);
+  for (j = 0; j < NumTimers; j++)
+  {
+    ES_Timer_SetPostFunc(j, RearmTimeout);
+    ES_Timer_InitTimer(j, BENCH_PERIOD(j));
+    ScanCounts[j] = BENCH_PERIOD(j);
+    ScanActive[j] = true;
+  }
+
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_BENCH_TICKS; i++)
+  {
+    ES_Timer_Tick_Resp();
+  }
+  HeapTicks = _HW_GetCoreTicks() - Start;
+
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_BENCH_TICKS; i++)
+  {
+    ScanTick(NumTimers);
+  }
+  ScanTicks = _HW_GetCoreTicks() - Start;
+
+  Start = _HW_GetCoreTicks();
+  for (i = 0; i < NUM_BENCH_TICKS; i += NUM_MISSED)
+  {
+    ES_Timer_MultiTick_Resp(NUM_MISSED);
+  }
+  CatchUpTicks = _HW_GetCoreTicks() - Start;
+
+  // the scan has to make a pass for every missed tick, so it costs the same
+  DB_printf("%d timers, core ticks per 100 ticks: heap %d, scan %d, "
+      "heap catching up %d at a time %d\r\n", NumTimers,
+      (uint32_t)((uint64_t)HeapTicks * 100 / NUM_BENCH_TICKS),
+      (uint32_t)((uint64_t)ScanTicks * 100 / NUM_BENCH_TICKS), NUM_MISSED,
+      (uint32_t)((uint64_t)CatchUpTicks * 100 / NUM_BENCH_TICKS));
+  for (j = 0; j < NumTimers; j++)
+  {
+    ES_Timer_StopTimer(j);
+    ScanActive[j] = false;
+  }
+}
+
+#endif
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
-
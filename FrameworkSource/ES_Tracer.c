@@ -0,0 +1,165 @@
+/****************************************************************************
+ Module
+     ES_Tracer.c
+ Description
+     Keeps the last ES_TRACE_RING_SIZE framework happenings in a RAM ring of
+     fixed size binary records: every post (with the service or checker
+     that made it), every run function call and return, every timer running
+     out and every event checker that found an event, each stamped with the
+     core timer.
+ Notes
+     The records are made by the inline ES_Trace_Record, called through the
+     ES_TRACE_xxx macros in the framework. The dump is written a line at a
+     time from ES_Run's idle loop, whenever the terminal buffer has room.
+     Recording stops while the dump is in progress, so the dump is a snapshot
+     of the moment it was asked for, and starts again when it is done.
+     HostSim/ES_TraceToChrome.c turns a captured dump into a Chrome trace.
+     When ES_TRACER is not defined this module compiles to nothing.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:00 agt      ES_Trace_Reset turns interrupts off itself
+ 10/18/26 00:30 agt      started coding
+*****************************************************************************/
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+
+#ifdef ES_TRACER
+
+#include "ES_Tracer.h"
+#include "ES_General.h"
+#include "ES_CheckEvents.h"
+#include "EventCheckWrapper.h"
+#include "terminal.h"
+#include "dbprintf.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// turn the list of checkers into a string for the dump
+#define LIST_TO_STRING(...) #__VA_ARGS__
+#define EXPAND_TO_STRING(...) LIST_TO_STRING(__VA_ARGS__)
+
+// don't start a line of the dump unless the terminal buffer has this much room
+#define DUMP_LINE_ROOM 160
+
+/*---------------------------- Module Functions ---------------------------*/
+
+/*---------------------------- Module Variables ---------------------------*/
+// shared with ES_Trace_Record in ES_Tracer.h
+ES_TraceRecord_t  ES_TraceRing[ES_TRACE_RING_SIZE];
+uint32_t          ES_TraceCount;
+uint8_t           ES_TraceFrom = ES_TRACE_FROM_MAIN;
+bool              ES_TraceIsFrozen;
+
+// the next record to print and the count to stop at, header lines while
+// DumpHeader is not 0
+static uint32_t   DumpNext;
+static uint32_t   DumpEnd;
+static uint8_t    DumpHeader;
+static bool       Dumping;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   ES_Trace_Reset
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   throws away everything recorded so far
+ Notes
+
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void ES_Trace_Reset(void)
+{
+  uint32_t IntState = ES_IntsOff();
+
+  ES_TraceCount = 0;
+  ES_IntsRestore(IntState);
+}
+
+/****************************************************************************
+ Function
+   ES_Trace_StartDump
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   stops recording and starts printing the ring to the terminal, oldest
+   record first. The printing itself happens in ES_Trace_DumpStep
+ Notes
+   does nothing if a dump is already under way
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void ES_Trace_StartDump(void)
+{
+  if (Dumping)
+  {
+    return;
+  }
+  ES_TraceIsFrozen = true;
+  DumpEnd   = ES_TraceCount;
+  DumpNext  = (DumpEnd > ES_TRACE_RING_SIZE) ?
+      DumpEnd - ES_TRACE_RING_SIZE : 0;
+  DumpHeader = 2;
+  Dumping   = true;
+}
+
+/****************************************************************************
+ Function
+   ES_Trace_DumpStep
+ Parameters
+   None
+ Returns
+   nothing
+ Description
+   prints the next lines of a dump started with ES_Trace_StartDump, as long
+   as the terminal buffer has room for them, and starts recording again at
+   the end
+ Notes
+   called from the idle part of ES_Run. Each record is a line
+     T <time> <kind> <who> <from> <type> <param>
+   all in hex, with the fields of ES_TraceRecord_t. The dump ends with a
+   line that starts "Trace end"
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void ES_Trace_DumpStep(void)
+{
+  ES_TraceRecord_t *pRecord;
+
+  while (Dumping && (Terminal_GetXmitSpace() >= DUMP_LINE_ROOM))
+  {
+    if (DumpHeader == 2)
+    {
+      DB_printf("\r\nTrace: %u records, %u lost, %d core ticks per us\r\n",
+          DumpEnd - DumpNext, DumpNext, ES_CORE_TICKS_PER_US);
+      DumpHeader--;
+    }
+    else if (DumpHeader == 1)
+    {
+      DB_printf("Checkers: %s\r\n", EXPAND_TO_STRING(EVENT_CHECK_LIST));
+      DumpHeader--;
+    }
+    else if (DumpNext != DumpEnd)
+    {
+      pRecord = &ES_TraceRing[DumpNext++ & (ES_TRACE_RING_SIZE - 1)];
+      DB_printf("T %x %x %x %x %x %x\r\n", pRecord->Time, pRecord->Kind,
+          pRecord->Who, pRecord->From, pRecord->Type, pRecord->Param);
+    }
+    else
+    {
+      DB_printf("Trace end\r\n");
+      Dumping = false;
+      ES_TraceIsFrozen = false;
+    }
+  }
+}
+
+#endif /* ES_TRACER */
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
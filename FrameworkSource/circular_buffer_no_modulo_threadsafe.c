@@ -23,7 +23,7 @@ struct circular_buf_t {
 circular_buf_t frameworkCircularBuffers[MAX_CIRC_BUFFERS];
 uint8_t numBuffersAllocated = 0;
 
-#pragma mark - Private Functions -
+// - Private Functions -
 
 static void advance_pointer(cbuf_handle_t cbuf)
 {
@@ -53,7 +53,7 @@ static void retreat_pointer(cbuf_handle_t cbuf)
 	}
 }
 
-#pragma mark - APIs -
+// - APIs -
 
 cbuf_handle_t circular_buf_init(uint8_t* buffer, size_t size)
 {
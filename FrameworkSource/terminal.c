@@ -17,6 +17,7 @@
  -------------- ---     --------
  08/29/20 14:46 ram     first pass
  10/05/20 19:38 ram     starting work on PIC32 port
+ 10/17/26 13:05 agt     added Terminal_GetXmitSpace
  ***************************************************************************/
 
 /*----------------------------- Include Files -----------------------------*/
@@ -201,6 +202,22 @@ void Terminal_MoveBuffer2UART( void )
   }
 }
 
+/*******************************************************************************
+ * Function: Terminal_GetXmitSpace
+ * Arguments: none
+ * Returns the number of bytes that can be written before the oldest unsent
+ *         bytes start to be overwritten
+ * 
+ * Created by: agt
+ * Description: lets modules that print a lot at once hold back until the
+ *              transmit buffer has drained enough to take the next line
+ ******************************************************************************/
+uint16_t Terminal_GetXmitSpace( void )
+{
+  return (uint16_t)(circular_buf_capacity(xmitBufferHandle) -
+      circular_buf_size(xmitBufferHandle));
+}
+
 void __attribute__((noreturn)) _fassert(int nLineNumber,
                                         const char * sFileName,
                                         const char * sFailedExpression,
@@ -0,0 +1,685 @@
+/****************************************************************************
+ Module
+   ES_TraceToChrome.c
+
+ Revision
+   1.0.1
+
+ Description
+   A host tool that reads a terminal capture holding one or more dumps of
+   the framework's event trace (see ES_Tracer.c) and writes them out as a
+   Chrome trace (JSON), for chrome://tracing or ui.perfetto.dev.
+
+ Notes
+   Build and run it with
+     gcc -I HostSim -I FrameworkHeaders -I ProjectHeaders
+         HostSim/ES_TraceToChrome.c -o tracetochrome
+     ./tracetochrome [-c FrameworkHeaders/ES_Configure.h] < capture.txt
+         > trace.json
+   With -c the services and events are named from the SERV_n_RUN
+   definitions and the ES_EventType_t enum, otherwise they are numbered.
+
+   Each service gets a track with a slice for every run function call. The
+   timers, the event checkers, the ISR mailboxes and the main loop get
+   tracks of their own. Each post is a short slice on the track of whoever
+   made it, with an arrow to the run function call that it led to. That
+   call is found by keeping a copy of each service's queue and taking the
+   first waiting event of the same type and param, which is exact unless
+   the dump starts with events already waiting. The wait from post to call
+   is in the args of the call, and the worst and mean wait for each service
+   are printed to stderr at the end.
+
+   Each dump in the capture is a process of its own in the trace. Lines
+   that are not part of a dump are ignored.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 00:30 agt     started coding
+*****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "ES_Tracer.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define MAX_LINE 1024
+#define MAX_NAME 48
+#define MAX_SERVICES 64
+#define MAX_CHECKERS 64
+#define MAX_EVENT_NAMES 256
+
+// the events waiting in our copy of each service's queue
+#define MAX_WAITING 64
+
+// the tracks that are not services
+#define TID_CHECKERS 100
+#define TID_TIMERS 200
+#define TID_ISR 300
+#define TID_MAIN 301
+
+// how long a post slice is drawn, in us
+#define POST_SLICE_US 0.05
+
+typedef struct
+{
+  uint16_t  Type;
+  uint32_t  Param;
+  uint32_t  FlowId;
+  double    PostTime;
+}Waiting_t;
+
+typedef struct
+{
+  Waiting_t Queue[MAX_WAITING];
+  uint8_t   NumWaiting;
+  Waiting_t Continuation;
+  bool      HasContinuation;
+  bool      IsRunning;
+  // post to call waits
+  uint32_t  NumWaits;
+  double    TotalWait;
+  double    MaxWait;
+}ServiceState_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+static void ReadConfigure(const char *pFileName);
+static void ReadCheckers(const char *pList);
+static void StartDump(void);
+static void EndDump(void);
+static void DoRecord(uint32_t Ticks, uint8_t Kind, uint8_t Who, uint8_t From,
+    uint16_t Type, uint32_t Param);
+static void DoPost(double Now, uint8_t Kind, uint8_t Who, uint8_t From,
+    uint16_t Type, uint32_t Param);
+static void DoRunStart(double Now, uint8_t Who, uint16_t Type,
+    uint32_t Param);
+static bool TakeWaiting(ServiceState_t *pService, uint16_t Type,
+    uint32_t Param, Waiting_t *pFound);
+static int FromToTid(uint8_t From);
+static void NameTrack(int Tid, const char *pName);
+static const char *ServiceName(uint8_t Which);
+static const char *EventName(uint16_t Which);
+static void StartEvent(void);
+
+/*---------------------------- Module Variables ---------------------------*/
+static char ServiceNames[MAX_SERVICES][MAX_NAME];
+static char CheckerNames[MAX_CHECKERS][MAX_NAME];
+static char EventNames[MAX_EVENT_NAMES][MAX_NAME];
+static uint16_t NumEventNames;
+
+static ServiceState_t Services[MAX_SERVICES];
+
+// the dump being read: its process id, the core ticks per us, and the time
+// of its first record unwrapped to 64 bits
+static int      Pid;
+static bool     InDump;
+static uint32_t TicksPerUs;
+static bool     HaveFirst;
+static uint32_t LastTicks;
+static uint64_t Elapsed;
+static bool     TrackNamed[TID_MAIN + 1];
+
+static uint32_t NextFlowId = 1;
+static bool     FirstEvent = true;
+
+/*------------------------------ Module Code ------------------------------*/
+int main(int argc, char *argv[])
+{
+  char      Line[MAX_LINE];
+  char      *pStart;
+  unsigned  Ticks, Kind, Who, From, Type, Param;
+  unsigned  NumRecords, NumLost, NewTicksPerUs;
+  uint8_t   i;
+
+  if ((argc == 3) && (strcmp(argv[1], "-c") == 0))
+  {
+    ReadConfigure(argv[2]);
+  }
+  else if (argc != 1)
+  {
+    fprintf(stderr, "usage: %s [-c ES_Configure.h] < capture > trace.json\n",
+        argv[0]);
+    return 1;
+  }
+
+  printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  while (fgets(Line, sizeof(Line), stdin) != NULL)
+  {
+    // the terminal may leave stray characters in front of a line
+    if ((pStart = strstr(Line, "Trace: ")) != NULL)
+    {
+      if (sscanf(pStart, "Trace: %u records, %u lost, %u core ticks per us",
+          &NumRecords, &NumLost, &NewTicksPerUs) == 3)
+      {
+        EndDump();
+        TicksPerUs = (NewTicksPerUs != 0) ? NewTicksPerUs : 1;
+        StartDump();
+      }
+    }
+    else if (!InDump)
+    {
+      continue;
+    }
+    else if ((pStart = strstr(Line, "Checkers: ")) != NULL)
+    {
+      ReadCheckers(pStart + strlen("Checkers: "));
+    }
+    else if (strstr(Line, "Trace end") != NULL)
+    {
+      EndDump();
+    }
+    else if (sscanf(Line, "T %x %x %x %x %x %x", &Ticks, &Kind, &Who, &From,
+        &Type, &Param) == 6)
+    {
+      DoRecord(Ticks, Kind, Who, From, Type, Param);
+    }
+  }
+  EndDump();
+  printf("\n]}\n");
+
+  for (i = 0; i < MAX_SERVICES; i++)
+  {
+    if (Services[i].NumWaits != 0)
+    {
+      fprintf(stderr, "%-28s %6u calls, wait mean %9.2f us, max %9.2f us\n",
+          ServiceName(i), Services[i].NumWaits,
+          Services[i].TotalWait / Services[i].NumWaits, Services[i].MaxWait);
+    }
+  }
+  return 0;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+/****************************************************************************
+ Function
+   ReadConfigure
+ Parameters
+   const char * : the path to ES_Configure.h
+ Returns
+   nothing
+ Description
+   picks up the names of the run functions from the SERV_n_RUN definitions
+   and the names of the event types from the ES_EventType_t enum
+ Notes
+   only enough of C is understood for the file as the framework lays it out
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void ReadConfigure(const char *pFileName)
+{
+  FILE      *pFile;
+  char      Line[MAX_LINE];
+  char      Name[MAX_NAME];
+  char      *pComment;
+  char      *pToken;
+  unsigned  Which;
+  unsigned  Value;
+  bool      InEnum = false;
+
+  pFile = fopen(pFileName, "r");
+  if (pFile == NULL)
+  {
+    perror(pFileName);
+    exit(1);
+  }
+  while (fgets(Line, sizeof(Line), pFile) != NULL)
+  {
+    // the comments in the enum are all on one line
+    if ((pComment = strstr(Line, "/*")) != NULL)
+    {
+      *pComment = '\0';
+    }
+    if ((pComment = strstr(Line, "//")) != NULL)
+    {
+      *pComment = '\0';
+    }
+    if (sscanf(Line, " #define SERV_%u_RUN %47s", &Which, Name) == 2)
+    {
+      if (Which < MAX_SERVICES)
+      {
+        strcpy(ServiceNames[Which], Name);
+      }
+    }
+    else if (strstr(Line, "typedef enum") != NULL)
+    {
+      InEnum = true;
+      NumEventNames = 0;
+    }
+    else if (InEnum)
+    {
+      if (strstr(Line, "ES_EventType_t") != NULL)
+      {
+        break;
+      }
+      for (pToken = strtok(Line, ",}= \t\r\n"); pToken != NULL;
+           pToken = strtok(NULL, ",}= \t\r\n"))
+      {
+        if ((isalpha((unsigned char)*pToken) || (*pToken == '_')) &&
+            (NumEventNames < MAX_EVENT_NAMES))
+        {
+          snprintf(EventNames[NumEventNames++], MAX_NAME, "%s", pToken);
+        }
+        else if (isdigit((unsigned char)*pToken) && (NumEventNames != 0))
+        {
+          // an explicit value for the name before it
+          Value = strtoul(pToken, NULL, 0);
+          if ((Value >= NumEventNames) && (Value < MAX_EVENT_NAMES))
+          {
+            strcpy(EventNames[Value], EventNames[NumEventNames - 1]);
+            EventNames[NumEventNames - 1][0] = '\0';
+            NumEventNames = Value + 1;
+          }
+        }
+      }
+    }
+  }
+  fclose(pFile);
+}
+
+// takes the names from the "Checkers: " line of a dump
+static void ReadCheckers(const char *pList)
+{
+  char  List[MAX_LINE];
+  char  *pToken;
+  uint8_t NumCheckers = 0;
+
+  snprintf(List, sizeof(List), "%s", pList);
+  for (pToken = strtok(List, ", \t\r\n"); (pToken != NULL) &&
+       (NumCheckers < MAX_CHECKERS); pToken = strtok(NULL, ", \t\r\n"))
+  {
+    snprintf(CheckerNames[NumCheckers++], MAX_NAME, "%s", pToken);
+  }
+}
+
+// gets ready for the records of a new dump
+static void StartDump(void)
+{
+  Pid++;
+  InDump    = true;
+  HaveFirst = false;
+  Elapsed   = 0;
+  memset(Services, 0, sizeof(Services));
+  memset(TrackNamed, 0, sizeof(TrackNamed));
+  StartEvent();
+  printf("{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,"
+      "\"args\":{\"name\":\"ES dump %d\"}}", Pid, Pid);
+}
+
+// closes the run function calls still open at the end of a dump
+static void EndDump(void)
+{
+  uint8_t i;
+  double  Now = (double)Elapsed / TicksPerUs;
+
+  if (!InDump)
+  {
+    return;
+  }
+  for (i = 0; i < MAX_SERVICES; i++)
+  {
+    if (Services[i].IsRunning)
+    {
+      StartEvent();
+      printf("{\"ph\":\"E\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}", Pid, i + 1,
+          Now);
+    }
+  }
+  InDump = false;
+}
+
+/****************************************************************************
+ Function
+   DoRecord
+ Parameters
+   the fields of a trace record
+ Returns
+   nothing
+ Description
+   writes out the trace events for one record of the dump
+ Notes
+   the core timer wraps every 3.5 minutes at 20MHz, so the time is kept as
+   the ticks since the first record of the dump
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void DoRecord(uint32_t Ticks, uint8_t Kind, uint8_t Who, uint8_t From,
+    uint16_t Type, uint32_t Param)
+{
+  double Now;
+
+  if (HaveFirst)
+  {
+    Elapsed += (uint32_t)(Ticks - LastTicks);
+  }
+  HaveFirst = true;
+  LastTicks = Ticks;
+  Now = (double)Elapsed / TicksPerUs;
+
+  switch (Kind)
+  {
+    case ES_TRACE_POST:
+    case ES_TRACE_POST_LIFO:
+    case ES_TRACE_POST_DROP:
+    case ES_TRACE_COALESCED:
+    case ES_TRACE_REFUSED:
+    case ES_TRACE_CONTINUE:
+    {
+      if (Who < MAX_SERVICES)
+      {
+        DoPost(Now, Kind, Who, From, Type, Param);
+      }
+    }
+    break;
+    case ES_TRACE_RUN_START:
+    {
+      if (Who < MAX_SERVICES)
+      {
+        DoRunStart(Now, Who, Type, Param);
+      }
+    }
+    break;
+    case ES_TRACE_RUN_END:
+    {
+      if ((Who < MAX_SERVICES) && Services[Who].IsRunning)
+      {
+        Services[Who].IsRunning = false;
+        StartEvent();
+        printf("{\"ph\":\"E\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}", Pid,
+            Who + 1, Now);
+      }
+    }
+    break;
+    case ES_TRACE_TIMEOUT:
+    {
+      NameTrack(TID_TIMERS, "Timers");
+      StartEvent();
+      printf("{\"ph\":\"X\",\"name\":\"timer %u: %s\",\"pid\":%d,\"tid\":%d,"
+          "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"param\":%u}}", Who,
+          EventName(Type), Pid, TID_TIMERS, Now, POST_SLICE_US, Param);
+    }
+    break;
+    case ES_TRACE_CHECKER:
+    {
+      FromToTid(ES_TRACE_FROM_CHECKER + Who);   // names the track
+      StartEvent();
+      printf("{\"ph\":\"i\",\"s\":\"t\",\"name\":\"found event\",\"pid\":%d,"
+          "\"tid\":%d,\"ts\":%.3f}", Pid, TID_CHECKERS + Who, Now);
+    }
+    break;
+    default:
+    break;
+  }
+}
+
+/****************************************************************************
+ Function
+   DoPost
+ Parameters
+   double : the time of the post in us
+   the fields of the trace record
+ Returns
+   nothing
+ Description
+   draws the post on the track of whoever made it and keeps our copy of the
+   target's queue up to date, starting an arrow for a post that will lead
+   to a call
+ Notes
+
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void DoPost(double Now, uint8_t Kind, uint8_t Who, uint8_t From,
+    uint16_t Type, uint32_t Param)
+{
+  static const char *const KindNames[] = {
+    "post", "post LIFO", "post, oldest dropped", "coalesced", "refused",
+    "continue"
+  };
+  ServiceState_t  *pService = &Services[Who];
+  Waiting_t       NewWaiting;
+  int             Tid = FromToTid(From);
+
+  NewWaiting.Type     = Type;
+  NewWaiting.Param    = Param;
+  NewWaiting.PostTime = Now;
+  NewWaiting.FlowId   = 0;
+
+  switch (Kind)
+  {
+    case ES_TRACE_POST_DROP:
+    {
+      if (pService->NumWaiting != 0)
+      {
+        pService->NumWaiting--;
+        memmove(&pService->Queue[0], &pService->Queue[1],
+            pService->NumWaiting * sizeof(Waiting_t));
+      }
+    }
+    /* fall through */
+    case ES_TRACE_POST:
+    case ES_TRACE_POST_LIFO:
+    {
+      NewWaiting.FlowId = NextFlowId++;
+      if (pService->NumWaiting == MAX_WAITING)
+      {
+        // forget the oldest, it must have been left over from before
+        pService->NumWaiting--;
+        memmove(&pService->Queue[0], &pService->Queue[1],
+            pService->NumWaiting * sizeof(Waiting_t));
+      }
+      if (Kind == ES_TRACE_POST_LIFO)
+      {
+        memmove(&pService->Queue[1], &pService->Queue[0],
+            pService->NumWaiting * sizeof(Waiting_t));
+        pService->Queue[0] = NewWaiting;
+      }
+      else
+      {
+        pService->Queue[pService->NumWaiting] = NewWaiting;
+      }
+      pService->NumWaiting++;
+    }
+    break;
+    case ES_TRACE_CONTINUE:
+    {
+      NewWaiting.FlowId         = NextFlowId++;
+      pService->Continuation    = NewWaiting;
+      pService->HasContinuation = true;
+    }
+    break;
+    default:  // coalesced or refused, nothing new will be dispatched
+    break;
+  }
+
+  StartEvent();
+  printf("{\"ph\":\"X\",\"name\":\"%s %s to %s\",\"pid\":%d,\"tid\":%d,"
+      "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"param\":%u}}", KindNames[Kind],
+      EventName(Type), ServiceName(Who), Pid, Tid, Now, POST_SLICE_US, Param);
+  if (NewWaiting.FlowId != 0)
+  {
+    StartEvent();
+    printf("{\"ph\":\"s\",\"name\":\"post\",\"cat\":\"post\",\"id\":%u,"
+        "\"pid\":%d,\"tid\":%d,\"ts\":%.3f}", NewWaiting.FlowId, Pid, Tid,
+        Now);
+  }
+}
+
+/****************************************************************************
+ Function
+   DoRunStart
+ Parameters
+   double : the time of the call in us
+   uint8_t : the service
+   uint16_t, uint32_t : the event it was handed
+ Returns
+   nothing
+ Description
+   opens a slice for the call and ends the arrow from the post that it came
+   from, if we saw that post
+ Notes
+
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void DoRunStart(double Now, uint8_t Who, uint16_t Type, uint32_t Param)
+{
+  ServiceState_t  *pService = &Services[Who];
+  Waiting_t       Found;
+  bool            IsFound;
+  double          Wait = 0;
+
+  NameTrack(Who + 1, ServiceName(Who));
+  IsFound = TakeWaiting(pService, Type, Param, &Found);
+  if (IsFound)
+  {
+    Wait = Now - Found.PostTime;
+    pService->NumWaits++;
+    pService->TotalWait += Wait;
+    if (Wait > pService->MaxWait)
+    {
+      pService->MaxWait = Wait;
+    }
+  }
+  pService->IsRunning = true;
+  StartEvent();
+  printf("{\"ph\":\"B\",\"name\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,"
+      "\"args\":{\"param\":%u", EventName(Type), Pid, Who + 1, Now, Param);
+  if (IsFound)
+  {
+    printf(",\"wait_us\":%.3f}}", Wait);
+    StartEvent();
+    printf("{\"ph\":\"f\",\"bp\":\"e\",\"name\":\"post\",\"cat\":\"post\","
+        "\"id\":%u,\"pid\":%d,\"tid\":%d,\"ts\":%.3f}", Found.FlowId, Pid,
+        Who + 1, Now);
+  }
+  else
+  {
+    printf("}}");
+  }
+}
+
+// takes the first waiting event that matches out of our copy of the queue,
+// or failing that the continuation, which ES_Run only hands out last
+static bool TakeWaiting(ServiceState_t *pService, uint16_t Type,
+    uint32_t Param, Waiting_t *pFound)
+{
+  uint8_t i;
+
+  for (i = 0; i < pService->NumWaiting; i++)
+  {
+    if ((pService->Queue[i].Type == Type) &&
+        (pService->Queue[i].Param == Param))
+    {
+      *pFound = pService->Queue[i];
+      pService->NumWaiting--;
+      memmove(&pService->Queue[i], &pService->Queue[i + 1],
+          (pService->NumWaiting - i) * sizeof(Waiting_t));
+      return true;
+    }
+  }
+  if (pService->HasContinuation && (pService->Continuation.Type == Type) &&
+      (pService->Continuation.Param == Param))
+  {
+    *pFound = pService->Continuation;
+    pService->HasContinuation = false;
+    return true;
+  }
+  return false;
+}
+
+// the track for whatever made a record, named the first time it is used
+static int FromToTid(uint8_t From)
+{
+  char Name[MAX_NAME + 16];
+  int  Tid;
+
+  if (From < ES_TRACE_FROM_CHECKER)
+  {
+    Tid = From + 1;
+    NameTrack(Tid, ServiceName(From));
+  }
+  else if (From < ES_TRACE_FROM_TIMER)
+  {
+    Tid = TID_CHECKERS + From - ES_TRACE_FROM_CHECKER;
+    if (CheckerNames[From - ES_TRACE_FROM_CHECKER][0] != '\0')
+    {
+      NameTrack(Tid, CheckerNames[From - ES_TRACE_FROM_CHECKER]);
+    }
+    else
+    {
+      snprintf(Name, sizeof(Name), "checker %d", From - ES_TRACE_FROM_CHECKER);
+      NameTrack(Tid, Name);
+    }
+  }
+  else if (From < ES_TRACE_FROM_ISR)
+  {
+    Tid = TID_TIMERS;
+    NameTrack(Tid, "Timers");
+  }
+  else if (From == ES_TRACE_FROM_ISR)
+  {
+    Tid = TID_ISR;
+    NameTrack(Tid, "ISR mailboxes");
+  }
+  else
+  {
+    Tid = TID_MAIN;
+    NameTrack(Tid, "main loop");
+  }
+  return Tid;
+}
+
+// writes the metadata that names a track, once per dump
+static void NameTrack(int Tid, const char *pName)
+{
+  if (TrackNamed[Tid])
+  {
+    return;
+  }
+  TrackNamed[Tid] = true;
+  StartEvent();
+  printf("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,"
+      "\"args\":{\"name\":\"%s\"}}", Pid, Tid, pName);
+  StartEvent();
+  printf("{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":%d,"
+      "\"tid\":%d,\"args\":{\"sort_index\":%d}}", Pid, Tid, Tid);
+}
+
+static const char *ServiceName(uint8_t Which)
+{
+  static char Name[MAX_NAME];
+
+  if ((Which < MAX_SERVICES) && (ServiceNames[Which][0] != '\0'))
+  {
+    return ServiceNames[Which];
+  }
+  snprintf(Name, sizeof(Name), "service %u", Which);
+  return Name;
+}
+
+static const char *EventName(uint16_t Which)
+{
+  static char Name[MAX_NAME];
+
+  if ((Which < NumEventNames) && (EventNames[Which][0] != '\0'))
+  {
+    return EventNames[Which];
+  }
+  snprintf(Name, sizeof(Name), "event %u", Which);
+  return Name;
+}
+
+// puts the comma between the entries of traceEvents
+static void StartEvent(void)
+{
+  printf(FirstEvent ? "\n" : ",\n");
+  FirstEvent = false;
+}
+
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
@@ -0,0 +1,191 @@
+/****************************************************************************
+ Module
+   FontTableGen.c
+
+ Revision
+   1.0.2
+
+ Description
+   A host tool that writes ProjectSource/FontTables.c: FontLines, every row
+   of every character of font4x6 unpacked, so that getFontLine is a table
+   read, and MessageBitmaps, each message of LED_MESSAGE_LIST rendered to
+   the pixel columns that DM_RenderMessage would make, so that the preset
+   messages need no font work on the PIC at all.
+
+ Notes
+   The build-pre step of the project Makefile keeps the tables up to date
+   with make -C HostSim fonts, when the PC has gcc. By hand it is
+     gcc -I HostSim -I FrameworkHeaders -I ProjectHeaders
+         HostSim/FontTableGen.c ProjectSource/FontStuff.c -o fonttablegen
+     ./fonttablegen > ProjectSource/FontTables.c
+   With -b it writes nothing and instead times DecodeFontLine, the way
+   getFontLine used to work, against reading FontLines, for the 6 rows of a
+   character as DM_AddChar2DisplayBuffer draws it, and for rendering the
+   character to columns as DM_RenderMessage does. It prints the characters
+   per second of each.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:40 agt     built by the fonts target of HostSim/Makefile
+ 10/18/26 04:10 agt     started coding
+*****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ES_Configure.h"
+#include "ES_General.h"
+#include "ES_Events.h"
+#include "FontStuff.h"
+#include "DM_Display.h"
+#include "LEDDisplayService.h"
+
+// the characters rendered for each timing
+#define BENCH_CHARS 20000000UL
+
+// a row of a character, as it is looked up
+typedef uint8_t FontLineFunc_t(unsigned char data, int line_num);
+
+static const char *Messages[] = {
+#define LED_MESSAGE(Text) Text,
+  LED_MESSAGE_LIST
+#undef LED_MESSAGE
+};
+
+static uint8_t Lines[FONT_NUM_CHARS][FONT_NUM_ROWS];
+
+static uint8_t readLine(unsigned char data, int line_num) {
+  return Lines[(uint8_t) (data - FONT_FIRST_CHAR)][line_num];
+}
+
+// the columns of one character, packed as DM_RenderMessage packs them
+static void renderChar(FontLineFunc_t *pGetLine, unsigned char Char,
+    uint8_t *pColumns) {
+  memset(pColumns, 0, DM_COLUMNS_PER_CHAR);
+  for (int WhichRow = 0; WhichRow < FONT_NUM_ROWS; WhichRow++) {
+    uint8_t FontLine = pGetLine(Char, WhichRow);
+    for (int WhichColumn = 0; WhichColumn < DM_COLUMNS_PER_CHAR;
+        WhichColumn++) {
+      if (FontLine & (0x08 >> WhichColumn)) {
+        pColumns[WhichColumn] |= 1 << WhichRow;
+      }
+    }
+  }
+}
+
+// characters per second drawn with pGetLine, rendered to columns as well
+// if IsRendering
+static double timeChars(FontLineFunc_t *pGetLine, bool IsRendering) {
+  struct timespec Start, End;
+  uint8_t Columns[DM_COLUMNS_PER_CHAR];
+  volatile uint8_t Sink = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+  for (unsigned long i = 0; i < BENCH_CHARS; i++) {
+    unsigned char Char = FONT_FIRST_CHAR + i % FONT_NUM_CHARS;
+    if (IsRendering) {
+      renderChar(pGetLine, Char, Columns);
+      Sink ^= Columns[i % DM_COLUMNS_PER_CHAR];
+    } else {
+      for (int WhichRow = 0; WhichRow < FONT_NUM_ROWS; WhichRow++) {
+        Sink ^= pGetLine(Char, WhichRow);
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &End);
+  return BENCH_CHARS / ((End.tv_sec - Start.tv_sec) +
+      (End.tv_nsec - Start.tv_nsec) / 1e9);
+}
+
+// a character as a C comment, with the ones that would end it left out
+static void printCharComment(unsigned char Char) {
+  if ((Char == '*') || (Char == '/') || (Char == 127)) {
+    printf("/* 0x%02x */", Char);
+  } else {
+    printf("/* '%c' */", Char);
+  }
+}
+
+static void writeTables(void) {
+  uint8_t Columns[DM_COLUMNS_PER_CHAR];
+
+  printf("/* ProjectSource/FontTables.c, made by HostSim/FontTableGen.c from\n"
+      "   font4x6 and LED_MESSAGE_LIST. Do not edit, see the notes of\n"
+      "   FontTableGen.c to rebuild it. */\n"
+      "#include <stdint.h>\n"
+      "#include \"ES_Configure.h\"\n"
+      "#include \"ES_Events.h\"\n"
+      "#include \"FontStuff.h\"\n"
+      "#include \"LEDDisplayService.h\"\n\n");
+
+  printf("const uint8_t FontLines[FONT_NUM_CHARS][FONT_NUM_ROWS] = {\n");
+  for (int Char = 0; Char < FONT_NUM_CHARS; Char++) {
+    printf("  {");
+    for (int WhichRow = 0; WhichRow < FONT_NUM_ROWS; WhichRow++) {
+      printf("0x%02x%s", Lines[Char][WhichRow],
+          (WhichRow < FONT_NUM_ROWS - 1) ? ", " : "");
+    }
+    printf("}%s ", (Char < FONT_NUM_CHARS - 1) ? "," : " ");
+    printCharComment(FONT_FIRST_CHAR + Char);
+    printf("\n");
+  }
+  printf("};\n");
+
+  for (size_t Msg = 0; Msg < ARRAY_SIZE(Messages); Msg++) {
+    const char *pChar = Messages[Msg];
+    printf("\n// \"%s\"\nstatic const uint8_t Message%u[] = {", Messages[Msg],
+        (unsigned) Msg);
+    for (int i = 0; pChar[i] != '\0'; i++) {
+      renderChar(readLine, pChar[i], Columns);
+      printf("\n  ");
+      for (int WhichColumn = 0; WhichColumn < DM_COLUMNS_PER_CHAR;
+          WhichColumn++) {
+        printf("0x%02x,%s", Columns[WhichColumn],
+            (WhichColumn < DM_COLUMNS_PER_CHAR - 1) ? " " : "");
+      }
+      printf(" ");
+      printCharComment(pChar[i]);
+    }
+    printf("\n};\n");
+  }
+
+  printf("\nconst LED_MessageBitmap_t MessageBitmaps[] = {\n");
+  for (size_t Msg = 0; Msg < ARRAY_SIZE(Messages); Msg++) {
+    printf("  {Message%u, sizeof(Message%u)},\n", (unsigned) Msg,
+        (unsigned) Msg);
+  }
+  printf("};\n");
+}
+
+int main(int argc, char *argv[]) {
+  for (int Char = 0; Char < FONT_NUM_CHARS; Char++) {
+    for (int WhichRow = 0; WhichRow < FONT_NUM_ROWS; WhichRow++) {
+      Lines[Char][WhichRow] = DecodeFontLine(FONT_FIRST_CHAR + Char,
+          WhichRow);
+    }
+  }
+  for (size_t Msg = 0; Msg < ARRAY_SIZE(Messages); Msg++) {
+    for (const char *pChar = Messages[Msg]; *pChar != '\0'; pChar++) {
+      if ((uint8_t) (*pChar - FONT_FIRST_CHAR) >= FONT_NUM_CHARS) {
+        fprintf(stderr, "message %u: 0x%02x is not in the font\n",
+            (unsigned) Msg, (uint8_t) *pChar);
+        return 1;
+      }
+    }
+  }
+
+  if ((argc > 1) && (0 == strcmp(argv[1], "-b"))) {
+    for (int IsRendering = 0; IsRendering <= 1; IsRendering++) {
+      double Decoded = timeChars(DecodeFontLine, IsRendering);
+      double Table = timeChars(readLine, IsRendering);
+      printf("%s\n", IsRendering ? "rendered to columns:" : "rows looked up:");
+      printf("  decoding font4x6:  %.0f characters/s\n", Decoded);
+      printf("  reading FontLines: %.0f characters/s, %.1f times as many\n",
+          Table, Table / Decoded);
+    }
+  } else {
+    writeTables();
+  }
+  return 0;
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ Module
+     NoTimerPosts.h
+
+ Description
+     Included ahead of ES_Timers.c (gcc -include) to build the timer module
+     on its own, for tests that give the timers their post functions with
+     ES_Timer_SetPostFunc. Every TIMERn_RESP_FUNC of ES_Configure.h is
+     turned into TIMER_UNUSED, so the services' post functions are not
+     needed to link.
+
+ Notes
+     ES_Configure.h is included here first, so its include guard keeps the
+     timer module from defining the post functions again
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 07:00 agt      started coding
+*****************************************************************************/
+#ifndef PIC32SIM_NOTIMERPOSTS_H
+#define PIC32SIM_NOTIMERPOSTS_H
+
+#include "ES_Configure.h"
+
+#undef TIMER0_RESP_FUNC
+#define TIMER0_RESP_FUNC TIMER_UNUSED
+#undef TIMER1_RESP_FUNC
+#define TIMER1_RESP_FUNC TIMER_UNUSED
+#undef TIMER2_RESP_FUNC
+#define TIMER2_RESP_FUNC TIMER_UNUSED
+#undef TIMER3_RESP_FUNC
+#define TIMER3_RESP_FUNC TIMER_UNUSED
+#undef TIMER4_RESP_FUNC
+#define TIMER4_RESP_FUNC TIMER_UNUSED
+#undef TIMER5_RESP_FUNC
+#define TIMER5_RESP_FUNC TIMER_UNUSED
+#undef TIMER6_RESP_FUNC
+#define TIMER6_RESP_FUNC TIMER_UNUSED
+#undef TIMER7_RESP_FUNC
+#define TIMER7_RESP_FUNC TIMER_UNUSED
+#undef TIMER8_RESP_FUNC
+#define TIMER8_RESP_FUNC TIMER_UNUSED
+#undef TIMER9_RESP_FUNC
+#define TIMER9_RESP_FUNC TIMER_UNUSED
+#undef TIMER10_RESP_FUNC
+#define TIMER10_RESP_FUNC TIMER_UNUSED
+#undef TIMER11_RESP_FUNC
+#define TIMER11_RESP_FUNC TIMER_UNUSED
+#undef TIMER12_RESP_FUNC
+#define TIMER12_RESP_FUNC TIMER_UNUSED
+#undef TIMER13_RESP_FUNC
+#define TIMER13_RESP_FUNC TIMER_UNUSED
+#undef TIMER14_RESP_FUNC
+#define TIMER14_RESP_FUNC TIMER_UNUSED
+#undef TIMER15_RESP_FUNC
+#define TIMER15_RESP_FUNC TIMER_UNUSED
+#undef TIMER16_RESP_FUNC
+#undef TIMER17_RESP_FUNC
+#undef TIMER18_RESP_FUNC
+#undef TIMER19_RESP_FUNC
+#undef TIMER20_RESP_FUNC
+#undef TIMER21_RESP_FUNC
+#undef TIMER22_RESP_FUNC
+#undef TIMER23_RESP_FUNC
+#undef TIMER24_RESP_FUNC
+#undef TIMER25_RESP_FUNC
+#undef TIMER26_RESP_FUNC
+#undef TIMER27_RESP_FUNC
+#undef TIMER28_RESP_FUNC
+#undef TIMER29_RESP_FUNC
+#undef TIMER30_RESP_FUNC
+#undef TIMER31_RESP_FUNC
+
+#endif /* PIC32SIM_NOTIMERPOSTS_H */
@@ -0,0 +1,1897 @@
+//#define TEST
+/****************************************************************************
+ Module
+   PIC32Sim.c
+
+ Revision
+   1.0.2
+
+ Description
+   A host model of the PIC32MX170 registers and peripherals that this
+   project uses, so that the HAL modules and services compile unchanged for
+   a Linux build and can be checked there. It models the port pins, the SPI
+   shift register and SS line, the UART TX and RX FIFOs, the output compare
+   PWM outputs and the ADC scan buffers, and keeps a time stamped log of
+   every register write.
+
+ Notes
+   The registers are the slots of PIC32Sim_SFR (see xc.h), which the code
+   reads and writes as plain memory. The model polls for writes: it keeps a
+   shadow of every register, and a register that no longer matches its
+   shadow, or an alias that is not 0, has been written since the last poll.
+   The CLR, SET and INV aliases are then folded into the register, the
+   peripheral models are run and the write is logged, with the time of the
+   poll. Writes to one register between two polls are folded in the order
+   REG, CLR, SET, INV, and writes to different registers in slot order.
+   Every access to a hooked register polls, then brings that register up
+   to date, e.g. the UART FIFO is moved on to the current time, so that a
+   polling loop sees it change. Each of the functions below polls first.
+   The slots are laid out with assembler directives for ELF objects, which
+   any GCC or Clang build on Linux or a BSD makes.
+
+   Time comes from the core timer count. By default that is the monotonic
+   clock of the host scaled to 20MHz; a test can set its own clock with
+   PIC32Sim_SetClock. PBCLK is 20MHz, the same as the core timer, so
+   peripheral times in PBCLK counts are also core timer counts.
+
+   SPI frames take no host time. Frames written with the enhanced buffer
+   on are sent with SS held low until the code next looks at IFS0 or
+   SPIxSTAT, which is when SS rises, as the buffer would have emptied by
+   then on the PIC32. With the standard buffer every frame has its own SS
+   pulse. As the HAL sets up INT4 (SPI1) or INT1 (SPI2) to catch the rise of
+   SS in leader mode, the rise sets that flag in IFS0.
+   The enhanced buffer holds 128 bits of frames; one written to a full
+   buffer is lost, and counted as an overrun. Code that reads SPIxSTAT with
+   SPITBF set finds room for a frame, as the next one has gone out, with
+   the burst still going. While the SPI TX interrupt is
+   enabled in IEC1 the code is taken to be keeping the buffer fed, so the
+   burst goes on: each time interrupts are taken, the buffer has drained
+   to half full and the TX flag is set in IFS1, as with STXISEL = 0b10.
+
+   The UART sends a byte every 10 bit times, so code that waits for space
+   in the FIFO needs a clock that moves.
+
+   Interrupts are not taken on their own; flags are set in IFS0 for the
+   code to poll. An ISR attached with PIC32Sim_AttachISR is called by
+   PIC32Sim_TakeInterrupts while its flag in IFS0 is set and enabled in
+   IEC0, or in IFS1 and IEC1, which the host port does each time it
+   processes pending interrupts.
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:10 agt     polls for writes against a shadow of the registers
+                        in place of the page and single step traps, which
+                        only ran on x86-64 Linux and were slow
+ 10/18/26 04:50 agt     the SPI enhanced buffer has its depth, and is fed
+                        from the SPI TX interrupts, from IFS1
+ 10/18/26 02:10 agt     ISRs can be attached, and are taken when asked
+ 10/17/26 23:55 agt     started coding
+*****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define PIC32SIM_MODEL      // the model uses the hooked registers in place
+#include "PIC32Sim.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// entries in the write log and the capture buffers, all powers of 2
+#define LOG_LEN 4096
+#define SPI_CAPTURE_LEN 1024
+#define UART_CAPTURE_LEN 4096
+
+// depth of the UART TX and RX FIFOs of the PIC32MX170
+#define UART_FIFO_LEN 8
+
+#define NUM_SPI 2
+// bits in the SPI enhanced TX buffer, 8 frames of 16 bits
+#define SPI_FIFO_BITS 128
+#define NUM_PORTS 2
+#define NUM_OC 5
+#define NUM_ISRS 8
+
+#define CORE_TICKS_PER_US 20
+
+// the offsets of the registers of a port from its ANSEL slot
+#define PORT_ANSEL 0
+#define PORT_TRIS 1
+#define PORT_PORT 2
+#define PORT_LAT 3
+#define PORT_CNPU 5
+#define PORT_CNPD 6
+
+// the read only bits of U1STA: URXDA, FERR, PERR, RIDLE, TRMT & UTXBF
+#define U1STA_READ_ONLY 0x0000031DUL
+// the bits of SPIxSTAT that the code can write, only SPIROV
+#define SPISTAT_WRITABLE 0x00000040UL
+// BUFS in AD1CON2 is set by the ADC only
+#define AD1CON2_BUFS 0x00000080UL
+
+// the OC modes that give a PWM output
+#define OCM_PWM 0b110
+#define OCM_PWM_FAULT 0b111
+
+#define SFR(Slot) (PIC32Sim_SFR[(Slot)])
+
+/*---------------------------- Module Types -------------------------------*/
+// the registers and the SS flag of an SPI module
+typedef struct
+{
+  uint16_t  Con;
+  uint16_t  Stat;
+  uint16_t  Brg;
+  uint16_t  Buf;
+  uint32_t  SSFlag;
+  uint32_t  TxFlag;
+} SPISlots_t;
+
+// the state of an SPI module that is not in its registers
+typedef struct
+{
+  PIC32Sim_SPIFrame_t Capture[SPI_CAPTURE_LEN];
+  uint16_t  CaptureHead;
+  uint16_t  CaptureCount;
+  uint32_t  BusCounts;
+  uint32_t  SSRises;
+  uint32_t  Overruns;
+  uint8_t   FifoCount;
+  bool      IsSSLow;
+} SPIModel_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+static void PollWrites(void);
+static void KeepShadow(void);
+static void BeforeAccess(uint16_t Slot);
+static void WriteReg(uint16_t Slot, PIC32Sim_Access_t Access, uint32_t Value);
+static void RunModels(uint16_t Slot, uint32_t OldValue);
+static void AddToLog(uint16_t Slot, PIC32Sim_Access_t Access, uint32_t Value);
+static void SetResetValues(void);
+static uint32_t WallClock(void);
+static void CheckCoreTimer(void);
+
+static void UpdatePort(uint8_t WhichPort);
+
+static void SPISend(uint8_t Module);
+static void SPIEndBurst(uint8_t Module);
+static bool IsSPIFed(uint8_t Module);
+static void SPIRaiseTxFlags(void);
+
+static uint32_t UartByteCounts(void);
+static void UartCatchUp(void);
+static void UartTx(void);
+static void UartUpdateStatus(void);
+
+static bool IsADCSampling(uint32_t Con1);
+static void ADCScan(void);
+
+/*---------------------------- Module Variables ---------------------------*/
+// the register slots. Each register, its bit fields and its aliases are
+// symbols at the words of its slot, as the XC32 linker script places them
+// on the PIC32
+#define PIC32SIM_SLOT_ASM(Name) \
+  "\t.globl " #Name ", " #Name "bits, " #Name "CLR, " #Name "SET, " \
+  #Name "INV\n" #Name ":\n" #Name "bits:\n\t.zero 4\n" \
+  #Name "CLR:\n\t.zero 4\n" #Name "SET:\n\t.zero 4\n" \
+  #Name "INV:\n\t.zero 4\n"
+
+__asm__(
+  "\t.pushsection .bss.PIC32Sim,\"aw\",%nobits\n"
+  "\t.balign 16\n"
+  "\t.globl PIC32Sim_SFR\n"
+  "PIC32Sim_SFR:\n"
+  PIC32SIM_PLAIN_REGS(PIC32SIM_SLOT_ASM)
+  PIC32SIM_HOOKED_REGS(PIC32SIM_SLOT_ASM)
+  "\t.popsection\n");
+
+int __XC_UART;
+
+static const char *const RegNames[SFR_NUM_SLOTS] = {
+#define PIC32SIM_REG_NAME(Name) [SFR_##Name] = #Name,
+  PIC32SIM_PLAIN_REGS(PIC32SIM_REG_NAME)
+  PIC32SIM_HOOKED_REGS(PIC32SIM_REG_NAME)
+#undef PIC32SIM_REG_NAME
+};
+
+// what each register held at the end of the last poll, or after the model
+// last changed it
+static uint32_t Shadow[SFR_NUM_SLOTS];
+// the writes found by a poll, by slot, and the slots that had any
+static PIC32Sim_SFR_t Written[SFR_NUM_SLOTS];
+static uint16_t WrittenSlots[SFR_NUM_SLOTS];
+
+static uint32_t (*Clock)(void) = WallClock;
+static uint32_t CoreCompare;
+static uint32_t LastCoreCheck;
+
+static PIC32Sim_LogEntry_t Log[LOG_LEN];
+static uint32_t LogTotal;
+
+static const uint16_t PortBase[NUM_PORTS] = { SFR_ANSELA, SFR_ANSELB };
+static const uint32_t PortPins[NUM_PORTS] = { 0x001FUL, 0xFFFFUL };
+// the levels put on the input pins by a test, and which pins it drives
+static uint32_t PinLevels[NUM_PORTS];
+static uint32_t PinDriven[NUM_PORTS];
+
+static const SPISlots_t SPISlots[NUM_SPI] = {
+  { SFR_SPI1CON, SFR_SPI1STAT, SFR_SPI1BRG, SFR_SPI1BUF, _IFS0_INT4IF_MASK,
+    _IFS1_SPI1TXIF_MASK },
+  { SFR_SPI2CON, SFR_SPI2STAT, SFR_SPI2BRG, SFR_SPI2BUF, _IFS0_INT1IF_MASK,
+    _IFS1_SPI2TXIF_MASK }
+};
+static SPIModel_t SPIModel[NUM_SPI];
+
+static uint8_t  TxFifo[UART_FIFO_LEN];
+static uint8_t  TxHead;
+static uint8_t  TxCount;
+// the core count when the byte at the head of the TX FIFO started out
+static uint32_t TxStart;
+static uint8_t  RxFifo[UART_FIFO_LEN];
+static uint8_t  RxHead;
+static uint8_t  RxCount;
+static uint8_t  TxCapture[UART_CAPTURE_LEN];
+static uint16_t TxCaptureHead;
+static uint16_t TxCaptureCount;
+
+static uint16_t AnalogLevels[PIC32SIM_NUM_AN];
+
+// the attached ISRs and the flags in IFS0 and IFS1 that they serve
+static void     (*ISRs[NUM_ISRS])(void);
+static uint32_t ISRFlags0[NUM_ISRS];
+static uint32_t ISRFlags1[NUM_ISRS];
+static uint8_t  NumISRs;
+
+// the prescales selected by TCKPS on Timer2 to Timer5
+static const uint16_t TimerPrescale[] = { 1, 2, 4, 8, 16, 32, 64, 256 };
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+   PowerOnReset
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   sets the registers to their reset values, before main runs
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void __attribute__((constructor)) PowerOnReset(void)
+{
+  PIC32Sim_Reset();
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_Reset
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   puts every register back to its reset value, empties the FIFOs and
+   capture buffers and clears the log
+ Notes
+   the input pins and analog levels set by a test are let go as well
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_Reset(void)
+{
+  memset(PinLevels, 0, sizeof(PinLevels));
+  memset(PinDriven, 0, sizeof(PinDriven));
+  memset(SPIModel, 0, sizeof(SPIModel));
+  memset(AnalogLevels, 0, sizeof(AnalogLevels));
+  TxHead = TxCount = RxHead = RxCount = 0;
+  TxCaptureHead = TxCaptureCount = 0;
+  SetResetValues();
+  LastCoreCheck = Clock();
+  CoreCompare   = LastCoreCheck - 1;
+  LogTotal      = 0;
+  KeepShadow();
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SetClock
+ Parameters
+   uint32_t (*NewClock)(void) : returns the core timer count, NULL for the
+     wall clock
+ Returns
+   nothing
+ Description
+   sets where the model gets the time from
+ Notes
+   a test that moves its own clock gets the same log and UART timing on
+   every run
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_SetClock(uint32_t (*NewClock)(void))
+{
+  Clock = (NewClock != NULL) ? NewClock : WallClock;
+  LastCoreCheck = Clock();
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_RegName
+ Parameters
+   uint16_t Slot : a PIC32Sim_Slot_t
+ Returns
+   const char * : the name of the register, as in xc.h
+ Description
+   for printing the log
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+const char *PIC32Sim_RegName(uint16_t Slot)
+{
+  if ((Slot < SFR_NUM_SLOTS) && (RegNames[Slot] != NULL))
+  {
+    return RegNames[Slot];
+  }
+  return "?";
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_GetCoreCount
+ Parameters
+   none
+ Returns
+   uint32_t : the core timer count
+ Description
+   _CP0_GET_COUNT on a host
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint32_t PIC32Sim_GetCoreCount(void)
+{
+  return Clock();
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SetCoreCompare / PIC32Sim_GetCoreCompare
+ Parameters
+   uint32_t NewCompare : the core count to set CTIF at
+ Returns
+   uint32_t : the compare (Get)
+ Description
+   _CP0_SET_COMPARE and _CP0_GET_COMPARE on a host
+ Notes
+   CTIF is set when a read of IFS0 finds that the count has passed the
+   compare since the last read
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_SetCoreCompare(uint32_t NewCompare)
+{
+  CoreCompare = NewCompare;
+}
+
+uint32_t PIC32Sim_GetCoreCompare(void)
+{
+  return CoreCompare;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_Access
+ Parameters
+   uint16_t Slot : a hooked register, a PIC32Sim_Slot_t
+ Returns
+   volatile PIC32Sim_SFR_t * : the slot of the register
+ Description
+   the hook behind the names of the hooked registers in xc.h. Polls for
+   writes, then brings the register up to date for the access
+ Notes
+   a write through the slot is found by the next poll
+ Author
+   agt, 10/18/26
+****************************************************************************/
+volatile PIC32Sim_SFR_t *PIC32Sim_Access(uint16_t Slot)
+{
+  PollWrites();
+  BeforeAccess(Slot);
+  KeepShadow();
+  return &SFR(Slot);
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SetPin
+ Parameters
+   uint8_t WhichPort : PIC32SIM_PORT_A or PIC32SIM_PORT_B
+   uint8_t WhichPin : 0 to 15
+   bool Level : the level to put on the pin
+ Returns
+   nothing
+ Description
+   drives an input pin from outside, as a button or sensor would
+ Notes
+   the level only shows in PORTx while the pin is a digital input
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_SetPin(uint8_t WhichPort, uint8_t WhichPin, bool Level)
+{
+  if ((WhichPort >= NUM_PORTS) || (WhichPin > 15))
+  {
+    return;
+  }
+  PollWrites();
+  PinDriven[WhichPort] |= (1UL << WhichPin);
+  if (Level)
+  {
+    PinLevels[WhichPort] |= (1UL << WhichPin);
+  }
+  else
+  {
+    PinLevels[WhichPort] &= ~(1UL << WhichPin);
+  }
+  UpdatePort(WhichPort);
+  KeepShadow();
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_ReleasePin
+ Parameters
+   uint8_t WhichPort : PIC32SIM_PORT_A or PIC32SIM_PORT_B
+   uint8_t WhichPin : 0 to 15
+ Returns
+   nothing
+ Description
+   stops driving an input pin, so that it reads as its pull up or pull
+   down leaves it, or as 0 with neither
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_ReleasePin(uint8_t WhichPort, uint8_t WhichPin)
+{
+  if ((WhichPort >= NUM_PORTS) || (WhichPin > 15))
+  {
+    return;
+  }
+  PollWrites();
+  PinDriven[WhichPort] &= ~(1UL << WhichPin);
+  UpdatePort(WhichPort);
+  KeepShadow();
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_GetOutput
+ Parameters
+   uint8_t WhichPort : PIC32SIM_PORT_A or PIC32SIM_PORT_B
+   uint8_t WhichPin : 0 to 15
+ Returns
+   bool : true if the pin is an output and driven high
+ Description
+   what an LED on the pin would show
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool PIC32Sim_GetOutput(uint8_t WhichPort, uint8_t WhichPin)
+{
+  uint16_t Base;
+
+  if ((WhichPort >= NUM_PORTS) || (WhichPin > 15))
+  {
+    return false;
+  }
+  PollWrites();
+  Base = PortBase[WhichPort];
+  return ((SFR(Base + PORT_LAT).Reg & ~SFR(Base + PORT_TRIS).Reg &
+         (1UL << WhichPin)) != 0);
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SPIRead
+ Parameters
+   uint8_t WhichModule : 0 for SPI1, 1 for SPI2
+   PIC32Sim_SPIFrame_t *pFrames : where to put the frames
+   uint16_t MaxFrames : room at pFrames
+ Returns
+   uint16_t : the number of frames taken
+ Description
+   takes the frames that the module has sent, oldest first
+ Notes
+   ends any burst that is still going, as the code has stopped writing
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint16_t PIC32Sim_SPIRead(uint8_t WhichModule, PIC32Sim_SPIFrame_t *pFrames,
+    uint16_t MaxFrames)
+{
+  SPIModel_t  *pModel;
+  uint16_t    NumTaken = 0;
+
+  if (WhichModule >= NUM_SPI)
+  {
+    return 0;
+  }
+  pModel = &SPIModel[WhichModule];
+  PollWrites();
+  SPIEndBurst(WhichModule);
+  KeepShadow();
+  while ((pModel->CaptureCount > 0) && (NumTaken < MaxFrames))
+  {
+    uint16_t Oldest = (pModel->CaptureHead - pModel->CaptureCount) &
+        (SPI_CAPTURE_LEN - 1);
+
+    pFrames[NumTaken++] = pModel->Capture[Oldest];
+    pModel->CaptureCount--;
+  }
+  return NumTaken;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SPIGetBusCounts
+ Parameters
+   uint8_t WhichModule : 0 for SPI1, 1 for SPI2
+ Returns
+   uint32_t : PBCLK counts that the module has spent shifting frames out
+ Description
+   the time that the transfers would have taken on the PIC32, at the bit
+   rate set in SPIxBRG
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint32_t PIC32Sim_SPIGetBusCounts(uint8_t WhichModule)
+{
+  PollWrites();
+  return (WhichModule < NUM_SPI) ? SPIModel[WhichModule].BusCounts : 0;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SPIGetSSRises
+ Parameters
+   uint8_t WhichModule : 0 for SPI1, 1 for SPI2
+ Returns
+   uint32_t : the number of times that SS has risen since the reset
+ Description
+   one rise per burst of frames, e.g. per row latched into the MAX7219s
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint32_t PIC32Sim_SPIGetSSRises(uint8_t WhichModule)
+{
+  PollWrites();
+  return (WhichModule < NUM_SPI) ? SPIModel[WhichModule].SSRises : 0;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SPIGetOverruns
+ Parameters
+   uint8_t WhichModule : 0 for SPI1, 1 for SPI2
+ Returns
+   uint32_t : the frames written while the enhanced buffer was full
+ Description
+   those frames were lost, so a code that keeps up has none
+ Notes
+
+ Author
+   agt, 10/18/26
+****************************************************************************/
+uint32_t PIC32Sim_SPIGetOverruns(uint8_t WhichModule)
+{
+  PollWrites();
+  return (WhichModule < NUM_SPI) ? SPIModel[WhichModule].Overruns : 0;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_AttachISR
+ Parameters
+   uint32_t IFS0Mask : the flags in IFS0 that the ISR serves
+   uint32_t IFS1Mask : the flags in IFS1 that the ISR serves
+   void (*pISR)(void) : the ISR
+ Returns
+   bool : false if there is no room for another ISR
+ Description
+   has PIC32Sim_TakeInterrupts call the ISR, as the PIC32 would take the
+   interrupt, while one of the flags is set in IFS0 or IFS1 and enabled in
+   IEC0 or IEC1
+ Notes
+   the enable bits in IECx are at the same places as the flags in IFSx
+ Author
+   agt, 10/18/26
+****************************************************************************/
+bool PIC32Sim_AttachISR(uint32_t IFS0Mask, uint32_t IFS1Mask,
+    void (*pISR)(void))
+{
+  if (NumISRs == NUM_ISRS)
+  {
+    return false;
+  }
+  ISRFlags0[NumISRs] = IFS0Mask;
+  ISRFlags1[NumISRs] = IFS1Mask;
+  ISRs[NumISRs++]    = pISR;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_TakeInterrupts
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   calls the attached ISRs whose interrupts are pending, until none is.
+   An ISR that starts an SPI burst is called again when the burst ends,
+   and one that feeds the buffer each time it has drained to half full
+ Notes
+   the ISRs run in the order that they were attached rather than by
+   priority, and only when this is called, not in the middle of the code
+ Author
+   agt, 10/18/26
+****************************************************************************/
+void PIC32Sim_TakeInterrupts(void)
+{
+  uint32_t  Pending;
+  uint8_t   Which;
+  bool      IsTaken;
+
+  do
+  {
+    IsTaken = false;
+    for (Which = 0; Which < NumISRs; Which++)
+    {
+      PollWrites();
+      SPIRaiseTxFlags();
+      BeforeAccess(SFR_IFS0);  // ends the SPI bursts, as a read would
+      Pending = (SFR(SFR_IFS0).Reg & SFR(SFR_IEC0).Reg & ISRFlags0[Which]) |
+          (SFR(SFR_IFS1).Reg & SFR(SFR_IEC1).Reg & ISRFlags1[Which]);
+      KeepShadow();
+      if (Pending != 0)
+      {
+        ISRs[Which]();
+        IsTaken = true;
+      }
+    }
+  } while (IsTaken);
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_UartTxRead
+ Parameters
+   uint8_t *pBytes : where to put the bytes
+   uint16_t MaxBytes : room at pBytes
+ Returns
+   uint16_t : the number of bytes taken
+ Description
+   takes the bytes that have gone out of U1TX, oldest first
+ Notes
+   bytes still in the TX FIFO at the current time are not included
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint16_t PIC32Sim_UartTxRead(uint8_t *pBytes, uint16_t MaxBytes)
+{
+  uint16_t NumTaken = 0;
+
+  PollWrites();
+  UartCatchUp();
+  KeepShadow();
+  while ((TxCaptureCount > 0) && (NumTaken < MaxBytes))
+  {
+    pBytes[NumTaken++] = TxCapture[(TxCaptureHead - TxCaptureCount) &
+        (UART_CAPTURE_LEN - 1)];
+    TxCaptureCount--;
+  }
+  return NumTaken;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_UartRx
+ Parameters
+   uint8_t NewByte : the byte that came in on U1RX
+ Returns
+   bool : false if the receiver is off or the RX FIFO overran
+ Description
+   puts a byte in the RX FIFO, as if it had been typed at the terminal
+ Notes
+   an overrun sets OERR, as on the PIC32
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool PIC32Sim_UartRx(uint8_t NewByte)
+{
+  bool ReturnVal = false;
+
+  PollWrites();
+  if (U1MODEbits.ON && U1STAbits.URXEN)
+  {
+    if (RxCount < UART_FIFO_LEN)
+    {
+      RxFifo[(RxHead + RxCount) % UART_FIFO_LEN] = NewByte;
+      RxCount++;
+      ReturnVal = true;
+    }
+    else
+    {
+      U1STAbits.OERR = 1;
+    }
+  }
+  UartUpdateStatus();
+  KeepShadow();
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_SetAnalog
+ Parameters
+   uint8_t Channel : AN0 to AN12
+   uint16_t NewValue : the 10 bit result that the channel converts to
+ Returns
+   nothing
+ Description
+   sets the voltage on an analog input. If the ADC is sampling, a scan is
+   done straight away, so the next read of the results sees it
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_SetAnalog(uint8_t Channel, uint16_t NewValue)
+{
+  if (Channel >= PIC32SIM_NUM_AN)
+  {
+    return;
+  }
+  PollWrites();
+  AnalogLevels[Channel] = NewValue & 0x3FF;
+  if (IsADCSampling(AD1CON1))
+  {
+    ADCScan();
+  }
+  KeepShadow();
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_GetPWM
+ Parameters
+   uint8_t Channel : OC1 to OC5, as 1 to 5
+   PIC32Sim_PWM_t *pPWM : where to put the waveform
+ Returns
+   bool : false for a channel that does not exist
+ Description
+   works out the period and high time of an output compare channel from
+   its mode, its duty register and the timer that it is on
+ Notes
+   uses OCxRS, the duty that the next period will have
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool PIC32Sim_GetPWM(uint8_t Channel, PIC32Sim_PWM_t *pPWM)
+{
+  volatile __OC1CONbits_t *pOCCon;
+  volatile __T2CONbits_t  *pTCon;
+  uint16_t  TimerBase;
+  uint32_t  Prescale;
+  uint32_t  Period;
+  uint32_t  High;
+
+  if ((Channel < 1) || (Channel > NUM_OC))
+  {
+    return false;
+  }
+  PollWrites();
+  pOCCon = (volatile __OC1CONbits_t *)&SFR(SFR_OC1CON +
+      3 * (Channel - 1)).Reg;
+  // Timer2 or Timer3, each a TxCON, TMRx, PRx trio from T1CON
+  TimerBase = SFR_T1CON + 3 * (pOCCon->OCTSEL ? 2 : 1);
+  pTCon = (volatile __T2CONbits_t *)&SFR(TimerBase).Reg;
+
+  Prescale  = TimerPrescale[pTCon->TCKPS];
+  Period    = SFR(TimerBase + 2).Reg + 1;
+  High      = SFR(SFR_OC1RS + 3 * (Channel - 1)).Reg;
+  if (High > Period)
+  {
+    High = Period; // stays high all through the period
+  }
+  pPWM->IsOn = pOCCon->ON && pTCon->ON &&
+      ((pOCCon->OCM == OCM_PWM) || (pOCCon->OCM == OCM_PWM_FAULT));
+  pPWM->PeriodCounts  = Period * Prescale;
+  pPWM->HighCounts    = High * Prescale;
+  return true;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_GetLogCount
+ Parameters
+   none
+ Returns
+   uint32_t : the number of writes in the log
+ Description
+   the log keeps the last LOG_LEN writes
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+uint32_t PIC32Sim_GetLogCount(void)
+{
+  PollWrites();
+  return (LogTotal < LOG_LEN) ? LogTotal : LOG_LEN;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_GetLogEntry
+ Parameters
+   uint32_t Index : 0 for the oldest write in the log
+   PIC32Sim_LogEntry_t *pEntry : where to put it
+ Returns
+   bool : false if there is no such entry
+ Description
+   reads back one write from the log
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+bool PIC32Sim_GetLogEntry(uint32_t Index, PIC32Sim_LogEntry_t *pEntry)
+{
+  uint32_t NumKept = PIC32Sim_GetLogCount();
+
+  if (Index >= NumKept)
+  {
+    return false;
+  }
+  *pEntry = Log[(LogTotal - NumKept + Index) & (LOG_LEN - 1)];
+  return true;
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_DumpLog
+ Parameters
+   FILE *pOut : where to print
+ Returns
+   nothing
+ Description
+   prints the log, one write to a line: the core count, the register, the
+   kind of write, the value and what the register held after it
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_DumpLog(FILE *pOut)
+{
+  static const char *const AccessNames[] = { "", "CLR", "SET", "INV" };
+  PIC32Sim_LogEntry_t Entry;
+  uint32_t Index;
+
+  for (Index = 0; PIC32Sim_GetLogEntry(Index, &Entry); Index++)
+  {
+    char Name[24];
+
+    snprintf(Name, sizeof(Name), "%s%s", PIC32Sim_RegName(Entry.Slot),
+        AccessNames[Entry.Access]);
+    fprintf(pOut, "%10u %-12s 0x%08X -> 0x%08X\n", Entry.Time, Name,
+        Entry.Value, Entry.Result);
+  }
+  if (LogTotal > LOG_LEN)
+  {
+    fprintf(pOut, "(%u older writes dropped)\n", LogTotal - LOG_LEN);
+  }
+}
+
+/****************************************************************************
+ Function
+   PIC32Sim_ClearLog
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   empties the log, e.g. once a module has been set up
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+void PIC32Sim_ClearLog(void)
+{
+  PollWrites();
+  LogTotal = 0;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+/****************************************************************************
+ Function
+   PollWrites
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   finds the registers that the code has written since the last poll, and
+   hands each write to WriteReg
+ Notes
+   every slot is put back as it was before any write is applied, so that a
+   change that the model makes to another register is not taken for a write
+   by the code
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void PollWrites(void)
+{
+  uint16_t NumWritten = 0;
+  uint16_t Slot;
+  uint16_t Index;
+
+  for (Slot = 0; Slot < SFR_NUM_SLOTS; Slot++)
+  {
+    volatile PIC32Sim_SFR_t *pSlot = &SFR(Slot);
+
+    if ((pSlot->Reg != Shadow[Slot]) ||
+        ((pSlot->Clr | pSlot->Set | pSlot->Inv) != 0))
+    {
+      Written[Slot] = *pSlot;
+      WrittenSlots[NumWritten++] = Slot;
+      pSlot->Reg = Shadow[Slot];
+      pSlot->Clr = pSlot->Set = pSlot->Inv = 0;
+    }
+  }
+  if (NumWritten == 0)
+  {
+    return;
+  }
+  for (Index = 0; Index < NumWritten; Index++)
+  {
+    const PIC32Sim_SFR_t *pWritten = &Written[WrittenSlots[Index]];
+
+    Slot = WrittenSlots[Index];
+    if (pWritten->Reg != Shadow[Slot])
+    {
+      WriteReg(Slot, PIC32SIM_REG_WRITE, pWritten->Reg);
+    }
+    if (pWritten->Clr != 0)
+    {
+      WriteReg(Slot, PIC32SIM_CLR_WRITE, pWritten->Clr);
+    }
+    if (pWritten->Set != 0)
+    {
+      WriteReg(Slot, PIC32SIM_SET_WRITE, pWritten->Set);
+    }
+    if (pWritten->Inv != 0)
+    {
+      WriteReg(Slot, PIC32SIM_INV_WRITE, pWritten->Inv);
+    }
+  }
+  KeepShadow();
+}
+
+/****************************************************************************
+ Function
+   KeepShadow
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   notes what every register holds once the model has changed it, so that
+   the next poll only finds what the code writes
+ Notes
+
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void KeepShadow(void)
+{
+  uint16_t Slot;
+
+  for (Slot = 0; Slot < SFR_NUM_SLOTS; Slot++)
+  {
+    Shadow[Slot] = SFR(Slot).Reg;
+  }
+}
+
+/****************************************************************************
+ Function
+   BeforeAccess
+ Parameters
+   uint16_t Slot : the hooked register being accessed
+ Returns
+   nothing
+ Description
+   brings a hooked register up to date before the code sees it
+ Notes
+   a read of U1RXREG takes the byte out of the RX FIFO. SPIxBUF and
+   U1TXREG are set to PIC32SIM_UNWRITTEN, so that the next poll finds a
+   write of any other value, even one the same as the last
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void BeforeAccess(uint16_t Slot)
+{
+  uint8_t Module;
+
+  switch (Slot)
+  {
+    case SFR_IFS0:
+      CheckCoreTimer();
+      for (Module = 0; Module < NUM_SPI; Module++)
+      {
+        if (!IsSPIFed(Module))
+        {
+          SPIEndBurst(Module);
+        }
+      }
+      break;
+    case SFR_SPI1STAT:
+    case SFR_SPI2STAT:
+      Module = (Slot == SFR_SPI1STAT) ? 0 : 1;
+      if (((volatile __SPI1STATbits_t *)&SFR(SPISlots[Module].Stat).Reg)
+          ->SPITBF)
+      {
+        // waiting for room, which a frame later there is
+        SPIModel[Module].FifoCount--;
+        ((volatile __SPI1STATbits_t *)&SFR(SPISlots[Module].Stat).Reg)
+          ->SPITBF = 0;
+      }
+      else if (!IsSPIFed(Module))
+      {
+        SPIEndBurst(Module);
+      }
+      break;
+    case SFR_SPI1BUF:
+    case SFR_SPI2BUF:
+      Module = (Slot == SFR_SPI1BUF) ? 0 : 1;
+      ((volatile __SPI1STATbits_t *)&SFR(SPISlots[Module].Stat).Reg)->SPIRBF
+        = 0;
+      SFR(Slot).Reg = PIC32SIM_UNWRITTEN;
+      break;
+    case SFR_U1STA:
+      UartCatchUp();
+      break;
+    case SFR_U1RXREG:
+      if (RxCount > 0)
+      {
+        U1RXREG = RxFifo[RxHead];
+        RxHead  = (RxHead + 1) % UART_FIFO_LEN;
+        RxCount--;
+        UartUpdateStatus();
+      }
+      break;
+    case SFR_U1TXREG:
+      SFR(Slot).Reg = PIC32SIM_UNWRITTEN;
+      break;
+    default:
+      break;
+  }
+}
+
+/****************************************************************************
+ Function
+   WriteReg
+ Parameters
+   uint16_t Slot : the register written
+   PIC32Sim_Access_t Access : to the register or one of its aliases
+   uint32_t Value : the value written
+ Returns
+   nothing
+ Description
+   applies a write as the PIC32 would, runs the models and logs it
+ Notes
+   a write to PORTx goes to LATx
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void WriteReg(uint16_t Slot, PIC32Sim_Access_t Access, uint32_t Value)
+{
+  volatile uint32_t *pTarget = &SFR(Slot).Reg;
+  uint32_t OldValue;
+  uint8_t  WhichPort;
+
+  for (WhichPort = 0; WhichPort < NUM_PORTS; WhichPort++)
+  {
+    if (Slot == PortBase[WhichPort] + PORT_PORT)
+    {
+      pTarget = &SFR(PortBase[WhichPort] + PORT_LAT).Reg;
+    }
+  }
+  OldValue = *pTarget;
+  switch (Access)
+  {
+    case PIC32SIM_CLR_WRITE:
+      *pTarget = OldValue & ~Value;
+      break;
+    case PIC32SIM_SET_WRITE:
+      *pTarget = OldValue | Value;
+      break;
+    case PIC32SIM_INV_WRITE:
+      *pTarget = OldValue ^ Value;
+      break;
+    default:
+      *pTarget = Value;
+      break;
+  }
+  RunModels(Slot, OldValue);
+  AddToLog(Slot, Access, Value);
+}
+
+/****************************************************************************
+ Function
+   RunModels
+ Parameters
+   uint16_t Slot : the register written
+   uint32_t OldValue : what it held before
+ Returns
+   nothing
+ Description
+   lets the peripheral that owns the register act on the write
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void RunModels(uint16_t Slot, uint32_t OldValue)
+{
+  uint8_t Index;
+
+  for (Index = 0; Index < NUM_PORTS; Index++)
+  {
+    if ((Slot >= PortBase[Index]) && (Slot <= PortBase[Index] + PORT_CNPD))
+    {
+      UpdatePort(Index);
+    }
+  }
+  for (Index = 0; Index < NUM_SPI; Index++)
+  {
+    const SPISlots_t *pSlots = &SPISlots[Index];
+
+    if (Slot == pSlots->Buf)
+    {
+      SPISend(Index);
+    }
+    else if (Slot == pSlots->Stat)
+    {
+      SFR(Slot).Reg = (SFR(Slot).Reg & SPISTAT_WRITABLE) |
+          (OldValue & ~SPISTAT_WRITABLE);
+    }
+    else if ((Slot == pSlots->Con) &&
+        !((volatile __SPI1CONbits_t *)&SFR(Slot).Reg)->ON)
+    {
+      SPIEndBurst(Index);
+    }
+  }
+  switch (Slot)
+  {
+    case SFR_U1TXREG:
+      UartTx();
+      break;
+    case SFR_U1STA:
+      U1STA = (U1STA & ~U1STA_READ_ONLY) | (OldValue & U1STA_READ_ONLY);
+      if ((OldValue & _U1STA_OERR_MASK) && !U1STAbits.OERR)
+      {
+        RxCount = 0; // clearing OERR empties the RX FIFO
+      }
+      UartUpdateStatus();
+      break;
+    case SFR_AD1CON1:
+      if (IsADCSampling(AD1CON1) && !IsADCSampling(OldValue))
+      {
+        ADCScan();
+      }
+      break;
+    case SFR_AD1CON2:
+      AD1CON2 = (AD1CON2 & ~AD1CON2_BUFS) | (OldValue & AD1CON2_BUFS);
+      break;
+    default:
+      break;
+  }
+}
+
+/****************************************************************************
+ Function
+   AddToLog
+ Parameters
+   uint16_t Slot : the register written
+   PIC32Sim_Access_t Access : to the register or one of its aliases
+   uint32_t Value : the value written
+ Returns
+   nothing
+ Description
+   adds a write to the log, over the oldest one once it is full
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void AddToLog(uint16_t Slot, PIC32Sim_Access_t Access, uint32_t Value)
+{
+  PIC32Sim_LogEntry_t *pEntry = &Log[LogTotal & (LOG_LEN - 1)];
+
+  pEntry->Time    = Clock();
+  pEntry->Slot    = Slot;
+  pEntry->Access  = Access;
+  pEntry->Value   = Value;
+  pEntry->Result  = SFR(Slot).Reg;
+  LogTotal++;
+}
+
+/****************************************************************************
+ Function
+   SetResetValues
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   the register values after a reset of the PIC32MX170, every register
+   not named here resets to 0
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void SetResetValues(void)
+{
+  memset((void *)PIC32Sim_SFR, 0, sizeof(PIC32Sim_SFR));
+  ANSELA    = 0x0003;
+  ANSELB    = 0xF00F;
+  TRISA     = 0x001F;
+  TRISB     = 0xFFFF;
+  SPI1STAT  = 0x0028; // SPITBE and SPIRBE
+  SPI2STAT  = 0x0028;
+  U1STA     = 0x0100; // TRMT
+  UpdatePort(PIC32SIM_PORT_A);
+  UpdatePort(PIC32SIM_PORT_B);
+}
+
+/****************************************************************************
+ Function
+   WallClock
+ Parameters
+   none
+ Returns
+   uint32_t : the host monotonic clock as a 20MHz count
+ Description
+   the default core timer
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static uint32_t WallClock(void)
+{
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return (uint32_t)((uint64_t)Now.tv_sec * (CORE_TICKS_PER_US * 1000000UL) +
+         (uint64_t)Now.tv_nsec / (1000 / CORE_TICKS_PER_US));
+}
+
+/****************************************************************************
+ Function
+   CheckCoreTimer
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   sets CTIF if the core count has passed the compare since the last check
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void CheckCoreTimer(void)
+{
+  uint32_t Now = Clock();
+
+  if ((CoreCompare - LastCoreCheck - 1) < (Now - LastCoreCheck))
+  {
+    IFS0 |= _IFS0_CTIF_MASK;
+  }
+  LastCoreCheck = Now;
+}
+
+/****************************************************************************
+ Function
+   UpdatePort
+ Parameters
+   uint8_t WhichPort : PIC32SIM_PORT_A or PIC32SIM_PORT_B
+ Returns
+   nothing
+ Description
+   works out PORTx from the pins: an output reads its latch, a digital
+   input reads the level on it, an analog input reads 0
+ Notes
+   an input that no test drives reads as its pull up or pull down
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void UpdatePort(uint8_t WhichPort)
+{
+  uint16_t Base = PortBase[WhichPort];
+  uint32_t Tris = SFR(Base + PORT_TRIS).Reg;
+  uint32_t Levels;
+
+  Levels = (PinDriven[WhichPort] & PinLevels[WhichPort]) |
+      (~PinDriven[WhichPort] & SFR(Base + PORT_CNPU).Reg &
+      ~SFR(Base + PORT_CNPD).Reg);
+  SFR(Base + PORT_PORT).Reg = ((SFR(Base + PORT_LAT).Reg & ~Tris) |
+      (Levels & Tris & ~SFR(Base + PORT_ANSEL).Reg)) & PortPins[WhichPort];
+}
+
+/****************************************************************************
+ Function
+   SPISend
+ Parameters
+   uint8_t Module : 0 for SPI1, 1 for SPI2
+ Returns
+   nothing
+ Description
+   shifts out the frame just written to SPIxBUF, at the width set in
+   SPIxCON, and adds its time on the bus
+ Notes
+   nothing is connected to SDI, so the frame that comes in is 0. With the
+   enhanced buffer full the frame is lost
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void SPISend(uint8_t Module)
+{
+  const SPISlots_t  *pSlots = &SPISlots[Module];
+  SPIModel_t        *pModel = &SPIModel[Module];
+  volatile __SPI1CONbits_t *pCon =
+      (volatile __SPI1CONbits_t *)&SFR(pSlots->Con).Reg;
+  volatile __SPI1STATbits_t *pStat =
+      (volatile __SPI1STATbits_t *)&SFR(pSlots->Stat).Reg;
+  uint32_t  Data = SFR(pSlots->Buf).Reg;
+  uint8_t   Width;
+
+  SFR(pSlots->Buf).Reg = 0;
+  if (!pCon->ON)
+  {
+    return;
+  }
+  Width = pCon->MODE32 ? 32 : (pCon->MODE16 ? 16 : 8);
+  if (Width < 32)
+  {
+    Data &= (1UL << Width) - 1;
+  }
+  if (pCon->ENHBUF)
+  {
+    if (pModel->FifoCount == SPI_FIFO_BITS / Width)
+    {
+      pModel->Overruns++;
+      return;
+    }
+    pModel->FifoCount++;
+    pStat->SPITBF = (pModel->FifoCount == SPI_FIFO_BITS / Width);
+  }
+
+  pModel->IsSSLow = true;
+  pModel->Capture[pModel->CaptureHead].Data   = Data;
+  pModel->Capture[pModel->CaptureHead].Burst  = pModel->SSRises;
+  pModel->CaptureHead = (pModel->CaptureHead + 1) & (SPI_CAPTURE_LEN - 1);
+  if (pModel->CaptureCount < SPI_CAPTURE_LEN)
+  {
+    pModel->CaptureCount++;
+  }
+  // a bit takes two counts of the baud rate generator
+  pModel->BusCounts += (uint32_t)Width * 2 * (SFR(pSlots->Brg).Reg + 1);
+  pStat->SPIRBF = 1;
+
+  if (!pCon->ENHBUF)
+  {
+    SPIEndBurst(Module);
+  }
+}
+
+/****************************************************************************
+ Function
+   SPIEndBurst
+ Parameters
+   uint8_t Module : 0 for SPI1, 1 for SPI2
+ Returns
+   nothing
+ Description
+   raises SS at the end of a burst of frames. In leader mode with SS on,
+   that sets the INT flag that the HAL watches SS with
+ Notes
+   the buffer has emptied by then
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void SPIEndBurst(uint8_t Module)
+{
+  SPIModel_t *pModel = &SPIModel[Module];
+  volatile __SPI1CONbits_t *pCon =
+      (volatile __SPI1CONbits_t *)&SFR(SPISlots[Module].Con).Reg;
+
+  pModel->FifoCount = 0;
+  ((volatile __SPI1STATbits_t *)&SFR(SPISlots[Module].Stat).Reg)->SPITBF = 0;
+  if (pModel->IsSSLow)
+  {
+    pModel->IsSSLow = false;
+    pModel->SSRises++;
+    if (pCon->MSTEN && pCon->MSSEN)
+    {
+      IFS0 |= SPISlots[Module].SSFlag;
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+   IsSPIFed
+ Parameters
+   uint8_t Module : 0 for SPI1, 1 for SPI2
+ Returns
+   bool : true while the TX interrupt of the module is enabled
+ Description
+   the code is then feeding the buffer from the interrupt, so it does not
+   run empty and SS stays low
+ Notes
+
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static bool IsSPIFed(uint8_t Module)
+{
+  return (SFR(SFR_IEC1).Reg & SPISlots[Module].TxFlag) != 0;
+}
+
+/****************************************************************************
+ Function
+   SPIRaiseTxFlags
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   lets the buffer of each module that is being fed drain to half full, and
+   sets its TX flag in IFS1 for the interrupt that refills it
+ Notes
+   called with the registers open
+ Author
+   agt, 10/18/26
+****************************************************************************/
+static void SPIRaiseTxFlags(void)
+{
+  uint8_t Module;
+
+  for (Module = 0; Module < NUM_SPI; Module++)
+  {
+    SPIModel_t *pModel = &SPIModel[Module];
+    volatile __SPI1CONbits_t *pCon =
+        (volatile __SPI1CONbits_t *)&SFR(SPISlots[Module].Con).Reg;
+    uint8_t Half = SPI_FIFO_BITS / 2 /
+        (pCon->MODE32 ? 32 : (pCon->MODE16 ? 16 : 8));
+
+    if (IsSPIFed(Module) && pCon->ON && pCon->ENHBUF)
+    {
+      if (pModel->FifoCount > Half)
+      {
+        pModel->FifoCount = Half;
+      }
+      ((volatile __SPI1STATbits_t *)&SFR(SPISlots[Module].Stat).Reg)->SPITBF
+        = 0;
+      SFR(SFR_IFS1).Reg |= SPISlots[Module].TxFlag;
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+   UartByteCounts
+ Parameters
+   none
+ Returns
+   uint32_t : PBCLK counts to send a byte
+ Description
+   10 bits (start, 8 data, stop) at the rate set by U1BRG and BRGH
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static uint32_t UartByteCounts(void)
+{
+  return 10UL * (U1MODEbits.BRGH ? 4 : 16) * (U1BRG + 1);
+}
+
+/****************************************************************************
+ Function
+   UartCatchUp
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   moves the bytes that have finished sending by now out of the TX FIFO
+   and into the capture buffer
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void UartCatchUp(void)
+{
+  uint32_t ByteCounts = UartByteCounts();
+  uint32_t Now = Clock();
+
+  while ((TxCount > 0) && ((Now - TxStart) >= ByteCounts))
+  {
+    TxCapture[TxCaptureHead] = TxFifo[TxHead];
+    TxCaptureHead = (TxCaptureHead + 1) & (UART_CAPTURE_LEN - 1);
+    if (TxCaptureCount < UART_CAPTURE_LEN)
+    {
+      TxCaptureCount++;
+    }
+    TxHead = (TxHead + 1) % UART_FIFO_LEN;
+    TxCount--;
+    TxStart += ByteCounts;
+  }
+  UartUpdateStatus();
+}
+
+/****************************************************************************
+ Function
+   UartTx
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   puts the byte written to U1TXREG into the TX FIFO
+ Notes
+   a byte written to a full FIFO, or with the transmitter off, is lost
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void UartTx(void)
+{
+  UartCatchUp();
+  if (U1MODEbits.ON && U1STAbits.UTXEN && (TxCount < UART_FIFO_LEN))
+  {
+    if (TxCount == 0)
+    {
+      TxStart = Clock();
+    }
+    TxFifo[(TxHead + TxCount) % UART_FIFO_LEN] = (uint8_t)U1TXREG;
+    TxCount++;
+  }
+  UartUpdateStatus();
+}
+
+/****************************************************************************
+ Function
+   UartUpdateStatus
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   sets UTXBF, TRMT and URXDA in U1STA from the FIFOs
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void UartUpdateStatus(void)
+{
+  U1STAbits.UTXBF = (TxCount == UART_FIFO_LEN);
+  U1STAbits.TRMT  = (TxCount == 0);
+  U1STAbits.URXDA = (RxCount > 0);
+}
+
+/****************************************************************************
+ Function
+   IsADCSampling
+ Parameters
+   uint32_t Con1 : a value of AD1CON1
+ Returns
+   bool : true if the ADC is on and sampling automatically
+ Description
+   the state in which the ADC scans on its own
+ Notes
+
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static bool IsADCSampling(uint32_t Con1)
+{
+  return (Con1 & (_AD1CON1_ON_MASK | _AD1CON1_ASAM_MASK)) ==
+         (_AD1CON1_ON_MASK | _AD1CON1_ASAM_MASK);
+}
+
+/****************************************************************************
+ Function
+   ADCScan
+ Parameters
+   none
+ Returns
+   nothing
+ Description
+   converts SMPI + 1 channels, from AD1CSSL when scanning or CH0SA when
+   not, into the half of the results that the ADC is filling, then swaps
+   halves and sets AD1IF
+ Notes
+   a scan takes no time, the levels come from PIC32Sim_SetAnalog
+ Author
+   agt, 10/17/26
+****************************************************************************/
+static void ADCScan(void)
+{
+  uint8_t  NumConversions = AD1CON2bits.SMPI + 1;
+  uint16_t ResultSlot = SFR_ADC1BUF0;
+  uint8_t  Channel = 0;
+  uint8_t  Index;
+
+  if (AD1CON2bits.BUFM && AD1CON2bits.BUFS)
+  {
+    ResultSlot = SFR_ADC1BUF8;
+  }
+  for (Index = 0; Index < NumConversions; Index++)
+  {
+    if (AD1CON2bits.CSCNA && ((AD1CSSL & 0x1FFFUL) != 0))
+    {
+      // the next channel in the scan list, from the one after the last
+      while (!(AD1CSSL & (1UL << Channel)))
+      {
+        Channel = (Channel + 1) % PIC32SIM_NUM_AN;
+      }
+    }
+    else
+    {
+      Channel = (AD1CHS >> 16) & 0xF;
+    }
+    SFR(ResultSlot + Index).Reg = (Channel < PIC32SIM_NUM_AN) ?
+        AnalogLevels[Channel] : 0;
+    Channel = (Channel + 1) % PIC32SIM_NUM_AN;
+  }
+  if (AD1CON2bits.BUFM)
+  {
+    AD1CON2 ^= AD1CON2_BUFS;
+  }
+  AD1CON1bits.DONE = 1;
+  IFS0 |= _IFS0_AD1IF_MASK;
+}
+
+#ifdef TEST
+/* test Harness for the model. Drives the HAL modules as the services do
+   and checks what comes out of the model. Build on a Linux host, with
+   terminal.c built without TEST as it has its own test main, e.g.
+     gcc -c -I HostSim -I FrameworkHeaders FrameworkSource/terminal.c
+     gcc -DTEST -I HostSim -I FrameworkHeaders -I ProjectHeaders
+         HostSim/PIC32Sim.c terminal.o ProjectSource/PIC32PortHAL.c
+         ProjectSource/PIC32_SPI_HAL_Starter.c ProjectSource/PWM_PIC32.c
+         ProjectSource/PIC32_AD_Lib.c FrameworkSource/dbprintf.c
+         FrameworkSource/circular_buffer_no_modulo_threadsafe.c
+*/
+// the harness is code that uses the registers, so it goes through the hooks
+#undef PIC32SIM_HOOK
+#define PIC32SIM_HOOK(Slot) (*PIC32Sim_Access(Slot))
+
+#include "PIC32PortHAL.h"
+#include "PIC32_SPI_HAL.h"
+#include "PWM_PIC32.h"
+#include "PIC32_AD_Lib.h"
+#include "terminal.h"
+#include "bitdefs.h"
+
+#define CHECK(Test) Check((Test), #Test)
+
+static uint32_t TestTime;
+static uint32_t NumChecks;
+static uint32_t NumFailed;
+static uint16_t NumFed;
+
+static uint32_t TestClock(void)
+{
+  return TestTime;
+}
+
+// the TX interrupt of SPI1, sending 20 frames in all, 4 at a time
+static void FeedSPI1(void)
+{
+  uint8_t Index;
+
+  IFS1CLR = _IFS1_SPI1TXIF_MASK;
+  for (Index = 0; (Index < 4) && (NumFed < 20); Index++)
+  {
+    SPIOperate_SPI1_Send16(0x0300 | NumFed++);
+  }
+  if (NumFed == 20)
+  {
+    IEC1CLR = _IEC1_SPI1TXIE_MASK;
+  }
+}
+
+static void Check(bool IsPassed, const char *pTest)
+{
+  NumChecks++;
+  if (!IsPassed)
+  {
+    NumFailed++;
+    printf("failed: %s\n", pTest);
+  }
+}
+
+void main(void)
+{
+  static const char Greeting[] = "PIC32Sim UART check\r\n";
+  PIC32Sim_SPIFrame_t Frames[8];
+  PIC32Sim_PWM_t      PWM;
+  uint8_t             RxBytes[sizeof(Greeting)];
+  uint32_t            Results[2];
+  uint16_t            NumTaken;
+  uint16_t            Index;
+
+  PIC32Sim_SetClock(TestClock);
+  PIC32Sim_Reset();
+
+  // ports: an LED output on RB4 and a button on RB9 with a pull up
+  PortSetup_ConfigureDigitalOutputs(_Port_B, _Pin_4);
+  LATBbits.LATB4 = 1;
+  CHECK(PIC32Sim_GetOutput(PIC32SIM_PORT_B, 4));
+  CHECK(PORTBbits.RB4 == 1);
+  LATBINV = _Pin_4;
+  CHECK(!PIC32Sim_GetOutput(PIC32SIM_PORT_B, 4));
+  PortSetup_ConfigureDigitalInputs(_Port_B, _Pin_9);
+  CHECK(PORTBbits.RB9 == 0);
+  PortSetup_ConfigurePullUps(_Port_B, _Pin_9);
+  CHECK(PORTBbits.RB9 == 1);
+  PIC32Sim_SetPin(PIC32SIM_PORT_B, 9, false);
+  CHECK(PORTBbits.RB9 == 0);
+  PIC32Sim_ReleasePin(PIC32SIM_PORT_B, 9);
+  CHECK(PORTBbits.RB9 == 1);
+
+  // SPI1 set up as the display uses it, then a row of four frames
+  SPISetup_BasicConfig(SPI_SPI1);
+  SPISetup_SetLeader(SPI_SPI1, SPI_SMP_MID);
+  SPISetup_SetBitTime(SPI_SPI1, 10000);
+  SPISetup_MapSSOutput(SPI_SPI1, SPI_RPA0);
+  SPISetup_MapSDOutput(SPI_SPI1, SPI_RPA1);
+  SPISetup_SetClockIdleState(SPI_SPI1, SPI_CLK_LO);
+  SPISetup_SetActiveEdge(SPI_SPI1, SPI_FIRST_EDGE);
+  SPISetup_SetXferWidth(SPI_SPI1, SPI_16BIT);
+  SPISetEnhancedBuffer(SPI_SPI1, true);
+  SPISetup_EnableSPI(SPI_SPI1);
+  for (Index = 0; Index < 3; Index++)
+  {
+    SPIOperate_SPI1_Send16(0x0100 | Index);
+  }
+  SPIOperate_SPI1_Send16Wait(0x0103);
+  CHECK(PIC32Sim_SPIGetSSRises(0) == 1);
+  CHECK(!SPIOperate_HasSS1_Risen());
+  NumTaken = PIC32Sim_SPIRead(0, Frames, 8);
+  CHECK(NumTaken == 4);
+  for (Index = 0; Index < NumTaken; Index++)
+  {
+    CHECK(Frames[Index].Data == (0x0100UL | Index));
+    CHECK(Frames[Index].Burst == 0);
+  }
+  CHECK(PIC32Sim_SPIGetBusCounts(0) == 4 * 16 * 2 * (SPI1BRG + 1));
+
+  // the enhanced buffer holds 8 frames, more are lost unless it is fed
+  for (Index = 0; Index < 10; Index++)
+  {
+    SPIOperate_SPI1_Send16(0x0200 | Index);
+  }
+  CHECK(PIC32Sim_SPIGetOverruns(0) == 2);
+  CHECK(PIC32Sim_SPIRead(0, Frames, 8) == 8);
+  CHECK(Frames[7].Data == 0x0207);
+  for (Index = 0; Index < 10; Index++)
+  {
+    while ((Index >= 8) && SPI1STATbits.SPITBF)
+    {
+    }
+    SPIOperate_SPI1_Send16(0x0200 | Index);
+  }
+  CHECK(PIC32Sim_SPIGetOverruns(0) == 2);
+  CHECK(PIC32Sim_SPIGetSSRises(0) == 2);
+  CHECK(PIC32Sim_SPIRead(0, Frames, 8) == 8);
+  CHECK(PIC32Sim_SPIRead(0, Frames, 8) == 2);
+  CHECK((Frames[1].Data == 0x0209) && (Frames[1].Burst == 2));
+  PIC32Sim_AttachISR(0, _IFS1_SPI1TXIF_MASK, FeedSPI1);
+  for (Index = 0; Index < 8; Index++)
+  {
+    SPIOperate_SPI1_Send16(0x0300 | Index);
+  }
+  NumFed = 8;
+  IEC1SET = _IEC1_SPI1TXIE_MASK;
+  PIC32Sim_TakeInterrupts();
+  CHECK(PIC32Sim_SPIGetOverruns(0) == 2);
+  CHECK(PIC32Sim_SPIGetSSRises(0) == 4);
+  CHECK(PIC32Sim_SPIRead(0, Frames, 8) == 8); // the first 8 of 20
+  CHECK((Frames[7].Data == 0x0307) && (Frames[7].Burst == 3));
+  CHECK(PIC32Sim_SPIRead(0, Frames, 8) == 8);
+  CHECK(PIC32Sim_SPIRead(0, Frames, 8) == 4);
+  CHECK((Frames[3].Data == 0x0313) && (Frames[3].Burst == 3));
+
+  // UART: the terminal sends 8 bytes into the FIFO, then waits for room
+  Terminal_HWInit();
+  for (Index = 0; Greeting[Index] != '\0'; Index++)
+  {
+    Terminal_WriteByte(Greeting[Index]);
+  }
+  Terminal_MoveBuffer2UART();
+  CHECK(U1STAbits.UTXBF);
+  CHECK(PIC32Sim_UartTxRead(RxBytes, sizeof(RxBytes)) == 0);
+  while (!U1STAbits.TRMT)
+  {
+    TestTime += 10 * 4 * (U1BRG + 1); // a byte time
+    Terminal_MoveBuffer2UART();
+  }
+  NumTaken = PIC32Sim_UartTxRead(RxBytes, sizeof(RxBytes));
+  CHECK(NumTaken == sizeof(Greeting) - 1);
+  CHECK(memcmp(RxBytes, Greeting, sizeof(Greeting) - 1) == 0);
+  PIC32Sim_UartRx('p');
+  CHECK(Terminal_IsRxData());
+  CHECK(Terminal_ReadByte() == 'p');
+  CHECK(!Terminal_IsRxData());
+
+  // PWM: 50Hz on Timer2 with a 25% duty on channel 1
+  PWMSetup_BasicConfig(1);
+  PWMSetup_SetFreqOnTimer(50, _Timer2_);
+  PWMSetup_AssignChannelToTimer(1, _Timer2_);
+  PWMOperate_SetDutyOnChannel(25, 1);
+  CHECK(PIC32Sim_GetPWM(1, &PWM));
+  CHECK(PWM.IsOn);
+  CHECK((PWM.PeriodCounts > 20000000UL / 51) &&
+      (PWM.PeriodCounts < 20000000UL / 49));
+  CHECK(((PWM.HighCounts * 100 + PWM.PeriodCounts / 2) / PWM.PeriodCounts)
+      == 25);
+
+  // ADC: AN5 (RB3) and AN11 (RB13)
+  PortSetup_ConfigureAnalogInputs(_Port_B, _Pin_3 | _Pin_13);
+  ADC_ConfigAutoScan(BIT5HI | BIT11HI);
+  PIC32Sim_SetAnalog(5, 123);
+  PIC32Sim_SetAnalog(11, 1000);
+  ADC_MultiRead(Results);
+  CHECK((Results[0] == 123) && (Results[1] == 1000));
+  PIC32Sim_SetAnalog(5, 456);
+  ADC_MultiRead(Results);
+  CHECK((Results[0] == 456) && (Results[1] == 1000));
+
+  printf("PIC32Sim: %u of %u checks passed, %u register writes logged\n",
+      NumChecks - NumFailed, NumChecks, PIC32Sim_GetLogCount());
+  printf("the last writes:\n");
+  PIC32Sim_ClearLog();
+  LATBSET = _Pin_4;
+  SPIOperate_SPI1_Send16Wait(0x0C01);
+  PIC32Sim_DumpLog(stdout);
+}
+#endif
+/*------------------------------- Footnotes -------------------------------*/
+/*------------------------------ End of file ------------------------------*/
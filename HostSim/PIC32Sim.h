@@ -0,0 +1,103 @@
+/****************************************************************************
+ Module
+     PIC32Sim.h
+
+ Description
+     header file for the host model of the PIC32MX170 peripherals that sits
+     behind HostSim/xc.h
+
+ Notes
+     The model runs on every access to a hooked register (see xc.h), and
+     catches up with the writes to the other registers then, so the project
+     modules need no changes. These functions are for a test, to drive the
+     inputs and look at what came out
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:10 agt      the model polls for writes, from hooked registers
+ 10/18/26 04:50 agt      added PIC32Sim_SPIGetOverruns, ISRs for IFS1 flags
+ 10/18/26 02:10 agt      added PIC32Sim_AttachISR & PIC32Sim_TakeInterrupts
+ 10/17/26 23:55 agt      started coding
+*****************************************************************************/
+#ifndef PIC32Sim_H
+#define PIC32Sim_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "xc.h"
+
+// the ports, as numbered by PIC32PortHAL.h
+#define PIC32SIM_PORT_A 0
+#define PIC32SIM_PORT_B 1
+
+// the number of analog channels, AN0 to AN12
+#define PIC32SIM_NUM_AN 13
+
+// which of the four words of a slot an access was to
+typedef enum
+{
+  PIC32SIM_REG_WRITE = 0,
+  PIC32SIM_CLR_WRITE,
+  PIC32SIM_SET_WRITE,
+  PIC32SIM_INV_WRITE
+} PIC32Sim_Access_t;
+
+// an entry of the register write log
+typedef struct
+{
+  uint32_t          Time;     // core timer count at the write
+  uint16_t          Slot;     // a PIC32Sim_Slot_t
+  PIC32Sim_Access_t Access;
+  uint32_t          Value;    // the value written
+  uint32_t          Result;   // the register once the model has run
+} PIC32Sim_LogEntry_t;
+
+// a frame that went out of an SPI module. Frames sent with SS held low
+// between them have the same Burst number
+typedef struct
+{
+  uint32_t Data;
+  uint32_t Burst;
+} PIC32Sim_SPIFrame_t;
+
+// the waveform on an output compare channel, in PBCLK counts
+typedef struct
+{
+  bool      IsOn;
+  uint32_t  PeriodCounts;
+  uint32_t  HighCounts;
+} PIC32Sim_PWM_t;
+
+/*----------------------- Public Function Prototypes ----------------------*/
+void PIC32Sim_Reset(void);
+void PIC32Sim_SetClock(uint32_t (*NewClock)(void));
+const char *PIC32Sim_RegName(uint16_t Slot);
+
+void PIC32Sim_SetPin(uint8_t WhichPort, uint8_t WhichPin, bool Level);
+void PIC32Sim_ReleasePin(uint8_t WhichPort, uint8_t WhichPin);
+bool PIC32Sim_GetOutput(uint8_t WhichPort, uint8_t WhichPin);
+
+uint16_t PIC32Sim_SPIRead(uint8_t WhichModule, PIC32Sim_SPIFrame_t *pFrames,
+    uint16_t MaxFrames);
+uint32_t PIC32Sim_SPIGetBusCounts(uint8_t WhichModule);
+uint32_t PIC32Sim_SPIGetSSRises(uint8_t WhichModule);
+uint32_t PIC32Sim_SPIGetOverruns(uint8_t WhichModule);
+
+bool PIC32Sim_AttachISR(uint32_t IFS0Mask, uint32_t IFS1Mask,
+    void (*pISR)(void));
+void PIC32Sim_TakeInterrupts(void);
+
+uint16_t PIC32Sim_UartTxRead(uint8_t *pBytes, uint16_t MaxBytes);
+bool PIC32Sim_UartRx(uint8_t NewByte);
+
+void PIC32Sim_SetAnalog(uint8_t Channel, uint16_t NewValue);
+
+bool PIC32Sim_GetPWM(uint8_t Channel, PIC32Sim_PWM_t *pPWM);
+
+uint32_t PIC32Sim_GetLogCount(void);
+bool PIC32Sim_GetLogEntry(uint32_t Index, PIC32Sim_LogEntry_t *pEntry);
+void PIC32Sim_DumpLog(FILE *pOut);
+void PIC32Sim_ClearLog(void);
+
+#endif /* PIC32Sim_H */
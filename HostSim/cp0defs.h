@@ -0,0 +1,34 @@
+/****************************************************************************
+ Module
+     cp0defs.h
+
+ Description
+     The host stand in for the XC32 coprocessor 0 header. The core timer
+     count and compare come from the register model in PIC32Sim.c
+
+ Notes
+     xc.h includes this, as the XC32 device header does
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/17/26 23:55 agt      started coding
+*****************************************************************************/
+#ifndef PIC32SIM_CP0DEFS_H
+#define PIC32SIM_CP0DEFS_H
+
+#include <stdint.h>
+
+uint32_t PIC32Sim_GetCoreCount(void);
+void PIC32Sim_SetCoreCompare(uint32_t NewCompare);
+uint32_t PIC32Sim_GetCoreCompare(void);
+
+#define _CP0_GET_COUNT() PIC32Sim_GetCoreCount()
+#define _CP0_SET_COMPARE(NewCompare) PIC32Sim_SetCoreCompare(NewCompare)
+#define _CP0_GET_COMPARE() PIC32Sim_GetCoreCompare()
+
+// the debug register only matters to a debugger, so it reads as 0
+#define _CP0_DEBUG_COUNTDM_MASK 0x02000000UL
+#define _CP0_GET_DEBUG() (0UL)
+#define _CP0_SET_DEBUG(NewDebug) ((void)(NewDebug))
+
+#endif /* PIC32SIM_CP0DEFS_H */
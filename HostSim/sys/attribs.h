@@ -0,0 +1,35 @@
+/****************************************************************************
+ Module
+     sys/attribs.h
+
+ Description
+     The host stand in for the XC32 attribute header. An ISR is a plain
+     function on a host, which a test calls when the flag it serves is set,
+     or which is attached with PIC32Sim_AttachISR
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 02:10 agt      ISRs can also be attached to the register model
+ 10/17/26 23:55 agt      started coding
+*****************************************************************************/
+#ifndef PIC32SIM_ATTRIBS_H
+#define PIC32SIM_ATTRIBS_H
+
+#define __ISR(Vector, ...)
+
+#define IPL1AUTO
+#define IPL2AUTO
+#define IPL3AUTO
+#define IPL4AUTO
+#define IPL5AUTO
+#define IPL6AUTO
+#define IPL7AUTO
+#define IPL1SOFT
+#define IPL2SOFT
+#define IPL3SOFT
+#define IPL4SOFT
+#define IPL5SOFT
+#define IPL6SOFT
+#define IPL7SOFT
+
+#endif /* PIC32SIM_ATTRIBS_H */
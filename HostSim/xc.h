@@ -0,0 +1,1004 @@
+/****************************************************************************
+ Module
+     xc.h
+
+ Description
+     The host stand in for the XC32 device header of the PIC32MX170F256B,
+     so that the modules that touch the PIC32 registers compile unchanged
+     for a Linux build. It has the registers and bit fields that this
+     project uses, backed by the register model in PIC32Sim.c
+
+ Notes
+     Put HostSim on the include path of a host build only, never of the
+     MPLAB project, as this file takes the place of <xc.h>.
+
+     As in the XC32 header, the registers and their bit fields are extern
+     variables. Every register is a slot of four words, the register and its
+     CLR, SET and INV aliases, in the order that the PIC32 lays them out, so
+     a table of register addresses (as in PIC32PortHAL.c) works as it does on
+     the chip. PIC32Sim.c lays the slots out as PIC32Sim_SFR, as plain
+     memory. The model finds what the code has written to them each time
+     that it polls, which it does on every access to a hooked register.
+
+     The hooked registers are the ones whose reads have side effects or show
+     the progress of a transfer (IFS0, the SPI and UART status registers and
+     RX buffer, and the bit fields of PORTA and PORTB), and the SPI and UART
+     TX buffers, which take a frame or a byte at every write. Their names are
+     macros that call PIC32Sim_Access, so they cannot be used in a static
+     initializer, and a read of SPIxBUF or U1TXREG gives
+     PIC32SIM_UNWRITTEN.
+
+     Slots are in the order of the lists below, so ADC1BUF0 to ADC1BUFF are
+     next to each other, as PIC32_AD_Lib.c reads them from a pointer
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/18/26 06:10 agt      registers are plain memory, with hooked accessors in
+                         place of the page traps
+ 10/18/26 04:50 agt      added IPC1bits, IPC7bits, IPC9bits and the SPI TX
+                         flags of IFS1, for a display on either SPI
+ 10/18/26 02:10 agt      added IPC4bits, for the INT4 priority
+ 10/17/26 23:55 agt      started coding
+*****************************************************************************/
+#ifndef PIC32SIM_XC_H
+#define PIC32SIM_XC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __XC32
+#error "HostSim/xc.h is for a host build, use the XC32 device header on the PIC32"
+#endif
+
+#include "cp0defs.h"
+
+/*----------------------------- Register Slots ----------------------------*/
+// the registers that are read and written in place, in slot order
+#define PIC32SIM_PLAIN_REGS(X) \
+  X(ANSELA) X(TRISA) X(PORTA) X(LATA) X(ODCA) X(CNPUA) X(CNPDA) X(CNCONA) \
+  X(CNENA) X(CNSTATA) X(ANSELB) X(TRISB) X(PORTB) X(LATB) X(ODCB) X(CNPUB) \
+  X(CNPDB) X(CNCONB) X(CNENB) X(CNSTATB) X(RPA0R) X(RPA1R) X(RPA2R) X(RPA3R) \
+  X(RPA4R) X(RPB0R) X(RPB1R) X(RPB2R) X(RPB3R) X(RPB4R) X(RPB5R) X(RPB6R) \
+  X(RPB7R) X(RPB8R) X(RPB9R) X(RPB10R) X(RPB11R) X(RPB12R) X(RPB13R) \
+  X(RPB14R) X(RPB15R) X(INT1R) X(INT2R) X(INT3R) X(INT4R) X(U1RXR) X(SDI1R) \
+  X(SDI2R) X(SS1R) X(SS2R) X(SPI1CON) X(SPI1BRG) X(SPI1CON2) X(SPI2CON) \
+  X(SPI2BRG) X(SPI2CON2) X(OC1CON) X(OC1R) X(OC1RS) X(OC2CON) X(OC2R) \
+  X(OC2RS) X(OC3CON) X(OC3R) X(OC3RS) X(OC4CON) X(OC4R) X(OC4RS) X(OC5CON) \
+  X(OC5R) X(OC5RS) X(T1CON) X(TMR1) X(PR1) X(T2CON) X(TMR2) X(PR2) X(T3CON) \
+  X(TMR3) X(PR3) X(T4CON) X(TMR4) X(PR4) X(T5CON) X(TMR5) X(PR5) X(AD1CON1) \
+  X(AD1CON2) X(AD1CON3) X(AD1CHS) X(AD1CSSL) X(ADC1BUF0) X(ADC1BUF1) \
+  X(ADC1BUF2) X(ADC1BUF3) X(ADC1BUF4) X(ADC1BUF5) X(ADC1BUF6) X(ADC1BUF7) \
+  X(ADC1BUF8) X(ADC1BUF9) X(ADC1BUFA) X(ADC1BUFB) X(ADC1BUFC) X(ADC1BUFD) \
+  X(ADC1BUFE) X(ADC1BUFF) X(U1MODE) X(U1BRG) X(INTCON) X(IFS1) X(IEC0) \
+  X(IEC1) X(IPC0) X(IPC1) X(IPC2) X(IPC3) X(IPC4) X(IPC5) X(IPC6) X(IPC7) \
+  X(IPC8) X(IPC9) X(IPC10) X(IPC11) X(IPC12)
+
+// the registers that the model has to see every access to
+#define PIC32SIM_HOOKED_REGS(X) \
+  X(IFS0) X(SPI1STAT) X(SPI1BUF) X(SPI2STAT) X(SPI2BUF) X(U1STA) X(U1RXREG) \
+  X(U1TXREG)
+
+// a register and its aliases, as laid out on the PIC32
+typedef struct
+{
+  uint32_t Reg;
+  uint32_t Clr;
+  uint32_t Set;
+  uint32_t Inv;
+} PIC32Sim_SFR_t;
+
+typedef enum
+{
+#define PIC32SIM_SLOT_NAME(Name) SFR_##Name,
+  PIC32SIM_PLAIN_REGS(PIC32SIM_SLOT_NAME)
+  PIC32SIM_HOOKED_REGS(PIC32SIM_SLOT_NAME)
+  SFR_NUM_SLOTS
+#undef PIC32SIM_SLOT_NAME
+} PIC32Sim_Slot_t;
+
+// what a read of SPIxBUF or U1TXREG gives, so that a write can be told from
+// it. A 32 bit SPI frame of all ones is not seen
+#define PIC32SIM_UNWRITTEN 0xFFFFFFFFUL
+
+// the slots, laid out in PIC32Sim.c
+extern volatile PIC32Sim_SFR_t PIC32Sim_SFR[SFR_NUM_SLOTS];
+
+volatile PIC32Sim_SFR_t *PIC32Sim_Access(uint16_t Slot);
+
+// each plain register and its aliases, at their words of the slot
+#define PIC32SIM_DECLARE_REG(Name) \
+  extern volatile uint32_t Name, Name##CLR, Name##SET, Name##INV;
+PIC32SIM_PLAIN_REGS(PIC32SIM_DECLARE_REG)
+#undef PIC32SIM_DECLARE_REG
+
+// a hooked register lets the model catch up before it is used. The model
+// itself defines PIC32SIM_MODEL, to use the slots as they are
+#ifdef PIC32SIM_MODEL
+#define PIC32SIM_HOOK(Slot) (PIC32Sim_SFR[(Slot)])
+#else
+#define PIC32SIM_HOOK(Slot) (*PIC32Sim_Access(Slot))
+#endif
+
+#define IFS0 (PIC32SIM_HOOK(SFR_IFS0).Reg)
+#define IFS0CLR (PIC32SIM_HOOK(SFR_IFS0).Clr)
+#define IFS0SET (PIC32SIM_HOOK(SFR_IFS0).Set)
+#define IFS0INV (PIC32SIM_HOOK(SFR_IFS0).Inv)
+#define SPI1STAT (PIC32SIM_HOOK(SFR_SPI1STAT).Reg)
+#define SPI1STATCLR (PIC32SIM_HOOK(SFR_SPI1STAT).Clr)
+#define SPI1STATSET (PIC32SIM_HOOK(SFR_SPI1STAT).Set)
+#define SPI1STATINV (PIC32SIM_HOOK(SFR_SPI1STAT).Inv)
+#define SPI1BUF (PIC32SIM_HOOK(SFR_SPI1BUF).Reg)
+#define SPI2STAT (PIC32SIM_HOOK(SFR_SPI2STAT).Reg)
+#define SPI2STATCLR (PIC32SIM_HOOK(SFR_SPI2STAT).Clr)
+#define SPI2STATSET (PIC32SIM_HOOK(SFR_SPI2STAT).Set)
+#define SPI2STATINV (PIC32SIM_HOOK(SFR_SPI2STAT).Inv)
+#define SPI2BUF (PIC32SIM_HOOK(SFR_SPI2BUF).Reg)
+#define U1STA (PIC32SIM_HOOK(SFR_U1STA).Reg)
+#define U1STACLR (PIC32SIM_HOOK(SFR_U1STA).Clr)
+#define U1STASET (PIC32SIM_HOOK(SFR_U1STA).Set)
+#define U1STAINV (PIC32SIM_HOOK(SFR_U1STA).Inv)
+#define U1RXREG (PIC32SIM_HOOK(SFR_U1RXREG).Reg)
+#define U1TXREG (PIC32SIM_HOOK(SFR_U1TXREG).Reg)
+
+/*------------------------------- Bit Fields ------------------------------*/
+typedef union {
+  struct {
+    unsigned RA0:1;
+    unsigned RA1:1;
+    unsigned RA2:1;
+    unsigned RA3:1;
+    unsigned RA4:1;
+  };
+  uint32_t w;
+} __PORTAbits_t;
+
+typedef union {
+  struct {
+    unsigned LATA0:1;
+    unsigned LATA1:1;
+    unsigned LATA2:1;
+    unsigned LATA3:1;
+    unsigned LATA4:1;
+  };
+  uint32_t w;
+} __LATAbits_t;
+
+typedef union {
+  struct {
+    unsigned TRISA0:1;
+    unsigned TRISA1:1;
+    unsigned TRISA2:1;
+    unsigned TRISA3:1;
+    unsigned TRISA4:1;
+  };
+  uint32_t w;
+} __TRISAbits_t;
+
+typedef union {
+  struct {
+    unsigned ANSA0:1;
+    unsigned ANSA1:1;
+  };
+  uint32_t w;
+} __ANSELAbits_t;
+
+typedef union {
+  struct {
+    unsigned RB0:1;
+    unsigned RB1:1;
+    unsigned RB2:1;
+    unsigned RB3:1;
+    unsigned RB4:1;
+    unsigned RB5:1;
+    unsigned RB6:1;
+    unsigned RB7:1;
+    unsigned RB8:1;
+    unsigned RB9:1;
+    unsigned RB10:1;
+    unsigned RB11:1;
+    unsigned RB12:1;
+    unsigned RB13:1;
+    unsigned RB14:1;
+    unsigned RB15:1;
+  };
+  uint32_t w;
+} __PORTBbits_t;
+
+typedef union {
+  struct {
+    unsigned LATB0:1;
+    unsigned LATB1:1;
+    unsigned LATB2:1;
+    unsigned LATB3:1;
+    unsigned LATB4:1;
+    unsigned LATB5:1;
+    unsigned LATB6:1;
+    unsigned LATB7:1;
+    unsigned LATB8:1;
+    unsigned LATB9:1;
+    unsigned LATB10:1;
+    unsigned LATB11:1;
+    unsigned LATB12:1;
+    unsigned LATB13:1;
+    unsigned LATB14:1;
+    unsigned LATB15:1;
+  };
+  uint32_t w;
+} __LATBbits_t;
+
+typedef union {
+  struct {
+    unsigned TRISB0:1;
+    unsigned TRISB1:1;
+    unsigned TRISB2:1;
+    unsigned TRISB3:1;
+    unsigned TRISB4:1;
+    unsigned TRISB5:1;
+    unsigned TRISB6:1;
+    unsigned TRISB7:1;
+    unsigned TRISB8:1;
+    unsigned TRISB9:1;
+    unsigned TRISB10:1;
+    unsigned TRISB11:1;
+    unsigned TRISB12:1;
+    unsigned TRISB13:1;
+    unsigned TRISB14:1;
+    unsigned TRISB15:1;
+  };
+  uint32_t w;
+} __TRISBbits_t;
+
+typedef union {
+  struct {
+    unsigned ANSB0:1;
+    unsigned ANSB1:1;
+    unsigned ANSB2:1;
+    unsigned ANSB3:1;
+    unsigned :8;
+    unsigned ANSB12:1;
+    unsigned ANSB13:1;
+    unsigned ANSB14:1;
+    unsigned ANSB15:1;
+  };
+  uint32_t w;
+} __ANSELBbits_t;
+
+typedef union {
+  struct {
+    unsigned SRXISEL:2;
+    unsigned STXISEL:2;
+    unsigned DISSDI:1;
+    unsigned MSTEN:1;
+    unsigned CKP:1;
+    unsigned SSEN:1;
+    unsigned CKE:1;
+    unsigned SMP:1;
+    unsigned MODE16:1;
+    unsigned MODE32:1;
+    unsigned DISSDO:1;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+    unsigned ENHBUF:1;
+    unsigned SPIFE:1;
+    unsigned :5;
+    unsigned MCLKSEL:1;
+    unsigned FRMCNT:3;
+    unsigned FRMSYPW:1;
+    unsigned MSSEN:1;
+    unsigned FRMPOL:1;
+    unsigned FRMSYNC:1;
+    unsigned FRMEN:1;
+  };
+  uint32_t w;
+} __SPI1CONbits_t;
+
+typedef union {
+  struct {
+    unsigned AUDMOD:2;
+    unsigned :1;
+    unsigned AUDMONO:1;
+    unsigned :3;
+    unsigned AUDEN:1;
+    unsigned IGNTUR:1;
+    unsigned IGNROV:1;
+    unsigned SPITUREN:1;
+    unsigned SPIROVEN:1;
+    unsigned FRMERREN:1;
+    unsigned :2;
+    unsigned SPISGNEXT:1;
+  };
+  uint32_t w;
+} __SPI1CON2bits_t;
+
+typedef union {
+  struct {
+    unsigned SPIRBF:1;
+    unsigned SPITBF:1;
+    unsigned :1;
+    unsigned SPITBE:1;
+    unsigned :1;
+    unsigned SPIRBE:1;
+    unsigned SPIROV:1;
+    unsigned SRMT:1;
+    unsigned SPITUR:1;
+    unsigned :2;
+    unsigned SPIBUSY:1;
+    unsigned FRMERR:1;
+    unsigned :3;
+    unsigned TXBUFELM:5;
+    unsigned :3;
+    unsigned RXBUFELM:5;
+  };
+  uint32_t w;
+} __SPI1STATbits_t;
+
+typedef union {
+  struct {
+    unsigned SRXISEL:2;
+    unsigned STXISEL:2;
+    unsigned DISSDI:1;
+    unsigned MSTEN:1;
+    unsigned CKP:1;
+    unsigned SSEN:1;
+    unsigned CKE:1;
+    unsigned SMP:1;
+    unsigned MODE16:1;
+    unsigned MODE32:1;
+    unsigned DISSDO:1;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+    unsigned ENHBUF:1;
+    unsigned SPIFE:1;
+    unsigned :5;
+    unsigned MCLKSEL:1;
+    unsigned FRMCNT:3;
+    unsigned FRMSYPW:1;
+    unsigned MSSEN:1;
+    unsigned FRMPOL:1;
+    unsigned FRMSYNC:1;
+    unsigned FRMEN:1;
+  };
+  uint32_t w;
+} __SPI2CONbits_t;
+
+typedef union {
+  struct {
+    unsigned AUDMOD:2;
+    unsigned :1;
+    unsigned AUDMONO:1;
+    unsigned :3;
+    unsigned AUDEN:1;
+    unsigned IGNTUR:1;
+    unsigned IGNROV:1;
+    unsigned SPITUREN:1;
+    unsigned SPIROVEN:1;
+    unsigned FRMERREN:1;
+    unsigned :2;
+    unsigned SPISGNEXT:1;
+  };
+  uint32_t w;
+} __SPI2CON2bits_t;
+
+typedef union {
+  struct {
+    unsigned SPIRBF:1;
+    unsigned SPITBF:1;
+    unsigned :1;
+    unsigned SPITBE:1;
+    unsigned :1;
+    unsigned SPIRBE:1;
+    unsigned SPIROV:1;
+    unsigned SRMT:1;
+    unsigned SPITUR:1;
+    unsigned :2;
+    unsigned SPIBUSY:1;
+    unsigned FRMERR:1;
+    unsigned :3;
+    unsigned TXBUFELM:5;
+    unsigned :3;
+    unsigned RXBUFELM:5;
+  };
+  uint32_t w;
+} __SPI2STATbits_t;
+
+typedef union {
+  struct {
+    unsigned OCM:3;
+    unsigned OCTSEL:1;
+    unsigned OCFLT:1;
+    unsigned OC32:1;
+    unsigned :7;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __OC1CONbits_t;
+
+typedef union {
+  struct {
+    unsigned OCM:3;
+    unsigned OCTSEL:1;
+    unsigned OCFLT:1;
+    unsigned OC32:1;
+    unsigned :7;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __OC2CONbits_t;
+
+typedef union {
+  struct {
+    unsigned OCM:3;
+    unsigned OCTSEL:1;
+    unsigned OCFLT:1;
+    unsigned OC32:1;
+    unsigned :7;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __OC3CONbits_t;
+
+typedef union {
+  struct {
+    unsigned OCM:3;
+    unsigned OCTSEL:1;
+    unsigned OCFLT:1;
+    unsigned OC32:1;
+    unsigned :7;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __OC4CONbits_t;
+
+typedef union {
+  struct {
+    unsigned OCM:3;
+    unsigned OCTSEL:1;
+    unsigned OCFLT:1;
+    unsigned OC32:1;
+    unsigned :7;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __OC5CONbits_t;
+
+typedef union {
+  struct {
+    unsigned :1;
+    unsigned TCS:1;
+    unsigned TSYNC:1;
+    unsigned :1;
+    unsigned TCKPS:2;
+    unsigned :1;
+    unsigned TGATE:1;
+    unsigned :3;
+    unsigned TWIP:1;
+    unsigned TWDIS:1;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __T1CONbits_t;
+
+typedef union {
+  struct {
+    unsigned :1;
+    unsigned TCS:1;
+    unsigned :1;
+    unsigned T32:1;
+    unsigned TCKPS:3;
+    unsigned TGATE:1;
+    unsigned :5;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __T2CONbits_t;
+
+typedef union {
+  struct {
+    unsigned :1;
+    unsigned TCS:1;
+    unsigned :1;
+    unsigned T32:1;
+    unsigned TCKPS:3;
+    unsigned TGATE:1;
+    unsigned :5;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __T3CONbits_t;
+
+typedef union {
+  struct {
+    unsigned :1;
+    unsigned TCS:1;
+    unsigned :1;
+    unsigned T32:1;
+    unsigned TCKPS:3;
+    unsigned TGATE:1;
+    unsigned :5;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __T4CONbits_t;
+
+typedef union {
+  struct {
+    unsigned :1;
+    unsigned TCS:1;
+    unsigned :1;
+    unsigned T32:1;
+    unsigned TCKPS:3;
+    unsigned TGATE:1;
+    unsigned :5;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __T5CONbits_t;
+
+typedef union {
+  struct {
+    unsigned T1IS:2;
+    unsigned T1IP:3;
+    unsigned :3;
+    unsigned IC1IS:2;
+    unsigned IC1IP:3;
+    unsigned :3;
+    unsigned OC1IS:2;
+    unsigned OC1IP:3;
+    unsigned :3;
+    unsigned INT1IS:2;
+    unsigned INT1IP:3;
+  };
+  uint32_t w;
+} __IPC1bits_t;
+
+typedef union {
+  struct {
+    unsigned T2IS:2;
+    unsigned T2IP:3;
+    unsigned :3;
+    unsigned IC2IS:2;
+    unsigned IC2IP:3;
+    unsigned :3;
+    unsigned OC2IS:2;
+    unsigned OC2IP:3;
+    unsigned :3;
+    unsigned INT2IS:2;
+    unsigned INT2IP:3;
+  };
+  uint32_t w;
+} __IPC2bits_t;
+
+typedef union {
+  struct {
+    unsigned T4IS:2;
+    unsigned T4IP:3;
+    unsigned :3;
+    unsigned IC4IS:2;
+    unsigned IC4IP:3;
+    unsigned :3;
+    unsigned OC4IS:2;
+    unsigned OC4IP:3;
+    unsigned :3;
+    unsigned INT4IS:2;
+    unsigned INT4IP:3;
+  };
+  uint32_t w;
+} __IPC4bits_t;
+
+typedef union {
+  struct {
+    unsigned T5IS:2;
+    unsigned T5IP:3;
+    unsigned :3;
+    unsigned IC5IS:2;
+    unsigned IC5IP:3;
+    unsigned :3;
+    unsigned OC5IS:2;
+    unsigned OC5IP:3;
+    unsigned :3;
+    unsigned AD1IS:2;
+    unsigned AD1IP:3;
+  };
+  uint32_t w;
+} __IPC5bits_t;
+
+typedef union {
+  struct {
+    unsigned CMP1IS:2;
+    unsigned CMP1IP:3;
+    unsigned :3;
+    unsigned CMP2IS:2;
+    unsigned CMP2IP:3;
+    unsigned :3;
+    unsigned USBIS:2;
+    unsigned USBIP:3;
+    unsigned :3;
+    unsigned SPI1IS:2;
+    unsigned SPI1IP:3;
+  };
+  uint32_t w;
+} __IPC7bits_t;
+
+typedef union {
+  struct {
+    unsigned SPI2IS:2;
+    unsigned SPI2IP:3;
+    unsigned :3;
+    unsigned U2IS:2;
+    unsigned U2IP:3;
+    unsigned :3;
+    unsigned I2C2IS:2;
+    unsigned I2C2IP:3;
+    unsigned :3;
+    unsigned CMP3IS:2;
+    unsigned CMP3IP:3;
+  };
+  uint32_t w;
+} __IPC9bits_t;
+
+typedef union {
+  struct {
+    unsigned DONE:1;
+    unsigned SAMP:1;
+    unsigned ASAM:1;
+    unsigned :1;
+    unsigned CLRASAM:1;
+    unsigned SSRC:3;
+    unsigned FORM:3;
+    unsigned :2;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __AD1CON1bits_t;
+
+typedef union {
+  struct {
+    unsigned ALTS:1;
+    unsigned BUFM:1;
+    unsigned SMPI:4;
+    unsigned :1;
+    unsigned BUFS:1;
+    unsigned :2;
+    unsigned CSCNA:1;
+    unsigned :1;
+    unsigned OFFCAL:1;
+    unsigned VCFG:3;
+  };
+  uint32_t w;
+} __AD1CON2bits_t;
+
+typedef union {
+  struct {
+    unsigned ADCS:8;
+    unsigned SAMC:5;
+    unsigned :2;
+    unsigned ADRC:1;
+  };
+  uint32_t w;
+} __AD1CON3bits_t;
+
+typedef union {
+  struct {
+    unsigned STSEL:1;
+    unsigned PDSEL:2;
+    unsigned BRGH:1;
+    unsigned RXINV:1;
+    unsigned ABAUD:1;
+    unsigned LPBACK:1;
+    unsigned WAKE:1;
+    unsigned UEN:2;
+    unsigned :1;
+    unsigned RTSMD:1;
+    unsigned IREN:1;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned ON:1;
+  };
+  uint32_t w;
+} __U1MODEbits_t;
+
+typedef union {
+  struct {
+    unsigned URXDA:1;
+    unsigned OERR:1;
+    unsigned FERR:1;
+    unsigned PERR:1;
+    unsigned RIDLE:1;
+    unsigned ADDEN:1;
+    unsigned URXISEL:2;
+    unsigned TRMT:1;
+    unsigned UTXBF:1;
+    unsigned UTXEN:1;
+    unsigned UTXBRK:1;
+    unsigned URXEN:1;
+    unsigned UTXINV:1;
+    unsigned UTXISEL:2;
+    unsigned ADDR:8;
+    unsigned ADM_EN:1;
+  };
+  uint32_t w;
+} __U1STAbits_t;
+
+typedef union {
+  struct {
+    unsigned INT0EP:1;
+    unsigned INT1EP:1;
+    unsigned INT2EP:1;
+    unsigned INT3EP:1;
+    unsigned INT4EP:1;
+    unsigned :3;
+    unsigned TPC:3;
+    unsigned :1;
+    unsigned MVEC:1;
+    unsigned :3;
+    unsigned SS0:1;
+  };
+  uint32_t w;
+} __INTCONbits_t;
+
+typedef union {
+  struct {
+    unsigned CTIF:1;
+    unsigned CS0IF:1;
+    unsigned CS1IF:1;
+    unsigned INT0IF:1;
+    unsigned T1IF:1;
+    unsigned INT1IF:1;
+    unsigned OC1IF:1;
+    unsigned IC1IF:1;
+    unsigned IC1EIF:1;
+    unsigned T2IF:1;
+    unsigned INT2IF:1;
+    unsigned OC2IF:1;
+    unsigned IC2IF:1;
+    unsigned IC2EIF:1;
+    unsigned T3IF:1;
+    unsigned INT3IF:1;
+    unsigned OC3IF:1;
+    unsigned IC3IF:1;
+    unsigned IC3EIF:1;
+    unsigned T4IF:1;
+    unsigned INT4IF:1;
+    unsigned OC4IF:1;
+    unsigned IC4IF:1;
+    unsigned IC4EIF:1;
+    unsigned T5IF:1;
+    unsigned OC5IF:1;
+    unsigned IC5IF:1;
+    unsigned IC5EIF:1;
+    unsigned AD1IF:1;
+    unsigned FSCMIF:1;
+    unsigned RTCCIF:1;
+    unsigned FCEIF:1;
+  };
+  uint32_t w;
+} __IFS0bits_t;
+
+typedef union {
+  struct {
+    unsigned CTIE:1;
+    unsigned CS0IE:1;
+    unsigned CS1IE:1;
+    unsigned INT0IE:1;
+    unsigned T1IE:1;
+    unsigned INT1IE:1;
+    unsigned OC1IE:1;
+    unsigned IC1IE:1;
+    unsigned IC1EIE:1;
+    unsigned T2IE:1;
+    unsigned INT2IE:1;
+    unsigned OC2IE:1;
+    unsigned IC2IE:1;
+    unsigned IC2EIE:1;
+    unsigned T3IE:1;
+    unsigned INT3IE:1;
+    unsigned OC3IE:1;
+    unsigned IC3IE:1;
+    unsigned IC3EIE:1;
+    unsigned T4IE:1;
+    unsigned INT4IE:1;
+    unsigned OC4IE:1;
+    unsigned IC4IE:1;
+    unsigned IC4EIE:1;
+    unsigned T5IE:1;
+    unsigned OC5IE:1;
+    unsigned IC5IE:1;
+    unsigned IC5EIE:1;
+    unsigned AD1IE:1;
+    unsigned FSCMIE:1;
+    unsigned RTCCIE:1;
+    unsigned FCEIE:1;
+  };
+  uint32_t w;
+} __IEC0bits_t;
+
+typedef union {
+  struct {
+    unsigned CTIS:2;
+    unsigned CTIP:3;
+    unsigned :3;
+    unsigned CS0IS:2;
+    unsigned CS0IP:3;
+    unsigned :3;
+    unsigned CS1IS:2;
+    unsigned CS1IP:3;
+    unsigned :3;
+    unsigned INT0IS:2;
+    unsigned INT0IP:3;
+  };
+  uint32_t w;
+} __IPC0bits_t;
+
+/*----------------------------- Bit Registers -----------------------------*/
+// the registers above, as their bit fields
+extern volatile __ANSELAbits_t ANSELAbits;
+extern volatile __TRISAbits_t TRISAbits;
+extern volatile __LATAbits_t LATAbits;
+extern volatile __ANSELBbits_t ANSELBbits;
+extern volatile __TRISBbits_t TRISBbits;
+extern volatile __LATBbits_t LATBbits;
+extern volatile __SPI1CONbits_t SPI1CONbits;
+extern volatile __SPI1CON2bits_t SPI1CON2bits;
+extern volatile __SPI2CONbits_t SPI2CONbits;
+extern volatile __SPI2CON2bits_t SPI2CON2bits;
+extern volatile __OC1CONbits_t OC1CONbits;
+extern volatile __OC2CONbits_t OC2CONbits;
+extern volatile __OC3CONbits_t OC3CONbits;
+extern volatile __OC4CONbits_t OC4CONbits;
+extern volatile __OC5CONbits_t OC5CONbits;
+extern volatile __T1CONbits_t T1CONbits;
+extern volatile __T2CONbits_t T2CONbits;
+extern volatile __T3CONbits_t T3CONbits;
+extern volatile __T4CONbits_t T4CONbits;
+extern volatile __T5CONbits_t T5CONbits;
+extern volatile __AD1CON1bits_t AD1CON1bits;
+extern volatile __AD1CON2bits_t AD1CON2bits;
+extern volatile __AD1CON3bits_t AD1CON3bits;
+extern volatile __U1MODEbits_t U1MODEbits;
+extern volatile __INTCONbits_t INTCONbits;
+extern volatile __IEC0bits_t IEC0bits;
+extern volatile __IPC0bits_t IPC0bits;
+extern volatile __IPC1bits_t IPC1bits;
+extern volatile __IPC2bits_t IPC2bits;
+extern volatile __IPC4bits_t IPC4bits;
+extern volatile __IPC5bits_t IPC5bits;
+extern volatile __IPC7bits_t IPC7bits;
+extern volatile __IPC9bits_t IPC9bits;
+
+// the bit fields of the ports are hooked, so that a read sees a write to the
+// latch or a pin set by a test, and the port can still be in an address table
+#define PORTAbits (*(volatile __PORTAbits_t *)&PIC32SIM_HOOK(SFR_PORTA).Reg)
+#define PORTBbits (*(volatile __PORTBbits_t *)&PIC32SIM_HOOK(SFR_PORTB).Reg)
+#define IFS0bits (*(volatile __IFS0bits_t *)&PIC32SIM_HOOK(SFR_IFS0).Reg)
+#define SPI1STATbits \
+  (*(volatile __SPI1STATbits_t *)&PIC32SIM_HOOK(SFR_SPI1STAT).Reg)
+#define SPI2STATbits \
+  (*(volatile __SPI2STATbits_t *)&PIC32SIM_HOOK(SFR_SPI2STAT).Reg)
+#define U1STAbits (*(volatile __U1STAbits_t *)&PIC32SIM_HOOK(SFR_U1STA).Reg)
+
+/*--------------------------------- Masks ---------------------------------*/
+#define _IFS0_CTIF_MASK        0x00000001UL
+#define _IEC0_CTIE_MASK        0x00000001UL
+#define _IFS0_CS0IF_MASK       0x00000002UL
+#define _IEC0_CS0IE_MASK       0x00000002UL
+#define _IFS0_CS1IF_MASK       0x00000004UL
+#define _IEC0_CS1IE_MASK       0x00000004UL
+#define _IFS0_INT0IF_MASK      0x00000008UL
+#define _IEC0_INT0IE_MASK      0x00000008UL
+#define _IFS0_T1IF_MASK        0x00000010UL
+#define _IEC0_T1IE_MASK        0x00000010UL
+#define _IFS0_INT1IF_MASK      0x00000020UL
+#define _IEC0_INT1IE_MASK      0x00000020UL
+#define _IFS0_OC1IF_MASK       0x00000040UL
+#define _IEC0_OC1IE_MASK       0x00000040UL
+#define _IFS0_IC1IF_MASK       0x00000080UL
+#define _IEC0_IC1IE_MASK       0x00000080UL
+#define _IFS0_IC1EIF_MASK      0x00000100UL
+#define _IEC0_IC1EIE_MASK      0x00000100UL
+#define _IFS0_T2IF_MASK        0x00000200UL
+#define _IEC0_T2IE_MASK        0x00000200UL
+#define _IFS0_INT2IF_MASK      0x00000400UL
+#define _IEC0_INT2IE_MASK      0x00000400UL
+#define _IFS0_OC2IF_MASK       0x00000800UL
+#define _IEC0_OC2IE_MASK       0x00000800UL
+#define _IFS0_IC2IF_MASK       0x00001000UL
+#define _IEC0_IC2IE_MASK       0x00001000UL
+#define _IFS0_IC2EIF_MASK      0x00002000UL
+#define _IEC0_IC2EIE_MASK      0x00002000UL
+#define _IFS0_T3IF_MASK        0x00004000UL
+#define _IEC0_T3IE_MASK        0x00004000UL
+#define _IFS0_INT3IF_MASK      0x00008000UL
+#define _IEC0_INT3IE_MASK      0x00008000UL
+#define _IFS0_OC3IF_MASK       0x00010000UL
+#define _IEC0_OC3IE_MASK       0x00010000UL
+#define _IFS0_IC3IF_MASK       0x00020000UL
+#define _IEC0_IC3IE_MASK       0x00020000UL
+#define _IFS0_IC3EIF_MASK      0x00040000UL
+#define _IEC0_IC3EIE_MASK      0x00040000UL
+#define _IFS0_T4IF_MASK        0x00080000UL
+#define _IEC0_T4IE_MASK        0x00080000UL
+#define _IFS0_INT4IF_MASK      0x00100000UL
+#define _IEC0_INT4IE_MASK      0x00100000UL
+#define _IFS0_OC4IF_MASK       0x00200000UL
+#define _IEC0_OC4IE_MASK       0x00200000UL
+#define _IFS0_IC4IF_MASK       0x00400000UL
+#define _IEC0_IC4IE_MASK       0x00400000UL
+#define _IFS0_IC4EIF_MASK      0x00800000UL
+#define _IEC0_IC4EIE_MASK      0x00800000UL
+#define _IFS0_T5IF_MASK        0x01000000UL
+#define _IEC0_T5IE_MASK        0x01000000UL
+#define _IFS0_OC5IF_MASK       0x02000000UL
+#define _IEC0_OC5IE_MASK       0x02000000UL
+#define _IFS0_IC5IF_MASK       0x04000000UL
+#define _IEC0_IC5IE_MASK       0x04000000UL
+#define _IFS0_IC5EIF_MASK      0x08000000UL
+#define _IEC0_IC5EIE_MASK      0x08000000UL
+#define _IFS0_AD1IF_MASK       0x10000000UL
+#define _IEC0_AD1IE_MASK       0x10000000UL
+#define _IFS0_FSCMIF_MASK      0x20000000UL
+#define _IEC0_FSCMIE_MASK      0x20000000UL
+#define _IFS0_RTCCIF_MASK      0x40000000UL
+#define _IEC0_RTCCIE_MASK      0x40000000UL
+#define _IFS0_FCEIF_MASK       0x80000000UL
+#define _IEC0_FCEIE_MASK       0x80000000UL
+#define _IFS1_SPI1TXIF_MASK    0x00000040UL
+#define _IEC1_SPI1TXIE_MASK    0x00000040UL
+#define _IFS1_SPI2TXIF_MASK    0x00100000UL
+#define _IEC1_SPI2TXIE_MASK    0x00100000UL
+#define _T1CON_ON_MASK         0x00008000UL
+#define _T2CON_ON_MASK         0x00008000UL
+#define _T3CON_ON_MASK         0x00008000UL
+#define _T4CON_ON_MASK         0x00008000UL
+#define _T5CON_ON_MASK         0x00008000UL
+#define _AD1CON1_ASAM_MASK     0x00000004UL
+#define _AD1CON1_ON_MASK       0x00008000UL
+#define _U1STA_OERR_MASK       0x00000002UL
+
+/*-------------------------------- Vectors --------------------------------*/
+#define _CORE_TIMER_VECTOR    0
+#define _TIMER_1_VECTOR       4
+#define _EXTERNAL_1_VECTOR    5
+#define _TIMER_2_VECTOR       8
+#define _TIMER_3_VECTOR       12
+#define _TIMER_4_VECTOR       16
+#define _EXTERNAL_4_VECTOR    17
+#define _TIMER_5_VECTOR       20
+#define _ADC_VECTOR           23
+#define _SPI_1_VECTOR         31
+#define _UART_1_VECTOR        32
+#define _SPI_2_VECTOR         35
+
+/*--------------------------------- Misc ----------------------------------*/
+// a host build has no interrupts to turn off, the model runs in line. They
+// still give a value, as on the PIC32, that callers are free to ignore
+#define __builtin_disable_interrupts() ({ 0U; })
+#define __builtin_enable_interrupts() ({ 0U; })
+
+// picks the UART that stdio uses on the PIC32, stdio is stdout on a host
+extern int __XC_UART;
+
+#endif /* PIC32SIM_XC_H */
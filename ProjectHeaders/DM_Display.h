@@ -6,12 +6,91 @@
 #ifndef DM_DISPLAY_H
 #define	DM_DISPLAY_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_Mailbox.h"
+#include "ES_Timers.h"
+#include "PIC32_SPI_HAL.h"
+
+// the columns that DM_RenderMessage makes for each character of the font
+#define DM_COLUMNS_PER_CHAR 4
+// the rows of every module
+#define DM_NUM_ROWS 8
+// a row of the buffer is a 32 bit word for every 4 modules
+#define DM_ROW_WORDS(NumModules) (((NumModules) + 3) / 4)
+// the sizes of the storage that DM_InitDisplay is given, for a chain of
+// NumModules
+#define DM_ROWS_LEN(NumModules) (DM_NUM_ROWS * DM_ROW_WORDS(NumModules))
+#define DM_FRAME_LEN(NumModules) (DM_NUM_ROWS * (NumModules))
+
+// A chain of MAX7219 modules on an SPI module of its own. The caller keeps
+// it and the storage for its rows, as for an ES_Mailbox_t, and only the
+// DM_ functions use what is in it.
+// Each row is NumWords words. The low byte of word 0 is the right-most
+// module, the first to be sent, and each module to the left is the next
+// byte up, so scrolling left is a shift up through the words.
+typedef struct
+{
+  SPI_Module_t      WhichSPI;
+  uint8_t           NumModules;
+  uint8_t           NumWords;
+  uint32_t          TopMask;      // the bits of the top word that are shown
+  uint32_t          *pRows;       // DM_ROWS_LEN(NumModules) words
+  uint16_t          *pFrame;      // DM_FRAME_LEN(NumModules) words
+  uint8_t           DirtyRows;    // a bit for each row changed since sent
+  uint8_t           InitStep;
+  uint8_t           UpdateRow;    // the next row of DM_TakeDisplayUpdateStep
+  // the rows being sent from the interrupts
+  uint8_t           NumFrameRows;
+  uint8_t           NextRow;
+  uint16_t          NextWord;     // of pFrame, to send next
+  uint16_t          RowEnd;       // the end of the row going out
+  volatile bool     IsRefreshing;
+  volatile bool     IsFrameRequested;
+  bool              IsGoverning;
+  ES_TimerHandle_t  GovernorTimer;
+  uint8_t           RefreshService;
+  ES_Mailbox_t      RefreshMailbox;
+  ES_Event_t        RefreshSlots[2];
+} DM_Display_t;
+
+/****************************************************************************
+ Function
+  DM_InitDisplay
+
+ Parameter
+  DM_Display_t *: The display to set up
+  SPI_Module_t: The SPI module that the chain is on, one display to each
+  SPI_PinMap_t: The pin for SS
+  SPI_PinMap_t: The pin for SDO
+  uint8_t: The number of modules in the chain
+  uint32_t *: DM_ROWS_LEN(NumModules) words for the display buffer
+  uint16_t *: DM_FRAME_LEN(NumModules) words for the frames being sent
+
+ Returns
+  bool: false if the SPI module already has a display, there are no
+        modules or the pins cannot be used by the SPI module
+
+ Description
+  Sets up the SPI module and SS pin for the chain, with the enhanced buffer,
+  and an empty display buffer. Chains longer than the 8 words of the
+  buffer are fed from the SPI TX interrupt as each row goes out.
+  Call it before any other DM_ function for the display.
+
+Example
+   DM_InitDisplay(&LEDDisplay, SPI_SPI1, SPI_RPA0, SPI_RPA1, 8, Rows, Frame);
+ ****************************************************************************/
+bool DM_InitDisplay(DM_Display_t *pDisplay, SPI_Module_t WhichSPI,
+    SPI_PinMap_t SSPin, SPI_PinMap_t SDPin, uint8_t NumModules,
+    uint32_t *pRows, uint16_t *pFrame);
+
 /****************************************************************************
  Function
   DM_TakeInitDisplayStep
 
  Parameter
-  None
+  DM_Display_t *: The display
 
  Returns
   bool: true when there are no more initialization steps to perform; false
@@ -28,10 +107,10 @@
     Finally, bring it out of shutdown and return true
    
 Example
-   while ( false == DM_TakeInitDisplayStep() )
+   while ( false == DM_TakeInitDisplayStep(&LEDDisplay) )
    {} // note this example is for non-event-driven code
  ****************************************************************************/
-bool DM_TakeInitDisplayStep(void);
+bool DM_TakeInitDisplayStep(DM_Display_t *pDisplay);
 
 
 /****************************************************************************
@@ -39,7 +118,7 @@ bool DM_TakeInitDisplayStep(void);
   DM_ClearDisplayBuffer
 
  Parameter
-  None
+  DM_Display_t *: The display
 
  Returns
  Nothing (void)
@@ -48,15 +127,16 @@ bool DM_TakeInitDisplayStep(void);
   Clears the contents of the display buffer.
    
 Example
-   BDM_ClearDisplayBuffer();
+   DM_ClearDisplayBuffer(&LEDDisplay);
  ****************************************************************************/
-void DM_ClearDisplayBuffer(void);
+void DM_ClearDisplayBuffer(DM_Display_t *pDisplay);
 
 /****************************************************************************
  Function
   DM_ScrollDisplayBuffer
 
  Parameter
+  DM_Display_t *: The display
   uint8_t: The number of Columns to scroll
 
  Returns
@@ -67,29 +147,79 @@ void DM_ClearDisplayBuffer(void);
   columns.
    
 Example
-   DM_ScrollDisplayBuffer(4);
+   DM_ScrollDisplayBuffer(&LEDDisplay, 4);
  ****************************************************************************/
-void DM_ScrollDisplayBuffer(uint8_t NumCols2Scroll);
+void DM_ScrollDisplayBuffer(DM_Display_t *pDisplay, uint8_t NumCols2Scroll);
 
 /****************************************************************************
  Function
   DM_TakeDisplayUpdateStep
 
  Parameter
-  None
+  DM_Display_t *: The display
 
  Returns
   bool: true when all rows have been copied to the display; false otherwise
 
  Description
   Copies the contents of the display buffer to the MAX7219 controllers 1 row
-  per call.
+  per call, waiting for each row to go out. Do not call it while an update
+  started with DM_StartDisplayUpdate is under way.
    
 Example
-   while (false == DM_TakeDisplayUpdateStep())
+   while (false == DM_TakeDisplayUpdateStep(&LEDDisplay))
    {} // note this example is for non-event-driven code
  ****************************************************************************/
-bool DM_TakeDisplayUpdateStep(void);
+bool DM_TakeDisplayUpdateStep(DM_Display_t *pDisplay);
+
+/****************************************************************************
+ Function
+  DM_InitDisplayRefresh
+
+ Parameter
+  DM_Display_t *: The display
+  uint8_t: The service to post ES_UPDATE_COMPLETE to
+
+ Returns
+  bool: false if no ISR mailbox (see ES_MAX_MAILBOXES) or no timer was left
+        for it
+
+ Description
+  Sets up the interrupts that DM_StartDisplayUpdate sends the display from
+  and the timer that paces it.
+  Call it once, from the init function of the service, after
+  DM_InitDisplay.
+   
+Example
+   DM_InitDisplayRefresh(&LEDDisplay, MyPriority);
+ ****************************************************************************/
+bool DM_InitDisplayRefresh(DM_Display_t *pDisplay, uint8_t WhichService);
+
+/****************************************************************************
+ Function
+  DM_StartDisplayUpdate
+
+ Parameter
+  DM_Display_t *: The display
+
+ Returns
+  Nothing (void)
+
+ Description
+  Copies the rows of the display buffer that have changed since they were
+  last sent to the MAX7219 controllers in the background, a row per SS
+  interrupt, then posts ES_UPDATE_COMPLETE to the service given to
+  DM_InitDisplayRefresh. The buffer can be changed as soon as this returns.
+  Frames start at least DM_FRAME_PERIOD ms apart: a call before then waits
+  for it, takes in any other calls made by then, and they share one
+  ES_UPDATE_COMPLETE. With no rows changed nothing is sent.
+   
+Example
+   DM_ScrollDisplayBuffer(&LEDDisplay, 4);
+   DM_AddChar2DisplayBuffer(&LEDDisplay, 'A');
+   DM_StartDisplayUpdate(&LEDDisplay);
+ ****************************************************************************/
+void DM_StartDisplayUpdate(DM_Display_t *pDisplay);
 
 
 /****************************************************************************
@@ -97,6 +227,7 @@ bool DM_TakeDisplayUpdateStep(void);
   DM_AddChar2DisplayBuffer
 
  Parameter
+  DM_Display_t *: The display
   unsigned char: The character to be added to the display
   
  Returns
@@ -107,15 +238,87 @@ bool DM_TakeDisplayUpdateStep(void);
   at the right-most character position in the buffer  
    
 Example
-   DM_AddChar2DisplayBuffer('A');
+   DM_AddChar2DisplayBuffer(&LEDDisplay, 'A');
+ ****************************************************************************/
+void DM_AddChar2DisplayBuffer(DM_Display_t *pDisplay,
+    unsigned char Char2Display);
+
+/****************************************************************************
+ Function
+  DM_RenderMessage
+
+ Parameter
+  const char *: The message to render
+  uint8_t *: Where to put the columns
+  uint16_t: The most columns that fit there
+
+ Returns
+  uint16_t: The number of columns made, DM_COLUMNS_PER_CHAR per character
+
+ Description
+  Turns the message into pixel columns, left to right, bit n of each for
+  row n, with the font looked up once here rather than as it scrolls. The
+  columns go to DM_ScrollInColumn or DM_PutColumnsIntoBuffer. Characters
+  that do not fit into MaxColumns are left out.
+
+Example
+   NumColumns = DM_RenderMessage("Hello", Columns, ARRAY_SIZE(Columns));
+ ****************************************************************************/
+uint16_t DM_RenderMessage(const char *pMessage, uint8_t *pColumns,
+    uint16_t MaxColumns);
+
+/****************************************************************************
+ Function
+  DM_ScrollInColumn
+
+ Parameter
+  DM_Display_t *: The display
+  uint8_t: A column from DM_RenderMessage
+
+ Returns
+  Nothing (void)
+
+ Description
+  Scrolls the display buffer by 1 column and puts the column in at the
+  right. Scrolling in the 4 columns of a character is the same as
+  DM_ScrollDisplayBuffer(4) followed by DM_AddChar2DisplayBuffer.
+
+Example
+   DM_ScrollInColumn(&LEDDisplay, Columns[NextColumn++]);
+   DM_StartDisplayUpdate(&LEDDisplay);
+ ****************************************************************************/
+void DM_ScrollInColumn(DM_Display_t *pDisplay, uint8_t Column);
+
+/****************************************************************************
+ Function
+  DM_PutColumnsIntoBuffer
+
+ Parameter
+  DM_Display_t *: The display
+  const uint8_t *: Columns from DM_RenderMessage
+  uint16_t: The number of columns
+
+ Returns
+  Nothing (void)
+
+ Description
+  Replaces the contents of the display buffer with the columns, the last
+  of them at the right, as if the buffer had been cleared and each scrolled
+  in with DM_ScrollInColumn.
+
+Example
+   DM_PutColumnsIntoBuffer(&LEDDisplay, Columns, NumColumns);
+   DM_StartDisplayUpdate(&LEDDisplay);
  ****************************************************************************/
-void DM_AddChar2DisplayBuffer(unsigned char Char2Display);
+void DM_PutColumnsIntoBuffer(DM_Display_t *pDisplay, const uint8_t *pColumns,
+    uint16_t NumColumns);
 
 /****************************************************************************
  Function
   DM_PutDataIntoBufferRow
 
  Parameter
+  DM_Display_t *: The display
   uint64_t: The new row data to be stored in the display buffer
   uint8_t:  The row (0->7) into which the data will be stored.
   
@@ -124,32 +327,36 @@ void DM_AddChar2DisplayBuffer(unsigned char Char2Display);
 
  Description
   Copies the raw data from the Data2Insert parameter into the specified row 
-  of the frame buffer 
+  of the frame buffer, as its right-most 64 columns. Any columns to the
+  left of those are cleared.
    
 Example
-   DM_PutDataInBufferRow(0x00000001, 0);
+   DM_PutDataIntoBufferRow(&LEDDisplay, 0x00000001, 0);
  ****************************************************************************/
-bool DM_PutDataIntoBufferRow(uint64_t Data2Insert, uint8_t WhichRow);
+bool DM_PutDataIntoBufferRow(DM_Display_t *pDisplay, uint64_t Data2Insert,
+    uint8_t WhichRow);
 
 /****************************************************************************
  Function
   DM_QueryRowData
 
  Parameter
+  DM_Display_t *: The display
   uint8_t: The row of the display buffer to be queried
-  uint32_t *: pointer to variable to hold the data from the buffer 
+  uint64_t *: pointer to variable to hold the data from the buffer 
   
  Returns
   bool: true for a legal row number; false otherwise
 
  Description
-  copies the contents of the specified row of the frame buffer into the
- location pointed to by pReturnValue
+  copies the right-most 64 columns of the specified row of the frame buffer
+ into the location pointed to by pReturnValue
    
 Example
-   DM_QueryRowData(0,&ReturnedValue);
+   DM_QueryRowData(&LEDDisplay, 0, &ReturnedValue);
  ****************************************************************************/
-bool DM_QueryRowData(uint8_t RowToQuery, uint64_t * pReturnValue);
+bool DM_QueryRowData(DM_Display_t *pDisplay, uint8_t RowToQuery,
+    uint64_t * pReturnValue);
 
 #endif	/* DM_DISPLAY_H */
 
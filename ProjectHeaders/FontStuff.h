@@ -12,7 +12,26 @@
 extern "C" {
 #endif
 
-uint8_t getFontLine(unsigned char data, int line_num);
+// the font covers the printable ASCII characters, 6 rows of 4 columns each
+#define FONT_FIRST_CHAR 32
+#define FONT_NUM_CHARS  96
+#define FONT_NUM_ROWS   6
+
+// every row of every character, made from font4x6 by HostSim/FontTableGen.c
+extern const uint8_t FontLines[FONT_NUM_CHARS][FONT_NUM_ROWS];
+
+// unpacks a row of a character from font4x6, for the generator
+uint8_t DecodeFontLine(unsigned char data, int line_num);
+
+// a row of a character, with the pixels in bits 3 (left) to 1 and bit 0
+// blank; 0 for rows and characters that the font does not have
+static inline uint8_t getFontLine(unsigned char data, int line_num) {
+    const uint8_t index = (uint8_t) (data - FONT_FIRST_CHAR);
+    if ((index >= FONT_NUM_CHARS) || ((unsigned) line_num >= FONT_NUM_ROWS)) {
+        return 0;
+    }
+    return FontLines[index][line_num];
+}
 
 
 #ifdef	__cplusplus
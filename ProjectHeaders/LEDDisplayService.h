@@ -6,11 +6,13 @@
  * This module takes Events from the RocketLaunchGameFSM to repeatedly scroll,
  * scroll once, or display (without scrolling) a pre-set message
  * 
+ * Each message is rendered into pixel columns once, when it arrives, and
+ * scrolled in a column at a time by posting ES_NEW_COLUMN to LEDFSM
  * 
  * Events this service responds to:
- **** ES_NEW_MESSAGE, ES_CLEAR_MESSAGE, ES_KEEP_UDPATING (Internal), ES_TIMEOUT (Internal)
+ **** ES_NEW_MESSAGE, ES_CLEAR_MESSAGE, ES_TIMEOUT (Internal)
  * Events this service posts:
- **** ES_FINISHED_SCROLLING 
+ **** ES_FINISHED_SCROLLING, ES_NEW_COLUMN (to LEDFSM)
  ****************************************************************************/
 
 #ifndef LED_DISPLAY_SERVICE_H
@@ -23,6 +25,28 @@ predetermined at the start of the game to this service
 */
 extern char* currentMessage; // pointer to the current message string
 
+/* The preset messages, in the order of LED_ID_t. HostSim/FontTableGen.c
+ * renders each into MessageBitmaps, so after changing them rebuild
+ * ProjectSource/FontTables.c as its notes say
+*/
+#define LED_MESSAGE_LIST \
+  LED_MESSAGE("Welcome! Please Insert 2 Poker Chips to Begin.    ") \
+  LED_MESSAGE("1 Chip Inserted") \
+  LED_MESSAGE("Use handles to push rocket down.    ") \
+  LED_MESSAGE("Repeat sequence by pressing RGB buttons ") \
+  LED_MESSAGE("Set Difficulty") \
+  LED_MESSAGE("NO USER INPUT. RESETTING.") \
+  // Insert new messages here
+
+// a preset message as the pixel columns that DM_RenderMessage would make
+typedef struct {
+  const uint8_t *pColumns;
+  uint16_t NumColumns;
+} LED_MessageBitmap_t;
+
+// in flash, one for each of LED_MESSAGE_LIST
+extern const LED_MessageBitmap_t MessageBitmaps[];
+
 /* Enums to represent msgID and dispInstructions values
  * Allows for uniform communications between RocketLaunchGameFSM and this service
 */
@@ -11,6 +11,10 @@
 // Event Definitions
 #include "ES_Configure.h" /* gets us event definitions */
 #include "ES_Types.h"     /* gets bool type for returns */
+#include "DM_Display.h"
+
+// the display that this machine draws on, for the services that fill it
+extern DM_Display_t LEDDisplay;
 
 // typedefs for the states
 // State definitions for use with the query function
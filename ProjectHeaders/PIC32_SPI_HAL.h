@@ -504,6 +504,46 @@ Example
 ****************************************************************************/
 void SPIOperate_SPI1_Send32Wait(uint32_t TheData);
 
+/****************************************************************************
+ Function
+    SPIOperate_SPI2_Send16
+
+ Parameters
+   uint16_t:     The Data to be written
+
+ Returns
+  Nothing
+
+ Description
+   Writes the 16-bit data to the SPI2 Module data register
+  Does not check if there is room in the buffer.
+   
+Example
+   SPIOperate_SPI2_Send16(0);
+****************************************************************************/
+void SPIOperate_SPI2_Send16( uint16_t TheData);
+
+/****************************************************************************
+  Function
+    SPIOperate_SPI2_Send16Wait
+
+  Parameters
+    uint16_t:     The Data to be written
+
+  Returns
+    Nothing
+
+  Description
+    Writes the 16-bit data to the SPI2 Module data register and waits
+    for the SS2 line to rise. The same blocking code as
+    SPIOperate_SPI1_Send16Wait.
+    Does not check if there is room in the buffer.
+   
+Example
+   SPIOperate_SPI2_Send16Wait(0);
+****************************************************************************/
+void SPIOperate_SPI2_Send16Wait( uint16_t TheData);
+
 /****************************************************************************
  Function
     SPIOperate_ReadData
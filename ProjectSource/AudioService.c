@@ -26,7 +26,7 @@ void SetPins(int8_t value);
 // with the introduction of Gen2, we need a module level Priority variable
 static uint8_t MyPriority;
 
-static ES_Event_t DeferralQueue[10 + 1];
+static ES_Event_t DeferralQueue[16 + 1];
 
 static bool SignalingInProgressState;
 static bool SignalingAfterDelayState;
@@ -55,6 +55,10 @@ bool InitAudioService(uint8_t Priority) {
   ES_Event_t ThisEvent;
 
   MyPriority = Priority;
+#ifdef TEST_AUDIO_SERVICE
+  // the test keystrokes arrive by ES_PostAll
+  ES_AddSubscriptions(MyPriority, ES_EVENT_BIT(ES_NEW_KEY));
+#endif
   /********************************************
    in here you write your initialization code
    *******************************************/
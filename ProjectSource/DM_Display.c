@@ -1,3 +1,4 @@
+//#define TEST
 /****************************************************************************
  Module
      DM_Display.c
@@ -5,59 +6,114 @@
      Source file for the Dot Matrix LED Hardware Abstraction Layer 
      used in ME218
  Notes
-     This file has been edited to control a 64x8 pixel display
+     This file has been edited to control chains of any number of 8x8
+     modules. Each chain is a DM_Display_t on an SPI module of its own, so
+     there can be a display on SPI1 and another on SPI2. A row of the buffer
+     is a 32 bit word for every 4 modules, and scrolls with shifts that
+     carry from word to word, so the work of a frame grows with the number
+     of modules and no faster.
+     DM_StartDisplayUpdate sends the display from the interrupt on the rise
+     of SS (INT4 for SS1, INT1 for SS2), a row per interrupt, and posts
+     ES_UPDATE_COMPLETE to the service given to DM_InitDisplayRefresh when
+     the last row is latched. A row of more than the DM_FIFO_WORDS that the
+     enhanced buffer holds is topped up from the SPI TX interrupt each time
+     the buffer is half empty, so SS stays low until the whole row is out.
+     Only the rows that have changed since they were last sent go out, and
+     frames start at least DM_FRAME_PERIOD apart; an update asked for sooner
+     is held back and merged with any that follow it.
+     DM_RenderMessage turns a string into columns once, so that a message
+     can be scrolled in a pixel column at a time by DM_ScrollInColumn with
+     no font lookups along the way.
  History
  When           Who     What/Why
  -------------- ---     --------
   10/03/21 12:32  jec     started coding
   2023-10-18      klg     Aligned DM_AddChar2DisplayBuffer
   2024-11-10      jlp     modify for two screens
+  10/18/26 02:10  agt     interrupt driven whole frame refresh
+  10/18/26 02:50  agt     only changed rows are sent, frames are paced
+  10/18/26 03:30  agt     messages rendered to columns, scrolled a column
+                          at a time
+  10/18/26 04:50  agt     any number of modules, a display on each SPI
  *****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
 #include <xc.h>
+#include <sys/attribs.h>
 #include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_Framework.h"
 #include "PIC32_SPI_HAL.h"
 #include "DM_Display.h"
 #include "FontStuff.h"
+#ifndef __XC32
+#include "PIC32Sim.h" // on the host, the register model takes the interrupts
+#endif
 
 /*----------------------------- Module Defines ----------------------------*/
-#define NumModules 8
-#define NUM_ROWS   8
 #define NUM_ROWS_IN_FONT 6
+// the left-most of the DM_COLUMNS_PER_CHAR columns in a line of the font
+#define FONT_FIRST_COLUMN 0x08
 #define DM_START_SHUTDOWN 0x0C00
 #define DM_END_SHUTDOWN   0x0C01
 #define DM_DISABLE_CODEB  0x0900
 #define DM_ENABLE_SCAN    0x0B07
 #define DM_SET_BRIGHT     0x0A00
+// the SPI bit time, in ns
+#define DM_BIT_TIME 10000
+// the 16 bit words that the SPI enhanced buffer holds. The TX interrupt
+// comes when it is half empty, with a row still to go, and tops it up with
+// DM_FIFO_WORDS / 2 more, 640us before it would run dry at DM_BIT_TIME
+#define DM_FIFO_WORDS 8
+// the refresh is background work, below the framework's timer tick
+#define REFRESH_INT_PRIORITY 2
+// the shortest time between the starts of two frames, in ms
+#ifndef DM_FRAME_PERIOD
+#define DM_FRAME_PERIOD 20
+#endif
 
 /*------------------------------ Module Types -----------------------------*/
-// this union definition assumes that the display is made up of 4 modules
-// 4 modules x 8 bits/module = 32 bits total
-// this union allows us to easily scroll the whole buffer, using the uint32_t
-// while picking out the individual bytes to send them to the controllers
-
-typedef union {
-  uint64_t FullRow;
-  uint8_t ByBytes[NumModules];
-} DM_Row_t;
-
 typedef enum {
   DM_StepStartShutdown = 0, DM_StepFillBufferZeros,
   DM_StepDisableCodeB, DM_StepEnableScanAll, DM_StepSetBrighness,
   DM_StepCopyBuffer2Display, DM_StepEndShutdown
 } InitStep_t;
 
+// what a display needs of the SPI module that it is on
+typedef struct {
+  uint32_t SSFlag; // the INT that catches the rise of SS, in IFS0 and IEC0
+  uint32_t TxFlag; // the SPI TX interrupt, in IFS1 and IEC1
+  void (*pSend16)(uint16_t TheData);
+  void (*pSend16Wait)(uint16_t TheData);
+} DM_Bus_t;
+
 /*---------------------------- Module Functions ---------------------------*/
-static void sendCmd(uint16_t Cmd2Send);
-static void sendRow(uint8_t RowNum, DM_Row_t RowData);
+static uint32_t *getRow(DM_Display_t *pDisplay, uint8_t WhichRow);
+static void sendCmd(DM_Display_t *pDisplay, uint16_t Cmd2Send);
+static void sendRow(DM_Display_t *pDisplay, uint8_t RowNum);
+static void waitForRoom(DM_Display_t *pDisplay, uint8_t WordsSent);
+static void startFrame(DM_Display_t *pDisplay);
+static uint8_t buildFrame(DM_Display_t *pDisplay);
+static void sendFrameRow(DM_Display_t *pDisplay);
+static bool feedFrameRow(DM_Display_t *pDisplay, uint8_t MaxWords);
+static void refreshRow(DM_Display_t *pDisplay);
+static void feedRow(DM_Display_t *pDisplay);
+static void governorTimeout(ES_EventParam_t Param);
+void DM_RefreshISR1(void);
+void DM_RefreshISR2(void);
+void DM_FeedISR1(void);
+void DM_FeedISR2(void);
 
 /*---------------------------- Module Variables ---------------------------*/
-// We make the display buffer from an array of these unions, one for each 
-// row in the display
-static DM_Row_t DM_Display[NUM_ROWS];
+// indexed by SPI_Module_t
+static const DM_Bus_t Buses[] = {
+  { _IFS0_INT4IF_MASK, _IFS1_SPI1TXIF_MASK, SPIOperate_SPI1_Send16,
+    SPIOperate_SPI1_Send16Wait },
+  { _IFS0_INT1IF_MASK, _IFS1_SPI2TXIF_MASK, SPIOperate_SPI2_Send16,
+    SPIOperate_SPI2_Send16Wait }
+};
 
-// this is the state variable for tracking init steps
-static InitStep_t CurrentInitStep = DM_StepStartShutdown;
+// the display on each SPI module, for its interrupts and governor timer
+static DM_Display_t *Displays[ARRAY_SIZE(Buses)];
 
 // In order to keep up with the display at 10MHz, the bit reverse operation
 // must be as fast as possible, hence the look-up table approach is the only
@@ -86,8 +142,71 @@ static const uint8_t BitReverseTable256[] = {
 };
 
 
+
+
 /*------------------------------ Module Code ------------------------------*/
 
+/****************************************************************************
+ Function
+  DM_InitDisplay
+
+ Description
+  Sets up the SPI module for the chain as the MAX7219s need it: 16 bit
+  words with the enhanced buffer, SS and SDO on the given pins, and the TX
+  interrupt, for when a row does not fit in the buffer, to come when it is
+  half empty. Then clears the display buffer and ties the display to the
+  SPI module, for the interrupts. A display set up again, between frames,
+  e.g. for a chain of another length, keeps what DM_InitDisplayRefresh
+  set up.
+ ****************************************************************************/
+bool DM_InitDisplay(DM_Display_t *pDisplay, SPI_Module_t WhichSPI,
+    SPI_PinMap_t SSPin, SPI_PinMap_t SDPin, uint8_t NumModules,
+    uint32_t *pRows, uint16_t *pFrame) {
+  if ((WhichSPI >= ARRAY_SIZE(Buses)) || (0 == NumModules) ||
+      ((NULL != Displays[WhichSPI]) && (pDisplay != Displays[WhichSPI]))) {
+    return false;
+  }
+  SPISetup_BasicConfig(WhichSPI);
+  SPISetup_SetLeader(WhichSPI, SPI_SMP_MID);
+  SPISetup_SetBitTime(WhichSPI, DM_BIT_TIME);
+  if ((false == SPISetup_MapSSOutput(WhichSPI, SSPin)) ||
+      (false == SPISetup_MapSDOutput(WhichSPI, SDPin))) {
+    return false;
+  }
+  SPISetup_SetClockIdleState(WhichSPI, SPI_CLK_LO);
+  SPISetup_SetActiveEdge(WhichSPI, SPI_FIRST_EDGE);
+  SPISetup_SetXferWidth(WhichSPI, SPI_16BIT);
+  SPISetEnhancedBuffer(WhichSPI, true);
+  if (SPI_SPI1 == WhichSPI) {
+    SPI1CONbits.STXISEL = 0b10; // TX interrupt when half empty
+  } else {
+    SPI2CONbits.STXISEL = 0b10;
+  }
+  SPISetup_EnableSPI(WhichSPI);
+
+  pDisplay->WhichSPI = WhichSPI;
+  pDisplay->NumModules = NumModules;
+  pDisplay->NumWords = DM_ROW_WORDS(NumModules);
+  // the top word only has a byte for each of the modules left over
+  pDisplay->TopMask = (0 == (NumModules % 4)) ? 0xFFFFFFFFUL :
+    ((1UL << (8 * (NumModules % 4))) - 1);
+  pDisplay->pRows = pRows;
+  pDisplay->pFrame = pFrame;
+  for (uint16_t index = 0; index < DM_ROWS_LEN(NumModules); index++) {
+    pRows[index] = 0;
+  }
+  pDisplay->DirtyRows = 0;
+  pDisplay->InitStep = DM_StepStartShutdown;
+  pDisplay->UpdateRow = 0;
+  pDisplay->NumFrameRows = 0;
+  pDisplay->NextRow = 0;
+  pDisplay->IsRefreshing = false;
+  pDisplay->IsFrameRequested = false;
+  pDisplay->IsGoverning = false;
+  Displays[WhichSPI] = pDisplay;
+  return true;
+}
+
 /****************************************************************************
  Function
   DM_TakeInitDisplayStep
@@ -102,17 +221,16 @@ static const uint8_t BitReverseTable256[] = {
     Copy our display buffer to the display, return false
     Finally, bring it out of shutdown and return true
  ****************************************************************************/
-bool DM_TakeInitDisplayStep(void) {
-  static uint8_t rowIndex = 0;
+bool DM_TakeInitDisplayStep(DM_Display_t *pDisplay) {
   bool ReturnVal = false;
 
-  switch (CurrentInitStep) {
+  switch (pDisplay->InitStep) {
     case DM_StepStartShutdown:
       // First, bring put it in shutdown to disable all displays
       // move on to next step
     {
-      sendCmd(DM_START_SHUTDOWN);
-      CurrentInitStep++;
+      sendCmd(pDisplay, DM_START_SHUTDOWN);
+      pDisplay->InitStep++;
     }
       break;
 
@@ -120,8 +238,8 @@ bool DM_TakeInitDisplayStep(void) {
       // fill the buffer with Zeros
       // move on to next step
     {
-      DM_ClearDisplayBuffer();
-      CurrentInitStep++;
+      DM_ClearDisplayBuffer(pDisplay);
+      pDisplay->InitStep++;
     }
       break;
 
@@ -129,8 +247,8 @@ bool DM_TakeInitDisplayStep(void) {
       // Next Disable Code B decoding for all digits
       // move on to next step
     {
-      sendCmd(DM_DISABLE_CODEB);
-      CurrentInitStep++;
+      sendCmd(pDisplay, DM_DISABLE_CODEB);
+      pDisplay->InitStep++;
     }
       break;
 
@@ -138,8 +256,8 @@ bool DM_TakeInitDisplayStep(void) {
       // Then, enable scanning for all digits
       // move on to next step
     {
-      sendCmd(DM_ENABLE_SCAN);
-      CurrentInitStep++;
+      sendCmd(pDisplay, DM_ENABLE_SCAN);
+      pDisplay->InitStep++;
     }
       break;
 
@@ -147,15 +265,15 @@ bool DM_TakeInitDisplayStep(void) {
       // The next setup step is to set the brightness to minimum
       // move on to next step
     {
-      sendCmd(DM_SET_BRIGHT);
-      CurrentInitStep++;
+      sendCmd(pDisplay, DM_SET_BRIGHT);
+      pDisplay->InitStep++;
     }
       break;
 
     case DM_StepCopyBuffer2Display: // copy our display buffer to the display
     {
-      if (true == DM_TakeDisplayUpdateStep()) {
-        CurrentInitStep++; // move on to next step
+      if (true == DM_TakeDisplayUpdateStep(pDisplay)) {
+        pDisplay->InitStep++; // move on to next step
       }
     }
       break;
@@ -165,8 +283,8 @@ bool DM_TakeInitDisplayStep(void) {
       // prepare for a re-init
       // let the caller know that we are done
     {
-      sendCmd(DM_END_SHUTDOWN);
-      CurrentInitStep = DM_StepStartShutdown;
+      sendCmd(pDisplay, DM_END_SHUTDOWN);
+      pDisplay->InitStep = DM_StepStartShutdown;
       ReturnVal = true;
     }
       break;
@@ -186,32 +304,158 @@ bool DM_TakeInitDisplayStep(void) {
   Copies the contents of the display buffer to the MAX7219 controllers 1 row
   per call.
  ****************************************************************************/
-bool DM_TakeDisplayUpdateStep(void) {
+bool DM_TakeDisplayUpdateStep(DM_Display_t *pDisplay) {
   bool ReturnVal = false;
-  static int8_t WhichRow = 0;
+  uint8_t WhichRow = pDisplay->UpdateRow;
 
-  sendRow(WhichRow, DM_Display[WhichRow]);
+  sendRow(pDisplay, WhichRow);
+  pDisplay->DirtyRows &= ~(1 << WhichRow);
   // check when we are done sending rows
-  if (WhichRow == NUM_ROWS - 1) {
+  if (WhichRow == DM_NUM_ROWS - 1) {
     ReturnVal = true; // show we are done
-    WhichRow = 0; // set up for next update
+    pDisplay->UpdateRow = 0; // set up for next update
   } else {
-    WhichRow++;
+    pDisplay->UpdateRow++;
   }
   return ReturnVal;
 }
 
+/****************************************************************************
+ Function
+  DM_InitDisplayRefresh
+
+ Description
+  Sets up the interrupts that DM_StartDisplayUpdate runs from, the mailbox
+  that the ES_UPDATE_COMPLETE events are posted through and the timer that
+  paces the frames. The INT on the SS pin (INT4 for SPI1, INT1 for SPI2) is
+  already set to catch its rise by SPISetup_MapSSOutput
+ ****************************************************************************/
+bool DM_InitDisplayRefresh(DM_Display_t *pDisplay, uint8_t WhichService) {
+  const DM_Bus_t *pBus = &Buses[pDisplay->WhichSPI];
+
+  if (false == ES_Mailbox_Init(&pDisplay->RefreshMailbox,
+      pDisplay->RefreshSlots, ARRAY_SIZE(pDisplay->RefreshSlots),
+      WhichService)) {
+    return false;
+  }
+  // the callback finds the display from its SPI module
+  pDisplay->GovernorTimer = ES_Timer_AllocCallback(governorTimeout,
+      pDisplay->WhichSPI);
+  if (ES_TIMER_NO_HANDLE == pDisplay->GovernorTimer) {
+    return false;
+  }
+  pDisplay->RefreshService = WhichService;
+  IEC0CLR = pBus->SSFlag;
+  IEC1CLR = pBus->TxFlag;
+  if (SPI_SPI1 == pDisplay->WhichSPI) {
+    IPC4bits.INT4IP = REFRESH_INT_PRIORITY;
+    IPC4bits.INT4IS = 0;
+    IPC7bits.SPI1IP = REFRESH_INT_PRIORITY;
+    IPC7bits.SPI1IS = 0;
+#ifndef __XC32
+    // the host has no interrupts of its own, the model takes these for us
+    PIC32Sim_AttachISR(_IFS0_INT4IF_MASK, 0, DM_RefreshISR1);
+    PIC32Sim_AttachISR(0, _IFS1_SPI1TXIF_MASK, DM_FeedISR1);
+#endif
+  } else {
+    IPC1bits.INT1IP = REFRESH_INT_PRIORITY;
+    IPC1bits.INT1IS = 0;
+    IPC9bits.SPI2IP = REFRESH_INT_PRIORITY;
+    IPC9bits.SPI2IS = 0;
+#ifndef __XC32
+    PIC32Sim_AttachISR(_IFS0_INT1IF_MASK, 0, DM_RefreshISR2);
+    PIC32Sim_AttachISR(0, _IFS1_SPI2TXIF_MASK, DM_FeedISR2);
+#endif
+  }
+  return true;
+}
+
+/****************************************************************************
+ Function
+  DM_StartDisplayUpdate
+
+ Description
+  Sends the rows of the display buffer that have changed, unless a frame is
+  still going out or started less than DM_FRAME_PERIOD ago. Then the update
+  waits for the governor timer, along with any others asked for by then,
+  and one ES_UPDATE_COMPLETE covers them all
+ ****************************************************************************/
+void DM_StartDisplayUpdate(DM_Display_t *pDisplay) {
+  if (pDisplay->IsGoverning) {
+    pDisplay->IsFrameRequested = true;
+  } else {
+    startFrame(pDisplay);
+  }
+}
+
+/****************************************************************************
+ Function
+  DM_RefreshISR1, DM_RefreshISR2
+
+ Description
+  SS1 (INT4) or SS2 (INT1) has risen, so the MAX7219s of the display on
+  that SPI module have latched the row that was sent
+ ****************************************************************************/
+void __ISR(_EXTERNAL_4_VECTOR, IPL2SOFT) DM_RefreshISR1(void) {
+  refreshRow(Displays[SPI_SPI1]);
+}
+
+void __ISR(_EXTERNAL_1_VECTOR, IPL2SOFT) DM_RefreshISR2(void) {
+  refreshRow(Displays[SPI_SPI2]);
+}
+
+/****************************************************************************
+ Function
+  DM_FeedISR1, DM_FeedISR2
+
+ Description
+  The SPI1 or SPI2 enhanced buffer is half empty, with more of the row that
+  is going out still to be sent. Only the TX interrupt of the SPI vector is
+  used
+ ****************************************************************************/
+void __ISR(_SPI_1_VECTOR, IPL2SOFT) DM_FeedISR1(void) {
+  feedRow(Displays[SPI_SPI1]);
+}
+
+void __ISR(_SPI_2_VECTOR, IPL2SOFT) DM_FeedISR2(void) {
+  feedRow(Displays[SPI_SPI2]);
+}
+
 /****************************************************************************
  Function
   DM_ScrollDisplayBuffer
  Description
   Scrolls the contents of the display buffer by the indicated number of 
-  columns. Makes use of the FullRow member to scroll all modules at once
+  columns. Each row is shifted a whole word at a time, with the bits that
+  leave the top of a word carried into the bottom of the next, from the top
+  word down so that every word is made before the ones under it change
  ****************************************************************************/
-void DM_ScrollDisplayBuffer(uint8_t NumCols2Scroll) {
-  for (uint8_t WhichRow = 0; WhichRow < NUM_ROWS; WhichRow++) {
-    DM_Display[WhichRow].FullRow =
-      DM_Display[WhichRow].FullRow << NumCols2Scroll;
+void DM_ScrollDisplayBuffer(DM_Display_t *pDisplay, uint8_t NumCols2Scroll) {
+  uint8_t WordShift = NumCols2Scroll / 32;
+  uint8_t BitShift = NumCols2Scroll % 32;
+  uint8_t TopWord = pDisplay->NumWords - 1;
+
+  for (uint8_t WhichRow = 0; WhichRow < DM_NUM_ROWS; WhichRow++) {
+    uint32_t *pRow = getRow(pDisplay, WhichRow);
+    uint32_t Changed = 0;
+    for (uint8_t WhichWord = pDisplay->NumWords; WhichWord-- > 0;) {
+      uint32_t NewWord = 0;
+      if (WhichWord >= WordShift) {
+        NewWord = pRow[WhichWord - WordShift] << BitShift;
+        if ((0 != BitShift) && (WhichWord > WordShift)) {
+          NewWord |= pRow[WhichWord - WordShift - 1] >> (32 - BitShift);
+        }
+      }
+      if (TopWord == WhichWord) {
+        NewWord &= pDisplay->TopMask;
+      }
+      Changed |= NewWord ^ pRow[WhichWord];
+      pRow[WhichWord] = NewWord;
+    }
+    // a blank row scrolls to the same blank row
+    if (0 != Changed) {
+      pDisplay->DirtyRows |= 1 << WhichRow;
+    }
   }
 }
 
@@ -223,11 +467,126 @@ void DM_ScrollDisplayBuffer(uint8_t NumCols2Scroll) {
   Copies the bitmap data from the font file into the rows of the frame buffer
   at the right-most character position in the buffer  
  ****************************************************************************/
-void DM_AddChar2DisplayBuffer(unsigned char Char2Display) {
+void DM_AddChar2DisplayBuffer(DM_Display_t *pDisplay,
+    unsigned char Char2Display) {
   uint8_t WhichRow;
   // loop for every row in the character font
   for (WhichRow = 0; WhichRow < NUM_ROWS_IN_FONT; WhichRow++) {
-    DM_Display[WhichRow].ByBytes[0] |= getFontLine(Char2Display, WhichRow);
+    uint32_t *pRow = getRow(pDisplay, WhichRow);
+    uint8_t FontLine = getFontLine(Char2Display, WhichRow);
+    // a row is only changed if the character has pixels in it, the
+    // right-most module is the low byte of the first word
+    if ((pRow[0] | FontLine) != pRow[0]) {
+      pRow[0] |= FontLine;
+      pDisplay->DirtyRows |= 1 << WhichRow;
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+  DM_RenderMessage
+
+ Description
+  Looks up the font of each character of the message and stores it as
+  DM_COLUMNS_PER_CHAR columns, left to right, bit n of each for row n. The
+  columns are what DM_ScrollDisplayBuffer(4) and DM_AddChar2DisplayBuffer
+  would have put into the right of the buffer, a column at a time. Stops at
+  the end of the string or when MaxColumns are filled and returns the
+  number of columns
+ ****************************************************************************/
+uint16_t DM_RenderMessage(const char *pMessage, uint8_t *pColumns,
+    uint16_t MaxColumns) {
+  uint16_t NumColumns = 0;
+  while (('\0' != *pMessage) &&
+      (NumColumns + DM_COLUMNS_PER_CHAR <= MaxColumns)) {
+    uint8_t *pCharColumns = &pColumns[NumColumns];
+    for (uint8_t WhichColumn = 0; WhichColumn < DM_COLUMNS_PER_CHAR;
+        WhichColumn++) {
+      pCharColumns[WhichColumn] = 0;
+    }
+    for (uint8_t WhichRow = 0; WhichRow < NUM_ROWS_IN_FONT; WhichRow++) {
+      uint8_t FontLine = getFontLine(*pMessage, WhichRow);
+      for (uint8_t WhichColumn = 0; WhichColumn < DM_COLUMNS_PER_CHAR;
+          WhichColumn++) {
+        if (FontLine & (FONT_FIRST_COLUMN >> WhichColumn)) {
+          pCharColumns[WhichColumn] |= 1 << WhichRow;
+        }
+      }
+    }
+    NumColumns += DM_COLUMNS_PER_CHAR;
+    pMessage++;
+  }
+  return NumColumns;
+}
+
+/****************************************************************************
+ Function
+  DM_ScrollInColumn
+
+ Description
+  Scrolls the display buffer by 1 column and puts Column, from
+  DM_RenderMessage, into the right-most column. The bit that leaves the top
+  of each word is carried into the bottom of the next
+ ****************************************************************************/
+void DM_ScrollInColumn(DM_Display_t *pDisplay, uint8_t Column) {
+  uint8_t TopWord = pDisplay->NumWords - 1;
+
+  for (uint8_t WhichRow = 0; WhichRow < DM_NUM_ROWS; WhichRow++) {
+    uint32_t *pRow = getRow(pDisplay, WhichRow);
+    uint32_t Carry = (Column >> WhichRow) & 1;
+    uint32_t Changed = 0;
+    for (uint8_t WhichWord = 0; WhichWord <= TopWord; WhichWord++) {
+      uint32_t OldWord = pRow[WhichWord];
+      uint32_t NewWord = (OldWord << 1) | Carry;
+      Carry = OldWord >> 31;
+      if (TopWord == WhichWord) {
+        NewWord &= pDisplay->TopMask;
+      }
+      Changed |= NewWord ^ OldWord;
+      pRow[WhichWord] = NewWord;
+    }
+    if (0 != Changed) {
+      pDisplay->DirtyRows |= 1 << WhichRow;
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+  DM_PutColumnsIntoBuffer
+
+ Description
+  Fills the display buffer as if it had been cleared and all of the columns
+  scrolled in, so the last of them ends up at the right. Only the last
+  8 columns of each module can be seen, so only those are put in
+ ****************************************************************************/
+void DM_PutColumnsIntoBuffer(DM_Display_t *pDisplay, const uint8_t *pColumns,
+    uint16_t NumColumns) {
+  uint16_t NumShown = (uint16_t) pDisplay->NumModules * 8;
+
+  if (NumColumns > NumShown) {
+    pColumns += NumColumns - NumShown;
+    NumColumns = NumShown;
+  }
+  for (uint8_t WhichRow = 0; WhichRow < DM_NUM_ROWS; WhichRow++) {
+    uint32_t *pRow = getRow(pDisplay, WhichRow);
+    // from the right-most column, bit 0 of the first word, to the left
+    const uint8_t *pColumn = &pColumns[NumColumns];
+    uint16_t ColumnsLeft = NumColumns;
+    uint32_t Changed = 0;
+    for (uint8_t WhichWord = 0; WhichWord < pDisplay->NumWords; WhichWord++) {
+      uint32_t NewWord = 0;
+      for (uint8_t Bit = 0; (Bit < 32) && (ColumnsLeft > 0); Bit++) {
+        NewWord |= (uint32_t) ((*--pColumn >> WhichRow) & 1) << Bit;
+        ColumnsLeft--;
+      }
+      Changed |= NewWord ^ pRow[WhichWord];
+      pRow[WhichWord] = NewWord;
+    }
+    if (0 != Changed) {
+      pDisplay->DirtyRows |= 1 << WhichRow;
+    }
   }
 }
 
@@ -238,10 +597,16 @@ void DM_AddChar2DisplayBuffer(unsigned char Char2Display) {
  Description
   Clears the contents of the display buffer by filling it with zeros.
  ****************************************************************************/
-void DM_ClearDisplayBuffer(void) {
+void DM_ClearDisplayBuffer(DM_Display_t *pDisplay) {
   uint8_t rowIndex;
-  for (rowIndex = 0; rowIndex < NUM_ROWS; rowIndex++) {
-    DM_Display[rowIndex].FullRow = 0;
+  for (rowIndex = 0; rowIndex < DM_NUM_ROWS; rowIndex++) {
+    uint32_t *pRow = getRow(pDisplay, rowIndex);
+    for (uint8_t WhichWord = 0; WhichWord < pDisplay->NumWords; WhichWord++) {
+      if (0 != pRow[WhichWord]) {
+        pRow[WhichWord] = 0;
+        pDisplay->DirtyRows |= 1 << rowIndex;
+      }
+    }
   }
 }
 
@@ -251,14 +616,29 @@ void DM_ClearDisplayBuffer(void) {
 
  Description
   Copies the raw data from the Data2Insert parameter into the specified row 
-  of the frame buffer 
+  of the frame buffer, the right-most 64 columns of it, and clears the rest
  ****************************************************************************/
-bool DM_PutDataIntoBufferRow(uint64_t Data2Insert, uint8_t WhichRow) {
+bool DM_PutDataIntoBufferRow(DM_Display_t *pDisplay, uint64_t Data2Insert,
+    uint8_t WhichRow) {
   bool ReturnVal = true;
   // test for legal row
-  if (0 <= WhichRow && NUM_ROWS - 1 >= WhichRow) {
+  if (DM_NUM_ROWS - 1 >= WhichRow) {
     // legal row, so stuff the data into the buffer
-    DM_Display[WhichRow].FullRow = Data2Insert;
+    uint32_t *pRow = getRow(pDisplay, WhichRow);
+    uint8_t TopWord = pDisplay->NumWords - 1;
+    uint32_t Changed = 0;
+    for (uint8_t WhichWord = 0; WhichWord <= TopWord; WhichWord++) {
+      uint32_t NewWord = (WhichWord < 2) ?
+        (uint32_t) (Data2Insert >> (32 * WhichWord)) : 0;
+      if (TopWord == WhichWord) {
+        NewWord &= pDisplay->TopMask;
+      }
+      Changed |= NewWord ^ pRow[WhichWord];
+      pRow[WhichWord] = NewWord;
+    }
+    if (0 != Changed) {
+      pDisplay->DirtyRows |= 1 << WhichRow;
+    }
   } else ReturnVal = false;
   return ReturnVal;
 }
@@ -268,16 +648,22 @@ bool DM_PutDataIntoBufferRow(uint64_t Data2Insert, uint8_t WhichRow) {
   DM_QueryRowData
 
  Description
-  copies the contents of the specified row of the frame buffer into the
- location pointed to by pReturnValue
+  copies the right-most 64 columns of the specified row of the frame buffer
+ into the location pointed to by pReturnValue
  ****************************************************************************/
-bool DM_QueryRowData(uint8_t RowToQuery, uint64_t * pReturnValue) {
+bool DM_QueryRowData(DM_Display_t *pDisplay, uint8_t RowToQuery,
+    uint64_t * pReturnValue) {
   bool ReturnVal = true;
   // test for legal row
-  if (0 <= RowToQuery && NUM_ROWS - 1 >= RowToQuery) {
+  if (DM_NUM_ROWS - 1 >= RowToQuery) {
     // legal row, so grab the data from the buffer
-    *pReturnValue = DM_Display[RowToQuery].FullRow;
+    uint32_t *pRow = getRow(pDisplay, RowToQuery);
+    *pReturnValue = pRow[0];
+    if (pDisplay->NumWords > 1) {
+      *pReturnValue |= (uint64_t) pRow[1] << 32;
+    }
   } else ReturnVal = false;
+  return ReturnVal;
 }
 
 
@@ -285,19 +671,35 @@ bool DM_QueryRowData(uint8_t RowToQuery, uint64_t * pReturnValue) {
 // private functions
 //*********************************
 
+/****************************************************************************
+ Function
+ getRow
+
+ Description
+  The first of the NumWords words of a row of the display buffer
+ ****************************************************************************/
+static uint32_t *getRow(DM_Display_t *pDisplay, uint8_t WhichRow) {
+  return &pDisplay->pRows[WhichRow * pDisplay->NumWords];
+}
+
 /****************************************************************************
  Function
  sendCmd
 
  Description
-  Send a single command to all 4 modules and waits for the SS to rise to
-  indicate completion.
+  Send a single command to all of the modules and waits for the SS to rise
+  to indicate completion.
  ****************************************************************************/
-static void sendCmd(uint16_t Cmd2Send) {
-  for (uint8_t index = 0; index < (NumModules - 1); index++) {
-    SPIOperate_SPI1_Send16(Cmd2Send);
+static void sendCmd(DM_Display_t *pDisplay, uint16_t Cmd2Send) {
+  const DM_Bus_t *pBus = &Buses[pDisplay->WhichSPI];
+  uint8_t index;
+
+  for (index = 0; index < (pDisplay->NumModules - 1); index++) {
+    waitForRoom(pDisplay, index);
+    pBus->pSend16(Cmd2Send);
   }
-  SPIOperate_SPI1_Send16Wait(Cmd2Send);
+  waitForRoom(pDisplay, index);
+  pBus->pSend16Wait(Cmd2Send);
 }
 
 /****************************************************************************
@@ -305,20 +707,669 @@ static void sendCmd(uint16_t Cmd2Send) {
  sendRow
 
  Description
-  Sends a row of data to the 4-module cluster. Translates from the logical
+  Sends a row of data to the chain of modules. Translates from the logical
  row number to the MAX7219 row numbers (mirrors)
  ****************************************************************************/
-static void sendRow(uint8_t RowNum, DM_Row_t RowData) {
-  // The rows on the display are mirrored relative to the rows in the memory
-  RowNum = NUM_ROWS - (RowNum + 1); // this will swap them top to bottom
-  // loop through, sending the first 3 values as fast as possible
+static void sendRow(DM_Display_t *pDisplay, uint8_t RowNum) {
+  const DM_Bus_t *pBus = &Buses[pDisplay->WhichSPI];
+  const uint32_t *pRow = getRow(pDisplay, RowNum);
+  // The rows on the display are mirrored relative to the rows in the memory,
+  // and the MAX7219 digit registers start at 1
+  uint16_t Digit = (uint16_t) (DM_NUM_ROWS - RowNum) << 8;
+  uint8_t LastModule = pDisplay->NumModules - 1;
   uint8_t index;
-  for (index = 0; index < (NumModules - 1); index++) {
-    SPIOperate_SPI1_Send16(((((uint16_t) RowNum + 1) << 8) |
-      BitReverseTable256[(RowData.ByBytes[index])]));
+
+  // loop through, sending all but the last module as fast as possible, a
+  // module to each byte of the row, from the bottom byte of the first word
+  for (index = 0; index <= LastModule; index++) {
+    uint8_t Byte = (uint8_t) (pRow[index / 4] >> (8 * (index % 4)));
+    waitForRoom(pDisplay, index);
+    if (index < LastModule) {
+      pBus->pSend16(Digit | BitReverseTable256[Byte]);
+    } else {
+      // then send the final byte and wait for the SS line to rise
+      pBus->pSend16Wait(Digit | BitReverseTable256[Byte]);
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+ waitForRoom
+
+ Description
+  Waits for the enhanced buffer to have room for another word, once a row
+  or command has filled it. The first DM_FIFO_WORDS always fit, as it has
+  emptied by the time SS rises at the end of the last row
+ ****************************************************************************/
+static void waitForRoom(DM_Display_t *pDisplay, uint8_t WordsSent) {
+  if (WordsSent >= DM_FIFO_WORDS) {
+    if (SPI_SPI1 == pDisplay->WhichSPI) {
+      while (SPI1STATbits.SPITBF) {
+      }
+    } else {
+      while (SPI2STATbits.SPITBF) {
+      }
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+ startFrame
+
+ Description
+  Sends the first of the changed rows and starts the governor timer, or, if
+  no row has changed, posts ES_UPDATE_COMPLETE straight away
+ ****************************************************************************/
+static void startFrame(DM_Display_t *pDisplay) {
+  uint32_t SSFlag = Buses[pDisplay->WhichSPI].SSFlag;
+
+  pDisplay->IsFrameRequested = false;
+  pDisplay->NumFrameRows = buildFrame(pDisplay);
+  if (0 == pDisplay->NumFrameRows) {
+    ES_Event_t DoneEvent = {ES_UPDATE_COMPLETE, 0};
+    pDisplay->IsGoverning = false;
+    ES_PostToService(pDisplay->RefreshService, DoneEvent);
+    return;
+  }
+  pDisplay->IsGoverning = true;
+  ES_Timer_InitTimer(pDisplay->GovernorTimer, DM_FRAME_PERIOD);
+  pDisplay->NextRow = 0;
+  pDisplay->NextWord = 0;
+  pDisplay->IsRefreshing = true;
+  IFS0CLR = SSFlag; // only the rise at the end of our row counts
+  sendFrameRow(pDisplay);
+  IEC0SET = SSFlag;
+}
+
+/****************************************************************************
+ Function
+ buildFrame
+
+ Description
+  Fills pFrame with the words that sendRow would send for each changed row,
+  in the same order, so that the ISR only has to copy them to the SPI. The
+  digit register in each word says which row it is, so the rows that have
+  not changed can be left out. Returns the number of rows
+ ****************************************************************************/
+static uint8_t buildFrame(DM_Display_t *pDisplay) {
+  uint16_t *pFrame = pDisplay->pFrame;
+  uint8_t NumRows = 0;
+  for (uint8_t WhichRow = 0; WhichRow < DM_NUM_ROWS; WhichRow++) {
+    if (pDisplay->DirtyRows & (1 << WhichRow)) {
+      const uint32_t *pRow = getRow(pDisplay, WhichRow);
+      // the rows are mirrored, and the MAX7219 digit registers start at 1
+      uint16_t Digit = (uint16_t) (DM_NUM_ROWS - WhichRow) << 8;
+      uint32_t Word = 0;
+      for (uint8_t index = 0; index < pDisplay->NumModules; index++) {
+        // a module to each byte, from the bottom of each word
+        if (0 == (index % 4)) {
+          Word = *pRow++;
+        }
+        *pFrame++ = Digit | BitReverseTable256[Word & 0xFF];
+        Word >>= 8;
+      }
+      NumRows++;
+    }
+  }
+  pDisplay->DirtyRows = 0;
+  return NumRows;
+}
+
+/****************************************************************************
+ Function
+ sendFrameRow
+
+ Description
+  Puts as much of the next row of the frame into the SPI buffer as it
+  holds, and if that is not all of it, has the TX interrupt feed it the
+  rest. SS stays low for the whole row and rises, latching it, once the
+  last word is out
+ ****************************************************************************/
+static void sendFrameRow(DM_Display_t *pDisplay) {
+  pDisplay->RowEnd = pDisplay->NextWord + pDisplay->NumModules;
+  pDisplay->NextRow++;
+  if (false == feedFrameRow(pDisplay, DM_FIFO_WORDS)) {
+    uint32_t TxFlag = Buses[pDisplay->WhichSPI].TxFlag;
+    IFS1CLR = TxFlag;
+    IEC1SET = TxFlag;
+  }
+}
+
+/****************************************************************************
+ Function
+ feedFrameRow
+
+ Description
+  Sends up to MaxWords more of the row going out. Returns true once all of
+  the row has been put into the SPI buffer
+ ****************************************************************************/
+static bool feedFrameRow(DM_Display_t *pDisplay, uint8_t MaxWords) {
+  void (*pSend16)(uint16_t) = Buses[pDisplay->WhichSPI].pSend16;
+  const uint16_t *pFrame = pDisplay->pFrame;
+  uint16_t NextWord = pDisplay->NextWord;
+  uint16_t StopWord = NextWord + MaxWords;
+
+  if (StopWord > pDisplay->RowEnd) {
+    StopWord = pDisplay->RowEnd;
+  }
+  while (NextWord < StopWord) {
+    pSend16(pFrame[NextWord++]);
+  }
+  pDisplay->NextWord = NextWord;
+  return NextWord == pDisplay->RowEnd;
+}
+
+/****************************************************************************
+ Function
+ refreshRow
+
+ Description
+  The SS rise of the display's SPI module. Sends the next row, or at the end
+  of the frame posts ES_UPDATE_COMPLETE, unless another update is waiting
+  to go out, which will post it instead
+ ****************************************************************************/
+static void refreshRow(DM_Display_t *pDisplay) {
+  uint32_t SSFlag = Buses[pDisplay->WhichSPI].SSFlag;
+
+  IFS0CLR = SSFlag;
+  if (pDisplay->NextRow < pDisplay->NumFrameRows) {
+    sendFrameRow(pDisplay);
+  } else {
+    IEC0CLR = SSFlag;
+    pDisplay->IsRefreshing = false;
+    if (false == pDisplay->IsFrameRequested) {
+      static const ES_Event_t DoneEvent = {ES_UPDATE_COMPLETE, 0};
+      ES_Mailbox_Post(&pDisplay->RefreshMailbox, DoneEvent);
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+ feedRow
+
+ Description
+  The TX interrupt of the display's SPI module: half of the buffer is free,
+  so tops it up. Once the row is all in, turns the interrupt off until the
+  next row that needs it
+ ****************************************************************************/
+static void feedRow(DM_Display_t *pDisplay) {
+  uint32_t TxFlag = Buses[pDisplay->WhichSPI].TxFlag;
+
+  if (feedFrameRow(pDisplay, DM_FIFO_WORDS / 2)) {
+    IEC1CLR = TxFlag;
+  }
+  IFS1CLR = TxFlag;
+}
+
+/****************************************************************************
+ Function
+ governorTimeout
+
+ Description
+  The callback of the governor timer, with the SPI module of its display.
+  Once the frame has gone out, sends any update that was held back, or lets
+  the next one go straight out
+ ****************************************************************************/
+static void governorTimeout(ES_EventParam_t Param) {
+  DM_Display_t *pDisplay = Displays[Param];
+
+  if (pDisplay->IsRefreshing) {
+    // look again on the next tick
+    ES_Timer_InitTimer(pDisplay->GovernorTimer, 1);
+  } else if (pDisplay->IsFrameRequested) {
+    startFrame(pDisplay);
+  } else {
+    pDisplay->IsGoverning = false;
+  }
+}
+
+#ifdef TEST
+/* Host check of the interrupt driven refresh against the SPI and SS model in
+   HostSim. The same buffer is sent with DM_TakeDisplayUpdateStep and with
+   DM_StartDisplayUpdate, which must put the same words on the SPI in the
+   same 8 bursts (one SS rise, so one latch, per row) and post a single
+   ES_UPDATE_COMPLETE. An update with nothing changed must send nothing, and
+   updates asked for while the governor timer runs must wait for it and go
+   out together, with the changed rows only and one ES_UPDATE_COMPLETE.
+   A rendered message scrolled in a column at a time, and put in at once,
+   must match the buffer made a character at a time, and the generated
+   FontLines and MessageBitmaps must match the font and messages they were
+   made from.
+   Then a chain of 16 modules on SPI1 and one of 32 on SPI2, longer than the
+   SPI buffer, are set up, filled a column at a time and scrolled across
+   words, and sent at the same time: each must get its rows, as a model of
+   its pixels says, in one burst a row, with no word lost to a full buffer.
+   Then reports the bus time of a frame at the bit time that LEDFSM sets,
+   the frames per second that allows, and how the two ways use the CPU, and
+   times scrolling in a column and building the frame on this host for
+   chains of 8, 16 and 32 modules.
+   The framework timer is stood in for here, its callback is called by hand.
+   Build on the host, compiling the other files without TEST so that only
+   this main is included, e.g.
+     gcc -c -IHostSim -IFrameworkHeaders -IProjectHeaders
+       ProjectSource/PIC32_SPI_HAL_Starter.c ProjectSource/FontStuff.c
+       ProjectSource/FontTables.c FrameworkSource/ES_Mailbox.c
+       HostSim/PIC32Sim.c
+     gcc -O2 -DTEST -IHostSim -IFrameworkHeaders -IProjectHeaders
+       ProjectSource/DM_Display.c *.o
+*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "LEDDisplayService.h"
+
+// longer than the display, with a character in the bottom row
+#define TEST_MESSAGE "Repeat sequence by pressing RGB, q"
+// the display as LEDFSM has it
+#define TEST_MODULES 8
+#define TEST_FRAME_LEN DM_FRAME_LEN(TEST_MODULES)
+// the longest chain that is tried
+#define TEST_MAX_MODULES 32
+// PBCLK counts per microsecond
+#define TEST_COUNTS_PER_US 20
+// the frames timed for each chain
+#define BENCH_FRAMES 200000UL
+
+static DM_Display_t Display; // on SPI1, service 0
+static uint32_t Rows[DM_ROWS_LEN(TEST_MAX_MODULES)];
+static uint16_t Frame[DM_FRAME_LEN(TEST_MAX_MODULES)];
+static DM_Display_t Marquee; // on SPI2, service 1
+static uint32_t MarqueeRows[DM_ROWS_LEN(TEST_MAX_MODULES)];
+static uint16_t MarqueeFrame[DM_FRAME_LEN(TEST_MAX_MODULES)];
+
+static PIC32Sim_SPIFrame_t Sent[3 * DM_FRAME_LEN(TEST_MAX_MODULES)];
+static uint16_t NumCompletes[2]; // by service
+static pTimerCallback TestCallbacks[2];
+static ES_EventParam_t TestParams[2];
+static bool IsTimerRunning[2];
+static uint8_t NumTimers;
+
+// stands in for the framework, for ES_Mailbox_DrainAll and startFrame
+bool ES_PostToService(uint8_t WhichService, ES_Event_t ThisEvent) {
+  if (ES_UPDATE_COMPLETE == ThisEvent.EventType) {
+    NumCompletes[WhichService]++;
+  }
+  return true;
+}
+
+// stand in for the framework timers, the test runs the callbacks itself
+ES_TimerHandle_t ES_Timer_AllocCallback(pTimerCallback Callback,
+    ES_EventParam_t Param) {
+  TestCallbacks[NumTimers] = Callback;
+  TestParams[NumTimers] = Param;
+  return NumTimers++;
+}
+
+ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime) {
+  IsTimerRunning[Num] = true;
+  return ES_Timer_OK;
+}
+
+// sends what is ready to go, then lets the governor timer run out
+static void runTimer(ES_TimerHandle_t WhichTimer) {
+  PIC32Sim_TakeInterrupts();
+  IsTimerRunning[WhichTimer] = false;
+  TestCallbacks[WhichTimer](TestParams[WhichTimer]);
+  PIC32Sim_TakeInterrupts();
+}
+
+// the buffer made from TEST_MESSAGE a character at a time, to compare with
+static void renderByChars(uint32_t *pRows) {
+  DM_ClearDisplayBuffer(&Display);
+  for (const char *pChar = TEST_MESSAGE; *pChar != '\0'; pChar++) {
+    DM_ScrollDisplayBuffer(&Display, 4);
+    DM_AddChar2DisplayBuffer(&Display, *pChar);
+  }
+  memcpy(pRows, Rows, sizeof(uint32_t) * DM_ROWS_LEN(TEST_MODULES));
+}
+
+// true if the frames are the words of Expected, sent a row to a burst
+static bool isFrameSent(const PIC32Sim_SPIFrame_t *pFrames,
+    const uint16_t *pExpected, uint16_t NumWords, uint8_t NumModules) {
+  for (uint16_t i = 0; i < NumWords; i++) {
+    if ((pFrames[i].Data != pExpected[i]) ||
+        ((pFrames[i].Burst == pFrames[0].Burst + i / NumModules) == false)) {
+      printf("word %u: %04x in burst %u\n", i, (unsigned) pFrames[i].Data,
+        (unsigned) (pFrames[i].Burst - pFrames[0].Burst));
+      return false;
+    }
+  }
+  return true;
+}
+
+// a model of a chain: each column as it is shown, bit n for row n, from the
+// right-most, and the words that a whole frame of it should be
+typedef struct {
+  uint8_t NumModules;
+  uint8_t Columns[TEST_MAX_MODULES * 8];
+} TestChain_t;
+
+static void scrollModel(TestChain_t *pModel, uint16_t NumColumns,
+    uint8_t NewColumn) {
+  uint16_t NumShown = pModel->NumModules * 8;
+  for (uint16_t i = NumShown; i-- > 0;) {
+    pModel->Columns[i] = (i >= NumColumns) ?
+      pModel->Columns[i - NumColumns] : 0;
+  }
+  pModel->Columns[0] |= NewColumn;
+}
+
+static void modelFrame(const TestChain_t *pModel, uint16_t *pExpected) {
+  for (uint8_t WhichRow = 0; WhichRow < DM_NUM_ROWS; WhichRow++) {
+    for (uint8_t Module = 0; Module < pModel->NumModules; Module++) {
+      uint8_t Byte = 0;
+      for (uint8_t Bit = 0; Bit < 8; Bit++) {
+        Byte |= ((pModel->Columns[8 * Module + Bit] >> WhichRow) & 1) << Bit;
+      }
+      *pExpected++ = ((DM_NUM_ROWS - WhichRow) << 8) |
+        BitReverseTable256[Byte];
+    }
+  }
+}
+
+// fills the chain a column at a time with a changing pattern, then scrolls
+// it across words, in the display and the model alike
+static void fillChain(DM_Display_t *pDisplay, TestChain_t *pModel) {
+  uint8_t Column = 0x5A;
+  pModel->NumModules = pDisplay->NumModules;
+  memset(pModel->Columns, 0, sizeof(pModel->Columns));
+  DM_ClearDisplayBuffer(pDisplay);
+  for (uint16_t i = 0; i < pDisplay->NumModules * 8; i++) {
+    Column = Column * 37 + 11;
+    DM_ScrollInColumn(pDisplay, Column);
+    scrollModel(pModel, 1, Column);
+  }
+  DM_ScrollDisplayBuffer(pDisplay, 37); // a word and 5 bits
+  scrollModel(pModel, 37, 0);
+}
+
+// true if the last frame of the chain went out as the model has it
+static bool isChainSent(const TestChain_t *pModel, uint8_t WhichSPI) {
+  static uint16_t Expected[DM_FRAME_LEN(TEST_MAX_MODULES)];
+  uint16_t FrameLen = DM_FRAME_LEN(pModel->NumModules);
+  uint16_t NumSent = PIC32Sim_SPIRead(WhichSPI, Sent, ARRAY_SIZE(Sent));
+
+  modelFrame(pModel, Expected);
+  if (FrameLen != NumSent) {
+    printf("%u modules: %u words\n", pModel->NumModules, NumSent);
+    return false;
+  }
+  return isFrameSent(Sent, Expected, FrameLen, pModel->NumModules);
+}
+
+// host ns to scroll in a column and build the frame, for a chain of
+// NumModules on SPI1, and the bus time of the frame in PBCLK counts
+static double timeChain(uint8_t NumModules, uint32_t *pBusCounts) {
+  struct timespec Start, End;
+  uint8_t Column = 0x5A;
+  volatile uint16_t Sink = 0;
+
+  DM_InitDisplay(&Display, SPI_SPI1, SPI_RPA0, SPI_RPA1, NumModules, Rows,
+    Frame);
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+  for (unsigned long i = 0; i < BENCH_FRAMES; i++) {
+    Column = Column * 37 + 11;
+    DM_ScrollInColumn(&Display, Column);
+    Sink ^= buildFrame(&Display);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &End);
+  // and one for real, every row changed
+  DM_PutDataIntoBufferRow(&Display, ~0ULL, 0);
+  DM_ScrollInColumn(&Display, 0xFF);
+  *pBusCounts = PIC32Sim_SPIGetBusCounts(0);
+  DM_StartDisplayUpdate(&Display);
+  runTimer(0);
+  *pBusCounts = PIC32Sim_SPIGetBusCounts(0) - *pBusCounts;
+  PIC32Sim_SPIRead(0, Sent, ARRAY_SIZE(Sent));
+  return ((End.tv_sec - Start.tv_sec) * 1e9 +
+    (End.tv_nsec - Start.tv_nsec)) / BENCH_FRAMES;
+}
+
+int main(void) {
+  uint16_t Expected[TEST_FRAME_LEN];
+  uint16_t NumSent;
+  uint32_t BusCounts;
+  uint32_t SSRises;
+  bool IsPassed = true;
+
+  DM_InitDisplay(&Display, SPI_SPI1, SPI_RPA0, SPI_RPA1, TEST_MODULES, Rows,
+    Frame);
+  while (false == DM_TakeInitDisplayStep(&Display)) {
+  }
+  for (uint8_t WhichRow = 0; WhichRow < DM_NUM_ROWS; WhichRow++) {
+    DM_PutDataIntoBufferRow(&Display, 0x0123456789ABCDEFULL * (WhichRow + 1),
+      WhichRow);
+  }
+  PIC32Sim_SPIRead(0, Sent, ARRAY_SIZE(Sent)); // leave out the init
+
+  // a row at a time, waiting for each
+  BusCounts = PIC32Sim_SPIGetBusCounts(0);
+  while (false == DM_TakeDisplayUpdateStep(&Display)) {
+  }
+  BusCounts = PIC32Sim_SPIGetBusCounts(0) - BusCounts;
+  NumSent = PIC32Sim_SPIRead(0, Sent, ARRAY_SIZE(Sent));
+  for (uint8_t i = 0; i < TEST_FRAME_LEN; i++) {
+    Expected[i] = (uint16_t) Sent[i].Data;
+  }
+  IsPassed = (TEST_FRAME_LEN == NumSent) &&
+    isFrameSent(Sent, Expected, TEST_FRAME_LEN, TEST_MODULES);
+  printf("step by step: %u words, %s\n", NumSent, IsPassed ? "8 bursts" :
+    "FAILED");
+
+  // the whole frame from the ISR, every row changed by clearing and putting
+  // the same contents back
+  DM_InitDisplayRefresh(&Display, 0);
+  DM_ClearDisplayBuffer(&Display);
+  for (uint8_t WhichRow = 0; WhichRow < DM_NUM_ROWS; WhichRow++) {
+    DM_PutDataIntoBufferRow(&Display, 0x0123456789ABCDEFULL * (WhichRow + 1),
+      WhichRow);
+  }
+  SSRises = PIC32Sim_SPIGetSSRises(0);
+  DM_StartDisplayUpdate(&Display);
+  PIC32Sim_TakeInterrupts();
+  ES_Mailbox_DrainAll();
+  SSRises = PIC32Sim_SPIGetSSRises(0) - SSRises;
+  NumSent = PIC32Sim_SPIRead(0, Sent, ARRAY_SIZE(Sent));
+  if ((TEST_FRAME_LEN != NumSent) ||
+      !isFrameSent(Sent, Expected, TEST_FRAME_LEN, TEST_MODULES) ||
+      (1 != NumCompletes[0]) || Display.IsRefreshing || !IsTimerRunning[0]) {
+    printf("interrupt driven: %u words, %u completions FAILED\n", NumSent,
+      NumCompletes[0]);
+    IsPassed = false;
+  } else {
+    printf("interrupt driven: the same words and bursts, 1 completion\n");
+  }
+
+  // nothing has changed, so it completes with the governor and sends nothing
+  DM_StartDisplayUpdate(&Display);
+  ES_Mailbox_DrainAll();
+  if (1 != NumCompletes[0]) {
+    printf("unchanged update: completed before the governor FAILED\n");
+    IsPassed = false;
+  }
+  runTimer(0);
+  NumSent = PIC32Sim_SPIRead(0, Sent, ARRAY_SIZE(Sent));
+  if ((0 != NumSent) || (2 != NumCompletes[0]) || IsTimerRunning[0]) {
+    printf("unchanged update: %u words, %u completions FAILED\n", NumSent,
+      NumCompletes[0]);
+    IsPassed = false;
+  } else {
+    printf("unchanged update: no words, completes after the governor\n");
+  }
+
+  // with the governor stopped, a change goes straight out, and the updates
+  // asked for while it runs wait for it and go out as one
+  DM_PutDataIntoBufferRow(&Display, 0, 0);
+  DM_StartDisplayUpdate(&Display);
+  DM_PutDataIntoBufferRow(&Display, 0, 1);
+  DM_StartDisplayUpdate(&Display);
+  DM_PutDataIntoBufferRow(&Display, 0, 2);
+  DM_StartDisplayUpdate(&Display);
+  PIC32Sim_TakeInterrupts();
+  NumSent = PIC32Sim_SPIRead(0, Sent, ARRAY_SIZE(Sent));
+  for (uint8_t i = 0; i < TEST_MODULES; i++) {
+    Expected[i] = DM_NUM_ROWS << 8; // row 0 is now blank
+    Expected[TEST_MODULES + i] = (DM_NUM_ROWS - 1) << 8;
+    Expected[2 * TEST_MODULES + i] = (DM_NUM_ROWS - 2) << 8;
+  }
+  if ((TEST_MODULES != NumSent) ||
+      !isFrameSent(Sent, Expected, TEST_MODULES, TEST_MODULES)) {
+    printf("changed row: %u words FAILED\n", NumSent);
+    IsPassed = false;
+  }
+  runTimer(0);
+  ES_Mailbox_DrainAll();
+  NumSent = PIC32Sim_SPIRead(0, Sent, ARRAY_SIZE(Sent));
+  if ((2 * TEST_MODULES != NumSent) ||
+      !isFrameSent(Sent, &Expected[TEST_MODULES], 2 * TEST_MODULES,
+      TEST_MODULES) || (3 != NumCompletes[0])) {
+    printf("merged updates: %u words, %u completions FAILED\n", NumSent,
+      NumCompletes[0]);
+    IsPassed = false;
+  } else {
+    printf("merged updates: 1 row, then 2 rows together, 1 completion\n");
+  }
+  runTimer(0);
+
+  // the column renderer against a character at a time
+  {
+    static uint8_t Columns[64 * DM_COLUMNS_PER_CHAR];
+    uint32_t ByChars[DM_ROWS_LEN(TEST_MODULES)];
+    uint16_t NumColumns;
+    bool IsSame;
+
+    renderByChars(ByChars);
+    NumColumns = DM_RenderMessage(TEST_MESSAGE, Columns, ARRAY_SIZE(Columns));
+    DM_ClearDisplayBuffer(&Display);
+    for (uint16_t i = 0; i < NumColumns; i++) {
+      DM_ScrollInColumn(&Display, Columns[i]);
+    }
+    IsSame = (0 == memcmp(ByChars, Rows, sizeof(ByChars)));
+    DM_PutDataIntoBufferRow(&Display, ~0ULL, 3);
+    DM_PutColumnsIntoBuffer(&Display, Columns, NumColumns);
+    IsSame = IsSame && (0 == memcmp(ByChars, Rows, sizeof(ByChars)));
+    // what does not fit is left out, a whole character at a time
+    IsSame = IsSame &&
+      (8 == DM_RenderMessage(TEST_MESSAGE, Columns, 2 * DM_COLUMNS_PER_CHAR + 3));
+    if ((strlen(TEST_MESSAGE) * DM_COLUMNS_PER_CHAR != NumColumns) ||
+        !IsSame) {
+      printf("rendered message: %u columns FAILED\n", NumColumns);
+      IsPassed = false;
+    } else {
+      printf("rendered message: the same buffer as a character at a time\n");
+    }
+  }
+
+  // the preset messages from FontTableGen against DM_RenderMessage
+  {
+    static const char *Messages[] = {
+#define LED_MESSAGE(Text) Text,
+      LED_MESSAGE_LIST
+#undef LED_MESSAGE
+    };
+    static uint8_t Columns[64 * DM_COLUMNS_PER_CHAR];
+    uint8_t NumDifferent = 0;
+
+    // and the font table against the packed font that it was made from
+    for (uint8_t Char = 0; Char < FONT_NUM_CHARS; Char++) {
+      for (uint8_t WhichRow = 0; WhichRow < FONT_NUM_ROWS; WhichRow++) {
+        if (getFontLine(FONT_FIRST_CHAR + Char, WhichRow) !=
+            DecodeFontLine(FONT_FIRST_CHAR + Char, WhichRow)) {
+          NumDifferent++;
+        }
+      }
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(Messages); i++) {
+      uint16_t NumColumns = DM_RenderMessage(Messages[i], Columns,
+          ARRAY_SIZE(Columns));
+      if ((MessageBitmaps[i].NumColumns != NumColumns) ||
+          (0 != memcmp(MessageBitmaps[i].pColumns, Columns, NumColumns))) {
+        printf("message %u: not the same as MessageBitmaps\n", i);
+        NumDifferent++;
+      }
+    }
+    if (0 != NumDifferent) {
+      printf("font and preset messages: %u FAILED, rebuild FontTables.c\n",
+        NumDifferent);
+      IsPassed = false;
+    } else {
+      printf("font and preset messages: all %u the same as the tables\n",
+        (unsigned) ARRAY_SIZE(Messages));
+    }
+  }
+
+  printf("a frame is %u us on the bus, up to %u frames/s\n",
+    (unsigned) (BusCounts / TEST_COUNTS_PER_US),
+    (unsigned) (1000000UL * TEST_COUNTS_PER_US / BusCounts));
+  printf("step by step: %u dispatches, the CPU waits on SS1 for all %u us\n",
+    DM_NUM_ROWS, (unsigned) (BusCounts / TEST_COUNTS_PER_US));
+  printf("interrupt driven: 1 event, %u ISR calls of up to %u SPI writes, "
+    "no waiting\n", (unsigned) SSRises, DM_FIFO_WORDS);
+
+  // chains longer than the SPI buffer, 16 modules on SPI1 and 32 on SPI2,
+  // set up and sent at the same time
+  {
+    static TestChain_t Model16, Model32;
+    bool IsChainPassed;
+
+    IsChainPassed = DM_InitDisplay(&Display, SPI_SPI1, SPI_RPA0, SPI_RPA1,
+        16, Rows, Frame) &&
+      DM_InitDisplay(&Marquee, SPI_SPI2, SPI_RPB9, SPI_RPB8, 32, MarqueeRows,
+        MarqueeFrame) &&
+      DM_InitDisplayRefresh(&Marquee, 1) &&
+      // but not a second display on SPI1
+      !DM_InitDisplay(&Marquee, SPI_SPI1, SPI_RPA0, SPI_RPA1, 32,
+        MarqueeRows, MarqueeFrame);
+    if (false == IsChainPassed) {
+      printf("16 and 32 modules: could not be set up FAILED\n");
+      return 1;
+    }
+    SSRises = PIC32Sim_SPIGetSSRises(1);
+    while (false == DM_TakeInitDisplayStep(&Marquee)) {
+    }
+    // 5 commands and 8 rows, each in a burst of its own
+    NumSent = PIC32Sim_SPIRead(1, Sent, ARRAY_SIZE(Sent));
+    IsChainPassed = (13 * 32 == NumSent) &&
+      (13 == PIC32Sim_SPIGetSSRises(1) - SSRises) &&
+      (DM_END_SHUTDOWN == Sent[NumSent - 1].Data) &&
+      (Sent[NumSent - 1].Burst == Sent[NumSent - 32].Burst);
+
+    fillChain(&Display, &Model16);
+    fillChain(&Marquee, &Model32);
+    DM_StartDisplayUpdate(&Display);
+    DM_StartDisplayUpdate(&Marquee);
+    PIC32Sim_TakeInterrupts();
+    ES_Mailbox_DrainAll();
+    IsChainPassed = IsChainPassed && isChainSent(&Model16, 0) &&
+      isChainSent(&Model32, 1) && (4 == NumCompletes[0]) &&
+      (1 == NumCompletes[1]) && (0 == PIC32Sim_SPIGetOverruns(0)) &&
+      (0 == PIC32Sim_SPIGetOverruns(1));
+    runTimer(0);
+    runTimer(1);
+    if (!IsChainPassed) {
+      printf("16 and 32 modules: %u, %u completions, %u, %u overruns "
+        "FAILED\n", NumCompletes[0], NumCompletes[1],
+        PIC32Sim_SPIGetOverruns(0), PIC32Sim_SPIGetOverruns(1));
+      IsPassed = false;
+    } else {
+      printf("16 and 32 modules: each as its model, a row to a burst, "
+        "1 completion each\n");
+    }
+  }
+
+  // the cost of a scrolled frame against the length of the chain
+  printf("modules  scroll+build ns  ns/module  bus us/frame  frames/s\n");
+  for (uint8_t NumModules = 8; NumModules <= TEST_MAX_MODULES;
+      NumModules *= 2) {
+    double Ns = timeChain(NumModules, &BusCounts);
+    printf("%7u  %15.0f  %9.1f  %12u  %8u\n", NumModules, Ns,
+      Ns / NumModules, (unsigned) (BusCounts / TEST_COUNTS_PER_US),
+      (unsigned) (1000000UL * TEST_COUNTS_PER_US / BusCounts));
   }
-  // then send the final byte and wait for the SS line to rise
-  SPIOperate_SPI1_Send16Wait(
-    ((((uint16_t) RowNum + 1) << 8) |
-    BitReverseTable256[(RowData.ByBytes[index])]));
+  printf("%s\n", IsPassed ? "passed" : "FAILED");
+  return IsPassed ? 0 : 1;
 }
+#endif /* TEST */
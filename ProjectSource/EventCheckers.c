@@ -16,6 +16,9 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 01:20 agt     keys go through the input log, 'i' dumps it when
+                        recording
+ 10/18/26 00:30 agt     't' starts a trace dump when the tracer is enabled
  08/06/13 13:36 jec     initial version
 ****************************************************************************/
 
@@ -97,6 +100,9 @@ bool Check4Lock(void)
    checks to see if a new key from the keyboard is detected and, if so,
    retrieves the key and posts an ES_NewKey event to TestHarnessService0
  Notes
+   When ES_TRACER is defined, 't' also starts a dump of the event trace,
+   and when ES_INPUT_RECORD is defined, 'i' starts a dump of the input log.
+   That is done here rather than in a service so that it works in any build
    The functions that actually check the serial hardware for characters
    and retrieve them are assumed to be in ES_Port.c
    Since we always retrieve the keystroke when we detect it, thus clearing the
@@ -108,11 +114,23 @@ bool Check4Lock(void)
 ****************************************************************************/
 bool Check4Keystroke(void)
 {
-  if (IsNewKeyReady())   // new key waiting?
+  if (ES_Input_IsKeyReady())   // new key waiting?
   {
     ES_Event_t ThisEvent;
     ThisEvent.EventType   = ES_NEW_KEY;
-    ThisEvent.EventParam  = GetNewKey();
+    ThisEvent.EventParam  = ES_Input_GetKey();
+#ifdef ES_TRACER
+    if ('t' == ThisEvent.EventParam)
+    {
+      ES_Trace_StartDump();
+    }
+#endif
+#ifdef ES_INPUT_RECORD
+    if ('i' == ThisEvent.EventParam)
+    {
+      ES_Input_StartDump();
+    }
+#endif
     ES_PostAll(ThisEvent);
     return true;
   }
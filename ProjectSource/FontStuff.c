@@ -116,10 +116,12 @@ const uint8_t font4x6[96][2] = {
 //THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //Font retreival function - ugly, but needed. 
 //kindly stolen from https://hackaday.io/project/6309-vga-graphics-over-spi-and-serial-vgatonic/log/20759-a-tiny-4x6-pixel-font-that-will-fit-on-almost-any-microcontroller-license-mit#header
-uint8_t getFontLine(unsigned char data, int line_num) {
+//Only HostSim/FontTableGen.c calls it now, getFontLine reads the FontLines
+//table that it makes
+uint8_t DecodeFontLine(unsigned char data, int line_num) {
     const uint8_t index = (data - 32);
     uint8_t pixel = 0;
-    if ((font4x6[index][1]) & 1 == 1) line_num -= 1;
+    if (((font4x6[index][1]) & 1) == 1) line_num -= 1;
     if (line_num == 0) {
         pixel = ((font4x6[index][0])) >> 4;
     }
@@ -0,0 +1,320 @@
+/* ProjectSource/FontTables.c, made by HostSim/FontTableGen.c from
+   font4x6 and LED_MESSAGE_LIST. Do not edit, see the notes of
+   FontTableGen.c to rebuild it. */
+#include <stdint.h>
+#include "ES_Configure.h"
+#include "ES_Events.h"
+#include "FontStuff.h"
+#include "LEDDisplayService.h"
+
+const uint8_t FontLines[FONT_NUM_CHARS][FONT_NUM_ROWS] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, /* ' ' */
+  {0x04, 0x04, 0x04, 0x00, 0x04, 0x00}, /* '!' */
+  {0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00}, /* '"' */
+  {0x0a, 0x0e, 0x0a, 0x0e, 0x0a, 0x00}, /* '#' */
+  {0x06, 0x0c, 0x0e, 0x06, 0x0c, 0x00}, /* '$' */
+  {0x0a, 0x02, 0x04, 0x08, 0x0a, 0x00}, /* '%' */
+  {0x04, 0x0a, 0x04, 0x0a, 0x0c, 0x00}, /* '&' */
+  {0x04, 0x04, 0x00, 0x00, 0x00, 0x00}, /* ''' */
+  {0x02, 0x04, 0x04, 0x04, 0x02, 0x00}, /* '(' */
+  {0x04, 0x02, 0x02, 0x02, 0x04, 0x00}, /* ')' */
+  {0x00, 0x0a, 0x04, 0x0a, 0x00, 0x00}, /* 0x2a */
+  {0x00, 0x04, 0x0e, 0x04, 0x00, 0x00}, /* '+' */
+  {0x00, 0x00, 0x00, 0x04, 0x08, 0x00}, /* ',' */
+  {0x00, 0x00, 0x0e, 0x00, 0x00, 0x00}, /* '-' */
+  {0x00, 0x00, 0x00, 0x00, 0x04, 0x00}, /* '.' */
+  {0x02, 0x02, 0x04, 0x08, 0x08, 0x00}, /* 0x2f */
+  {0x06, 0x0a, 0x0a, 0x0a, 0x0c, 0x00}, /* '0' */
+  {0x04, 0x0c, 0x04, 0x04, 0x0e, 0x00}, /* '1' */
+  {0x0c, 0x02, 0x06, 0x08, 0x0e, 0x00}, /* '2' */
+  {0x0c, 0x02, 0x04, 0x02, 0x0c, 0x00}, /* '3' */
+  {0x08, 0x08, 0x0a, 0x0e, 0x02, 0x00}, /* '4' */
+  {0x0e, 0x08, 0x0e, 0x02, 0x0c, 0x00}, /* '5' */
+  {0x06, 0x08, 0x0e, 0x0a, 0x0c, 0x00}, /* '6' */
+  {0x0e, 0x02, 0x04, 0x08, 0x08, 0x00}, /* '7' */
+  {0x06, 0x0a, 0x0e, 0x0a, 0x0c, 0x00}, /* '8' */
+  {0x06, 0x0a, 0x0e, 0x02, 0x0c, 0x00}, /* '9' */
+  {0x00, 0x04, 0x00, 0x04, 0x00, 0x00}, /* ':' */
+  {0x00, 0x04, 0x00, 0x04, 0x08, 0x00}, /* ';' */
+  {0x02, 0x04, 0x08, 0x04, 0x02, 0x00}, /* '<' */
+  {0x00, 0x0e, 0x00, 0x0e, 0x00, 0x00}, /* '=' */
+  {0x08, 0x04, 0x02, 0x04, 0x08, 0x00}, /* '>' */
+  {0x0e, 0x02, 0x04, 0x00, 0x04, 0x00}, /* '?' */
+  {0x04, 0x0a, 0x0a, 0x08, 0x06, 0x00}, /* '@' */
+  {0x06, 0x0a, 0x0e, 0x0a, 0x0a, 0x00}, /* 'A' */
+  {0x0c, 0x0a, 0x0c, 0x0a, 0x0c, 0x00}, /* 'B' */
+  {0x06, 0x08, 0x08, 0x08, 0x06, 0x00}, /* 'C' */
+  {0x0c, 0x0a, 0x0a, 0x0a, 0x0c, 0x00}, /* 'D' */
+  {0x06, 0x08, 0x0e, 0x08, 0x0e, 0x00}, /* 'E' */
+  {0x06, 0x08, 0x0e, 0x08, 0x08, 0x00}, /* 'F' */
+  {0x06, 0x08, 0x0a, 0x0a, 0x06, 0x00}, /* 'G' */
+  {0x0a, 0x0a, 0x0e, 0x0a, 0x0a, 0x00}, /* 'H' */
+  {0x0e, 0x04, 0x04, 0x04, 0x0e, 0x00}, /* 'I' */
+  {0x06, 0x02, 0x02, 0x0a, 0x04, 0x00}, /* 'J' */
+  {0x0a, 0x0a, 0x0c, 0x0a, 0x0a, 0x00}, /* 'K' */
+  {0x08, 0x08, 0x08, 0x08, 0x0e, 0x00}, /* 'L' */
+  {0x0a, 0x0e, 0x0a, 0x0a, 0x0a, 0x00}, /* 'M' */
+  {0x0c, 0x0a, 0x0a, 0x0a, 0x0a, 0x00}, /* 'N' */
+  {0x04, 0x0a, 0x0a, 0x0a, 0x04, 0x00}, /* 'O' */
+  {0x0c, 0x0a, 0x0e, 0x08, 0x08, 0x00}, /* 'P' */
+  {0x06, 0x0a, 0x0a, 0x0e, 0x06, 0x00}, /* 'Q' */
+  {0x06, 0x0a, 0x0c, 0x0a, 0x0a, 0x00}, /* 'R' */
+  {0x06, 0x08, 0x04, 0x02, 0x0c, 0x00}, /* 'S' */
+  {0x0e, 0x04, 0x04, 0x04, 0x04, 0x00}, /* 'T' */
+  {0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x00}, /* 'U' */
+  {0x0a, 0x0a, 0x0a, 0x0a, 0x04, 0x00}, /* 'V' */
+  {0x0a, 0x0a, 0x0a, 0x0e, 0x0a, 0x00}, /* 'W' */
+  {0x0a, 0x0a, 0x04, 0x0a, 0x0a, 0x00}, /* 'X' */
+  {0x0a, 0x0a, 0x04, 0x04, 0x04, 0x00}, /* 'Y' */
+  {0x0e, 0x02, 0x04, 0x08, 0x0e, 0x00}, /* 'Z' */
+  {0x06, 0x04, 0x04, 0x04, 0x06, 0x00}, /* '[' */
+  {0x08, 0x08, 0x04, 0x02, 0x02, 0x00}, /* '\' */
+  {0x06, 0x02, 0x02, 0x02, 0x06, 0x00}, /* ']' */
+  {0x04, 0x0a, 0x00, 0x00, 0x00, 0x00}, /* '^' */
+  {0x00, 0x00, 0x00, 0x00, 0x0e, 0x00}, /* '_' */
+  {0x04, 0x02, 0x00, 0x00, 0x00, 0x00}, /* '`' */
+  {0x00, 0x06, 0x0a, 0x0a, 0x06, 0x00}, /* 'a' */
+  {0x08, 0x0c, 0x0a, 0x0a, 0x0c, 0x00}, /* 'b' */
+  {0x00, 0x06, 0x08, 0x08, 0x06, 0x00}, /* 'c' */
+  {0x02, 0x06, 0x0a, 0x0a, 0x06, 0x00}, /* 'd' */
+  {0x00, 0x06, 0x0a, 0x0c, 0x06, 0x00}, /* 'e' */
+  {0x04, 0x0a, 0x08, 0x0c, 0x08, 0x00}, /* 'f' */
+  {0x00, 0x04, 0x0a, 0x06, 0x02, 0x0c}, /* 'g' */
+  {0x08, 0x08, 0x0c, 0x0a, 0x0a, 0x00}, /* 'h' */
+  {0x04, 0x00, 0x04, 0x04, 0x02, 0x00}, /* 'i' */
+  {0x00, 0x04, 0x00, 0x04, 0x04, 0x08}, /* 'j' */
+  {0x08, 0x0a, 0x0c, 0x0a, 0x0a, 0x00}, /* 'k' */
+  {0x04, 0x04, 0x04, 0x04, 0x02, 0x00}, /* 'l' */
+  {0x00, 0x0a, 0x0e, 0x0a, 0x0a, 0x00}, /* 'm' */
+  {0x00, 0x0c, 0x0a, 0x0a, 0x0a, 0x00}, /* 'n' */
+  {0x00, 0x04, 0x0a, 0x0a, 0x04, 0x00}, /* 'o' */
+  {0x00, 0x0c, 0x0a, 0x0a, 0x0c, 0x08}, /* 'p' */
+  {0x00, 0x06, 0x0a, 0x0a, 0x06, 0x02}, /* 'q' */
+  {0x00, 0x0a, 0x0c, 0x08, 0x08, 0x00}, /* 'r' */
+  {0x00, 0x06, 0x0c, 0x02, 0x0c, 0x00}, /* 's' */
+  {0x08, 0x0c, 0x08, 0x08, 0x06, 0x00}, /* 't' */
+  {0x00, 0x0a, 0x0a, 0x0a, 0x06, 0x00}, /* 'u' */
+  {0x00, 0x0a, 0x0a, 0x0a, 0x0c, 0x00}, /* 'v' */
+  {0x00, 0x0a, 0x0a, 0x0e, 0x0a, 0x00}, /* 'w' */
+  {0x00, 0x0a, 0x04, 0x0a, 0x0a, 0x00}, /* 'x' */
+  {0x00, 0x0a, 0x0a, 0x06, 0x02, 0x04}, /* 'y' */
+  {0x00, 0x0e, 0x02, 0x04, 0x0e, 0x00}, /* 'z' */
+  {0x06, 0x04, 0x0c, 0x04, 0x06, 0x00}, /* '{' */
+  {0x04, 0x04, 0x04, 0x04, 0x04, 0x00}, /* '|' */
+  {0x0c, 0x04, 0x06, 0x04, 0x0c, 0x00}, /* '}' */
+  {0x04, 0x0a, 0x00, 0x00, 0x00, 0x00}, /* '~' */
+  {0x04, 0x0a, 0x0a, 0x0e, 0x00, 0x00}  /* 0x7f */
+};
+
+// "Welcome! Please Insert 2 Poker Chips to Begin.    "
+static const uint8_t Message0[] = {
+  0x1f, 0x08, 0x1f, 0x00, /* 'W' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x00, 0x0f, 0x10, 0x00, /* 'l' */
+  0x0c, 0x12, 0x12, 0x00, /* 'c' */
+  0x0c, 0x12, 0x0c, 0x00, /* 'o' */
+  0x1e, 0x04, 0x1e, 0x00, /* 'm' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x00, 0x17, 0x00, 0x00, /* '!' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1f, 0x05, 0x06, 0x00, /* 'P' */
+  0x00, 0x0f, 0x10, 0x00, /* 'l' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x0c, 0x12, 0x1e, 0x00, /* 'a' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x11, 0x1f, 0x11, 0x00, /* 'I' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x1e, 0x04, 0x02, 0x00, /* 'r' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x19, 0x15, 0x16, 0x00, /* '2' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1f, 0x05, 0x06, 0x00, /* 'P' */
+  0x0c, 0x12, 0x0c, 0x00, /* 'o' */
+  0x1f, 0x04, 0x1a, 0x00, /* 'k' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x1e, 0x04, 0x02, 0x00, /* 'r' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x0e, 0x11, 0x11, 0x00, /* 'C' */
+  0x1f, 0x04, 0x18, 0x00, /* 'h' */
+  0x00, 0x0d, 0x10, 0x00, /* 'i' */
+  0x3e, 0x12, 0x0c, 0x00, /* 'p' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x0c, 0x12, 0x0c, 0x00, /* 'o' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1f, 0x15, 0x0a, 0x00, /* 'B' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x24, 0x2a, 0x1c, 0x00, /* 'g' */
+  0x00, 0x0d, 0x10, 0x00, /* 'i' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x00, 0x10, 0x00, 0x00, /* '.' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+};
+
+// "1 Chip Inserted"
+static const uint8_t Message1[] = {
+  0x12, 0x1f, 0x10, 0x00, /* '1' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x0e, 0x11, 0x11, 0x00, /* 'C' */
+  0x1f, 0x04, 0x18, 0x00, /* 'h' */
+  0x00, 0x0d, 0x10, 0x00, /* 'i' */
+  0x3e, 0x12, 0x0c, 0x00, /* 'p' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x11, 0x1f, 0x11, 0x00, /* 'I' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x1e, 0x04, 0x02, 0x00, /* 'r' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x0c, 0x12, 0x1f, 0x00, /* 'd' */
+};
+
+// "Use handles to push rocket down.    "
+static const uint8_t Message2[] = {
+  0x0f, 0x10, 0x1f, 0x00, /* 'U' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1f, 0x04, 0x18, 0x00, /* 'h' */
+  0x0c, 0x12, 0x1e, 0x00, /* 'a' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x0c, 0x12, 0x1f, 0x00, /* 'd' */
+  0x00, 0x0f, 0x10, 0x00, /* 'l' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x0c, 0x12, 0x0c, 0x00, /* 'o' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x3e, 0x12, 0x0c, 0x00, /* 'p' */
+  0x0e, 0x10, 0x1e, 0x00, /* 'u' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x1f, 0x04, 0x18, 0x00, /* 'h' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1e, 0x04, 0x02, 0x00, /* 'r' */
+  0x0c, 0x12, 0x0c, 0x00, /* 'o' */
+  0x0c, 0x12, 0x12, 0x00, /* 'c' */
+  0x1f, 0x04, 0x1a, 0x00, /* 'k' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x0c, 0x12, 0x1f, 0x00, /* 'd' */
+  0x0c, 0x12, 0x0c, 0x00, /* 'o' */
+  0x1e, 0x08, 0x1e, 0x00, /* 'w' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x00, 0x10, 0x00, 0x00, /* '.' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+};
+
+// "Repeat sequence by pressing RGB buttons "
+static const uint8_t Message3[] = {
+  0x1e, 0x05, 0x1b, 0x00, /* 'R' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x3e, 0x12, 0x0c, 0x00, /* 'p' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x0c, 0x12, 0x1e, 0x00, /* 'a' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x0c, 0x12, 0x3e, 0x00, /* 'q' */
+  0x0e, 0x10, 0x1e, 0x00, /* 'u' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x0c, 0x12, 0x12, 0x00, /* 'c' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1f, 0x12, 0x0c, 0x00, /* 'b' */
+  0x06, 0x28, 0x1e, 0x00, /* 'y' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x3e, 0x12, 0x0c, 0x00, /* 'p' */
+  0x1e, 0x04, 0x02, 0x00, /* 'r' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x00, 0x0d, 0x10, 0x00, /* 'i' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x24, 0x2a, 0x1c, 0x00, /* 'g' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1e, 0x05, 0x1b, 0x00, /* 'R' */
+  0x0e, 0x11, 0x1d, 0x00, /* 'G' */
+  0x1f, 0x15, 0x0a, 0x00, /* 'B' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1f, 0x12, 0x0c, 0x00, /* 'b' */
+  0x0e, 0x10, 0x1e, 0x00, /* 'u' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x0c, 0x12, 0x0c, 0x00, /* 'o' */
+  0x1e, 0x02, 0x1c, 0x00, /* 'n' */
+  0x14, 0x16, 0x0a, 0x00, /* 's' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+};
+
+// "Set Difficulty"
+static const uint8_t Message4[] = {
+  0x12, 0x15, 0x09, 0x00, /* 'S' */
+  0x0c, 0x1a, 0x16, 0x00, /* 'e' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1f, 0x11, 0x0e, 0x00, /* 'D' */
+  0x00, 0x0d, 0x10, 0x00, /* 'i' */
+  0x1e, 0x09, 0x02, 0x00, /* 'f' */
+  0x1e, 0x09, 0x02, 0x00, /* 'f' */
+  0x00, 0x0d, 0x10, 0x00, /* 'i' */
+  0x0c, 0x12, 0x12, 0x00, /* 'c' */
+  0x0e, 0x10, 0x1e, 0x00, /* 'u' */
+  0x00, 0x0f, 0x10, 0x00, /* 'l' */
+  0x0f, 0x12, 0x10, 0x00, /* 't' */
+  0x06, 0x28, 0x1e, 0x00, /* 'y' */
+};
+
+// "NO USER INPUT. RESETTING."
+static const uint8_t Message5[] = {
+  0x1f, 0x01, 0x1e, 0x00, /* 'N' */
+  0x0e, 0x11, 0x0e, 0x00, /* 'O' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x0f, 0x10, 0x1f, 0x00, /* 'U' */
+  0x12, 0x15, 0x09, 0x00, /* 'S' */
+  0x1e, 0x15, 0x15, 0x00, /* 'E' */
+  0x1e, 0x05, 0x1b, 0x00, /* 'R' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x11, 0x1f, 0x11, 0x00, /* 'I' */
+  0x1f, 0x01, 0x1e, 0x00, /* 'N' */
+  0x1f, 0x05, 0x06, 0x00, /* 'P' */
+  0x0f, 0x10, 0x1f, 0x00, /* 'U' */
+  0x01, 0x1f, 0x01, 0x00, /* 'T' */
+  0x00, 0x10, 0x00, 0x00, /* '.' */
+  0x00, 0x00, 0x00, 0x00, /* ' ' */
+  0x1e, 0x05, 0x1b, 0x00, /* 'R' */
+  0x1e, 0x15, 0x15, 0x00, /* 'E' */
+  0x12, 0x15, 0x09, 0x00, /* 'S' */
+  0x1e, 0x15, 0x15, 0x00, /* 'E' */
+  0x01, 0x1f, 0x01, 0x00, /* 'T' */
+  0x01, 0x1f, 0x01, 0x00, /* 'T' */
+  0x11, 0x1f, 0x11, 0x00, /* 'I' */
+  0x1f, 0x01, 0x1e, 0x00, /* 'N' */
+  0x0e, 0x11, 0x1d, 0x00, /* 'G' */
+  0x00, 0x10, 0x00, 0x00, /* '.' */
+};
+
+const LED_MessageBitmap_t MessageBitmaps[] = {
+  {Message0, sizeof(Message0)},
+  {Message1, sizeof(Message1)},
+  {Message2, sizeof(Message2)},
+  {Message3, sizeof(Message3)},
+  {Message4, sizeof(Message4)},
+  {Message5, sizeof(Message5)},
+};
@@ -2,7 +2,7 @@
  Module
    GreenButtonFSM.c
 
- 
+****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
 /* include header files for this state machine as well as any machines at the
    next lower level in the hierarchy that are sub-machines to this machine
@@ -17,7 +17,7 @@
 /*----------------------------- Module Defines ----------------------------*/
 #define PIN_PORT _Port_B
 #define PIN_NUM _Pin_11
-#define PIN_READ PORTBbits.RB11;
+#define PIN_READ ES_Input_Level(ES_IN_GREEN_BUTTON, PORTBbits.RB11);
 #define DEBOUNCE_TIME 5 // milliseconds
 /*---------------------------- Module Functions ---------------------------*/
 /* prototypes for private functions for this machine.They should be functions
@@ -11,6 +11,7 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 01:20 agt     the pin is read through the input log
  10/25/24 22:14 sjp     initial version
 ****************************************************************************/
 
@@ -42,7 +43,7 @@
 /*---------------------------- Module Variables ---------------------------*/
 #define PIN_PORT _Port_B
 #define PIN_NUM _Pin_13
-#define PIN_READ PORTBbits.RB13;
+#define PIN_READ ES_Input_Level(ES_IN_IR_LAUNCH, PORTBbits.RB13);
 
 static bool LastState;
 
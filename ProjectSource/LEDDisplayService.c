@@ -13,12 +13,19 @@
 #include "dbprintf.h"
 #include "PIC32PortHAL.h"
 #include "DM_Display.h"
+#include "LEDFSM.h"
+#include "RocketLaunchGameFSM.h"
 #include <stdint.h>
 
 
 /*----------------------------- Module Defines ----------------------------*/
-#define SCROLL_DURATION 100 // milliseconds
-#define SCROLL_DURATION_SLOW 200
+// messages scroll a pixel column per frame, 4 columns to a character
+#define SCROLL_FRAME_RATE 40 // frames per second
+#define SCROLL_FRAME_RATE_SLOW 20
+#define SCROLL_DURATION (1000 / SCROLL_FRAME_RATE) // milliseconds
+#define SCROLL_DURATION_SLOW (1000 / SCROLL_FRAME_RATE_SLOW)
+// the longest custom message, characters past this are not shown
+#define MAX_MESSAGE_CHARS 64
 
 /*---------------------------- Module Functions ---------------------------*/
 /* prototypes for private functions for this service.They should be functions
@@ -36,22 +43,20 @@ const uint8_t numSpaces[5] = {
   1,
   0
 };
-/*************************************************************************** */
-/**** PUT NEW PRESET MESSAGES HERE AND UPDATE THE LED_ID_t ENUM TO MATCH INDEX *****/
+// the preset messages, to add one see LED_MESSAGE_LIST in the header
 char* MESSAGES[] = {
-  "Welcome! Please Insert 2 Poker Chips to Begin.    ",
-  "1 Chip Inserted",
-  "Use handles to push rocket down.    ",
-  "Repeat sequence by pressing RGB buttons ",
-  "Set Difficulty",
-  "NO USER INPUT. RESETTING.",
-  // Insert new messages here
+#define LED_MESSAGE(Text) Text,
+  LED_MESSAGE_LIST
+#undef LED_MESSAGE
 };
-/* REMEMBER TO GO TO HEADER FILE AND UPDATE LED_ID_t */
-/************************************************************************** */
 
 char* currentMessage; // = MESSAGES[MSG_STARTUP]; // global variable defined here because it has to be defined somewhere
-static char* pMessage; // pointer to message string (iterates)
+// the message as pixel columns, from MessageBitmaps for the presets, or
+// rendered into CustomColumns once when a custom message arrives
+static uint8_t CustomColumns[MAX_MESSAGE_CHARS * DM_COLUMNS_PER_CHAR];
+static const uint8_t *pMessageColumns;
+static uint16_t NumMessageColumns;
+static uint16_t NextColumn; // the next column to scroll in
 
 static LED_Instructions_t currentInstructions;
 
@@ -86,7 +91,7 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
 
     case ES_CLEAR_MESSAGE:
     {
-      DM_ClearDisplayBuffer();
+      DM_ClearDisplayBuffer(&LEDDisplay);
     }
       break;
 
@@ -96,20 +101,25 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
       msgParams.fullParam = ThisEvent.EventParam;
       if (msgParams.msgID != MSG_CUSTOM) {
         currentMessage = MESSAGES[msgParams.msgID];
+        pMessageColumns = MessageBitmaps[msgParams.msgID].pColumns;
+        NumMessageColumns = MessageBitmaps[msgParams.msgID].NumColumns;
+      } else {
+        // currentMessage is already set to RGB sequence by RocketLaunchGameFSM
+        pMessageColumns = CustomColumns;
+        NumMessageColumns = DM_RenderMessage(currentMessage, CustomColumns,
+            ARRAY_SIZE(CustomColumns));
       }
-      // else currentMessage is already set to RGB sequence by RocketLaunchGameFSM
-
-      pMessage = currentMessage;
-      DB_printf("ledDisplayService got new message: %s| with instructions %d\n", pMessage, msgParams.dispInstructions);
+      NextColumn = 0;
+      DB_printf("ledDisplayService got new message: %s| with instructions %d\n", currentMessage, msgParams.dispInstructions);
 
       switch (msgParams.dispInstructions) {
         case DISPLAY_HOLD:
         {
           currentInstructions = DISPLAY_HOLD;
-          DM_ClearDisplayBuffer();
-          ES_Event_t NextEvent;
-          NextEvent.EventType = ES_KEEP_UPDATING;
-          PostLEDDisplayService(NextEvent);
+          // the whole message at once, sent to the display in the background
+          DM_PutColumnsIntoBuffer(&LEDDisplay, pMessageColumns,
+              NumMessageColumns);
+          DM_StartDisplayUpdate(&LEDDisplay);
           ES_Timer_StopTimer(SCROLL_MESSAGE_TIMER);
         }
           break;
@@ -117,7 +127,7 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
         case SCROLL_ONCE:
         {
           currentInstructions = SCROLL_ONCE;
-          DM_ClearDisplayBuffer();
+          DM_ClearDisplayBuffer(&LEDDisplay);
           ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, SCROLL_DURATION);
         }
           break;
@@ -125,7 +135,7 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
         case SCROLL_ONCE_SLOW:
         {
           currentInstructions = SCROLL_ONCE_SLOW;
-          DM_ClearDisplayBuffer();
+          DM_ClearDisplayBuffer(&LEDDisplay);
           ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, SCROLL_DURATION_SLOW);
         }
           break;
@@ -134,7 +144,7 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
         {
           ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, 1000);
           currentInstructions = SCROLL_REPEAT;
-          DM_ClearDisplayBuffer();
+          DM_ClearDisplayBuffer(&LEDDisplay);
           ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, SCROLL_DURATION);
         }
           break;
@@ -143,7 +153,7 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
         {
           ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, 1000);
           currentInstructions = SCROLL_REPEAT_SLOW;
-          DM_ClearDisplayBuffer();
+          DM_ClearDisplayBuffer(&LEDDisplay);
           ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, SCROLL_DURATION_SLOW);
         }
           break;
@@ -151,33 +161,14 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
     }
       break;
 
-      // This event is for Display holding only
-    case ES_KEEP_UPDATING:
-    {
-      ES_Event_t NextEvent;
-      NextEvent.EventType = ES_KEEP_UPDATING;
-      // if entire message isn't added to buffer yet
-      if (*pMessage != '\0') {
-        Add2DisplayBuffer();
-        PostLEDDisplayService(NextEvent);
-      }// else keep updating the display until done 
-      else {
-        bool done = DM_TakeDisplayUpdateStep();
-        if (done == false) {
-          PostLEDDisplayService(NextEvent);
-        }
-      }
-    }
-      break;
-
       // This  ES_TIMEOUT:event is for scrolling messages only
     case ES_TIMEOUT:
     {
       if (ThisEvent.EventParam == SCROLL_MESSAGE_TIMER) {
         ScrollMessage();
-        if (*pMessage == '\0') {
+        if (NextColumn >= NumMessageColumns) {
           if (currentInstructions == SCROLL_REPEAT || currentInstructions == SCROLL_REPEAT_SLOW) {
-            pMessage = currentMessage; // Reset pointer for repeating
+            NextColumn = 0; // start over for repeating
           } else if (currentInstructions == SCROLL_ONCE || currentInstructions == SCROLL_ONCE_SLOW) {
             ES_Timer_StopTimer(SCROLL_MESSAGE_TIMER);
             // Tell PostRocketLaunchGame that scrolling is done
@@ -198,22 +189,18 @@ ES_Event_t RunLEDDisplayService(ES_Event_t ThisEvent) {
  private functions
  ***************************************************************************/
 void ScrollMessage(void) {
-  ES_Event_t CharEvent;
-  CharEvent.EventType = ES_NEW_CHAR;
-  CharEvent.EventParam = *pMessage;
-  PostLEDFSM(CharEvent);
-  pMessage++;
+  if (NextColumn < NumMessageColumns) {
+    ES_Event_t ColumnEvent;
+    ColumnEvent.EventType = ES_NEW_COLUMN;
+    ColumnEvent.EventParam = pMessageColumns[NextColumn];
+    PostLEDFSM(ColumnEvent);
+    NextColumn++;
+  }
   if (currentInstructions == SCROLL_ONCE || currentInstructions == SCROLL_REPEAT) {
     ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, SCROLL_DURATION);
   } else {
     ES_Timer_InitTimer(SCROLL_MESSAGE_TIMER, SCROLL_DURATION_SLOW);
   }
 }
-
-void Add2DisplayBuffer(void) {
-  DM_ScrollDisplayBuffer(4);
-  DM_AddChar2DisplayBuffer(*pMessage);
-  pMessage++;
-}
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
@@ -14,6 +14,17 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 05:30 agt      columns that arrive during an update are kept and
+                         all scrolled in for the next frame instead of each
+                         being deferred. TEST_LED_STRESS checks that the
+                         characters are drawn in the order they were posted
+ 10/18/26 04:50 agt      the display is LEDDisplay, set up by DM_InitDisplay
+ 10/18/26 03:30 agt      ES_NEW_COLUMN scrolls in a single pixel column
+ 10/18/26 02:10 agt      a character is drawn with a single interrupt driven
+                         refresh, which ends with ES_UPDATE_COMPLETE
+ 10/17/26 18:45 agt      deferral queue sized to a power of 2 plus 1
+ 10/17/26 17:30 agt      the init and update steps continue the service instead
+                         of posting to its queue. Added TEST_LED_STRESS
  01/15/12 11:12 jec      revisions for Gen2 framework
  11/07/11 11:26 jec      made the queue static
  10/30/11 17:59 jec      fixed references to CurrentEvent in RunTemplateSM()
@@ -33,13 +44,34 @@
 #include "dbprintf.h"
 
 /*----------------------------- Module Defines ----------------------------*/
+// the 8x8 modules in the chain
+#define LED_NUM_MODULES 8
+// the columns that can arrive while a frame is being sent
+#define MAX_PENDING_COLUMNS 16
+//#define TEST_LED_STRESS // uncomment, then press 's' to fire bursts of characters at the display while it draws
+#ifdef TEST_LED_STRESS
+// each burst is as many characters as the queue holds
+#define STRESS_BURST 3
+#define STRESS_ROUNDS 20
+#endif
 
 /*---------------------------- Module Functions ---------------------------*/
 /* prototypes for private functions for this machine.They should be functions
    relevant to the behavior of this state machine
  */
+static bool scrollInPendingColumns(void);
+#ifdef TEST_LED_STRESS
+static void StartStress(void);
+static void PostStressChar(void);
+static void ReportStress(void);
+#endif
 
 /*---------------------------- Module Variables ---------------------------*/
+// the display, and the storage for its buffer and frames
+DM_Display_t LEDDisplay;
+static uint32_t LEDRows[DM_ROWS_LEN(LED_NUM_MODULES)];
+static uint16_t LEDFrame[DM_FRAME_LEN(LED_NUM_MODULES)];
+
 // everybody needs a state variable, you may need others as well.
 // type of state variable should match htat of enum in header file
 static LEDState_t CurrentState;
@@ -47,7 +79,19 @@ static LEDState_t CurrentState;
 // with the introduction of Gen2, we need a module level Priority var as well
 static uint8_t MyPriority;
 // add a deferral queue for up to 3 pending deferrals +1 to allow for overhead
-static ES_Event_t DeferralQueue[10 + 1];
+static ES_Event_t DeferralQueue[16 + 1];
+// the ES_NEW_COLUMN columns that came in during an update, oldest first
+static uint8_t PendingColumns[MAX_PENDING_COLUMNS];
+static uint8_t NumPendingColumns;
+
+#ifdef TEST_LED_STRESS
+static uint8_t  StressRoundsLeft;
+static uint16_t StressPosted;   // characters posted by the stress test
+static uint16_t StressRefused;  // posts that failed
+static uint16_t StressDrawn;    // characters that reached the display
+static uint16_t StressOutOfOrder; // drawn other than in the order posted
+static bool     StressBurstDue;
+#endif
 
 /*------------------------------ Module Code ------------------------------*/
 
@@ -73,20 +117,18 @@ bool InitLEDFSM(uint8_t Priority) {
   ES_Event_t ThisEvent;
 
   MyPriority = Priority;
+#ifdef TEST_LED_STRESS
+  // the test keystrokes arrive by ES_PostAll
+  ES_AddSubscriptions(MyPriority, ES_EVENT_BIT(ES_NEW_KEY));
+#endif
   // put us into the Initial PseudoState
   CurrentState = InitPState;
 
-  // SPI Initialization
-  SPISetup_BasicConfig(SPI_SPI1);
-  SPISetup_SetLeader(SPI_SPI1, SPI_SMP_MID);
-  SPISetup_SetBitTime(SPI_SPI1, 10000);
-  SPISetup_MapSSOutput(SPI_SPI1, SPI_RPA0);
-  SPISetup_MapSDOutput(SPI_SPI1, SPI_RPA1);
-  SPISetup_SetClockIdleState(SPI_SPI1, SPI_CLK_LO);
-  SPISetup_SetActiveEdge(SPI_SPI1, SPI_FIRST_EDGE);
-  SPISetup_SetXferWidth(SPI_SPI1, SPI_16BIT);
-  SPISetEnhancedBuffer(SPI_SPI1, true);
-  SPISetup_EnableSPI(SPI_SPI1);
+  // SPI Initialization, the display is on SPI1 with SS on RA0, SDO on RA1
+  DM_InitDisplay(&LEDDisplay, SPI_SPI1, SPI_RPA0, SPI_RPA1, LED_NUM_MODULES,
+      LEDRows, LEDFrame);
+  // the display refresh posts ES_UPDATE_COMPLETE back to us
+  DM_InitDisplayRefresh(&LEDDisplay, MyPriority);
 
   // initialize deferral queue for ES_NEW_CHAR events
   ES_InitDeferralQueueWith(DeferralQueue, ARRAY_SIZE(DeferralQueue));
@@ -141,16 +183,22 @@ ES_Event_t RunLEDFSM(ES_Event_t ThisEvent) {
   ES_Event_t ReturnEvent;
   ReturnEvent.EventType = ES_NO_EVENT; // assume no errors
 
+#ifdef TEST_LED_STRESS
+  if ((ThisEvent.EventType == ES_NEW_KEY) && (ThisEvent.EventParam == 's')) {
+    StartStress();
+    return ReturnEvent;
+  }
+#endif
   switch (CurrentState) {
     case InitPState: // If current state is initial Pseudo State
     {
       if (ThisEvent.EventType == ES_INIT) // only respond to ES_Init
       {
-        bool done = DM_TakeInitDisplayStep(); // Initialize Display
+        bool done = DM_TakeInitDisplayStep(&LEDDisplay); // Initialize Display
         if (done == false) {
           ES_Event_t NextEvent;
           NextEvent.EventType = ES_INIT;
-          PostLEDFSM(NextEvent);
+          ES_ContinueService(MyPriority, NextEvent); // take the next step
         } else {
           CurrentState = Waiting;
         }
@@ -160,15 +208,42 @@ ES_Event_t RunLEDFSM(ES_Event_t ThisEvent) {
 
     case Waiting: // If current state is state one
     {
-      if (ThisEvent.EventType == ES_NEW_CHAR) // only respond to ES_NEW_CHAR
+      if (ThisEvent.EventType == ES_NEW_CHAR) // a whole character
       {
         unsigned char entry = ThisEvent.EventParam; // retrieve entered char
-        DM_ScrollDisplayBuffer(4); // Scroll buffer by 4 columns
-        DM_AddChar2DisplayBuffer(entry); // Add character to buffer
+        DM_ScrollDisplayBuffer(&LEDDisplay, 4); // Scroll buffer by 4 columns
+        DM_AddChar2DisplayBuffer(&LEDDisplay, entry); // Add character to buffer
+        DM_StartDisplayUpdate(&LEDDisplay); // ES_UPDATE_COMPLETE when done
+        CurrentState = Updating;
+#ifdef TEST_LED_STRESS
+        if (StressPosted != 0) {
+          // the deferred ones should come back from the deferral queue in
+          // the order they were posted
+          if (entry != 'A' + (StressDrawn % 26)) {
+            StressOutOfOrder++;
+          }
+          StressDrawn++;
+          // fire the next burst once this is the last character outstanding
+          StressBurstDue = (StressRoundsLeft != 0) &&
+              (StressDrawn == StressPosted - StressRefused);
+        }
+        if (StressBurstDue) {
+          uint8_t i;
+          // these arrive while the display is being drawn
+          StressBurstDue = false;
+          StressRoundsLeft--;
+          for (i = 0; i < STRESS_BURST; i++) {
+            PostStressChar();
+          }
+        }
+#endif
+      }
+      else if (ThisEvent.EventType == ES_NEW_COLUMN) // a single pixel column
+      {
+        // a column from DM_RenderMessage
+        DM_ScrollInColumn(&LEDDisplay, ThisEvent.EventParam);
+        DM_StartDisplayUpdate(&LEDDisplay); // ES_UPDATE_COMPLETE when done
         CurrentState = Updating;
-        ES_Event_t NextEvent;
-        NextEvent.EventType = ES_KEEP_UPDATING;
-        PostLEDFSM(NextEvent);
       }
     }
       break;
@@ -179,29 +254,42 @@ ES_Event_t RunLEDFSM(ES_Event_t ThisEvent) {
           // if update is complete
         case ES_UPDATE_COMPLETE:
         {
+          bool IsScrolled;
+
           CurrentState = Waiting; // go to waiting state
-          // recall any deferred character events
-          ES_RecallEvents(MyPriority, DeferralQueue);
+          // the columns that came in are all scrolled in for the next frame
+          IsScrolled = scrollInPendingColumns();
+          // recall any deferred character events, in the order they came
+          // in. The first of them starts the next update, which takes the
+          // columns with it
+          if (!ES_RecallEvents(MyPriority, DeferralQueue)) {
+            if (IsScrolled) {
+              DM_StartDisplayUpdate(&LEDDisplay); // ES_UPDATE_COMPLETE when done
+              CurrentState = Updating;
+            }
+#ifdef TEST_LED_STRESS
+            else if ((StressPosted != 0) && (StressRoundsLeft == 0)) {
+              ReportStress(); // nothing left to draw
+            }
+#endif
+          }
         }
           break;
 
-          // if still updating
-        case ES_KEEP_UPDATING:
+          // if an additional column is sent, keep it for the next frame
+        case ES_NEW_COLUMN:
         {
-          ES_Event_t NextEvent;
-          // take update step and if finished updating, post event
-          if (DM_TakeDisplayUpdateStep() == true) {
-            NextEvent.EventType = ES_UPDATE_COMPLETE;
-            PostLEDFSM(NextEvent);
-          }// else post event to keep updating
-          else {
-            NextEvent.EventType = ES_KEEP_UPDATING;
-            PostLEDFSM(NextEvent);
+          // return an error if there is no room for it
+          if (NumPendingColumns < ARRAY_SIZE(PendingColumns)) {
+            PendingColumns[NumPendingColumns++] = ThisEvent.EventParam;
+          } else {
+            ReturnEvent.EventType = ES_ERROR;
+            ReturnEvent.EventParam = MyPriority;
           }
         }
           break;
 
-          // if additional character to display is sent
+          // if an additional character to display is sent
         case ES_NEW_CHAR:
         {
           // defer the event and return an error if queue is full
@@ -248,4 +336,53 @@ LEDState_t QueryLEDFSM(void) {
 /***************************************************************************
  private functions
  ***************************************************************************/
+// scrolls in the columns that came in during the last update, returning
+// true if there were any
+static bool scrollInPendingColumns(void) {
+  uint8_t i;
+
+  for (i = 0; i < NumPendingColumns; i++) {
+    DM_ScrollInColumn(&LEDDisplay, PendingColumns[i]);
+  }
+  NumPendingColumns = 0;
+  return i != 0;
+}
+
+#ifdef TEST_LED_STRESS
+// starts a stress run with a single character. Each time the last character
+// posted starts drawing, a burst of STRESS_BURST more is posted in the middle
+// of its update, until STRESS_ROUNDS bursts have gone out
+static void StartStress(void) {
+  StressRoundsLeft = STRESS_ROUNDS;
+  StressPosted = 0;
+  StressRefused = 0;
+  StressDrawn = 0;
+  StressOutOfOrder = 0;
+  StressBurstDue = false;
+  DB_printf("LED stress: %d bursts of %d characters\r\n", STRESS_ROUNDS,
+      STRESS_BURST);
+  PostStressChar();
+}
+
+// posts the next letter of the alphabet, counting a failed post as lost
+static void PostStressChar(void) {
+  ES_Event_t CharEvent;
+  CharEvent.EventType = ES_NEW_CHAR;
+  // the letters run on from the last one that got in
+  CharEvent.EventParam = 'A' + ((StressPosted - StressRefused) % 26);
+  if (!PostLEDFSM(CharEvent)) {
+    StressRefused++;
+  }
+  StressPosted++;
+}
+
+// prints the result once the display has nothing left to draw
+static void ReportStress(void) {
+  DB_printf("LED stress: %d characters posted, %d refused, %d lost, "
+      "%d drawn, %d out of order\r\n", StressPosted, StressRefused,
+      StressPosted - StressRefused - StressDrawn, StressDrawn,
+      StressOutOfOrder);
+  StressPosted = 0;
+}
+#endif
 
@@ -2,7 +2,7 @@
  Module
    ButtonDebounceFSM.c
 
- 
+****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
 /* include header files for this state machine as well as any machines at the
    next lower level in the hierarchy that are sub-machines to this machine
@@ -17,7 +17,7 @@
 /*----------------------------- Module Defines ----------------------------*/
 #define PIN_PORT _Port_B
 #define PIN_NUM _Pin_9
-#define PIN_READ PORTBbits.RB9;
+#define PIN_READ ES_Input_Level(ES_IN_LIMIT_SWITCH, PORTBbits.RB9);
 #define DEBOUNCE_TIME 5 // milliseconds
 /*---------------------------- Module Functions ---------------------------*/
 /* prototypes for private functions for this machine.They should be functions
@@ -11,6 +11,7 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/18/26 01:20 agt     the pin is read through the input log
  10/25/24 22:14 sjp     initial version
 ****************************************************************************/
 
@@ -41,7 +42,7 @@
 /*---------------------------- Module Variables ---------------------------*/
 #define PIN_PORT _Port_B
 #define PIN_NUM _Pin_4
-#define PIN_READ PORTBbits.RB4;
+#define PIN_READ ES_Input_Level(ES_IN_PC_SENSOR, PORTBbits.RB4);
 
 static bool LastState;
 
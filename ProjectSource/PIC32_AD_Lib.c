@@ -13,6 +13,7 @@
  When           Who     What/Why
  -------------- ---     --------
 
+ 10/18/26 01:20 agt     ADC_MultiRead passes its results through the input log
  11/03/20 14:55 jec     cleaned up typos and clarified a comment
  10/27/20 16:10 jec     cleaned up the documentation to meet SPDL Standards
  10/20/20 16:38 jec     Began Coding
@@ -21,6 +22,8 @@
 #include "PIC32_AD_Lib.h"
 #include <xc.h>
 #include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_InputLog.h"
 
 /*--------------------------- External Variables --------------------------*/
 
@@ -132,7 +135,6 @@ bool ADC_ConfigAutoScan( uint16_t whichPins){
 ****************************************************************************/
 void ADC_MultiRead(uint32_t *adcResults){
 uint8_t i;
-uint32_t LocalResult;
 volatile uint32_t *resultSet;
 
 // stop automatic sampling during the read to be sure we get a coherent set
@@ -149,11 +151,13 @@ for (i=0; i < numChanInSet; i++)
 {
     // read the results from the ADC1BUFx registers. They are 16 bytes apart in
     // the memory map. That's 4 uint32_t apart, hence *4
-    LocalResult= adcResults[i] = *(resultSet+(4*i)); // read the results from the ADC1BUFx registers
+    adcResults[i] = *(resultSet+(4*i)); // read the results from the ADC1BUFx registers
     
 }
 AD1CON1bits.ASAM = 1;  // restart automatic sampling
 IFS0CLR = _IFS0_AD1IF_MASK;  // clear ADC interrupt flag, see table 7-1, pg 68
+// log the set, or on replay swap in the logged one
+ES_Input_Analog(adcResults, numChanInSet);
 }
 
 // count the number of bits set in v. Algorithm from K&R 
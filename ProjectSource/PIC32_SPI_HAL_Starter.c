@@ -8,6 +8,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+  10/18/26 04:50 agt    SPI2 16-bit sends, SS2 rise check for a second
+                        display
   10/03/21 12:32 jec    started coding
 *****************************************************************************/
 /*----------------------------- Include Files -----------------------------*/
@@ -222,7 +224,7 @@ bool SPISetup_SetBitTime(SPI_Module_t WhichModule, uint32_t SPI_ClkPeriodIn_ns)
       ReturnVal = false;
   else{
       const uint16_t brgDivisor = (20 * SPI_ClkPeriodIn_ns) / (2 * 1000) - 1;
-      if (brgDivisor >= 0 && brgDivisor <= 8191){
+      if (brgDivisor <= 8191){
           selectModuleRegisters(WhichModule);
           *pSPIBRG = brgDivisor;
       }
@@ -245,6 +247,9 @@ bool SPISetup_SetBitTime(SPI_Module_t WhichModule, uint32_t SPI_ClkPeriodIn_ns)
 bool SPISetup_MapSSInput(SPI_Module_t WhichModule, SPI_PinMap_t WhichPin)
 {
   // not needed for ME218a Labs
+  (void)WhichModule;
+  (void)WhichPin;
+  return false;
 }
 
 /****************************************************************************
@@ -322,6 +327,9 @@ bool SPISetup_MapSSOutput(SPI_Module_t WhichModule, SPI_PinMap_t WhichPin)
 bool SPISetup_MapSDInput(SPI_Module_t WhichModule, SPI_PinMap_t WhichPin)
 {
   // not needed for ME218a Labs
+  (void)WhichModule;
+  (void)WhichPin;
+  return false;
 }
 
 /****************************************************************************
@@ -504,6 +512,7 @@ bool SPISetup_EnableSPI(SPI_Module_t WhichModule)
 void SPIOperate_SPI1_Send8(uint8_t TheData)
 {
   // not needed for ME218a Labs
+  (void)TheData;
 }
 
 /****************************************************************************
@@ -533,6 +542,7 @@ void SPIOperate_SPI1_Send16( uint16_t TheData)
 void SPIOperate_SPI1_Send32(uint32_t TheData)
 {
   // not needed for ME218a Labs
+  (void)TheData;
 }
 
 /****************************************************************************
@@ -551,6 +561,7 @@ void SPIOperate_SPI1_Send32(uint32_t TheData)
 void SPIOperate_SPI1_Send8Wait(uint8_t TheData)
 {
   // not needed for ME218a Labs
+  (void)TheData;
 }
 
 /****************************************************************************
@@ -588,6 +599,36 @@ void SPIOperate_SPI1_Send16Wait( uint16_t TheData)
 void SPIOperate_SPI1_Send32Wait(uint32_t TheData)
 {
   // not needed for ME218a Labs
+  (void)TheData;
+}
+
+/****************************************************************************
+ Function
+    SPIOperate_SPI2_Send16
+
+ Description
+   Writes the 16-bit data to the SPI2 Module data register
+  Does not check if there is room in the buffer.
+****************************************************************************/
+void SPIOperate_SPI2_Send16( uint16_t TheData)
+{
+    SPI2BUF = TheData;
+}
+
+/****************************************************************************
+ Function
+    SPIOperate_SPI2_Send16Wait
+
+  Description
+    Writes the 16-bit data to the SPI2 Module data register and waits
+    for the SS2 line to rise. NOTE: this is blocking code, as is
+    SPIOperate_SPI1_Send16Wait.
+    Does not check if there is room in the buffer.
+****************************************************************************/
+void SPIOperate_SPI2_Send16Wait( uint16_t TheData)
+{
+    SPI2BUF = TheData;
+    while (!SPIOperate_HasSS2_Risen()); // wait for SS2 to rise
 }
 /****************************************************************************
  Function
@@ -601,6 +642,8 @@ void SPIOperate_SPI1_Send32Wait(uint32_t TheData)
 uint32_t SPIOperate_ReadData(SPI_Module_t WhichModule)
 {
   // not needed for ME218a Labs
+  (void)WhichModule;
+  return 0;
 }
 /****************************************************************************
  Function
@@ -642,7 +685,12 @@ bool SPIOperate_HasSS1_Risen(void)
 ****************************************************************************/
 bool SPIOperate_HasSS2_Risen(void)
 {
-  // not needed for ME218a
+  bool ReturnVal = true;
+  if (IFS0bits.INT1IF == true){
+      IFS0CLR = _IFS0_INT1IF_MASK;
+  }
+  else ReturnVal = false;
+  return ReturnVal;
 }
 
 
@@ -96,18 +96,6 @@ static uint32_t const mapChannel2PinSelConst[] = { 0b0101/*OC1*/, 0b0101/*OC2*/,
                                                    0b0110/*OC5*/
 };
 
-static PWM_PinMap_t const LegalOC2OutPins[] = { PWM_RPA1, PWM_RPB1, PWM_RPB5, 
-                                                PWM_RPB8,PWM_RPB11
-};
-
-static PWM_PinMap_t const LegalOC3OutPins[] = { PWM_RPA3, PWM_RPB0, PWM_RPB9, 
-                                                PWM_RPB10,PWM_RPB14
-};
-
-static PWM_PinMap_t const LegalOC4_5OutPins[] = { PWM_RPA2, PWM_RPA4, PWM_RPB2, 
-                                                  PWM_RPB6,PWM_RPB13
-};
-
 /*------------------------------ Module Code ------------------------------*/
 
 /****************************************************************************
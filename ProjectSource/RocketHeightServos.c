@@ -55,6 +55,10 @@ bool InitRocketHeightServos(uint8_t Priority) {
   ES_Event_t ThisEvent;
 
   MyPriority = Priority;
+#ifdef TEST_ROCKET_HEIGHT_SERVOS
+  // the test keystrokes arrive by ES_PostAll
+  ES_AddSubscriptions(MyPriority, ES_EVENT_BIT(ES_NEW_KEY));
+#endif
   // post the initial transition event
   ThisEvent.EventType = ES_INIT;
   if (ES_PostToService(MyPriority, ThisEvent) == true) {
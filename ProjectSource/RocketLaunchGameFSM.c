@@ -14,6 +14,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 22:30 agt      WaitForButton compared the timeout param with = not ==
+ 10/17/26 21:45 agt      the difficulty knob is polled with a periodic timer
  01/15/12 11:12 jec      revisions for Gen2 framework
  11/07/11 11:26 jec      made the queue static
  10/30/11 17:59 jec      fixed references to CurrentEvent in RunTemplateSM()
@@ -38,6 +40,7 @@
 #include "RocketHeightServos.h"
 #include "RocketReleaseServo.h"
 #include <string.h>
+#include <stdlib.h>
 
 /*----------------------------- Module Defines ----------------------------*/
 //#define TESTGAME // uncomment to remove testing with keyboard events
@@ -68,6 +71,7 @@ void SendMessage(LED_ID_t whichMsg, LED_Instructions_t whichInst);
 void readPot(void);
 void sendSequenceToDisplay(char* result, const char* input, int numSpaces);
 void setGameOver(void);
+void setLaunchRocket(void);
 
 /*---------------------------- Module Variables ---------------------------*/
 // everybody needs a state variable, you may need others as well.
@@ -80,11 +84,9 @@ static uint8_t gameDifficulty = 0;
 static uint32_t difficultyKnobVal = 0;
 static uint16_t knobAnalogReadVal = 0;
 static uint32_t lastDifficultyKnobVal = 0;
-static char* playerEntry;
 static uint8_t roundNumber;
 char customBuffer[100];
 static uint8_t randomSeed;
-static char* gameSequences[MAX_ROUNDS];
 static uint8_t currentGuess;
 static char userInput[MAX_SEQUENCE_LENGTH + 1]; //+1 for null character at end of strings
 static char currentSequence[MAX_SEQUENCE_LENGTH + 1];
@@ -194,6 +196,10 @@ bool InitRocketLaunchGameFSM(uint8_t Priority) {
   ES_Event_t ThisEvent;
 
   MyPriority = Priority;
+#ifdef TESTGAME
+  // the test keystrokes arrive by ES_PostAll
+  ES_AddSubscriptions(MyPriority, ES_EVENT_BIT(ES_NEW_KEY));
+#endif
   // put us into the Initial PseudoState
   CurrentState = Initializing;
 
@@ -268,6 +274,8 @@ ES_Event_t RunRocketLaunchGameFSM(ES_Event_t ThisEvent) {
     ES_Event_t NewEvent;
     NewEvent.EventType = ES_RESET_GAME_TIMER;
     PostTimerServoFSM(NewEvent);
+    // stop polling the difficulty knob, in case it was being chosen
+    ES_Timer_StopTimer(CHOOSE_DIFFICULTY_TIMER);
     // Goes to state for displaying timeout message
     CurrentState = DisplayingTimeout;
     SendMessage(MSG_TIMEOUT, SCROLL_ONCE_SLOW);
@@ -404,7 +412,7 @@ ES_Event_t RunRocketLaunchGameFSM(ES_Event_t ThisEvent) {
               SendMessage(MSG_CHOOSE_DIFF, DISPLAY_HOLD);
               // Set time to choose difficulty
               ES_Timer_InitTimer(HOLD_MESSAGE_TIMER, 6000);
-              ES_Timer_InitTimer(CHOOSE_DIFFICULTY_TIMER, 200);
+              ES_Timer_InitPeriodic(CHOOSE_DIFFICULTY_TIMER, 200);
               readPot();
               lastDifficultyKnobVal = knobAnalogReadVal;
             }
@@ -447,15 +455,13 @@ ES_Event_t RunRocketLaunchGameFSM(ES_Event_t ThisEvent) {
             if (ThisEvent.EventParam == CHOOSE_DIFFICULTY_TIMER) {
               readPot();
 
-              if (abs(knobAnalogReadVal - lastDifficultyKnobVal) > 3) {
+              if (abs((int32_t)(knobAnalogReadVal - lastDifficultyKnobVal)) > 3) {
                 humanInteracted = true;
                 lastDifficultyKnobVal = knobAnalogReadVal;
                 sprintf(customBuffer, "Difficulty: %d", difficultyKnobVal);
                 currentMessage = customBuffer;
                 SendMessage(MSG_CUSTOM, DISPLAY_HOLD);
               }
-
-              ES_Timer_InitTimer(CHOOSE_DIFFICULTY_TIMER, 200);
             }
             if (ThisEvent.EventParam == HOLD_MESSAGE_TIMER) {
               ES_Timer_StopTimer(CHOOSE_DIFFICULTY_TIMER);
@@ -519,7 +525,7 @@ ES_Event_t RunRocketLaunchGameFSM(ES_Event_t ThisEvent) {
         switch (ThisEvent.EventType) {
           case ES_TIMEOUT:
           {
-            if (ThisEvent.EventParam = HOLD_MESSAGE_TIMER) {
+            if (ThisEvent.EventParam == HOLD_MESSAGE_TIMER) {
               sendSequenceToDisplay(customBuffer, userInput, NUM_SPACES[gameDifficulty - 1]);
             }
           }
@@ -727,7 +733,7 @@ void readPot(void) {
   DB_printf("Difficulty: %d\n", gameDifficulty);
 }
 
-void setLaunchRocket() {
+void setLaunchRocket(void) {
   //currentMessage = "LAUNCH ROCKET!  ";
   //SendMessage(MSG_CUSTOM, SCROLL_REPEAT_SLOW);
   CurrentState = LaunchRocket;
@@ -751,7 +757,7 @@ void setLaunchRocket() {
   ES_Timer_InitTimer(HOLD_MESSAGE_TIMER, 100);
 }
 
-void setGameOver() {
+void setGameOver(void) {
   ES_Event_t NewEvent;
   NewEvent.EventType = ES_ROCKET_RELEASE_SERVO_LAUNCH;
   PostRocketReleaseServo(NewEvent);
@@ -774,7 +780,7 @@ void sendSequenceToDisplay(char* result, const char* input, int numSpaces) {
 
   // Add the characters from input with spaces between them
   int j = numSpaces;
-  for (int i = 0; i < strlen(input); i++) {
+  for (size_t i = 0; i < strlen(input); i++) {
     result[j++] = input[i];
     if (i < strlen(input) - 1) {
       result[j++] = ' '; // Add space between characters
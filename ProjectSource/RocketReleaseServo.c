@@ -45,6 +45,10 @@ bool InitRocketReleaseServo(uint8_t Priority) {
   ES_Event_t ThisEvent;
 
   MyPriority = Priority;
+#ifdef TEST_ROCKET_RELEASE
+  // the test keystrokes arrive by ES_PostAll
+  ES_AddSubscriptions(MyPriority, ES_EVENT_BIT(ES_NEW_KEY));
+#endif
   // post the initial transition event
   ThisEvent.EventType = ES_INIT;
   if (ES_PostToService(MyPriority, ThisEvent) == true) {
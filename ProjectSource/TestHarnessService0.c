@@ -14,6 +14,12 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 18:45 agt     deferral queue sized to a power of 2 plus 1
+ 10/17/26 14:20 agt     Timer2ISR posts through a mailbox and times its post,
+                        or posts directly if POST_FROM_INTS is defined
+ 10/17/26 13:05 agt     'c' starts a profile dump when the profiler is enabled
+ 10/17/26 12:10 agt     'q' dumps the queue telemetry when it is enabled
+ 10/17/26 11:30 agt     added TEST_BATCH_DISPATCH event storm benchmark
  10/26/17 18:26 jec     moves definition of ALL_BITS to ES_Port.h
  10/19/17 21:28 jec     meaningless change to test updating
  10/19/17 18:42 jec     removed referennces to driverlib and programmed the
@@ -56,6 +62,7 @@
 
 //#define TEST_INT_POST
 //#define BLINK LED
+//#define TEST_BATCH_DISPATCH
 /*---------------------------- Module Functions ---------------------------*/
 /* prototypes for private functions for this service.They should be functions
    relevant to the behavior of this service
@@ -69,11 +76,34 @@ static void BlinkLED(void);
 static void InitTMR2(void);
 static void StartTMR2(void);
 #endif
+
+#ifdef TEST_BATCH_DISPATCH
+// number of self-posted events in each storm
+#define STORM_LENGTH 10000
+// the core timer runs at half of the 40MHz system clock
+#define CORE_TICKS_PER_SEC 20000000ULL
+static void StartStorm(void);
+static void ReportStorm(void);
+#endif
 /*---------------------------- Module Variables ---------------------------*/
+#ifdef TEST_INT_POST
+// the Timer2ISR mailbox and the longest that its post has taken
+static ES_Mailbox_t       Timer2Mailbox;
+static ES_Event_t         Timer2Slots[4];
+static volatile uint32_t  MaxIntPostTicks;
+#endif
 // with the introduction of Gen2, we need a module level Priority variable
 static uint8_t MyPriority;
 // add a deferral queue for up to 3 pending deferrals +1 to allow for overhead
-static ES_Event_t DeferralQueue[3 + 1];
+static ES_Event_t DeferralQueue[4 + 1];
+
+#ifdef TEST_BATCH_DISPATCH
+// the batch budgets to measure, one storm each
+static const uint8_t StormBudgets[] = { 1, 4, 16 };
+static uint8_t  StormIndex;
+static uint16_t StormCount;
+static uint32_t StormStart;
+#endif
 
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
@@ -111,6 +141,15 @@ bool InitTestHarnessService0(uint8_t Priority)
   DB_printf( "Press 'd' to test event deferral \n\r");
   DB_printf( "Press 'r' to test event recall \n\r");
   DB_printf( "Press 'p' to test posting from an interrupt \n\r");
+#ifdef ES_QUEUE_TELEMETRY
+  DB_printf( "Press 'q' to print the queue telemetry \n\r");
+#endif
+#ifdef ES_PROFILER
+  DB_printf( "Press 'c' to print the cycle profile \n\r");
+#endif
+#ifdef TEST_BATCH_DISPATCH
+  DB_printf( "Press 'b' to time an event storm at batch sizes 1, 4 & 16 \n\r");
+#endif
 
   /********************************************
    in here you write your initialization code
@@ -122,6 +161,8 @@ bool InitTestHarnessService0(uint8_t Priority)
   InitLED();
 #endif
 #ifdef TEST_INT_POST
+  ES_Mailbox_Init(&Timer2Mailbox, Timer2Slots, ARRAY_SIZE(Timer2Slots),
+      MyPriority);
   InitTMR2();
 #endif
   // initialize the Short timer system for channel A
@@ -206,6 +247,10 @@ ES_Event_t RunTestHarnessService0(ES_Event_t ThisEvent)
     case ES_SHORT_TIMEOUT:   // lower the line & announce
     {
       puts("\rES_SHORT_TIMEOUT received\r\n");
+#ifdef TEST_INT_POST
+      DB_printf("posting from the ISR took at most %d core ticks\r\n",
+          MaxIntPostTicks);
+#endif
     }
     break;
     case ES_NEW_KEY:   // announce
@@ -237,8 +282,49 @@ ES_Event_t RunTestHarnessService0(ES_Event_t ThisEvent)
         StartTMR2();
       }
 #endif
+#ifdef ES_QUEUE_TELEMETRY
+      if ('q' == ThisEvent.EventParam)
+      {
+        ES_DumpQueueStats();
+      }
+#endif
+#ifdef ES_PROFILER
+      if ('c' == ThisEvent.EventParam)
+      {
+        ES_Profile_StartDump();
+      }
+#endif
+#ifdef TEST_BATCH_DISPATCH
+      if ('b' == ThisEvent.EventParam)
+      {
+        StormIndex = 0;
+        StartStorm();
+      }
+#endif
+    }
+    break;
+#ifdef TEST_BATCH_DISPATCH
+    case ES_KEEP_UPDATING:   // one link of the event storm
+    {
+      if (++StormCount < STORM_LENGTH)
+      {
+        PostTestHarnessService0(ThisEvent);
+      }
+      else
+      {
+        ReportStorm();
+        if (++StormIndex < ARRAY_SIZE(StormBudgets))
+        {
+          StartStorm();
+        }
+        else
+        {
+          ES_SetBatchBudget(MyPriority, 1);
+        }
+      }
     }
     break;
+#endif
     default:
     {}
      break;
@@ -265,6 +351,31 @@ static void BlinkLED(void)
 }
 #endif
 
+#ifdef TEST_BATCH_DISPATCH
+// Sets the budget for the next storm and posts its first event. Each
+// ES_KEEP_UPDATING re-posts itself, as the LED services do while drawing,
+// so the storm measures the ES_Run overhead per dispatched event
+static void StartStorm(void)
+{
+  ES_Event_t StormEvent = { ES_KEEP_UPDATING, 0 };
+
+  ES_SetBatchBudget(MyPriority, StormBudgets[StormIndex]);
+  StormCount = 0;
+  StormStart = _CP0_GET_COUNT();
+  PostTestHarnessService0(StormEvent);
+}
+
+// Prints the throughput of the storm that just finished
+static void ReportStorm(void)
+{
+  uint32_t Elapsed = _CP0_GET_COUNT() - StormStart;
+
+  DB_printf("batch %d: %d events in %d core ticks = %d events/sec\r\n",
+      StormBudgets[StormIndex], STORM_LENGTH, Elapsed,
+      (uint32_t)((STORM_LENGTH * CORE_TICKS_PER_SEC) / Elapsed));
+}
+#endif
+
 #ifdef TEST_INT_POST
 #include <sys/attribs.h> // for ISR macors
 
@@ -306,7 +417,18 @@ void __ISR(_TIMER_2_VECTOR, IPL2AUTO) Timer2ISR(void)
   IFS0bits.T2IF = 0;
   // post event
   static ES_Event_t interruptEvent = {ES_SHORT_TIMEOUT, 0};
+  uint32_t PostStart = _HW_GetCoreTicks();
+#ifdef POST_FROM_INTS
+  // the old way, straight into the queue with interrupts turned off
   PostTestHarnessService0(interruptEvent);
+#else
+  ES_Mailbox_Post(&Timer2Mailbox, interruptEvent);
+#endif
+  uint32_t PostTicks = _HW_GetCoreTicks() - PostStart;
+  if (PostTicks > MaxIntPostTicks)
+  {
+    MaxIntPostTicks = PostTicks;
+  }
   
   // stop timer
   T2CONbits.ON = 0;
@@ -10,6 +10,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/17/26 21:45 agt      the one second timer is periodic, so the game time
+                         doesn't drift by the timeout handling time
  01/15/12 11:12 jec      revisions for Gen2 framework
  11/07/11 11:26 jec      made the queue static
  10/30/11 17:59 jec      fixed references to CurrentEvent in RunTemplateSM()
@@ -70,6 +72,10 @@ bool InitTimerServoFSM(uint8_t Priority) {
   ES_Event_t ThisEvent;
 
   MyPriority = Priority;
+#ifdef TEST_TIMER_SERVO_FSM
+  // the test keystrokes arrive by ES_PostAll
+  ES_AddSubscriptions(MyPriority, ES_EVENT_BIT(ES_NEW_KEY));
+#endif
   // put us into the Initial PseudoState
   CurrentState = TS_InitPState;
   // post the initial transition event
@@ -128,7 +134,7 @@ ES_Event_t RunTimerServoFSM(ES_Event_t ThisEvent) {
       switch (ThisEvent.EventType) {
         case ES_START_GAME_TIMER:
         {
-          ES_Timer_InitTimer(TIMER_SERVO_TIMER, ONE_SECOND);
+          ES_Timer_InitPeriodic(TIMER_SERVO_TIMER, ONE_SECOND);
           timerVal = 0;
           SetServoTime(0);
           CurrentState = TS_Timing;
@@ -147,6 +153,7 @@ ES_Event_t RunTimerServoFSM(ES_Event_t ThisEvent) {
             timerVal++;
             SetServoTime(timerVal);
             if (timerVal >= maxTime) {
+              ES_Timer_StopTimer(TIMER_SERVO_TIMER);
               CurrentState = TS_Waiting;
 
               DB_printf("GAME OVER!!!\n");
@@ -154,9 +161,6 @@ ES_Event_t RunTimerServoFSM(ES_Event_t ThisEvent) {
               ES_Event_t NewEvent;
               NewEvent.EventType = ES_GAME_OVER;
               PostRocketLaunchGameFSM(NewEvent);
-
-            } else {
-              ES_Timer_InitTimer(TIMER_SERVO_TIMER, ONE_SECOND);
             }
           }
         }
@@ -16,7 +16,7 @@
 #include "ES_Port.h"
 #include "PWM_PIC32.h"
 
-void main(void)
+int main(void)
 {
   ES_Return_t ErrorType = Success;
 